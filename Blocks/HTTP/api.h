@@ -46,6 +46,7 @@ SOFTWARE.
 #if defined(CURRENT_POSIX) || defined(CURRENT_WINDOWS) || defined(CURRENT_APPLE_HTTP_CLIENT_POSIX)
 #include "impl/posix_client.h"
 #include "impl/posix_server.h"
+#include "impl/async_client.h"
 #include "chunked_response_parser.h"
 using HTTP_CLIENT = current::http::HTTPClientPOSIX;
 using CHUNKED_HTTP_CLIENT = current::http::GenericHTTPClientPOSIX<ChunkByChunkHTTPResponseReceiver>;
@@ -80,6 +81,7 @@ using current::http::HTTP;
 using current::http::Request;
 using current::http::Response;
 using current::http::ReRegisterRoute;
+using current::http::HTTPServerOptions;
 using HTTPRoutesScope = typename HTTP_IMPL::server_impl_t::HTTPRoutesScope;
 using HTTPRoutesScopeEntry = current::http::HTTPServerPOSIX::HTTPRoutesScopeEntry;
 
@@ -0,0 +1,142 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Admission control of `HTTPServerPOSIX`, per server and per route.
+//
+// A request is "queued" from the moment it has been received in full until a handler thread picks it up,
+// and is "in flight" while its handler runs. A request over either limit is not served, but "shed":
+// it gets an immediate "503 SERVICE UNAVAILABLE" with the `Retry-After` header, instead of waiting.
+// Thus, a route which has fallen behind can not push the requests to the other routes into timeouts.
+
+#ifndef BLOCKS_HTTP_IMPL_ADMISSION_H
+#define BLOCKS_HTTP_IMPL_ADMISSION_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace current {
+namespace http {
+
+// Zero stands for "no limit".
+struct HTTPAdmissionLimits {
+  // The maximum number of requests the handlers of which are running at the same time.
+  size_t max_in_flight_requests = 0u;
+  // The maximum number of requests waiting for the handler thread. Only applies with `WorkerThreads(n)`.
+  size_t max_queued_requests = 0u;
+  // The value of the `Retry-After` header of the "503" response to the request which has been shed.
+  std::chrono::seconds retry_after = std::chrono::seconds(1);
+
+  HTTPAdmissionLimits& MaxInFlightRequests(size_t value) {
+    max_in_flight_requests = value;
+    return *this;
+  }
+  HTTPAdmissionLimits& MaxQueuedRequests(size_t value) {
+    max_queued_requests = value;
+    return *this;
+  }
+  HTTPAdmissionLimits& RetryAfter(std::chrono::seconds value) {
+    retry_after = value;
+    return *this;
+  }
+};
+
+struct HTTPAdmissionCounters {
+  uint64_t in_flight = 0u;  // The number of requests the handlers of which are running now.
+  uint64_t queued = 0u;     // The number of requests waiting for the handler thread now.
+  uint64_t admitted = 0u;   // The total number of requests which have passed the in-flight limit.
+  uint64_t shed = 0u;       // The total number of requests responded to with a "503".
+};
+
+struct HTTPAdmissionStats {
+  HTTPAdmissionCounters server;
+  // Only the routes with limits set via `SetRouteAdmissionLimits()` are tracked.
+  std::map<std::string, HTTPAdmissionCounters> routes;
+};
+
+// The limits and the counters of the server, or of a single route. Thread-safe.
+class HTTPAdmission final {
+ public:
+  explicit HTTPAdmission(const HTTPAdmissionLimits& limits = HTTPAdmissionLimits()) : limits_(limits) {}
+
+  void SetLimits(const HTTPAdmissionLimits& limits) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limits_ = limits;
+  }
+
+  // Returns `false`, and counts the request as shed, if the queue is full.
+  bool TryEnqueue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (limits_.max_queued_requests && counters_.queued >= limits_.max_queued_requests) {
+      ++counters_.shed;
+      return false;
+    }
+    ++counters_.queued;
+    return true;
+  }
+
+  void Dequeue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --counters_.queued;
+  }
+
+  // Returns `false`, and counts the request as shed, if too many requests are in flight already.
+  bool TryStart() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (limits_.max_in_flight_requests && counters_.in_flight >= limits_.max_in_flight_requests) {
+      ++counters_.shed;
+      return false;
+    }
+    ++counters_.in_flight;
+    ++counters_.admitted;
+    return true;
+  }
+
+  void Finish() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    --counters_.in_flight;
+  }
+
+  std::chrono::seconds RetryAfter() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limits_.retry_after;
+  }
+
+  HTTPAdmissionCounters Counters() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_;
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  HTTPAdmissionLimits limits_;
+  HTTPAdmissionCounters counters_;
+};
+
+}  // namespace http
+}  // namespace current
+
+#endif  // BLOCKS_HTTP_IMPL_ADMISSION_H
@@ -0,0 +1,746 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The asynchronous HTTP client, which runs many requests at once from a single `epoll`-based thread.
+//
+// `HTTPAsyncClient::Send()` takes the very `GET`, `HEAD`, `POST`, `PUT`, `PATCH` and `DELETE` request objects
+// the blocking `HTTP(...)` call takes, and returns an `std::future<HTTPResponseWithBuffer>`, or calls back
+// with the response or with the exception. `ChunkedGET` streams the chunks through its own callbacks.
+//
+// Each request has a deadline, counted from the call to `Send()`, and fails with `HTTPRequestTimeoutException`
+// once the deadline passes. The deadline covers the time spent in the queue and following the redirects.
+// At most `max_concurrent_requests` connections are open at any time, the requests beyond this limit wait
+// in the queue. The callbacks are invoked from the thread of the client, keep them short.
+//
+// The host name is resolved on the caller's thread as the request is sent. The targets of the redirects are resolved
+// on a separate thread, started on the first redirect, so that a slow DNS lookup does not hold up the other requests.
+// Each request uses its own connection, which is closed once the response is received.
+
+#ifndef BLOCKS_HTTP_IMPL_ASYNC_CLIENT_H
+#define BLOCKS_HTTP_IMPL_ASYNC_CLIENT_H
+
+#include "../../../port.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "posix_client.h"
+
+#include "../../../Bricks/net/exceptions.h"
+#include "../../../Bricks/net/http/http.h"
+#include "../../../Bricks/strings/join.h"
+#include "../../../Bricks/time/chrono.h"
+
+#if defined(CURRENT_POSIX) && defined(__linux__)
+#define CURRENT_HTTP_HAS_ASYNC_CLIENT
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
+namespace current {
+namespace http {
+
+// Parses the HTTP response from the bytes as they arrive. The body is either `Content-Length` bytes,
+// or the chunks up to and including the zero-length one, or everything until the server closes the connection.
+// The chunks are passed to `on_chunk`, if set, and appended to the body otherwise.
+class IncrementalHTTPResponse final {
+ public:
+  // Headers larger than this are a sign of a misbehaving server.
+  static constexpr size_t kMaxHeaderSizeInBytes = 1024 * 1024;
+
+  IncrementalHTTPResponse(bool head_request,
+                          std::function<void(const std::string&, const std::string&)> on_header = nullptr,
+                          std::function<void(const std::string&)> on_chunk = nullptr)
+      : head_request_(head_request), on_header_(on_header), on_chunk_(on_chunk) {}
+
+  // Returns `true` once the response has been received in full.
+  bool Append(const char* data, size_t length) {
+    buffer_.erase(0, offset_);
+    offset_ = 0u;
+    buffer_.append(data, length);
+    while (state_ != State::Done) {
+      if (state_ == State::StatusLine || state_ == State::Headers || state_ == State::ChunkSize ||
+          state_ == State::Trailers) {
+        const char* begin = buffer_.data() + offset_;
+        const char* crlf = current::net::http::scan::FindCRLF(begin, buffer_.data() + buffer_.length());
+        if (!crlf) {
+          if (buffer_.length() - offset_ > kMaxHeaderSizeInBytes) {
+            CURRENT_THROW(current::net::HTTPMalformedResponseException("The line is too long."));
+          }
+          return false;
+        }
+        offset_ += (crlf - begin) + 2;
+        OnLine(std::string(begin, crlf));
+      } else if (state_ == State::ContentLengthBody) {
+        if (buffer_.length() - offset_ < remaining_) {
+          return false;
+        }
+        body_.append(buffer_, offset_, remaining_);
+        offset_ += remaining_;
+        state_ = State::Done;
+      } else if (state_ == State::ChunkData) {
+        if (buffer_.length() - offset_ < remaining_ + 2) {
+          return false;
+        }
+        if (on_chunk_) {
+          on_chunk_(buffer_.substr(offset_, remaining_));
+        } else {
+          body_.append(buffer_, offset_, remaining_);
+        }
+        offset_ += remaining_ + 2;
+        state_ = State::ChunkSize;
+      } else {
+        // `State::UntilClosed`.
+        body_.append(buffer_, offset_, std::string::npos);
+        offset_ = buffer_.length();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The server has closed the connection. Returns `true` if the response is complete nonetheless.
+  bool OnEndOfStream() {
+    if (state_ == State::UntilClosed) {
+      state_ = State::Done;
+    }
+    return state_ == State::Done;
+  }
+
+  int Code() const { return code_; }
+  const std::string& Location() const { return location_; }
+  current::net::http::Headers& Headers() { return headers_; }
+  std::string& Body() { return body_; }
+
+ private:
+  enum class State { StatusLine, Headers, ContentLengthBody, ChunkSize, ChunkData, Trailers, UntilClosed, Done };
+
+  static std::string Trim(const std::string& s) {
+    const size_t begin = s.find_first_not_of(" \t");
+    return begin == std::string::npos ? "" : s.substr(begin, s.find_last_not_of(" \t") - begin + 1);
+  }
+
+  void OnLine(const std::string& line) {
+    if (state_ == State::StatusLine) {
+      // Tolerate the empty lines before the status line, as the request parser does.
+      if (!line.empty()) {
+        const size_t space = line.find(' ');
+        if (line.compare(0, 5, "HTTP/") || space == std::string::npos) {
+          CURRENT_THROW(current::net::HTTPMalformedResponseException(line));
+        }
+        code_ = std::atoi(line.c_str() + space + 1);
+        state_ = State::Headers;
+      }
+    } else if (state_ == State::Headers) {
+      if (!line.empty()) {
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+          CURRENT_THROW(current::net::HTTPMalformedResponseException(line));
+        }
+        OnHeader(Trim(line.substr(0, colon)), Trim(line.substr(colon + 1)));
+      } else {
+        OnHeadersDone();
+      }
+    } else if (state_ == State::ChunkSize) {
+      char* end;
+      remaining_ = static_cast<size_t>(std::strtoull(line.c_str(), &end, 16));
+      if (end == line.c_str() || (*end && *end != ';' && *end != ' ')) {
+        CURRENT_THROW(current::net::ChunkSizeNotAValidHEXValue());
+      }
+      state_ = remaining_ ? State::ChunkData : State::Trailers;
+    } else if (line.empty()) {
+      // `State::Trailers`, which are ignored.
+      state_ = State::Done;
+    }
+  }
+
+  void OnHeader(const std::string& key, const std::string& value) {
+    if (!strcasecmp(key.c_str(), current::net::constants::kContentLengthHeaderKey)) {
+      content_length_ = static_cast<size_t>(std::strtoull(value.c_str(), nullptr, 10));
+      has_content_length_ = true;
+    } else if (!strcasecmp(key.c_str(), current::net::constants::kTransferEncodingHeaderKey) &&
+               !strcasecmp(value.c_str(), current::net::constants::kTransferEncodingChunkedValue)) {
+      chunked_ = true;
+    } else if (!strcasecmp(key.c_str(), "Location")) {
+      location_ = value;
+    }
+    headers_.SetHeaderOrCookie(key, value);
+    if (on_header_) {
+      on_header_(key, value);
+    }
+  }
+
+  void OnHeadersDone() {
+    if (code_ >= 100 && code_ <= 199) {
+      // The interim response, such as `100 Continue`, is followed by the actual one.
+      headers_ = current::net::http::Headers();
+      state_ = State::StatusLine;
+    } else if (head_request_ || code_ == 204 || code_ == 304) {
+      state_ = State::Done;
+    } else if (chunked_) {
+      state_ = State::ChunkSize;
+    } else if (has_content_length_) {
+      remaining_ = content_length_;
+      state_ = State::ContentLengthBody;
+    } else {
+      state_ = State::UntilClosed;
+    }
+  }
+
+  const bool head_request_;
+  const std::function<void(const std::string&, const std::string&)> on_header_;
+  const std::function<void(const std::string&)> on_chunk_;
+
+  State state_ = State::StatusLine;
+  std::string buffer_;
+  size_t offset_ = 0u;
+  size_t remaining_ = 0u;
+
+  int code_ = 0;
+  current::net::http::Headers headers_;
+  std::string location_;
+  bool chunked_ = false;
+  bool has_content_length_ = false;
+  size_t content_length_ = 0u;
+  std::string body_;
+};
+
+#ifdef CURRENT_HTTP_HAS_ASYNC_CLIENT
+
+struct HTTPAsyncClientOptions {
+  // The maximum number of requests in progress at the same time. The requests beyond it wait in the queue.
+  size_t max_concurrent_requests = 64u;
+  // The timeout of the requests sent with no timeout of their own.
+  std::chrono::milliseconds default_timeout = std::chrono::seconds(30);
+
+  HTTPAsyncClientOptions& MaxConcurrentRequests(size_t value) {
+    max_concurrent_requests = value;
+    return *this;
+  }
+  HTTPAsyncClientOptions& DefaultTimeout(std::chrono::milliseconds value) {
+    default_timeout = value;
+    return *this;
+  }
+};
+
+class HTTPAsyncClient final {
+ public:
+  using on_response_t = std::function<void(HTTPResponseWithBuffer&&)>;
+  using on_error_t = std::function<void(std::exception_ptr)>;
+
+  explicit HTTPAsyncClient(const HTTPAsyncClientOptions& options = HTTPAsyncClientOptions())
+      : options_(options), epoll_fd_(::epoll_create1(EPOLL_CLOEXEC)), wakeup_fd_(::eventfd(0, EFD_NONBLOCK)) {
+    if (epoll_fd_ < 0 || wakeup_fd_ < 0) {
+      CURRENT_THROW(current::net::SocketCreateException());  // LCOV_EXCL_LINE
+    }
+    Watch(wakeup_fd_, EPOLLIN, EPOLL_CTL_ADD);
+    thread_ = std::thread([this]() { Loop(); });
+  }
+
+  // The requests still in progress fail with `HTTPClientShutdownException`.
+  ~HTTPAsyncClient() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    redirects_cv_.notify_one();
+    WakeUp();
+    thread_.join();
+    if (redirects_thread_.joinable()) {
+      redirects_thread_.join();
+    }
+    // Both threads are done, so the requests they have left behind are failed from here.
+    const std::exception_ptr shutdown = std::make_exception_ptr(current::net::HTTPClientShutdownException());
+    for (auto& call : redirects_) {
+      Fail(std::move(call), shutdown);
+    }
+    for (auto& call : submitted_) {
+      Fail(std::move(call), shutdown);
+    }
+    ::close(wakeup_fd_);
+    ::close(epoll_fd_);
+  }
+
+  // The zero `timeout` stands for the default timeout of the client.
+  template <typename REQUEST>
+  void Send(const REQUEST& request,
+            on_response_t on_response,
+            on_error_t on_error,
+            std::chrono::milliseconds timeout = std::chrono::milliseconds(0)) {
+    std::unique_ptr<Call> call(new Call(on_response, on_error));
+    try {
+      ImplWrapper<HTTPClientPOSIX>::PrepareInput(request, call->request);
+    } catch (...) {
+      on_error(std::current_exception());
+      return;
+    }
+    Submit(std::move(call), timeout);
+  }
+
+  template <typename REQUEST>
+  std::future<HTTPResponseWithBuffer> Send(const REQUEST& request,
+                                           std::chrono::milliseconds timeout = std::chrono::milliseconds(0)) {
+    auto promise = std::make_shared<std::promise<HTTPResponseWithBuffer>>();
+    std::future<HTTPResponseWithBuffer> future = promise->get_future();
+    Send(request,
+         [promise](HTTPResponseWithBuffer&& response) { promise->set_value(std::move(response)); },
+         [promise](std::exception_ptr e) { promise->set_exception(e); },
+         timeout);
+    return future;
+  }
+
+  // The headers and the chunks are passed to the callbacks of `ChunkedGET` as they arrive. A body which is not
+  // chunked is passed as a single chunk. Throwing from the callbacks aborts the request with that exception.
+  std::future<net::HTTPResponseCodeValue> Send(const ChunkedGET& request,
+                                               std::chrono::milliseconds timeout = std::chrono::milliseconds(0)) {
+    auto promise = std::make_shared<std::promise<net::HTTPResponseCodeValue>>();
+    std::future<net::HTTPResponseCodeValue> future = promise->get_future();
+    std::unique_ptr<Call> call(
+        new Call([promise](HTTPResponseWithBuffer&& response) { promise->set_value(response.code); },
+                 [promise](std::exception_ptr e) { promise->set_exception(e); }));
+    call->request.request_method_ = "GET";
+    call->request.request_url_ = request.url;
+    call->streaming = true;
+    call->header_callback = request.header_callback;
+    call->chunk_callback = request.chunk_callback;
+    call->done_callback = request.done_callback;
+    Submit(std::move(call), timeout);
+    return future;
+  }
+
+  // The number of requests sent and not yet completed, including the queued ones.
+  size_t InFlightRequestsCount() const { return in_flight_; }
+
+ private:
+  struct Call {
+    // The method, the URL, the headers and the body of the request, as prepared for the blocking client.
+    HTTPClientPOSIX request;
+    on_response_t on_response;
+    on_error_t on_error;
+
+    bool streaming = false;
+    std::function<void(const std::string&, const std::string&)> header_callback;
+    std::function<void(const std::string&)> chunk_callback;
+    std::function<void()> done_callback;
+
+    std::chrono::microseconds deadline;
+    URL url;
+    std::string response_url;
+    std::set<std::string> visited_urls;
+    sockaddr_in address;
+    // Set if the host name of the redirect target could not be resolved.
+    std::exception_ptr resolve_error;
+
+    int fd = -1;
+    bool connected = false;
+    std::string output;
+    size_t output_offset = 0u;
+    std::unique_ptr<IncrementalHTTPResponse> response;
+
+    Call(on_response_t on_response, on_error_t on_error)
+        : request(HTTPClientPOSIX::http_helper_t::ConstructionParams()),
+          on_response(on_response),
+          on_error(on_error) {}
+  };
+
+  static sockaddr_in Resolve(const URL& url) {
+    const current::net::addrinfo_t addr_info = current::net::GetAddrInfo(url.host, std::to_string(url.port));
+    sockaddr_in result;
+    std::memcpy(&result, addr_info->ai_addr, sizeof(result));
+    return result;
+  }
+
+  // Sets the URL to request next. Throws on a redirect loop.
+  static void NavigateTo(Call& call, const URL& url) {
+    const std::string composed_url = url.ComposeURL();
+    if (call.visited_urls.count(composed_url)) {
+      CURRENT_THROW(current::net::HTTPRedirectLoopException(current::strings::Join(call.visited_urls, ' ') + ' ' +
+                                                            composed_url));
+    }
+    call.visited_urls.insert(composed_url);
+    call.url = url;
+  }
+
+  void Submit(std::unique_ptr<Call> call, std::chrono::milliseconds timeout) {
+    call->deadline = current::time::Now() +
+                     std::chrono::microseconds(timeout.count() ? timeout : options_.default_timeout);
+    call->response_url = call->request.request_url_;
+    try {
+      NavigateTo(*call, URL(call->request.request_url_));
+      call->address = Resolve(call->url);
+    } catch (...) {
+      call->on_error(std::current_exception());
+      return;
+    }
+    ++in_flight_;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!stopping_) {
+        submitted_.push_back(std::move(call));
+      }
+    }
+    if (call) {
+      Fail(std::move(call), std::make_exception_ptr(current::net::HTTPClientShutdownException()));  // LCOV_EXCL_LINE
+    } else {
+      WakeUp();
+    }
+  }
+
+  // Resolves the host names of the redirect targets, and passes the requests back to the thread of the client.
+  void RedirectsThread() {
+    while (true) {
+      std::unique_ptr<Call> call;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        redirects_cv_.wait(lock, [this]() { return stopping_ || !redirects_.empty(); });
+        if (stopping_) {
+          return;
+        }
+        call = std::move(redirects_.front());
+        redirects_.pop_front();
+      }
+      try {
+        call->address = Resolve(call->url);
+      } catch (...) {
+        call->resolve_error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        submitted_.push_back(std::move(call));
+      }
+      WakeUp();
+    }
+  }
+
+  void WakeUp() {
+    const uint64_t one = 1u;
+    if (::write(wakeup_fd_, &one, sizeof(one)) < 0) {
+      // The counter is non-zero already, which is just as good.
+    }
+  }
+
+  void Watch(int fd, uint32_t events, int operation) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.fd = fd;
+    if (::epoll_ctl(epoll_fd_, operation, fd, &event)) {
+      CURRENT_THROW(current::net::SocketException());  // LCOV_EXCL_LINE
+    }
+  }
+
+  void Loop() {
+    constexpr int kMaxEvents = 256;
+    struct epoll_event events[kMaxEvents];
+    while (true) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+          break;
+        }
+        for (auto& call : submitted_) {
+          queued_.push_back(std::move(call));
+        }
+        submitted_.clear();
+      }
+      while (!queued_.empty() && active_.size() < std::max(options_.max_concurrent_requests, size_t(1))) {
+        std::unique_ptr<Call> call = std::move(queued_.front());
+        queued_.pop_front();
+        Start(std::move(call));
+      }
+      const int n = ::epoll_wait(epoll_fd_, events, kMaxEvents, ExpireAndReturnMillisecondsUntilNextDeadline());
+      if (n < 0 && errno != EINTR) {
+        std::cerr << "HTTP async client `epoll_wait()` failed: " << strerror(errno) << '\n';  // LCOV_EXCL_LINE
+        break;                                                                                 // LCOV_EXCL_LINE
+      }
+      for (int i = 0; i < n; ++i) {
+        if (events[i].data.fd == wakeup_fd_) {
+          uint64_t value;
+          if (::read(wakeup_fd_, &value, sizeof(value)) < 0) {
+            // Nothing to read, the client has been woken up more than once.
+          }
+        } else {
+          OnEvent(events[i].data.fd, events[i].events);
+        }
+      }
+    }
+    // Shutting down.
+    const std::exception_ptr shutdown = std::make_exception_ptr(current::net::HTTPClientShutdownException());
+    while (!active_.empty()) {
+      Fail(Detach(active_.begin()->first), shutdown);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto& call : submitted_) {
+        queued_.push_back(std::move(call));
+      }
+      submitted_.clear();
+    }
+    for (auto& call : queued_) {
+      Fail(std::move(call), shutdown);
+    }
+    queued_.clear();
+  }
+
+  // Fails the requests past their deadlines. Returns the `epoll_wait()` timeout until the next deadline, or -1.
+  int ExpireAndReturnMillisecondsUntilNextDeadline() {
+    const std::chrono::microseconds now = current::time::Now();
+    const std::exception_ptr timeout = std::make_exception_ptr(current::net::HTTPRequestTimeoutException());
+    std::chrono::microseconds next = std::chrono::microseconds::max();
+    for (auto it = active_.begin(); it != active_.end();) {
+      const std::chrono::microseconds deadline = it->second->deadline;
+      const int fd = it->first;
+      ++it;
+      if (deadline <= now) {
+        Fail(Detach(fd), timeout);
+      } else {
+        next = std::min(next, deadline);
+      }
+    }
+    for (auto it = queued_.begin(); it != queued_.end();) {
+      if ((*it)->deadline <= now) {
+        Fail(std::move(*it), timeout);
+        it = queued_.erase(it);
+      } else {
+        next = std::min(next, (*it)->deadline);
+        ++it;
+      }
+    }
+    if (next == std::chrono::microseconds::max()) {
+      return -1;
+    } else {
+      // Round up, so that the deadline has passed by the time the client wakes up.
+      return static_cast<int>((next - now).count() / 1000 + 1);
+    }
+  }
+
+  void Start(std::unique_ptr<Call> call) {
+    if (call->resolve_error) {
+      const std::exception_ptr e = call->resolve_error;
+      Fail(std::move(call), e);
+      return;
+    }
+    try {
+      call->output = call->request.ComposeRequestHead(call->url) + call->request.request_body_contents_;
+      call->output_offset = 0u;
+      call->connected = false;
+      if (call->streaming) {
+        call->response.reset(
+            new IncrementalHTTPResponse(false, call->header_callback, call->chunk_callback));
+      } else {
+        call->response.reset(new IncrementalHTTPResponse(call->request.request_method_ == "HEAD"));
+      }
+      call->fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+      if (call->fd < 0) {
+        CURRENT_THROW(current::net::SocketCreateException());  // LCOV_EXCL_LINE
+      }
+      if (::connect(call->fd, reinterpret_cast<const struct sockaddr*>(&call->address), sizeof(call->address)) &&
+          errno != EINPROGRESS) {
+        CURRENT_THROW(current::net::SocketConnectException());
+      }
+      Watch(call->fd, EPOLLIN | EPOLLOUT, EPOLL_CTL_ADD);
+    } catch (...) {
+      Fail(std::move(call), std::current_exception());
+      return;
+    }
+    const int fd = call->fd;
+    active_[fd] = std::move(call);
+  }
+
+  void OnEvent(int fd, uint32_t events) {
+    const auto it = active_.find(fd);
+    if (it == active_.end()) {
+      return;  // LCOV_EXCL_LINE
+    }
+    Call& call = *it->second;
+    try {
+      if (!call.connected) {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) || error) {
+          CURRENT_THROW(current::net::SocketConnectException());
+        }
+        call.connected = true;
+      }
+      if (call.output_offset < call.output.length()) {
+        while (call.output_offset < call.output.length()) {
+          const ssize_t n = ::send(
+              fd, call.output.data() + call.output_offset, call.output.length() - call.output_offset, MSG_NOSIGNAL);
+          if (n >= 0) {
+            call.output_offset += static_cast<size_t>(n);
+          } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+          } else if (errno != EINTR) {
+            // The server may have responded and closed the connection before reading the whole request,
+            // as `HTTPServerPOSIX` does for the payload too large. Read the response, if there is one.
+            call.output_offset = call.output.length();
+          }
+        }
+        if (call.output_offset == call.output.length()) {
+          Watch(fd, EPOLLIN, EPOLL_CTL_MOD);
+        }
+      }
+      if (events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+        char buffer[64 * 1024];
+        while (true) {
+          const ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+          if (n > 0) {
+            if (call.response->Append(buffer, static_cast<size_t>(n))) {
+              Complete(fd);
+              return;
+            }
+          } else if (n == 0) {
+            if (!call.response->OnEndOfStream()) {
+              CURRENT_THROW(current::net::ConnectionResetByPeer());
+            }
+            Complete(fd);
+            return;
+          } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+          } else if (errno != EINTR) {
+            CURRENT_THROW(current::net::SocketReadException());
+          }
+        }
+      }
+    } catch (...) {
+      Fail(Detach(fd), std::current_exception());
+    }
+  }
+
+  std::unique_ptr<Call> Detach(int fd) {
+    const auto it = active_.find(fd);
+    std::unique_ptr<Call> call = std::move(it->second);
+    active_.erase(it);
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    call->fd = -1;
+    return call;
+  }
+
+  void Complete(int fd) {
+    std::unique_ptr<Call> call = Detach(fd);
+    IncrementalHTTPResponse& response = *call->response;
+    // Follow the redirects, same as the blocking client does. `ChunkedGET` does not follow them.
+    if (response.Code() >= 300 && response.Code() <= 399 && !response.Location().empty() && !call->streaming) {
+      try {
+        if (!call->request.allow_redirects_) {
+          CURRENT_THROW(current::net::HTTPRedirectNotAllowedException());
+        }
+        NavigateTo(*call, URL::MakeRedirectedURL(call->url, response.Location()));
+        call->response_url = call->url.ComposeURL();
+      } catch (...) {
+        Fail(std::move(call), std::current_exception());
+        return;
+      }
+      if (!redirects_thread_.joinable()) {
+        redirects_thread_ = std::thread([this]() { RedirectsThread(); });
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        redirects_.push_back(std::move(call));
+      }
+      redirects_cv_.notify_one();
+      return;
+    }
+    HTTPResponseWithBuffer result;
+    result.url = call->response_url;
+    result.code = HTTPResponseCode(response.Code());
+    result.headers = std::move(response.Headers());
+    result.body = std::move(response.Body());
+    if (call->streaming) {
+      try {
+        if (!result.body.empty()) {
+          call->chunk_callback(result.body);
+        }
+        call->done_callback();
+      } catch (...) {
+        Fail(std::move(call), std::current_exception());
+        return;
+      }
+    }
+    --in_flight_;
+    try {
+      call->on_response(std::move(result));
+    } catch (const std::exception& e) {                                            // LCOV_EXCL_LINE
+      std::cerr << "HTTP async client response callback threw: " << e.what() << '\n';  // LCOV_EXCL_LINE
+    }
+  }
+
+  void Fail(std::unique_ptr<Call> call, std::exception_ptr e) {
+    if (call->fd >= 0) {
+      ::close(call->fd);
+    }
+    --in_flight_;
+    try {
+      call->on_error(e);
+    } catch (const std::exception& e) {                                         // LCOV_EXCL_LINE
+      std::cerr << "HTTP async client error callback threw: " << e.what() << '\n';  // LCOV_EXCL_LINE
+    }
+  }
+
+  const HTTPAsyncClientOptions options_;
+  const int epoll_fd_;
+  const int wakeup_fd_;
+  std::atomic_size_t in_flight_{0u};
+
+  std::mutex mutex_;
+  bool stopping_ = false;
+  std::deque<std::unique_ptr<Call>> submitted_;
+  // The redirected requests, for `redirects_thread_` to resolve the host names of.
+  std::deque<std::unique_ptr<Call>> redirects_;
+  std::condition_variable redirects_cv_;
+
+  // Only accessed from the thread of the client.
+  std::deque<std::unique_ptr<Call>> queued_;
+  std::unordered_map<int, std::unique_ptr<Call>> active_;
+
+  std::thread thread_;
+  // Started from the thread of the client on the first redirect, and joined by the destructor after that thread.
+  std::thread redirects_thread_;
+
+  HTTPAsyncClient(const HTTPAsyncClient&) = delete;
+  void operator=(const HTTPAsyncClient&) = delete;
+};
+
+#endif  // CURRENT_HTTP_HAS_ASYNC_CLIENT
+
+}  // namespace http
+}  // namespace current
+
+#endif  // BLOCKS_HTTP_IMPL_ASYNC_CLIENT_H
@@ -0,0 +1,185 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The per-process pool of idle keep-alive connections of the HTTP client, keyed by host and port.
+//
+// `HTTPClientPOSIX` takes a connection from the pool before opening a new one, and, once the response has been
+// read in full and the server has not asked to close the connection, returns it back into the pool.
+// The limits can be changed at runtime via `HTTPClientConnectionPool().SetLimits(...)`.
+
+#ifndef BLOCKS_HTTP_IMPL_CLIENT_CONNECTION_POOL_H
+#define BLOCKS_HTTP_IMPL_CLIENT_CONNECTION_POOL_H
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "../../../Bricks/net/tcp/tcp.h"
+#include "../../../Bricks/time/chrono.h"
+#include "../../../Bricks/util/singleton.h"
+
+namespace current {
+namespace http {
+
+struct HTTPClientConnectionPoolLimits {
+  // The maximum number of idle connections kept per host and port.
+  size_t max_idle_connections_per_host = 8u;
+  // The maximum number of idle connections kept in total.
+  size_t max_idle_connections = 64u;
+  // Idle connections older than this are closed instead of being reused.
+  std::chrono::microseconds max_idle_time = std::chrono::seconds(30);
+
+  HTTPClientConnectionPoolLimits& MaxIdleConnectionsPerHost(size_t value) {
+    max_idle_connections_per_host = value;
+    return *this;
+  }
+  HTTPClientConnectionPoolLimits& MaxIdleConnections(size_t value) {
+    max_idle_connections = value;
+    return *this;
+  }
+  HTTPClientConnectionPoolLimits& MaxIdleTime(std::chrono::microseconds value) {
+    max_idle_time = value;
+    return *this;
+  }
+};
+
+class HTTPClientConnectionPoolImpl final {
+ public:
+  using connection_t = std::unique_ptr<current::net::Connection>;
+
+  void SetLimits(const HTTPClientConnectionPoolLimits& limits) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limits_ = limits;
+    EvictWhileOverLimits(current::time::Now());
+  }
+
+  // Returns an idle connection to `host:port` that still appears open, or `nullptr` if there is none.
+  connection_t Acquire(const std::string& host, int port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = idle_.find(Key(host, port));
+    if (it == idle_.end()) {
+      return nullptr;
+    }
+    const std::chrono::microseconds now = current::time::Now();
+    connection_t result;
+    // Take the most recently used connection, as it is the least likely one to have been closed by the server.
+    while (!result && !it->second.empty()) {
+      IdleConnection idle = std::move(it->second.back());
+      it->second.pop_back();
+      --total_idle_;
+      if (now - idle.since <= limits_.max_idle_time && idle.connection->IsIdleAndOpen()) {
+        result = std::move(idle.connection);
+      }
+    }
+    if (it->second.empty()) {
+      idle_.erase(it);
+    }
+    return result;
+  }
+
+  // Keeps the connection for reuse, unless the limits say otherwise, in which case closes it.
+  void Release(const std::string& host, int port, connection_t connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!limits_.max_idle_connections_per_host || !limits_.max_idle_connections) {
+      return;
+    }
+    const std::chrono::microseconds now = current::time::Now();
+    auto& per_host = idle_[Key(host, port)];
+    per_host.push_back(IdleConnection{std::move(connection), now});
+    ++total_idle_;
+    if (per_host.size() > limits_.max_idle_connections_per_host) {
+      per_host.pop_front();
+      --total_idle_;
+    }
+    EvictWhileOverLimits(now);
+  }
+
+  // Closes all the idle connections.
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.clear();
+    total_idle_ = 0u;
+  }
+
+  size_t IdleConnectionsCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_idle_;
+  }
+
+ private:
+  struct IdleConnection {
+    connection_t connection;
+    std::chrono::microseconds since;
+  };
+
+  static std::string Key(const std::string& host, int port) { return host + ':' + std::to_string(port); }
+
+  // Closes the expired connections, and then the least recently used ones while there are too many of them.
+  void EvictWhileOverLimits(std::chrono::microseconds now) {
+    for (auto it = idle_.begin(); it != idle_.end();) {
+      auto& per_host = it->second;
+      while (!per_host.empty() &&
+             (now - per_host.front().since > limits_.max_idle_time ||
+              per_host.size() > limits_.max_idle_connections_per_host)) {
+        per_host.pop_front();
+        --total_idle_;
+      }
+      if (per_host.empty()) {
+        it = idle_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    while (total_idle_ > limits_.max_idle_connections) {
+      auto oldest = idle_.begin();
+      for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+        if (it->second.front().since < oldest->second.front().since) {
+          oldest = it;
+        }
+      }
+      oldest->second.pop_front();
+      --total_idle_;
+      if (oldest->second.empty()) {
+        idle_.erase(oldest);
+      }
+    }
+  }
+
+  mutable std::mutex mutex_;
+  HTTPClientConnectionPoolLimits limits_;
+  std::map<std::string, std::deque<IdleConnection>> idle_;
+  size_t total_idle_ = 0u;
+};
+
+inline HTTPClientConnectionPoolImpl& HTTPClientConnectionPool() {
+  return current::Singleton<HTTPClientConnectionPoolImpl>();
+}
+
+}  // namespace http
+}  // namespace current
+
+#endif  // BLOCKS_HTTP_IMPL_CLIENT_CONNECTION_POOL_H
@@ -0,0 +1,427 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The `epoll`-based event loop for `HTTPServerPOSIX`.
+//
+// The classic mode of `HTTPServerPOSIX` is one thread per port, which accepts the connection, reads the request
+// and runs the handler. Thus, a single client slowly trickling its request bytes blocks every other client.
+//
+// The event loop accepts connections and reads from them in non-blocking mode. A connection is only handed over
+// to the caller once `IncompleteHTTPRequest` confirms the full request, headers and body, has been received.
+// The handed over `Connection` is switched back to blocking mode, and has the already received bytes attached,
+// so that the regular `HTTPServerConnection` parses the request from memory, without touching the socket.
+// The requests to the routes which stream the body are handed over as soon as their headers have been received,
+// so that the body is read by the handler, from the blocking socket, and is never buffered in full.
+// A connection which has not sent its request, or its headers if the body is streamed, within the timeout
+// since it was accepted is closed, so that clients trickling their bytes can not exhaust the file descriptors.
+
+#ifndef BLOCKS_HTTP_IMPL_EVENT_LOOP_H
+#define BLOCKS_HTTP_IMPL_EVENT_LOOP_H
+
+#include "../../../port.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "../../../Bricks/net/exceptions.h"
+#include "../../../Bricks/net/http/http.h"
+
+#if defined(CURRENT_POSIX) && defined(__linux__)
+#define CURRENT_HTTP_SERVER_HAS_EVENT_LOOP
+#include <fcntl.h>
+#include <sys/epoll.h>
+#endif
+
+namespace current {
+namespace http {
+
+// Incrementally answers the question of whether the bytes received so far make up a complete HTTP request.
+// Mirrors the logic of `GenericHTTPRequestData`: the body is either `Content-Length` bytes, or the chunks
+// up to and including the zero-length one, or nothing if neither is set.
+// Malformed requests are reported as complete, so that the regular parser sends the proper error response.
+class IncompleteHTTPRequest final {
+ public:
+  // Headers larger than this are a sign of a misbehaving client. Such connections are dropped.
+  static constexpr size_t kMaxHeaderSizeInBytes = 1024 * 1024;
+
+  enum class Status { Incomplete, Complete, Invalid };
+
+  void Append(const char* data, size_t length) { data_.append(data, length); }
+
+  Status Check() {
+    if (headers_end_ == kNotFound) {
+      // The parser ignores the CRLF-s before the very first line; so does this logic.
+      while (scan_offset_ + 1 < data_.length() && data_[scan_offset_] == '\r' && data_[scan_offset_ + 1] == '\n') {
+        scan_offset_ += 2;
+      }
+      const size_t search_from = std::max(scan_offset_, headers_scan_offset_ > 3 ? headers_scan_offset_ - 3 : 0u);
+      const size_t p = data_.find("\r\n\r\n", search_from);
+      if (p == std::string::npos) {
+        headers_scan_offset_ = data_.length();
+        return data_.length() > kMaxHeaderSizeInBytes ? Status::Invalid : Status::Incomplete;
+      }
+      headers_end_ = p + 4;
+      ParseHeaders(scan_offset_, p + 2);
+      if (content_length_ > net::constants::kMaxHTTPPayloadSizeInBytes) {
+        return Status::Complete;  // The parser will respond with "413 Request Entity Too Large".
+      }
+      scan_offset_ = headers_end_;
+    }
+    if (chunked_) {
+      while (true) {
+        const size_t crlf = data_.find("\r\n", scan_offset_);
+        if (crlf == std::string::npos) {
+          return Status::Incomplete;
+        }
+        if (crlf == scan_offset_) {
+          scan_offset_ += 2;  // Blank lines between chunks are ignored.
+          continue;
+        }
+        char* end_of_number;
+        const size_t chunk_length = static_cast<size_t>(std::strtoul(&data_[scan_offset_], &end_of_number, 16));
+        if (end_of_number == &data_[scan_offset_] || chunk_length == 0u) {
+          return Status::Complete;  // Either the final chunk, or an invalid one, for which "400" will be returned.
+        }
+        const size_t next_offset = crlf + 2 + chunk_length;
+        if (data_.length() < next_offset) {
+          return Status::Incomplete;
+        }
+        scan_offset_ = next_offset;
+      }
+    } else if (content_length_ != kNotFound) {
+      return data_.length() >= headers_end_ + content_length_ ? Status::Complete : Status::Incomplete;
+    } else {
+      return Status::Complete;
+    }
+  }
+
+  std::string ExtractData() { return std::move(data_); }
+
+  bool HeadersReceived() const { return headers_end_ != kNotFound; }
+
+  // The path of the request, as in the first line of it, "METHOD PATH HTTP/1.1". Empty until the headers are received.
+  const std::string& RawPath() const { return raw_path_; }
+
+ private:
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  static bool HeaderNameEquals(const char* begin, const char* end, const char* name) {
+    const auto normalize = [](char c) { return c != '_' ? static_cast<char>(std::tolower(c)) : '-'; };
+    while (begin < end && *name) {
+      if (normalize(*begin++) != normalize(*name++)) {
+        return false;
+      }
+    }
+    return begin == end && !*name;
+  }
+
+  void ParseHeaders(size_t begin, size_t end) {
+    // Only keep the path from the first line.
+    const size_t first_line_end = data_.find("\r\n", begin);
+    const size_t path_begin = data_.find_first_not_of(" \t", data_.find_first_of(" \t", begin));
+    if (path_begin < first_line_end) {
+      raw_path_ = data_.substr(path_begin, data_.find_first_of(" \t\r", path_begin) - path_begin);
+    }
+    size_t line = first_line_end + 2;
+    while (line < end) {
+      const size_t eol = data_.find("\r\n", line);
+      const size_t colon = data_.find(net::constants::kHeaderKeyValueSeparator, line);
+      if (colon < eol) {
+        const char* key_begin = &data_[line];
+        const char* key_end = &data_[colon];
+        const char* value = &data_[colon + 1];
+        const char* value_end = &data_[eol];
+        while (value < value_end && (*value == ' ' || *value == '\t')) {
+          ++value;
+        }
+        while (value_end > value && (*(value_end - 1) == ' ' || *(value_end - 1) == '\t')) {
+          --value_end;
+        }
+        if (HeaderNameEquals(key_begin, key_end, net::constants::kContentLengthHeaderKey)) {
+          content_length_ = static_cast<size_t>(std::atoi(value));
+        } else if (HeaderNameEquals(key_begin, key_end, net::constants::kTransferEncodingHeaderKey)) {
+          chunked_ = HeaderNameEquals(value, value_end, net::constants::kTransferEncodingChunkedValue);
+        }
+      }
+      line = eol + 2;
+    }
+  }
+
+  std::string data_;
+  std::string raw_path_;
+  size_t scan_offset_ = 0u;
+  size_t headers_scan_offset_ = 0u;
+  size_t headers_end_ = kNotFound;
+  size_t content_length_ = kNotFound;
+  bool chunked_ = false;
+};
+
+#ifdef CURRENT_HTTP_SERVER_HAS_EVENT_LOOP
+
+// Runs the accept-and-read loop over the listening socket until `terminating` is set and a connection arrives.
+// Calls `on_request` with each connection that has received its HTTP request in full, from the same thread.
+// If `streams_body` returns `true` for the raw path of the request, the connection is handed over
+// as soon as the headers have been received.
+// The connections which have not been handed over within `incomplete_request_timeout` are closed.
+class HTTPServerEventLoop final {
+ public:
+  HTTPServerEventLoop(current::net::Socket& socket,
+                      const std::atomic_bool& terminating,
+                      std::chrono::milliseconds incomplete_request_timeout,
+                      std::function<void(current::net::Connection&&)> on_request,
+                      std::function<bool(const std::string&)> streams_body = nullptr)
+      : listening_socket_(socket),
+        terminating_(terminating),
+        incomplete_request_timeout_(incomplete_request_timeout),
+        on_request_(on_request),
+        streams_body_(streams_body),
+        epoll_fd_(::epoll_create1(0)),
+        spare_fd_(OpenSpareFD()) {
+    if (epoll_fd_ < 0) {
+      CURRENT_THROW(current::net::SocketCreateException());  // LCOV_EXCL_LINE
+    }
+  }
+
+  ~HTTPServerEventLoop() {
+    for (const auto& fd_and_request : incomplete_requests_) {
+      ::close(fd_and_request.first);
+    }
+    if (spare_fd_ >= 0) {
+      ::close(spare_fd_);
+    }
+    ::close(epoll_fd_);
+  }
+
+  void Run() {
+    const SOCKET listening_fd = listening_socket_.socket;
+    SetNonBlocking(listening_fd, true);
+    AddToEpoll(listening_fd);
+
+    constexpr int kMaxEvents = 256;
+    struct epoll_event events[kMaxEvents];
+    while (!terminating_) {
+      const int n = ::epoll_wait(epoll_fd_, events, kMaxEvents, MillisecondsUntilNextDeadline());
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;  // LCOV_EXCL_LINE
+        }
+        CURRENT_THROW(current::net::SocketException());  // LCOV_EXCL_LINE
+      }
+      for (int i = 0; i < n && !terminating_; ++i) {
+        if (events[i].data.fd == listening_fd) {
+          AcceptAll(listening_fd);
+        } else {
+          ReadFrom(events[i].data.fd);
+        }
+      }
+      CloseExpired();
+    }
+  }
+
+ private:
+  using clock_t = std::chrono::steady_clock;
+
+  struct IncompleteRequestAndAddress {
+    IncompleteHTTPRequest request;
+    sockaddr_in addr_client;
+    clock_t::time_point deadline;
+    bool streams_body_checked = false;
+  };
+
+  static void SetNonBlocking(int fd, bool non_blocking) {
+    const int flags = ::fcntl(fd, F_GETFL, 0);
+    ::fcntl(fd, F_SETFL, non_blocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK));
+  }
+
+  void AddToEpoll(int fd) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event)) {
+      CURRENT_THROW(current::net::SocketException());  // LCOV_EXCL_LINE
+    }
+  }
+
+  void Forget(int fd) {
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    incomplete_requests_.erase(fd);
+  }
+
+  static int OpenSpareFD() { return ::open("/dev/null", O_RDONLY | O_CLOEXEC); }
+
+  // The timeout for `epoll_wait()`: until the earliest deadline, or infinite if there are no connections to expire.
+  int MillisecondsUntilNextDeadline() const {
+    if (deadlines_.empty()) {
+      return -1;
+    }
+    const clock_t::time_point now = clock_t::now();
+    if (deadlines_.front().first <= now) {
+      return 0;
+    }
+    // Round up, so that the loop does not wake up just before the deadline and spin until it passes.
+    return static_cast<int>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(deadlines_.front().first - now).count() + 1);
+  }
+
+  // All the connections get the same timeout, so the deadlines are queued in the order of accepting.
+  // The queue may hold the deadlines of the connections that have already been handed over or closed,
+  // or whose descriptors have since been reused; the deadline kept with the connection itself is what counts.
+  void CloseExpired() {
+    const clock_t::time_point now = clock_t::now();
+    while (!deadlines_.empty() && deadlines_.front().first <= now) {
+      const int fd = deadlines_.front().second;
+      deadlines_.pop_front();
+      const auto it = incomplete_requests_.find(fd);
+      if (it != incomplete_requests_.end() && it->second.deadline <= now) {
+        Forget(fd);
+        ::close(fd);
+      }
+    }
+  }
+
+  void AcceptAll(SOCKET listening_fd) {
+    while (!terminating_) {
+      sockaddr_in addr_client;
+      socklen_t addr_client_length = sizeof(sockaddr_in);
+      const int fd = ::accept(listening_fd, reinterpret_cast<struct sockaddr*>(&addr_client), &addr_client_length);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) {
+          continue;  // LCOV_EXCL_LINE
+        }
+        if ((errno == EMFILE || errno == ENFILE) && spare_fd_ >= 0) {
+          // Out of file descriptors. The listening socket is level-triggered, so leaving the pending connection
+          // in the queue would spin `epoll_wait()`. Release the spare descriptor to accept and drop it.
+          // LCOV_EXCL_START
+          ::close(spare_fd_);
+          const int dropped_fd = ::accept(listening_fd, nullptr, nullptr);
+          if (dropped_fd >= 0) {
+            ::close(dropped_fd);
+          }
+          spare_fd_ = OpenSpareFD();
+          if (dropped_fd >= 0) {
+            continue;
+          }
+          // LCOV_EXCL_STOP
+        }
+        return;  // `EAGAIN` once all pending connections are accepted.
+      }
+      if (terminating_) {
+        ::close(fd);
+        return;
+      }
+      SetNonBlocking(fd, true);
+      AddToEpoll(fd);
+      IncompleteRequestAndAddress& state = incomplete_requests_[fd];
+      state.addr_client = addr_client;
+      state.deadline = clock_t::now() + incomplete_request_timeout_;
+      deadlines_.emplace_back(state.deadline, fd);
+    }
+  }
+
+  void ReadFrom(int fd) {
+    auto it = incomplete_requests_.find(fd);
+    if (it == incomplete_requests_.end()) {
+      return;  // LCOV_EXCL_LINE
+    }
+    IncompleteRequestAndAddress& state = it->second;
+    char buffer[16 * 1024];
+    while (true) {
+      const ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+      if (n > 0) {
+        state.request.Append(buffer, static_cast<size_t>(n));
+        const IncompleteHTTPRequest::Status status = state.request.Check();
+        if (status == IncompleteHTTPRequest::Status::Complete) {
+          HandOver(fd, state);
+          return;
+        } else if (status == IncompleteHTTPRequest::Status::Invalid) {
+          Forget(fd);
+          ::close(fd);
+          return;
+        } else if (streams_body_ && !state.streams_body_checked && state.request.HeadersReceived()) {
+          state.streams_body_checked = true;
+          if (streams_body_(state.request.RawPath())) {
+            HandOver(fd, state);
+            return;
+          }
+        }
+      } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;
+      } else if (n < 0 && errno == EINTR) {
+        continue;  // LCOV_EXCL_LINE
+      } else {
+        // The peer has closed the connection, or an error has occurred, before the request was received in full.
+        Forget(fd);
+        ::close(fd);
+        return;
+      }
+    }
+  }
+
+  void HandOver(int fd, IncompleteRequestAndAddress& state) {
+    std::string data = state.request.ExtractData();
+    const sockaddr_in addr_client = state.addr_client;
+    Forget(fd);
+    SetNonBlocking(fd, false);
+    try {
+      current::net::Connection connection(current::net::Socket::AcceptedConnection(fd, addr_client));
+      connection.SetReceivedAhead(std::move(data));
+      on_request_(std::move(connection));
+    } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
+      std::cerr << "HTTP event loop failed to hand over the connection: " << e.what() << '\n';  // LCOV_EXCL_LINE
+    }
+  }
+
+  current::net::Socket& listening_socket_;
+  const std::atomic_bool& terminating_;
+  const std::chrono::milliseconds incomplete_request_timeout_;
+  std::function<void(current::net::Connection&&)> on_request_;
+  std::function<bool(const std::string&)> streams_body_;
+  const int epoll_fd_;
+  // Kept open to be released when `accept()` fails with `EMFILE`, so that the pending connection can be dropped.
+  int spare_fd_;
+  std::unordered_map<int, IncompleteRequestAndAddress> incomplete_requests_;
+  std::deque<std::pair<clock_t::time_point, int>> deadlines_;
+
+  HTTPServerEventLoop() = delete;
+  HTTPServerEventLoop(const HTTPServerEventLoop&) = delete;
+  void operator=(const HTTPServerEventLoop&) = delete;
+};
+
+#endif  // CURRENT_HTTP_SERVER_HAS_EVENT_LOOP
+
+}  // namespace http
+}  // namespace current
+
+#endif  // BLOCKS_HTTP_IMPL_EVENT_LOOP_H
@@ -30,6 +30,9 @@ SOFTWARE.
 
 #include "../types.h"
 
+#include "client_connection_pool.h"
+
+#include <chrono>
 #include <memory>
 #include <string>
 #include <set>
@@ -44,6 +47,9 @@ namespace http {
 
 namespace impl {
 struct HTTPRedirectHelper : current::net::HTTPDefaultHelper {
+  // The `Location` header is needed as soon as the response is received.
+  constexpr static bool kDefersHeaders = false;
+
   struct ConstructionParams {};
   HTTPRedirectHelper() = delete;
   HTTPRedirectHelper(const ConstructionParams&) {}
@@ -84,47 +90,32 @@ class GenericHTTPClientPOSIX final {
         CURRENT_THROW(current::net::HTTPRedirectLoopException(loop));
       }
       all_urls.insert(composed_url);
-      current::net::Connection connection(
-          current::net::Connection(current::net::ClientSocket(parsed_url.host, parsed_url.port)));
-      connection.BlockingWrite(
-          request_method_ + ' ' + parsed_url.path + parsed_url.ComposeParameters() + " HTTP/1.1\r\n", true);
-      connection.BlockingWrite("Host: " + parsed_url.host + "\r\n", true);
-      if (!request_user_agent_.empty()) {
-        connection.BlockingWrite("User-Agent: " + request_user_agent_ + "\r\n", true);
-      }
-      for (const auto& h : request_headers_) {
-        connection.BlockingWrite(h.header + ": " + h.value + "\r\n", true);
-      }
-      if (!request_headers_.cookies.empty()) {
-        connection.BlockingWrite("Cookie: " + request_headers_.CookiesAsString() + "\r\n", true);
-      }
-      if (!request_body_content_type_.empty()) {
-        connection.BlockingWrite("Content-Type: " + request_body_content_type_ + "\r\n", true);
-      }
-      if (!request_body_contents_.empty()) {
-        // NOTE(dkorolev): The `try/catch/throw` combo here is a hack for the unit test for HTTP 413 to pass.
-        // It swallows the `SocketWriteException` exception for huge payloads, as Current's HTTP server logic
-        // does intentionally close the HTTP connection prematurely if `Content-Length` exceeds a reasonable limit.
+      // Prefer an idle keep-alive connection for the requests which are safe to repeat. If the server has closed it
+      // just as the request was being sent, not a single byte of the response arrives, and the request is repeated
+      // over a new connection. So it is if the reused connection stays silent for longer than the timeout, as
+      // the peer may be gone without closing it. The other requests always go over a new connection,
+      // as they can not be repeated.
+      std::unique_ptr<current::net::Connection> connection =
+          (keep_alive_ && RequestCanBeRepeated()) ? HTTPClientConnectionPool().Acquire(parsed_url.host, parsed_url.port)
+                                                  : nullptr;
+      bool request_sent = false;
+      if (connection) {
         try {
-#ifndef CURRENT_WINDOWS
-          connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n", true);
-          connection.BlockingWrite("\r\n", true);
-          connection.BlockingWrite(request_body_contents_, false);
-#else
-          // TODO(grixa): this fix for the PayloadTooLarge test on Windows is temporary, need to revisit it.
-          connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n\r\n" +
-                                       request_body_contents_,
-                                   false);
-#endif
-        } catch (const net::SocketWriteException&) {
-          if (request_body_contents_.length() <= net::constants::kMaxHTTPPayloadSizeInBytes) {
-            throw;
-          }
+          SendRequest(*connection, parsed_url);
+          request_sent = connection->BlockingWaitForData(
+              std::chrono::milliseconds(current::net::constants::kKeepAliveResponseTimeoutInMilliseconds));
+        } catch (const current::net::SocketException&) {
         }
-      } else {
-        connection.BlockingWrite("\r\n", false);
       }
-      http_request_.reset(new CustomHTTPRequestData(connection, request_data_construction_params_));
+      if (!request_sent) {
+        connection = std::make_unique<current::net::Connection>(
+            current::net::ClientSocket(parsed_url.host, parsed_url.port));
+        SendRequest(*connection, parsed_url);
+      }
+      http_request_.reset(new CustomHTTPRequestData(*connection, request_data_construction_params_));
+      if (keep_alive_ && request_method_ != "HEAD" && http_request_->KeepAlive()) {
+        HTTPClientConnectionPool().Release(parsed_url.host, parsed_url.port, std::move(connection));
+      }
       // TODO(dkorolev): Rename `Path()`, it's only called so now because of HTTP request/response format.
       // Elaboration:
       // HTTP request  message is: `GET /path HTTP/1.1`, "/path" is the second component of it.
@@ -149,7 +140,63 @@ class GenericHTTPClientPOSIX final {
 
   const CustomHTTPRequestData& HTTPRequest() const { return *http_request_.get(); }
 
+ private:
+  // The requests which can be repeated without changing the state of the server twice, or their own result.
+  // `DELETE` is idempotent per RFC 7231, but, once repeated, it may well result in a 404.
+  bool RequestCanBeRepeated() const {
+    return request_method_ == "GET" || request_method_ == "HEAD" || request_method_ == "PUT";
+  }
+
+  void SendRequest(current::net::Connection& connection, const URL& parsed_url) {
+    const std::string head = ComposeRequestHead(parsed_url);
+    if (!request_body_contents_.empty()) {
+      // NOTE(dkorolev): The `try/catch/throw` combo here is a hack for the unit test for HTTP 413 to pass.
+      // It swallows the `SocketWriteException` exception for huge payloads, as Current's HTTP server logic
+      // does intentionally close the HTTP connection prematurely if `Content-Length` exceeds a reasonable limit.
+      try {
+#ifndef CURRENT_WINDOWS
+        connection.BlockingWrite(head, true);
+        connection.BlockingWrite(request_body_contents_, false);
+#else
+        // TODO(grixa): this fix for the PayloadTooLarge test on Windows is temporary, need to revisit it.
+        connection.BlockingWrite(head + request_body_contents_, false);
+#endif
+      } catch (const net::SocketWriteException&) {
+        if (request_body_contents_.length() <= net::constants::kMaxHTTPPayloadSizeInBytes) {
+          throw;
+        }
+      }
+    } else {
+      connection.BlockingWrite(head, false);
+    }
+  }
+
  public:
+  // The request line and the headers, up to and including the empty line, for the request body to follow.
+  // Also used by `HTTPAsyncClient`, which writes the request into a non-blocking socket by itself.
+  std::string ComposeRequestHead(const URL& parsed_url) const {
+    std::string head =
+        request_method_ + ' ' + parsed_url.path + parsed_url.ComposeParameters() + " HTTP/1.1\r\n";
+    head += "Host: " + parsed_url.host + "\r\n";
+    if (!request_user_agent_.empty()) {
+      head += "User-Agent: " + request_user_agent_ + "\r\n";
+    }
+    for (const auto& h : request_headers_) {
+      head += h.header + ": " + h.value + "\r\n";
+    }
+    if (!request_headers_.cookies.empty()) {
+      head += "Cookie: " + request_headers_.CookiesAsString() + "\r\n";
+    }
+    if (!request_body_content_type_.empty()) {
+      head += "Content-Type: " + request_body_content_type_ + "\r\n";
+    }
+    if (!request_body_contents_.empty()) {
+      head += "Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n";
+    }
+    head += "\r\n";
+    return head;
+  }
+
   // Request parameters.
   std::string request_method_ = "";
   std::string request_url_ = "";
@@ -159,6 +206,7 @@ class GenericHTTPClientPOSIX final {
   current::net::http::Headers request_headers_;
   const typename HTTP_HELPER::ConstructionParams request_data_construction_params_;
   bool allow_redirects_ = false;
+  bool keep_alive_ = true;
 
   // Output parameters.
   current::net::HTTPResponseCodeValue response_code_ = HTTPResponseCode.InvalidCode;
@@ -178,6 +226,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const HEAD& request, HTTPClientPOSIX& client) {
@@ -186,6 +235,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const POST& request, HTTPClientPOSIX& client) {
@@ -196,6 +246,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const POSTFromFile& request, HTTPClientPOSIX& client) {
@@ -207,6 +258,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
         current::FileSystem::ReadFileAsString(request.file_name);  // Can throw FileException.
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const PUT& request, HTTPClientPOSIX& client) {
@@ -217,6 +269,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const PATCH& request, HTTPClientPOSIX& client) {
@@ -227,6 +280,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const DELETE& request, HTTPClientPOSIX& client) {
@@ -235,6 +289,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;  // LCOV_EXCL_LINE  -- tested in GET above.
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const KeepResponseInMemory&, HTTPClientPOSIX&) {}
@@ -29,12 +29,22 @@ SOFTWARE.
 #define BLOCKS_HTTP_IMPL_POSIX_SERVER_H
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <string>
 #include <map>
 #include <memory>
 #include <thread>
 #include <iostream>  // TODO(dkorolev): More robust logging here.
 
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "admission.h"
+#include "event_loop.h"
+#include "route_table.h"
+
 #include "../types.h"
 #include "../request.h"
 
@@ -45,6 +55,7 @@ SOFTWARE.
 #include "../../../Bricks/time/chrono.h"
 #include "../../../Bricks/strings/printf.h"
 #include "../../../Bricks/util/accumulative_scoped_deleter.h"
+#include "../../../Bricks/util/make_scope_guard.h"
 
 namespace current {
 namespace http {
@@ -87,6 +98,15 @@ struct ServeStaticFilesFromCannotServeMoreThanOneIndexFile : ServeStaticFilesExc
   using ServeStaticFilesException::ServeStaticFilesException;
 };
 
+// Where `ServeStaticFilesFrom()` keeps the contents of the files it serves.
+enum class StaticFilesServedFrom : bool {
+  // Read each file into memory once, when the routes are registered.
+  Memory = false,
+  // Keep only the names of the files, and `sendfile()` them from disk on every request, supporting conditional
+  // and range requests. Meant for large directories, as the files are never kept in memory.
+  Disk = true
+};
+
 struct ServeStaticFilesFromOptions {
   // HTTP server route prefix.
   std::string route_prefix;
@@ -97,30 +117,44 @@ struct ServeStaticFilesFromOptions {
   // Names of files to serve if a directory URL is requested, in the priority order (first found will be served).
   std::vector<std::string> index_filenames;
 
+  // Whether to serve the files from memory or from disk.
+  StaticFilesServedFrom served_from;
+
   explicit ServeStaticFilesFromOptions(std::string route_prefix_in = "/",
                                        std::string public_url_prefix_in = "",
-                                       std::vector<std::string> index_filenames_in = {"index.html", "index.htm"})
+                                       std::vector<std::string> index_filenames_in = {"index.html", "index.htm"},
+                                       StaticFilesServedFrom served_from_in = StaticFilesServedFrom::Memory)
       : route_prefix(std::move(route_prefix_in)),
         public_url_prefix(public_url_prefix_in.empty() ? route_prefix : std::move(public_url_prefix_in)),
-        index_filenames(std::move(index_filenames_in)) {}
+        index_filenames(std::move(index_filenames_in)),
+        served_from(served_from_in) {}
+
+  ServeStaticFilesFromOptions& ServedFrom(StaticFilesServedFrom served_from_in) {
+    served_from = served_from_in;
+    return *this;
+  }
 };
 
 // Helper to serve a static file.
+// Serves `content` if `pathname` is empty, and the file `pathname` from disk otherwise.
 // TODO(dkorolev): Expose it externally under a better name, and add a comment/example.
 struct StaticFileServer {
   std::string content;
   std::string content_type;
   bool serves_directory;
   std::string trailing_slash_redirect_url;
+  std::string pathname;
 
   StaticFileServer(std::string content,
                    std::string content_type,
                    bool serves_directory,
-                   std::string trailing_slash_redirect_url = "")
+                   std::string trailing_slash_redirect_url = "",
+                   std::string pathname = "")
       : content(std::move(content)),
         content_type(content_type),
         serves_directory(serves_directory),
-        trailing_slash_redirect_url(trailing_slash_redirect_url) {}
+        trailing_slash_redirect_url(trailing_slash_redirect_url),
+        pathname(std::move(pathname)) {}
 
   void operator()(Request r) {
     if (r.method == "GET") {
@@ -129,7 +163,11 @@ struct StaticFileServer {
         // (`static` is a directory, not a file).
         // 2) Respond with the content if we're serving a file and don't have a trailing slash. Example:
         // `/static/index.html`, `/static/file.png`.
-        r.connection.SendHTTPResponse(content, HTTPResponseCode.OK, content_type);
+        if (pathname.empty()) {
+          r.connection.SendHTTPResponse(content, HTTPResponseCode.OK, content_type);
+        } else {
+          ServeFromDisk(r);
+        }
       } else if (!serves_directory && r.url_path_had_trailing_slash) {
         // Respond with HTTP 404 Not Found if we're serving a file and have a trailing slash. Example:
         // `/static/index.html/`.
@@ -152,39 +190,284 @@ struct StaticFileServer {
                                     current::net::constants::kDefaultHTMLContentType);
     }
   }
+
+  // The outcome of parsing the `Range` header against the file of a given size.
+  enum class ByteRange { Whole, Partial, Unsatisfiable };
+
+  // Parses a single `bytes=first-last`, `bytes=first-`, or `bytes=-suffix_length` range, per RFC 7233.
+  // On `Partial`, sets `[begin, end)`. Multiple ranges and malformed headers are ignored, serving the whole file.
+  static ByteRange ParseByteRange(const std::string& header, uint64_t size, uint64_t& begin, uint64_t& end) {
+    const std::string prefix = "bytes=";
+    if (header.compare(0u, prefix.length(), prefix) || header.find(',') != std::string::npos) {
+      return ByteRange::Whole;
+    }
+    const size_t dash = header.find('-', prefix.length());
+    if (dash == std::string::npos) {
+      return ByteRange::Whole;
+    }
+    uint64_t first;
+    uint64_t last;
+    const bool has_first = ParseUInt64(header, prefix.length(), dash, first);
+    const bool has_last = ParseUInt64(header, dash + 1u, header.length(), last);
+    if (has_first) {
+      if (dash + 1u != header.length() && (!has_last || last < first)) {
+        return ByteRange::Whole;
+      } else if (first >= size) {
+        return ByteRange::Unsatisfiable;
+      }
+      begin = first;
+      end = (dash + 1u == header.length()) ? size : std::min(last + 1u, size);
+    } else {
+      if (dash != prefix.length() || !has_last) {
+        return ByteRange::Whole;
+      } else if (!last || !size) {
+        return ByteRange::Unsatisfiable;
+      }
+      begin = size - std::min(last, size);
+      end = size;
+    }
+    return ByteRange::Partial;
+  }
+
+ private:
+  static bool ParseUInt64(const std::string& s, size_t begin, size_t end, uint64_t& output) {
+    // Up to 18 digits, to not worry about overflows.
+    if (begin == end || end - begin > 18u) {
+      return false;
+    }
+    output = 0u;
+    for (size_t i = begin; i < end; ++i) {
+      if (s[i] < '0' || s[i] > '9') {
+        return false;
+      }
+      output = output * 10u + static_cast<uint64_t>(s[i] - '0');
+    }
+    return true;
+  }
+
+  // Whether the value of `If-None-Match` lists `etag`, using the weak comparison, as RFC 7232 requires.
+  static bool ETagListMatches(const std::string& list, const std::string& etag) {
+    size_t i = 0u;
+    while (i < list.length()) {
+      size_t next = list.find(',', i);
+      if (next == std::string::npos) {
+        next = list.length();
+      }
+      size_t begin = i;
+      size_t end = next;
+      while (begin < end && list[begin] == ' ') {
+        ++begin;
+      }
+      while (end > begin && list[end - 1u] == ' ') {
+        --end;
+      }
+      if (end - begin >= 2u && list[begin] == 'W' && list[begin + 1u] == '/') {
+        begin += 2u;
+      }
+      const std::string candidate = list.substr(begin, end - begin);
+      if (candidate == "*" || candidate == etag) {
+        return true;
+      }
+      i = next + 1u;
+    }
+    return false;
+  }
+
+  void ServeFromDisk(Request& r) const {
+#ifndef CURRENT_WINDOWS
+    const int fd = ::open(pathname.c_str(), O_RDONLY);
+#else
+    const int fd = ::_open(pathname.c_str(), _O_RDONLY | _O_BINARY);
+#endif
+    if (fd < 0) {
+      // The file has been removed since the routes were registered.
+      r.connection.SendHTTPResponse(current::net::DefaultNotFoundMessage(),
+                                    HTTPResponseCode.NotFound,
+                                    current::net::constants::kDefaultHTMLContentType);
+      return;
+    }
+    const auto file_closer = current::MakeScopeGuard([fd]() {
+#ifndef CURRENT_WINDOWS
+      ::close(fd);
+#else
+      ::_close(fd);
+#endif
+    });
+
+    struct stat info;
+    if (::fstat(fd, &info)) {
+      CURRENT_THROW(current::FileException(pathname));  // LCOV_EXCL_LINE
+    }
+    const uint64_t size = static_cast<uint64_t>(info.st_size);
+    const int64_t mtime_seconds = static_cast<int64_t>(info.st_mtime);
+    const std::string etag = current::strings::Printf("\"%llx-%llx\"",
+                                                      static_cast<unsigned long long>(size),
+                                                      static_cast<unsigned long long>(mtime_seconds));
+    const std::string last_modified = FormatDateTimeAsIMFFix(std::chrono::microseconds(mtime_seconds * 1000000));
+    current::net::http::Headers headers({{"ETag", etag}, {"Last-Modified", last_modified}, {"Accept-Ranges", "bytes"}});
+
+    // Per RFC 7232, `If-Modified-Since` is only looked at if there is no `If-None-Match`.
+    const current::net::http::Headers& request_headers = r.headers;
+    bool not_modified = false;
+    if (request_headers.Has("If-None-Match")) {
+      not_modified = ETagListMatches(request_headers.Get("If-None-Match"), etag);
+    } else if (request_headers.Has("If-Modified-Since")) {
+      const std::chrono::microseconds since = IMFFixDateTimeStringToTimestamp(request_headers.Get("If-Modified-Since"));
+      not_modified = since.count() > 0 && mtime_seconds * 1000000 <= since.count();
+    }
+    if (not_modified) {
+      r.connection.SendHTTPResponse("", HTTPResponseCode.NotModified, content_type, headers);
+      return;
+    }
+
+    // `If-Range` makes the `Range` apply only if the file has not changed; otherwise the whole file is sent.
+    uint64_t begin = 0u;
+    uint64_t end = size;
+    if (request_headers.Has("Range") &&
+        (!request_headers.Has("If-Range") || request_headers.Get("If-Range") == etag ||
+         request_headers.Get("If-Range") == last_modified)) {
+      const ByteRange range = ParseByteRange(request_headers.Get("Range"), size, begin, end);
+      if (range == ByteRange::Unsatisfiable) {
+        headers.Set("Content-Range", current::strings::Printf("bytes */%llu", static_cast<unsigned long long>(size)));
+        r.connection.SendHTTPResponse("", HTTPResponseCode.RequestedRangeNotSatisfiable, content_type, headers);
+        return;
+      } else if (range == ByteRange::Partial) {
+        headers.Set("Content-Range",
+                    current::strings::Printf("bytes %llu-%llu/%llu",
+                                             static_cast<unsigned long long>(begin),
+                                             static_cast<unsigned long long>(end - 1u),
+                                             static_cast<unsigned long long>(size)));
+        r.connection.SendHTTPResponseFromFile(
+            fd, begin, end - begin, HTTPResponseCode.PartialContent, content_type, headers);
+        return;
+      }
+    }
+    r.connection.SendHTTPResponseFromFile(fd, 0u, size, HTTPResponseCode.OK, content_type, headers);
+  }
+};
+
+// The threading model of `HTTPServerPOSIX`. Passed in as `HTTP(port, HTTPServerOptions().WorkerThreads(8))`.
+// Only takes effect on the first access to the port, as that is when the server is created.
+struct HTTPServerOptions {
+  // The number of threads to run the handlers in.
+  // Zero is the classic mode: one thread per port accepts the connection, reads the request, and runs the handler.
+  // With a non-zero value, on Linux, connections are accepted and read in non-blocking mode by an `epoll`-based
+  // event loop, and the requests that have been received in full are dispatched to the pool of handler threads.
+  // Elsewhere, the accept thread reads the requests, and only the handlers run in the pool.
+  size_t worker_threads = 0u;
+  // The number of sockets listening on the port, each with its own thread accepting and reading the requests,
+  // which also runs the handlers unless there are `worker_threads`. On Linux, via `SO_REUSEPORT`, so that
+  // the kernel spreads the incoming connections across them. Elsewhere, there is always one listening socket.
+  // All the listeners share the routes, the handlers, and the admission limits.
+  size_t listeners = 1u;
+  // The server-wide admission limits, which can also be changed later via `SetAdmissionLimits()`.
+  HTTPAdmissionLimits admission;
+  // With the event loop, the time for a client to send its request, or its headers if the body is streamed,
+  // counting from when the connection is accepted. The connections which take longer are closed.
+  std::chrono::milliseconds incomplete_request_timeout = std::chrono::seconds(30);
+
+  HTTPServerOptions& WorkerThreads(size_t worker_threads_in) {
+    worker_threads = worker_threads_in;
+    return *this;
+  }
+  HTTPServerOptions& Listeners(size_t listeners_in) {
+    listeners = listeners_in;
+    return *this;
+  }
+  HTTPServerOptions& Admission(const HTTPAdmissionLimits& admission_in) {
+    admission = admission_in;
+    return *this;
+  }
+  HTTPServerOptions& IncompleteRequestTimeout(std::chrono::milliseconds incomplete_request_timeout_in) {
+    incomplete_request_timeout = incomplete_request_timeout_in;
+    return *this;
+  }
 };
 
 // HTTP server bound to a specific port.
 class HTTPServerPOSIX final {
  public:
+  using options_t = HTTPServerOptions;
+
   // The constructor starts listening on the specified port.
   // Since instances of `HTTPServerPOSIX` are created via a singleton,
   // a listening thread will only be created once per port, on the first access to that port.
-  explicit HTTPServerPOSIX(int port)
-      : terminating_(false), port_(port), thread_(&HTTPServerPOSIX::Thread, this, current::net::Socket(port)) {}
+  explicit HTTPServerPOSIX(int port, const HTTPServerOptions& options = HTTPServerOptions())
+      : terminating_(false),
+        port_(port),
+        options_(options),
+        listeners_running_(ListenersCount(options)),
+        server_admission_(options.admission) {
+    // Bind to the port in the constructor, so that `SocketBindException` is thrown from here.
+    const size_t listeners = ListenersCount(options_);
+    std::vector<current::net::Socket> sockets;
+    sockets.reserve(listeners);
+    for (size_t i = 0; i < listeners; ++i) {
+      sockets.emplace_back(port,
+                           current::net::kMaxServerQueuedConnections,
+                           current::net::kDisableNagleAlgorithmByDefault,
+                           listeners > 1u);
+    }
+    for (size_t i = 0; i < options_.worker_threads; ++i) {
+      workers_.emplace_back(&HTTPServerPOSIX::WorkerThread, this);
+    }
+    for (auto& socket : sockets) {
+      if (!options_.worker_threads) {
+        threads_.emplace_back(&HTTPServerPOSIX::Thread, this, std::move(socket));
+      } else {
+#ifdef CURRENT_HTTP_SERVER_HAS_EVENT_LOOP
+        threads_.emplace_back(&HTTPServerPOSIX::EventLoopThread, this, std::move(socket));
+#else
+        threads_.emplace_back(&HTTPServerPOSIX::Thread, this, std::move(socket));
+#endif
+      }
+    }
+  }
 
   // The destructor closes the socket.
   // Note that the destructor will only be run on the shutdown of the binary,
   // unregistering all handlers will still keep the listening thread up, and it will serve 404-s.
   ~HTTPServerPOSIX() {
     terminating_ = true;
-    // Notify the server thread that it should terminate.
+    // Notify the server threads that they should terminate.
     // Effectively, call `HTTP(GET("/healthz"))`, but in a way that avoids client <=> server dependency.
-    // LCOV_EXCL_START
-    try {
-      // TODO(dkorolev): This should always use the POSIX implemenation of the client, nothing fancier.
-      // It is a safe call, since the server itself is POSIX, so the architecture we are on is POSIX-friendly.
-      current::net::Connection(current::net::ClientSocket("localhost", port_))
-          .BlockingWrite("GET /healthz HTTP/1.1\r\n\r\n", true);
-    } catch (const current::Exception&) {
-      // It is guaranteed that after `terminated_` is set the server will be terminated on the next request,
-      // but it might so happen that that terminating request will happen between `terminating_ = true`
-      // and the consecutive request. Which is perfectly fine, since it implies that the server has terminated.
+    // With several listeners, which one gets the connection is up to the kernel. A listener closes its socket
+    // as it terminates, so that the connections are only spread across the remaining ones, and it takes
+    // a few more attempts for each listener to get one.
+    while (listeners_running_) {
+      // LCOV_EXCL_START
+      try {
+        // TODO(dkorolev): This should always use the POSIX implemenation of the client, nothing fancier.
+        // It is a safe call, since the server itself is POSIX, so the architecture we are on is POSIX-friendly.
+        current::net::Connection(current::net::ClientSocket("localhost", port_))
+            .BlockingWrite("GET /healthz HTTP/1.1\r\n\r\n", true);
+      } catch (const current::Exception&) {
+        // It is guaranteed that after `terminated_` is set the server will be terminated on the next request,
+        // but it might so happen that that terminating request will happen between `terminating_ = true`
+        // and the consecutive request. Which is perfectly fine, since it implies that the server has terminated.
+        break;
+      }
+      // LCOV_EXCL_STOP
+      if (threads_.size() > 1u) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      } else {
+        break;
+      }
     }
-    // LCOV_EXCL_STOP
-    // Wait for the thread to terminate.
-    if (thread_.joinable()) {
-      thread_.join();
+    // Wait for the threads to terminate.
+    for (auto& thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+    // Then stop the handler threads, if any. The requests still in the queue are dropped.
+    {
+      std::lock_guard<std::mutex> lock(ready_requests_mutex_);
+      ready_requests_.clear();
+    }
+    ready_requests_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
     }
   }
 
@@ -192,7 +475,9 @@ class HTTPServerPOSIX final {
   // instead of `while(true)`
   // LCOV_EXCL_START
   void Join() {
-    thread_.join();  // May throw.
+    for (auto& thread : threads_) {
+      thread.join();  // May throw.
+    }
   }
   // LCOV_EXCL_STOP
 
@@ -239,9 +524,26 @@ class HTTPServerPOSIX final {
     return DoRegisterHandler(path, handler, URLPathArgs::CountMask::None, POLICY);
   }
 
+  // With `RequestBody::Streamed`, the handler is called as soon as the headers have been received,
+  // and reads the body itself, via `Request::ReadBody()`. The payload size limit does not apply to such routes.
+  template <ReRegisterRoute POLICY = ReRegisterRoute::ThrowOnAttempt>
+  HTTPRoutesScopeEntry Register(const std::string& path,
+                                const URLPathArgs::CountMask path_args_count_mask,
+                                RequestBody body,
+                                std::function<void(Request)> handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return DoRegisterHandler(path, handler, path_args_count_mask, POLICY, body);
+  }
+  template <ReRegisterRoute POLICY = ReRegisterRoute::ThrowOnAttempt>
+  HTTPRoutesScopeEntry Register(const std::string& path, RequestBody body, std::function<void(Request)> handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return DoRegisterHandler(path, handler, URLPathArgs::CountMask::None, POLICY, body);
+  }
+
   void UnRegister(const std::string& path,
                   const URLPathArgs::CountMask path_args_count_mask = URLPathArgs::CountMask::None) {
     std::lock_guard<std::mutex> lock(mutex_);
+    const auto publish_route_table = current::MakeScopeGuard([this]() { PublishRouteTable(); });
     URLPathArgs::CountMask mask = URLPathArgs::CountMask::None;  // `None` == 1 == (1 << 0).
     for (size_t i = 0; i <= URLPathArgs::MaxArgsCount; ++i, mask <<= 1) {
       if ((path_args_count_mask & mask) == mask) {
@@ -267,7 +569,11 @@ class HTTPServerPOSIX final {
                                        const ServeStaticFilesFromOptions& options = ServeStaticFilesFromOptions()) {
     ValidateRoute(options.route_prefix);
 
-    HTTPRoutesScope scope;
+    // Publish the route table once for the whole directory, not once per file, both when registering the files
+    // and when the returned scope unregisters them. The scope entries run in reverse order, so the first entry
+    // ends the batch and the last one begins it. Should a file fail to register, the rollback is batched too.
+    DeferRouteTablePublishing();
+    HTTPRoutesScope scope([this]() { PublishDeferredRouteTable(); });
     current::FileSystem::ScanDir(
         dir,
         [this, &dir, &options, &scope](const current::FileSystem::ScanDirItemInfo& item_info) {
@@ -304,7 +610,9 @@ class HTTPServerPOSIX final {
 
             // TODO(dkorolev): Wrap keeping file contents into a singleton
             // that keeps a map from a (SHA256) hash to the contents.
-            std::string content = current::FileSystem::ReadFileAsString(item_info.pathname);
+            const bool from_disk = (options.served_from == StaticFilesServedFrom::Disk);
+            std::string content = from_disk ? "" : current::FileSystem::ReadFileAsString(item_info.pathname);
+            const std::string pathname = from_disk ? item_info.pathname : "";
 
             // If it's an index file, serve it additionally at the route without the filename (i.e. the directory
             // route).
@@ -320,13 +628,14 @@ class HTTPServerPOSIX final {
                                                         (path_components_empty ? "" : path_components_joined + "/");
               CURRENT_ASSERT(trailing_slash_redirect_url.length() > 0 && trailing_slash_redirect_url.back() == '/');
 
-              auto static_file_server =
-                  std::make_unique<StaticFileServer>(content, content_type, true, trailing_slash_redirect_url);
+              auto static_file_server = std::make_unique<StaticFileServer>(
+                  content, content_type, true, trailing_slash_redirect_url, pathname);
               scope += Register(route_for_directory, *static_file_server);
               static_file_servers_.push_back(std::move(static_file_server));
             }
 
-            auto static_file_server = std::make_unique<StaticFileServer>(std::move(content), content_type, false);
+            auto static_file_server =
+                std::make_unique<StaticFileServer>(std::move(content), content_type, false, "", pathname);
             scope += Register(route_for_file, *static_file_server);
             static_file_servers_.push_back(std::move(static_file_server));
           } else {
@@ -335,9 +644,37 @@ class HTTPServerPOSIX final {
         },
         FileSystem::ScanDirParameters::ListFilesOnly,
         FileSystem::ScanDirRecursive::Yes);
+    PublishDeferredRouteTable();
+    scope += HTTPRoutesScopeEntry([this]() { DeferRouteTablePublishing(); });
     return scope;
   }
 
+  // Sets the limits of the whole server.
+  void SetAdmissionLimits(const HTTPAdmissionLimits& limits) { server_admission_.SetLimits(limits); }
+
+  // Sets the limits of the route, which apply to all its URL path args counts. Survive `UnRegister()`.
+  void SetRouteAdmissionLimits(const std::string& path, const HTTPAdmissionLimits& limits) {
+    ValidateRoute(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& admission = route_admission_[path];
+    if (admission) {
+      admission->SetLimits(limits);
+    } else {
+      admission = std::make_shared<HTTPAdmission>(limits);
+      PublishRouteTable();
+    }
+  }
+
+  HTTPAdmissionStats AdmissionStats() const {
+    HTTPAdmissionStats stats;
+    stats.server = server_admission_.Counters();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& path_and_admission : route_admission_) {
+      stats.routes[path_and_admission.first] = path_and_admission.second->Counters();
+    }
+    return stats;
+  }
+
   size_t PathHandlersCount() const {
     // NOTE: The total number of handlers is no longer an interesting measure.
     //       Just return the number of distinct paths, which may be path prefixes.
@@ -346,102 +683,87 @@ class HTTPServerPOSIX final {
   }
 
  private:
-  void FindHandler(const std::string& path,
-                   std::function<void(Request)>& output_handler,
-                   URLPathArgs& output_url_args) {
-    // Just `return` is safe. Uninitialized `output_handler` would be interpreted as "no handler found".
+  // The request received in full, or, for the routes which stream the body, its headers,
+  // along with its handler, if any, and the admission control of its route, if any.
+  struct RoutedRequest {
+    std::unique_ptr<current::net::HTTPServerConnection> connection;
+    bool routed = false;
+    HTTPRouteTable::shared_handler_t handler;
+    HTTPRouteTable::shared_admission_t route_admission;
+    URLPathArgs url_path_args;
+  };
+
+  // Lock-free, as the route table is immutable and is swapped in atomically by `Register()` and `UnRegister()`.
+  HTTPRouteTable::shared_handler_t FindHandler(const std::string& path,
+                                               URLPathArgs& output_url_args,
+                                               HTTPRouteTable::shared_admission_t* output_admission) const {
+    // Just `return nullptr` is safe, and would be interpreted as "no handler found".
     // LCOV_EXCL_START
     if (path.empty()) {
       std::cerr << "HTTP: path is empty.\n";
-      return;
+      return nullptr;
     }
     if (path[0] != '/') {
       std::cerr << "HTTP: path does not start with a slash.\n";
-      return;
+      return nullptr;
     }
     // LCOV_EXCL_STOP
+    return route_table_.Find(path, output_url_args, output_admission);
+  }
 
-    // Work with the path by trying to match the full one, then the one with the last component removed,
-    // then the one with two last components removed, etc.
-    // As a component is removed, it's removed from `base_path` and is added to `url_args`.
-    std::string& remaining_path = output_url_args.base_path;
-    remaining_path = path;
-
-    // Friendly reminder: `remaining_path[0]` is guaranteed to be '/'.
-    while (true) {
-      while (remaining_path.length() > 1 && remaining_path.back() == '/') {
-        remaining_path.resize(remaining_path.length() - 1);
-      }
-
-      const auto cit = handlers_.find(remaining_path);
-      if (cit != handlers_.end()) {
-        const auto cit2 = cit->second.find(output_url_args.size());
-        if (cit2 != cit->second.end()) {
-          output_handler = cit2->second;
-          return;
-        }
-      }
+  // Rebuilds the route table from `handlers_`. Must be called with `mutex_` locked.
+  // Between `DeferRouteTablePublishing()` and `PublishDeferredRouteTable()` only marks the table as stale.
+  void PublishRouteTable() {
+    if (route_table_publishing_deferred_) {
+      route_table_stale_ = true;
+    } else {
+      route_table_.Publish(std::unique_ptr<const HTTPRouteTable>(new HTTPRouteTable(handlers_, route_admission_)));
+      route_table_stale_ = false;
+    }
+  }
 
-      if (remaining_path == "/") {
-        break;
-      }
+  void DeferRouteTablePublishing() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++route_table_publishing_deferred_;
+  }
 
-      const size_t arg_begin_index = remaining_path.rfind('/') + 1;
-      output_url_args.add(remaining_path.substr(arg_begin_index));
-      remaining_path.resize(arg_begin_index);
+  void PublishDeferredRouteTable() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (route_table_publishing_deferred_ && !--route_table_publishing_deferred_ && route_table_stale_) {
+      PublishRouteTable();
     }
   }
 
+  static size_t ListenersCount(const HTTPServerOptions& options) {
+#ifdef CURRENT_NET_HAS_REUSEPORT
+    return std::max(options.listeners, static_cast<size_t>(1u));
+#else
+    static_cast<void>(options);
+    return 1u;
+#endif
+  }
+
   void Thread(current::net::Socket socket) {
+    // Close the socket as soon as this listener is done, so that no more connections are queued on it.
+    const auto done = current::MakeScopeGuard([this, &socket]() {
+      current::net::Socket closed_socket(std::move(socket));
+      --listeners_running_;
+    });
     // TODO(dkorolev): Benchmark QPS.
     while (!terminating_) {
       try {
-        std::unique_ptr<current::net::HTTPServerConnection> connection(
-            new current::net::HTTPServerConnection(socket.Accept()));
+        RoutedRequest request;
+        request.connection.reset(new current::net::HTTPServerConnection(socket.Accept(), RouteAfterHeaders(request)));
         if (terminating_) {
           // Already terminating. Will not send the response, and this
           // lack of response should not result in an exception.
-          connection->DoNotSendAnyResponse();
+          request.connection->DoNotSendAnyResponse();
           break;
         }
-        std::function<void(Request)> handler;
-        URLPathArgs url_path_args;
-        {
-          // TODO(dkorolev): Read-write lock for performance?
-          std::lock_guard<std::mutex> lock(mutex_);
-          FindHandler(connection->HTTPRequest().URL().path, handler, url_path_args);
-        }
-        if (handler) {
-          // OK, here's the tricky part with error handling and exceptions in this multithreaded world.
-          // * On the one hand, the connection should be std::move-d into the request,
-          //   since it might end up being served in another thread, via a message queue, etc.
-          //   Thus, the user code is responsible for closing the connection.
-          //   Not to mention that the std::move-d away connection can easily outlive this scope.
-          // * On the other hand, if an exception occurs in user code, we need to return a 500,
-          //   which should obviously happen before the connection object is destructed.
-          //   This seems like a good reason to not std::move it away, or move it away with some flag,
-          //   but I thought hard of it, and don't think it's a good choice -- D.K.
-          //
-          // Solution: Do nothing here. No matter how tempting it is, it won't work across threads. Period.
-          //
-          // The implementation of HTTP connection will return an "INTERNAL SERVER ERROR"
-          // if no response was sent. That's what the user gets. In debugger, they can put a breakpoint there
-          // and see what caused the error.
-          //
-          // It is the job of the user of this library to ensure no exceptions leave their code.
-          // In practice, a top-level try-catch for `const current::Exception& e` is good enough.
-          try {
-            handler(Request(std::move(connection), url_path_args));
-          } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
-            // WARNING: This `catch` is really not sufficient, it just logs a message
-            // if a user exception occurred in the same thread that ran the handler.
-            // DO NOT COUNT ON IT.
-            std::cerr << "HTTP route failed in user code: " << e.what() << '\n';  // LCOV_EXCL_LINE
-          }
+        if (workers_.empty()) {
+          Dispatch(Route(std::move(request)));
         } else {
-          connection->SendHTTPResponse(current::net::DefaultNotFoundMessage(),
-                                       HTTPResponseCode.NotFound,
-                                       current::net::constants::kDefaultHTMLContentType);
+          Enqueue(Route(std::move(request)));
         }
       } catch (const current::net::ChunkSizeNotAValidHEXValue&) {
         // The `ChunkSizeNotAValidHEXValue` situation, if emerged, is already handled with a "400 BAD REQUEST" response.
@@ -456,6 +778,167 @@ class HTTPServerPOSIX final {
     }
   }
 
+#ifdef CURRENT_HTTP_SERVER_HAS_EVENT_LOOP
+  void EventLoopThread(current::net::Socket socket) {
+    const auto done = current::MakeScopeGuard([this, &socket]() {
+      current::net::Socket closed_socket(std::move(socket));
+      --listeners_running_;
+    });
+    HTTPServerEventLoop event_loop(
+        socket,
+        terminating_,
+        options_.incomplete_request_timeout,
+        [this](current::net::Connection&& c) {
+          try {
+            // The request, or its headers if the body is streamed, has been received, so it is parsed from memory.
+            RoutedRequest request;
+            request.connection.reset(new current::net::HTTPServerConnection(std::move(c), RouteAfterHeaders(request)));
+            Enqueue(Route(std::move(request)));
+          } catch (const current::net::ChunkSizeNotAValidHEXValue&) {
+            // Already handled with a "400 BAD REQUEST" response.
+          } catch (const current::net::HTTPPayloadTooLarge&) {
+            // Already handled with a "413 ENTITY TOO LARGE" response.
+          } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
+            std::cerr << "HTTP route failed: " << e.what() << '\n';  // LCOV_EXCL_LINE
+          }
+        },
+        [this](const std::string& raw_path) {
+          URLPathArgs unused_url_path_args;
+          const auto handler = FindHandler(URL(raw_path).path, unused_url_path_args, nullptr);
+          return handler && handler->StreamsBody();
+        });
+    try {
+      event_loop.Run();
+    } catch (const current::Exception& e) {                    // LCOV_EXCL_LINE
+      std::cerr << "HTTP event loop failed: " << e.what() << '\n';  // LCOV_EXCL_LINE
+    }
+  }
+#endif  // CURRENT_HTTP_SERVER_HAS_EVENT_LOOP
+
+  // Finds the handler as soon as the headers have been parsed, to tell whether to leave the body unread.
+  // The `request` must outlive the construction of the `HTTPServerConnection` these parameters are passed to.
+  current::net::HTTPDefaultHelper::ConstructionParams RouteAfterHeaders(RoutedRequest& request) const {
+    current::net::HTTPDefaultHelper::ConstructionParams params;
+    params.stream_body = [this, &request](const URL& url) {
+      request.handler = FindHandler(url.path, request.url_path_args, &request.route_admission);
+      request.routed = true;
+      return request.handler && request.handler->StreamsBody();
+    };
+    return params;
+  }
+
+  RoutedRequest Route(RoutedRequest request) {
+    if (!request.routed) {
+      request.handler =
+          FindHandler(request.connection->HTTPRequest().URL().path, request.url_path_args, &request.route_admission);
+      request.routed = true;
+    }
+    return request;
+  }
+
+  // Responds with a "503" right away, so that the client does not wait for the overloaded server.
+  static void Shed(RoutedRequest& request, const HTTPAdmission& admission) {
+    request.connection->SendHTTPResponse(
+        current::net::DefaultServiceUnavailableMessage(),
+        HTTPResponseCode.ServiceUnavailable,
+        current::net::constants::kDefaultHTMLContentType,
+        current::net::http::Headers({{"Retry-After", current::ToString(admission.RetryAfter().count())}}));
+  }
+
+  void Enqueue(RoutedRequest request) {
+    if (!server_admission_.TryEnqueue()) {
+      Shed(request, server_admission_);
+      return;
+    }
+    if (request.route_admission && !request.route_admission->TryEnqueue()) {
+      server_admission_.Dequeue();
+      Shed(request, *request.route_admission);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(ready_requests_mutex_);
+      ready_requests_.push_back(std::move(request));
+    }
+    ready_requests_cv_.notify_one();
+  }
+
+  void WorkerThread() {
+    while (true) {
+      RoutedRequest request;
+      {
+        std::unique_lock<std::mutex> lock(ready_requests_mutex_);
+        ready_requests_cv_.wait(lock, [this]() { return !ready_requests_.empty() || terminating_; });
+        if (ready_requests_.empty()) {
+          return;
+        }
+        request = std::move(ready_requests_.front());
+        ready_requests_.pop_front();
+      }
+      server_admission_.Dequeue();
+      if (request.route_admission) {
+        request.route_admission->Dequeue();
+      }
+      try {
+        Dispatch(std::move(request));
+      } catch (const current::Exception& e) {                  // LCOV_EXCL_LINE
+        std::cerr << "HTTP route failed: " << e.what() << '\n';  // LCOV_EXCL_LINE
+      }
+    }
+  }
+
+  // Runs the handler of the request, unless the admission limits say otherwise.
+  // Responds with a "404" if no handler is registered.
+  void Dispatch(RoutedRequest request) {
+    if (request.handler) {
+      if (!server_admission_.TryStart()) {
+        Shed(request, server_admission_);
+        return;
+      }
+      if (request.route_admission && !request.route_admission->TryStart()) {
+        server_admission_.Finish();
+        Shed(request, *request.route_admission);
+        return;
+      }
+      // The request is in flight until the handler returns, even if it has passed the request on elsewhere.
+      const auto finish = current::MakeScopeGuard([this, &request]() {
+        server_admission_.Finish();
+        if (request.route_admission) {
+          request.route_admission->Finish();
+        }
+      });
+      // OK, here's the tricky part with error handling and exceptions in this multithreaded world.
+      // * On the one hand, the connection should be std::move-d into the request,
+      //   since it might end up being served in another thread, via a message queue, etc.
+      //   Thus, the user code is responsible for closing the connection.
+      //   Not to mention that the std::move-d away connection can easily outlive this scope.
+      // * On the other hand, if an exception occurs in user code, we need to return a 500,
+      //   which should obviously happen before the connection object is destructed.
+      //   This seems like a good reason to not std::move it away, or move it away with some flag,
+      //   but I thought hard of it, and don't think it's a good choice -- D.K.
+      //
+      // Solution: Do nothing here. No matter how tempting it is, it won't work across threads. Period.
+      //
+      // The implementation of HTTP connection will return an "INTERNAL SERVER ERROR"
+      // if no response was sent. That's what the user gets. In debugger, they can put a breakpoint there
+      // and see what caused the error.
+      //
+      // It is the job of the user of this library to ensure no exceptions leave their code.
+      // In practice, a top-level try-catch for `const current::Exception& e` is good enough.
+      try {
+        (*request.handler)(Request(std::move(request.connection), request.url_path_args));
+      } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
+        // WARNING: This `catch` is really not sufficient, it just logs a message
+        // if a user exception occurred in the same thread that ran the handler.
+        // DO NOT COUNT ON IT.
+        std::cerr << "HTTP route failed in user code: " << e.what() << '\n';  // LCOV_EXCL_LINE
+      }
+    } else {
+      request.connection->SendHTTPResponse(current::net::DefaultNotFoundMessage(),
+                                           HTTPResponseCode.NotFound,
+                                           current::net::constants::kDefaultHTMLContentType);
+    }
+  }
+
   void ValidateRoute(const std::string& path) {
     if (path.empty() || path[0] != '/') {
       CURRENT_THROW(PathDoesNotStartWithSlash("HTTP URL path does not start with a slash: `" + path + "`."));
@@ -471,7 +954,8 @@ class HTTPServerPOSIX final {
   HTTPRoutesScopeEntry DoRegisterHandler(const std::string& path,
                                          std::function<void(Request)> handler,
                                          const URLPathArgs::CountMask path_args_count_mask,
-                                         const ReRegisterRoute policy) {
+                                         const ReRegisterRoute policy,
+                                         const RequestBody body = RequestBody::ReadInFull) {
     // LCOV_EXCL_START
     if (static_cast<uint16_t>(path_args_count_mask) == 0) {
       return HTTPRoutesScopeEntry();
@@ -504,13 +988,15 @@ class HTTPServerPOSIX final {
 
     {
       // Step 2: Update.
+      const auto shared_handler = std::make_shared<const HTTPRouteHandler>(HTTPRouteHandler{std::move(handler), body});
       auto& handlers_per_path = handlers_[path];
       URLPathArgs::CountMask mask = URLPathArgs::CountMask::None;  // `None` == 1 == (1 << 0).
       for (size_t i = 0; i <= URLPathArgs::MaxArgsCount; ++i, mask = mask << 1) {
         if ((path_args_count_mask & mask) == mask) {
-          handlers_per_path[i] = handler;
+          handlers_per_path[i] = shared_handler;
         }
       }
+      PublishRouteTable();
     }
 
     if (policy == ReRegisterRoute::SilentlyUpdateExisting) {
@@ -524,12 +1010,29 @@ class HTTPServerPOSIX final {
 
   std::atomic_bool terminating_;
   const int port_;
-  std::thread thread_;
-
-  // TODO(dkorolev): Look into read-write mutexes here.
+  const HTTPServerOptions options_;
+  // One thread per listening socket.
+  std::vector<std::thread> threads_;
+  std::atomic_size_t listeners_running_;
+
+  // The pool of handler threads, and the queue of fully received requests for them to serve.
+  std::vector<std::thread> workers_;
+  std::deque<RoutedRequest> ready_requests_;
+  std::mutex ready_requests_mutex_;
+  std::condition_variable ready_requests_cv_;
+
+  // Guards `handlers_` and `route_admission_`, which are only accessed by `Register()`, `UnRegister()`,
+  // and the admission control setters and getters.
+  // The serving threads only access `route_table_`, which is lock-free.
   mutable std::mutex mutex_;
 
-  std::map<std::string, std::map<size_t, std::function<void(Request)>>> handlers_;
+  HTTPRouteTable::handlers_per_path_t handlers_;
+  HTTPRouteTable::admission_per_path_t route_admission_;
+  HTTPRouteTableHolder route_table_;
+  size_t route_table_publishing_deferred_ = 0u;
+  bool route_table_stale_ = false;
+
+  HTTPAdmission server_admission_;
   std::vector<std::unique_ptr<StaticFileServer>> static_file_servers_;
 };
 
@@ -0,0 +1,284 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The route table of `HTTPServerPOSIX`, precompiled into an immutable trie of path components.
+//
+// `Register()` and `UnRegister()` build a new table and swap it in atomically via `HTTPRouteTableHolder`.
+// The serving threads look up the handler without taking any locks and without allocating memory,
+// in one left-to-right pass over the URL path. The URL path args are kept as positions in the path,
+// and are only copied into `URLPathArgs` once the handler has been found.
+
+#ifndef BLOCKS_HTTP_IMPL_ROUTE_TABLE_H
+#define BLOCKS_HTTP_IMPL_ROUTE_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "admission.h"
+
+#include "../request.h"
+#include "../types.h"
+
+#include "../../URL/url.h"
+
+namespace current {
+namespace http {
+
+// The handler of a route, along with whether the body of the request to it is read in full in advance.
+struct HTTPRouteHandler final {
+  std::function<void(Request)> handler;
+  RequestBody body;
+
+  void operator()(Request r) const { handler(std::move(r)); }
+  bool StreamsBody() const { return body == RequestBody::Streamed; }
+};
+
+class HTTPRouteTable final {
+ public:
+  using handler_t = HTTPRouteHandler;
+  using shared_handler_t = std::shared_ptr<const handler_t>;
+  using handlers_per_path_t = std::map<std::string, std::map<size_t, shared_handler_t>>;
+  using shared_admission_t = std::shared_ptr<HTTPAdmission>;
+  using admission_per_path_t = std::map<std::string, shared_admission_t>;
+
+  HTTPRouteTable() : nodes_(1u) {}
+
+  explicit HTTPRouteTable(const handlers_per_path_t& handlers,
+                          const admission_per_path_t& admission = admission_per_path_t())
+      : nodes_(1u) {
+    for (const auto& path_and_handlers : handlers) {
+      const size_t node = InsertPath(path_and_handlers.first);
+      for (const auto& count_and_handler : path_and_handlers.second) {
+        if (count_and_handler.first <= URLPathArgs::MaxArgsCount) {
+          nodes_[node].handlers[count_and_handler.first] = count_and_handler.second;
+        }
+      }
+    }
+    for (const auto& path_and_admission : admission) {
+      nodes_[InsertPath(path_and_admission.first)].admission = path_and_admission.second;
+    }
+  }
+
+  // Finds the handler with the longest matching path, for which the number of the remaining path components,
+  // which become the URL path args, is registered. Empty path components, as in "/foo//bar/", are ignored.
+  // Returns a null pointer if no handler matches. Only allocates memory to fill `output_url_args` on success.
+  // If `output_admission` is set, it is pointed to the admission control of the matched path, if there is one.
+  const shared_handler_t* Find(const std::string& path,
+                               URLPathArgs& output_url_args,
+                               shared_admission_t* output_admission = nullptr) const {
+    // The last `kWindow` nodes visited and path components seen, as only they can end up being URL path args.
+    constexpr size_t kWindow = URLPathArgs::MaxArgsCount + 1;
+    size_t visited_node[kWindow];
+    size_t component_begin[kWindow];
+    size_t component_end[kWindow];
+
+    size_t depth = 0u;           // The number of path components matched by the trie so far.
+    size_t components = 0u;      // The total number of path components seen so far.
+    size_t node = 0u;            // The current trie node, while still matching.
+    bool still_matching = true;  // Whether each component seen so far has matched a trie node.
+    visited_node[0] = 0u;
+    component_end[0] = 0u;
+
+    const char* const data = path.data();
+    const size_t length = path.length();
+    size_t i = 0u;
+    while (true) {
+      while (i < length && data[i] == '/') {
+        ++i;
+      }
+      if (i == length) {
+        break;
+      }
+      const size_t begin = i;
+      while (i < length && data[i] != '/') {
+        ++i;
+      }
+      ++components;
+      component_begin[components % kWindow] = begin;
+      component_end[components % kWindow] = i;
+      if (still_matching) {
+        const size_t child = FindChild(node, data + begin, i - begin);
+        if (child) {
+          node = child;
+          ++depth;
+          visited_node[depth % kWindow] = node;
+        } else {
+          still_matching = false;
+        }
+      }
+    }
+
+    // Try the deepest matching node first, then back off one path component at a time.
+    for (size_t k = depth + 1u; k-- > 0u;) {
+      const size_t args_count = components - k;
+      if (args_count > URLPathArgs::MaxArgsCount) {
+        break;
+      }
+      const Node& matched_node = nodes_[visited_node[k % kWindow]];
+      const shared_handler_t& handler = matched_node.handlers[args_count];
+      if (handler) {
+        if (output_admission) {
+          *output_admission = matched_node.admission;
+        }
+        output_url_args = URLPathArgs();
+        output_url_args.base_path = k ? path.substr(0u, component_end[k % kWindow]) : "/";
+        // `URLPathArgs` keeps its args in the reverse order.
+        for (size_t j = components; j > k; --j) {
+          const size_t begin = component_begin[j % kWindow];
+          output_url_args.add(path.substr(begin, component_end[j % kWindow] - begin));
+        }
+        return &handler;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  struct Node {
+    // The children of this node, sorted by the path component, with the indexes of the nodes they point to.
+    std::vector<std::pair<std::string, size_t>> children;
+    shared_handler_t handlers[URLPathArgs::MaxArgsCount + 1];
+    shared_admission_t admission;
+  };
+
+  size_t InsertPath(const std::string& path) {
+    size_t node = 0u;
+    size_t i = 0u;
+    while (true) {
+      while (i < path.length() && path[i] == '/') {
+        ++i;
+      }
+      if (i == path.length()) {
+        return node;
+      }
+      const size_t begin = i;
+      while (i < path.length() && path[i] != '/') {
+        ++i;
+      }
+      const std::string component = path.substr(begin, i - begin);
+      auto& children = nodes_[node].children;
+      const auto it = std::lower_bound(
+          children.begin(),
+          children.end(),
+          component,
+          [](const std::pair<std::string, size_t>& lhs, const std::string& rhs) { return lhs.first < rhs; });
+      if (it != children.end() && it->first == component) {
+        node = it->second;
+      } else {
+        const size_t child = nodes_.size();
+        children.insert(it, std::make_pair(component, child));
+        nodes_.emplace_back();
+        node = child;
+      }
+    }
+  }
+
+  // Returns the index of the child node, or zero, which is the root, if there is no such child.
+  size_t FindChild(size_t node, const char* component, size_t length) const {
+    const auto& children = nodes_[node].children;
+    size_t lo = 0u;
+    size_t hi = children.size();
+    while (lo < hi) {
+      const size_t mid = (lo + hi) / 2;
+      const std::string& candidate = children[mid].first;
+      int cmp = std::memcmp(candidate.data(), component, std::min(candidate.length(), length));
+      if (!cmp) {
+        cmp = (candidate.length() < length) ? -1 : (candidate.length() > length) ? 1 : 0;
+      }
+      if (!cmp) {
+        return children[mid].second;
+      } else if (cmp < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return 0u;
+  }
+
+  std::vector<Node> nodes_;
+};
+
+// Holds the current `HTTPRouteTable`, RCU-style.
+// `Publish()` is to be called under the writers' mutex. `Find()` is lock-free and is safe to call concurrently.
+// Each lookup is counted against the parity of the epoch it started in. `Publish()` swaps in the new table,
+// advances the epoch, and waits for the lookups of the previous epoch to complete before freeing the old table.
+class HTTPRouteTableHolder final {
+ public:
+  HTTPRouteTableHolder() : table_(new HTTPRouteTable()), epoch_(0u) {
+    lookups_in_flight_[0] = 0u;
+    lookups_in_flight_[1] = 0u;
+  }
+
+  ~HTTPRouteTableHolder() { delete table_.load(); }
+
+  void Publish(std::unique_ptr<const HTTPRouteTable> new_table) {
+    std::unique_ptr<const HTTPRouteTable> old_table(table_.exchange(new_table.release()));
+    const size_t epoch = epoch_.load();
+    epoch_.store(epoch + 1u);
+    // The lookups started from now on see the new table. The ones of the previous epoch are short, and can not
+    // be joined by new ones, so this wait is bounded.
+    while (lookups_in_flight_[epoch & 1u].load()) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Returns the handler by `shared_ptr`, so that it remains valid after the route table is replaced.
+  // Copying the `shared_ptr` does not allocate memory, unlike copying the `std::function` would.
+  HTTPRouteTable::shared_handler_t Find(const std::string& path,
+                                        URLPathArgs& output_url_args,
+                                        HTTPRouteTable::shared_admission_t* output_admission = nullptr) const {
+    size_t epoch;
+    while (true) {
+      epoch = epoch_.load();
+      ++lookups_in_flight_[epoch & 1u];
+      if (epoch_.load() == epoch) {
+        break;
+      }
+      // The table has just been replaced, and `Publish()` may be waiting on this parity. Retry in the new epoch.
+      --lookups_in_flight_[epoch & 1u];
+    }
+    const HTTPRouteTable::shared_handler_t* handler = table_.load()->Find(path, output_url_args, output_admission);
+    HTTPRouteTable::shared_handler_t result = handler ? *handler : nullptr;
+    --lookups_in_flight_[epoch & 1u];
+    return result;
+  }
+
+ private:
+  std::atomic<const HTTPRouteTable*> table_;
+  std::atomic<size_t> epoch_;
+  mutable std::atomic<size_t> lookups_in_flight_[2];
+};
+
+}  // namespace http
+}  // namespace current
+
+#endif  // BLOCKS_HTTP_IMPL_ROUTE_TABLE_H
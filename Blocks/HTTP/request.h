@@ -25,6 +25,7 @@ SOFTWARE.
 #ifndef BLOCKS_HTTP_REQUEST_H
 #define BLOCKS_HTTP_REQUEST_H
 
+#include <functional>
 #include <vector>
 #include <string>
 
@@ -112,6 +113,11 @@ struct Request final {
     connection.SendHTTPResponse(std::forward<TS>(params)...);
   }
 
+  // Reads the body of the request to the route registered with `RequestBody::Streamed`, as the client is sending it,
+  // passing it to `on_chunk` piece by piece. For other routes, `body` has it already, and it is passed on at once.
+  // The client is held back while `on_chunk` is running, so that a slow handler does not have to buffer the body.
+  void ReadBody(const std::function<void(const char*, size_t)>& on_chunk) { connection.ReadStreamedBody(on_chunk); }
+
   current::net::HTTPServerConnection::ChunkedResponseSender SendChunkedResponse(
       net::HTTPResponseCodeValue code = HTTPResponseCode.OK,
       const std::string& content_type = net::constants::kDefaultJSONContentType,
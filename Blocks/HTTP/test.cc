@@ -82,6 +82,22 @@ DEFINE_int32(net_api_test_port_secondary,
              "different from "
              "ports in other network-based tests, since API-driven HTTP server will hold it open for the whole "
              "lifetime of the binary.");
+DEFINE_int32(net_api_test_event_loop_port,
+             PickPortForUnitTest(),
+             "Local port to use for the test API-based HTTP server running the event loop with handler threads.");
+DEFINE_int32(net_api_test_incomplete_request_timeout_port,
+             PickPortForUnitTest(),
+             "Local port to use for the test HTTP server running the event loop with a short incomplete request "
+             "timeout.");
+DEFINE_int32(net_api_test_keep_alive_port,
+             PickPortForUnitTest(),
+             "Local port to use for the test keep-alive HTTP server, to test the client connection pool.");
+DEFINE_int32(net_api_test_silent_port,
+             PickPortForUnitTest(),
+             "Local port to use for the test server which never responds, to test the async client timeouts.");
+DEFINE_int32(net_api_test_reuseport_port,
+             PickPortForUnitTest(),
+             "Local port to use for the test HTTP server with several listening sockets.");
 DEFINE_string(net_api_test_tmpdir, ".current", "Local path for the test to create temporary files in.");
 
 CURRENT_STRUCT(HTTPAPITestObject) {
@@ -171,6 +187,25 @@ TEST(HTTPAPI, RegisterWithURLPathParams) {
   EXPECT_EQ("/ (user, a, 1, blah) url_path_had_trailing_slash", run("/user/a/1/blah/"));
 }
 
+TEST(HTTPAPI, RoutesCanBeChangedWhileServing) {
+  const auto scope = HTTP(FLAGS_net_api_test_port).Register("/stable", [](Request r) { r("Stable.\n"); });
+  std::atomic_bool done(false);
+  std::thread churn([&done]() {
+    while (!done) {
+      const auto transient_scope =
+          HTTP(FLAGS_net_api_test_port).Register("/transient", URLPathArgs::CountMask::Any, [](Request r) { r("."); });
+    }
+  });
+  for (int i = 0; i < 50; ++i) {
+    const auto response = HTTP(GET(Printf("http://localhost:%d/stable", FLAGS_net_api_test_port)));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ("Stable.\n", response.body);
+  }
+  done = true;
+  churn.join();
+  EXPECT_EQ(404, static_cast<int>(HTTP(GET(Printf("http://localhost:%d/transient", FLAGS_net_api_test_port))).code));
+}
+
 TEST(HTTPAPI, ScopeLeftHangingThrowsAnException) {
   const string url = Printf("http://localhost:%d/foo", FLAGS_net_api_test_port);
 
@@ -1357,6 +1392,108 @@ TEST(HTTPAPI, ServeStaticFilesFromOnlyServesFilesOfKnownMIMEType) {
   FileSystem::WriteStringToFile("FOO is not! ", FileSystem::JoinPath(dir, "file.foo").c_str());
   ASSERT_THROW(HTTP(FLAGS_net_api_test_port).ServeStaticFilesFrom(dir),
                ServeStaticFilesFromCanNotServeStaticFilesOfUnknownMIMEType);
+  // The files registered before the failure are unregistered, and the route table is published as usual again.
+  EXPECT_EQ(404, static_cast<int>(HTTP(GET(Printf("http://localhost:%d/file.txt", FLAGS_net_api_test_port))).code));
+  const auto scope = HTTP(FLAGS_net_api_test_port).Register("/file.txt", [](Request r) { r("Registered.\n"); });
+  EXPECT_EQ("Registered.\n", HTTP(GET(Printf("http://localhost:%d/file.txt", FLAGS_net_api_test_port))).body);
+}
+
+TEST(HTTPAPI, ServeStaticFilesFromDisk) {
+  FileSystem::MkDir(FLAGS_net_api_test_tmpdir, FileSystem::MkDirParameters::Silent);
+  const std::string dir = FileSystem::JoinPath(FLAGS_net_api_test_tmpdir, "static");
+  const auto dir_remover = current::FileSystem::ScopedRmDir(dir);
+  FileSystem::MkDir(dir, FileSystem::MkDirParameters::Silent);
+  FileSystem::WriteStringToFile("<h1>HTML index</h1>", FileSystem::JoinPath(dir, "index.html").c_str());
+  std::string large_file;
+  for (size_t i = 0; i < 100000; ++i) {
+    large_file += Printf("%09d\n", static_cast<int>(i));
+  }
+  FileSystem::WriteStringToFile(large_file, FileSystem::JoinPath(dir, "large.txt").c_str());
+
+  const auto scope = HTTP(FLAGS_net_api_test_port)
+                         .ServeStaticFilesFrom(
+                             dir, ServeStaticFilesFromOptions().ServedFrom(StaticFilesServedFrom::Disk));
+
+  const auto index = HTTP(GET(Printf("http://localhost:%d/", FLAGS_net_api_test_port)));
+  EXPECT_EQ(200, static_cast<int>(index.code));
+  EXPECT_EQ("text/html", index.headers.Get("Content-Type"));
+  EXPECT_EQ("<h1>HTML index</h1>", index.body);
+  EXPECT_EQ(404, static_cast<int>(HTTP(GET(Printf("http://localhost:%d/index.html/", FLAGS_net_api_test_port))).code));
+
+  const std::string url = Printf("http://localhost:%d/large.txt", FLAGS_net_api_test_port);
+  const auto full = HTTP(GET(url));
+  EXPECT_EQ(200, static_cast<int>(full.code));
+  EXPECT_EQ(large_file, full.body);
+  ASSERT_TRUE(full.headers.Has("ETag"));
+  ASSERT_TRUE(full.headers.Has("Last-Modified"));
+  EXPECT_EQ("bytes", full.headers.Get("Accept-Ranges"));
+  const std::string etag = full.headers.Get("ETag");
+  const std::string last_modified = full.headers.Get("Last-Modified");
+
+  // Conditional requests.
+  {
+    const auto response = HTTP(GET(url).SetHeader("If-None-Match", etag));
+    EXPECT_EQ(304, static_cast<int>(response.code));
+    EXPECT_EQ("", response.body);
+    EXPECT_EQ(etag, response.headers.Get("ETag"));
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("If-None-Match", "\"other\", W/" + etag));
+    EXPECT_EQ(304, static_cast<int>(response.code));
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("If-None-Match", "\"other\""));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ(large_file, response.body);
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("If-Modified-Since", last_modified));
+    EXPECT_EQ(304, static_cast<int>(response.code));
+    EXPECT_EQ("", response.body);
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("If-Modified-Since", "Thu, 01 Jan 2015 00:00:00 GMT"));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ(large_file.length(), response.body.length());
+  }
+
+  // Range requests.
+  {
+    const auto response = HTTP(GET(url).SetHeader("Range", "bytes=10-29"));
+    EXPECT_EQ(206, static_cast<int>(response.code));
+    EXPECT_EQ("000000001\n000000002\n", response.body);
+    EXPECT_EQ("bytes 10-29/1000000", response.headers.Get("Content-Range"));
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("Range", "bytes=999990-"));
+    EXPECT_EQ(206, static_cast<int>(response.code));
+    EXPECT_EQ("000099999\n", response.body);
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("Range", "bytes=-20"));
+    EXPECT_EQ(206, static_cast<int>(response.code));
+    EXPECT_EQ("000099998\n000099999\n", response.body);
+    EXPECT_EQ("bytes 999980-999999/1000000", response.headers.Get("Content-Range"));
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("Range", "bytes=1000000-"));
+    EXPECT_EQ(416, static_cast<int>(response.code));
+    EXPECT_EQ("bytes */1000000", response.headers.Get("Content-Range"));
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("Range", "bytes=0-9").SetHeader("If-Range", "\"stale\""));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ(large_file, response.body);
+  }
+  {
+    const auto response = HTTP(GET(url).SetHeader("Range", "bytes=0-9").SetHeader("If-Range", etag));
+    EXPECT_EQ(206, static_cast<int>(response.code));
+    EXPECT_EQ("000000000\n", response.body);
+  }
+
+  // The files are read from disk on every request.
+  FileSystem::RmFile(FileSystem::JoinPath(dir, "large.txt"));
+  EXPECT_EQ(404, static_cast<int>(HTTP(GET(url)).code));
 }
 
 TEST(HTTPAPI, ResponseSmokeTest) {
@@ -1534,3 +1671,475 @@ TEST(HTTPAPI, JSONHasOriginWhenSentViaResponse) {
   ASSERT_TRUE(response.headers.Has("Access-Control-Allow-Origin"));
   EXPECT_EQ("*", response.headers.Get("Access-Control-Allow-Origin"));
 }
+
+TEST(HTTPAPI, EventLoopSlowClientDoesNotBlockOtherClients) {
+  auto& server = HTTP(FLAGS_net_api_test_event_loop_port, HTTPServerOptions().WorkerThreads(2));
+  const auto scope = server.Register("/fast", [](Request r) { r("Fast.\n"); }) +
+                     server.Register("/echo", [](Request r) { r(r.method + ' ' + r.body + '\n'); });
+
+  // The slow client has only sent half of its request.
+  Connection slow(current::net::ClientSocket("localhost", FLAGS_net_api_test_event_loop_port));
+  slow.BlockingWrite("POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 6\r\n\r\nSlow", true);
+
+  // Yet the other clients are served.
+  for (int i = 0; i < 3; ++i) {
+    const auto response = HTTP(GET(Printf("http://localhost:%d/fast", FLAGS_net_api_test_event_loop_port)));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ("Fast.\n", response.body);
+  }
+
+  // Once the slow client is done sending its request, it is served too.
+  slow.BlockingWrite("..", false);
+  std::string response;
+  char buffer[1024];
+  while (response.find("POST Slow..\n") == std::string::npos) {
+    const size_t n = slow.BlockingRead(buffer, sizeof(buffer));
+    ASSERT_GT(n, 0u);
+    response.append(buffer, n);
+  }
+  EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n"));
+}
+
+TEST(HTTPAPI, EventLoopClosesConnectionsWhichDoNotSendTheRequestInTime) {
+  auto& server = HTTP(FLAGS_net_api_test_incomplete_request_timeout_port,
+                      HTTPServerOptions().WorkerThreads(1).IncompleteRequestTimeout(std::chrono::milliseconds(100)));
+  const auto scope = server.Register("/fast", [](Request r) { r("Fast.\n"); });
+
+  // The slow client keeps trickling its headers, and is disconnected once the timeout has passed.
+  Connection slow(current::net::ClientSocket("localhost", FLAGS_net_api_test_incomplete_request_timeout_port));
+  slow.BlockingWrite("GET /fast HTTP/1.1\r\n", true);
+  for (int i = 0; i < 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    slow.BlockingWrite("X-Slow: yes\r\n", true);
+  }
+  char buffer[1024];
+  ASSERT_THROW(slow.BlockingRead(buffer, sizeof(buffer)), current::net::EmptySocketException);
+
+  // The clients which send their requests in time are served.
+  const auto response =
+      HTTP(GET(Printf("http://localhost:%d/fast", FLAGS_net_api_test_incomplete_request_timeout_port)));
+  EXPECT_EQ(200, static_cast<int>(response.code));
+  EXPECT_EQ("Fast.\n", response.body);
+}
+
+TEST(HTTPAPI, EventLoopServesBodiesAndChunkedResponsesFromOtherThreads) {
+  auto& server = HTTP(FLAGS_net_api_test_event_loop_port, HTTPServerOptions().WorkerThreads(2));
+  std::vector<std::thread> threads;
+  const auto scope = server.Register("/post", [](Request r) { r("Got " + std::to_string(r.body.length()) + '\n'); }) +
+                     server.Register("/chunks", [&threads](Request r) {
+                       // Move the request into another thread, which responds in chunks.
+                       threads.emplace_back([](Request r) {
+                         auto response = r.SendChunkedResponse();
+                         response("foo\n");
+                         response("bar\n");
+                       }, std::move(r));
+                     });
+
+  {
+    const auto response = HTTP(
+        POST(Printf("http://localhost:%d/post", FLAGS_net_api_test_event_loop_port), std::string(100000, '.')));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ("Got 100000\n", response.body);
+  }
+  {
+    // A chunk-encoded request body, sent in pieces.
+    Connection c(current::net::ClientSocket("localhost", FLAGS_net_api_test_event_loop_port));
+    c.BlockingWrite("POST /post HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nfo", true);
+    c.BlockingWrite("o\r\n4\r\nbar\n\r\n", true);
+    c.BlockingWrite("0\r\n\r\n", false);
+    std::string response;
+    char buffer[1024];
+    while (response.find("Got 7\n") == std::string::npos) {
+      const size_t n = c.BlockingRead(buffer, sizeof(buffer));
+      ASSERT_GT(n, 0u);
+      response.append(buffer, n);
+    }
+  }
+  {
+    const auto response = HTTP(GET(Printf("http://localhost:%d/chunks", FLAGS_net_api_test_event_loop_port)));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ("foo\nbar\n", response.body);
+  }
+  {
+    const auto response = HTTP(GET(Printf("http://localhost:%d/nope", FLAGS_net_api_test_event_loop_port)));
+    EXPECT_EQ(404, static_cast<int>(response.code));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
+TEST(HTTPAPI, StreamedRequestBody) {
+  // Count the pieces of the body, and the bytes, with a checksum to confirm they arrive in order.
+  // The last number is the length of `r.body`, which is empty for the routes which stream the body.
+  const auto handler = [](Request r) {
+    size_t pieces = 0u;
+    size_t bytes = 0u;
+    uint64_t checksum = 0u;
+    try {
+      r.ReadBody([&](const char* data, size_t length) {
+        ASSERT_GT(length, 0u);
+        ++pieces;
+        for (size_t i = 0; i < length; ++i) {
+          checksum = checksum * 31u + static_cast<uint8_t>(data[i]);
+        }
+        bytes += length;
+      });
+    } catch (const current::net::ChunkSizeNotAValidHEXValue&) {
+      // Already responded to with a "400".
+      return;
+    }
+    r(Printf("%s %d %d %d\n",
+             pieces > 1u ? "many" : "one",
+             static_cast<int>(bytes),
+             static_cast<int>(checksum % 1000000u),
+             static_cast<int>(r.body.length())));
+  };
+  const auto Checksum = [](const std::string& s) {
+    uint64_t checksum = 0u;
+    for (char c : s) {
+      checksum = checksum * 31u + static_cast<uint8_t>(c);
+    }
+    return static_cast<int>(checksum % 1000000u);
+  };
+
+  std::string body;
+  for (int i = 0; i < 100000; ++i) {
+    body += current::ToString(i) + ' ';
+  }
+
+  auto& event_loop_server = HTTP(FLAGS_net_api_test_event_loop_port, HTTPServerOptions().WorkerThreads(2));
+  const auto scope = HTTP(FLAGS_net_api_test_port).Register("/upload", RequestBody::Streamed, handler) +
+                     event_loop_server.Register("/upload", RequestBody::Streamed, handler) +
+                     event_loop_server.Register("/regular", handler);
+
+  for (int port : {FLAGS_net_api_test_port, FLAGS_net_api_test_event_loop_port}) {
+    {
+      // With `Content-Length`, the body arrives in pieces.
+      const auto response = HTTP(POST(Printf("http://localhost:%d/upload", port), body));
+      EXPECT_EQ(200, static_cast<int>(response.code));
+      EXPECT_EQ(Printf("many %d %d 0\n", static_cast<int>(body.length()), Checksum(body)), response.body);
+    }
+    {
+      // Chunk-encoded, with the chunks and the lines split across the writes.
+      Connection c(current::net::ClientSocket("localhost", port));
+      c.BlockingWrite("POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nfo", true);
+      c.BlockingWrite("o\r\n4\r\nbar\n\r\n", true);
+      c.BlockingWrite("1", true);
+      c.BlockingWrite("0\r\n0123456789abcdef\r\n0\r\n\r\n", false);
+      std::string response;
+      char buffer[1024];
+      const std::string golden = Printf("many 23 %d 0\n", Checksum("foobar\n0123456789abcdef"));
+      while (response.find(golden) == std::string::npos) {
+        const size_t n = c.BlockingRead(buffer, sizeof(buffer));
+        ASSERT_GT(n, 0u) << response;
+        response.append(buffer, n);
+      }
+      EXPECT_EQ(0u, response.find("HTTP/1.1 200 OK\r\n"));
+    }
+    {
+      // An invalid chunk size is responded to with a "400".
+      Connection c(current::net::ClientSocket("localhost", port));
+      c.BlockingWrite("POST /upload HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nXYZ\r\n", false);
+      std::string response;
+      char buffer[1024];
+      while (response.find("\r\n\r\n") == std::string::npos) {
+        const size_t n = c.BlockingRead(buffer, sizeof(buffer));
+        ASSERT_GT(n, 0u) << response;
+        response.append(buffer, n);
+      }
+      EXPECT_EQ(0u, response.find("HTTP/1.1 400 Bad Request\r\n")) << response;
+    }
+  }
+
+  {
+    // The payload size limit does not apply to the routes which stream the body.
+    const std::string large_body(current::net::constants::kMaxHTTPPayloadSizeInBytes + 1, '.');
+    const auto response = HTTP(POST(Printf("http://localhost:%d/upload", FLAGS_net_api_test_port), large_body));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ(Printf("many %d %d 0\n", static_cast<int>(large_body.length()), Checksum(large_body)), response.body);
+  }
+  {
+    // For the regular routes, `ReadBody()` passes on the body which has already been read.
+    const auto response = HTTP(POST(Printf("http://localhost:%d/regular", FLAGS_net_api_test_event_loop_port), body));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    const int length = static_cast<int>(body.length());
+    EXPECT_EQ(Printf("one %d %d %d\n", length, Checksum(body), length), response.body);
+  }
+}
+
+#ifdef CURRENT_NET_HAS_REUSEPORT
+TEST(HTTPAPI, SeveralListenersShareTheRoutes) {
+  auto& server = HTTP(FLAGS_net_api_test_reuseport_port, HTTPServerOptions().Listeners(4));
+
+  // The port is taken, even though other sockets with `SO_REUSEPORT` could join in.
+  ASSERT_THROW(current::net::Socket unused(FLAGS_net_api_test_reuseport_port), current::net::SocketBindException);
+
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  {
+    const auto scope = server.Register("/thread", [&mutex, &threads](Request r) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+      }
+      r("OK\n");
+    });
+    // The handlers are run by the listeners' threads, and the kernel spreads the connections across them.
+    for (int i = 0; i < 100; ++i) {
+      const auto response = HTTP(GET(Printf("http://localhost:%d/thread", FLAGS_net_api_test_reuseport_port)));
+      EXPECT_EQ(200, static_cast<int>(response.code));
+      EXPECT_EQ("OK\n", response.body);
+    }
+  }
+  EXPECT_GT(threads.size(), 1u);
+  EXPECT_LE(threads.size(), 4u);
+
+  // Once the scope is gone, the route is gone for all the listeners.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(404,
+              static_cast<int>(
+                  HTTP(GET(Printf("http://localhost:%d/thread", FLAGS_net_api_test_reuseport_port))).code));
+  }
+}
+#endif  // CURRENT_NET_HAS_REUSEPORT
+
+TEST(HTTPAPI, AdmissionControlShedsRequestsOverTheLimits) {
+  auto& server = HTTP(FLAGS_net_api_test_event_loop_port, HTTPServerOptions().WorkerThreads(2));
+  std::atomic_bool released(false);
+  const auto blocking_handler = [&released](Request r) {
+    while (!released) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    r("Released.\n");
+  };
+  const auto scope = server.Register("/slow", blocking_handler) + server.Register("/other_slow", blocking_handler) +
+                     server.Register("/fast", [](Request r) { r("Fast.\n"); });
+  server.SetRouteAdmissionLimits("/slow",
+                                 HTTPAdmissionLimits().MaxInFlightRequests(1).RetryAfter(std::chrono::seconds(5)));
+  const auto url = [](const std::string& path) {
+    return Printf("http://localhost:%d%s", FLAGS_net_api_test_event_loop_port, path.c_str());
+  };
+  const auto wait_for = [&server](std::function<bool(const HTTPAdmissionStats&)> predicate) {
+    while (!predicate(server.AdmissionStats())) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  };
+
+  // One `/slow` request is in flight, so the second one is shed right away, while the other routes are served.
+  std::thread slow([&url]() { EXPECT_EQ("Released.\n", HTTP(GET(url("/slow"))).body); });
+  wait_for([](const HTTPAdmissionStats& stats) { return stats.routes.at("/slow").in_flight == 1u; });
+  {
+    const auto response = HTTP(GET(url("/slow")));
+    EXPECT_EQ(503, static_cast<int>(response.code));
+    EXPECT_EQ("5", response.headers.Get("Retry-After"));
+  }
+  EXPECT_EQ("Fast.\n", HTTP(GET(url("/fast"))).body);
+  {
+    const HTTPAdmissionCounters counters = server.AdmissionStats().routes.at("/slow");
+    EXPECT_EQ(1u, counters.in_flight);
+    EXPECT_EQ(1u, counters.admitted);
+    EXPECT_EQ(1u, counters.shed);
+  }
+
+  // Both handler threads are busy, so the next request is queued, and the one after it is over the queue limit.
+  // The route with no limits set is tracked too. The handler of `/fast` may still be returning, so wait for it.
+  server.SetAdmissionLimits(HTTPAdmissionLimits().MaxQueuedRequests(1));
+  server.SetRouteAdmissionLimits("/other_slow", HTTPAdmissionLimits());
+  std::thread other_slow([&url]() { EXPECT_EQ("Released.\n", HTTP(GET(url("/other_slow"))).body); });
+  wait_for([](const HTTPAdmissionStats& stats) {
+    return stats.routes.at("/other_slow").in_flight == 1u && stats.server.in_flight == 2u;
+  });
+  std::thread queued([&url]() { EXPECT_EQ("Fast.\n", HTTP(GET(url("/fast"))).body); });
+  wait_for([](const HTTPAdmissionStats& stats) { return stats.server.queued == 1u; });
+  EXPECT_EQ(503, static_cast<int>(HTTP(GET(url("/fast"))).code));
+  EXPECT_EQ(1u, server.AdmissionStats().server.shed);
+
+  released = true;
+  slow.join();
+  other_slow.join();
+  queued.join();
+  server.SetAdmissionLimits(HTTPAdmissionLimits());
+  wait_for([](const HTTPAdmissionStats& stats) {
+    return stats.server.in_flight == 0u && stats.server.queued == 0u && stats.routes.at("/slow").in_flight == 0u;
+  });
+  EXPECT_EQ(1u, server.AdmissionStats().routes.at("/other_slow").admitted);
+}
+
+TEST(HTTPAPI, ClientReusesKeepAliveConnections) {
+  // A minimalistic keep-alive server, as `HTTPServerPOSIX` closes the connection after each response.
+  // `/close` responds with `Connection: close`, and `/drop` closes the connection without saying so.
+  HTTPClientConnectionPool().Clear();
+  const int port = FLAGS_net_api_test_keep_alive_port;
+  const size_t total_connections = 5u;
+  std::atomic_size_t accepted_connections(0u);
+  std::vector<std::thread> connection_threads;
+  std::mutex connection_threads_mutex;
+  current::net::Socket socket(port);
+  std::thread server([&]() {
+    for (size_t i = 0; i < total_connections; ++i) {
+      auto connection = std::make_shared<Connection>(socket.Accept());
+      ++accepted_connections;
+      std::lock_guard<std::mutex> lock(connection_threads_mutex);
+      connection_threads.emplace_back([connection]() {
+        try {
+          while (true) {
+            const current::net::HTTPRequestData request(*connection);
+            const std::string path = request.RawPath();
+            const std::string body = "Response to " + path;
+            connection->BlockingWrite(
+                Printf("HTTP/1.1 200 OK\r\nContent-Length: %d\r\n%s\r\n%s",
+                       static_cast<int>(body.length()),
+                       path == "/close" ? "Connection: close\r\n" : "",
+                       body.c_str()),
+                false);
+            if (path == "/close" || path == "/drop") {
+              break;
+            }
+          }
+        } catch (const current::net::SocketException&) {
+          // The client has closed the connection.
+        }
+      });
+    }
+  });
+
+  const auto Get = [port](const std::string& path) {
+    return HTTP(GET(Printf("http://localhost:%d%s", port, path.c_str()))).body;
+  };
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ("Response to /ok", Get("/ok"));
+  }
+  EXPECT_EQ(1u, accepted_connections);
+  EXPECT_EQ(1u, HTTPClientConnectionPool().IdleConnectionsCount());
+
+  EXPECT_EQ("Response to /ok",
+            HTTP(GET(Printf("http://localhost:%d/ok", port)).KeepAlive(false)).body);
+  EXPECT_EQ(2u, accepted_connections);
+  EXPECT_EQ(1u, HTTPClientConnectionPool().IdleConnectionsCount());
+
+  // The server asks to close the connection, so it is not returned into the pool.
+  EXPECT_EQ("Response to /close", Get("/close"));
+  EXPECT_EQ(2u, accepted_connections);
+  EXPECT_EQ(0u, HTTPClientConnectionPool().IdleConnectionsCount());
+
+  // The server closes the pooled connection, so the next request goes over a new one.
+  EXPECT_EQ("Response to /drop", Get("/drop"));
+  EXPECT_EQ(3u, accepted_connections);
+  EXPECT_EQ(1u, HTTPClientConnectionPool().IdleConnectionsCount());
+  EXPECT_EQ("Response to /ok", Get("/ok"));
+  EXPECT_EQ(4u, accepted_connections);
+  EXPECT_EQ(1u, HTTPClientConnectionPool().IdleConnectionsCount());
+
+  // A `POST` can not be repeated if the pooled connection turns out to be closed, so it opens a new one.
+  EXPECT_EQ("Response to /post", HTTP(POST(Printf("http://localhost:%d/post", port), "body")).body);
+  EXPECT_EQ(5u, accepted_connections);
+
+  // The limits are respected.
+  HTTPClientConnectionPool().SetLimits(HTTPClientConnectionPoolLimits().MaxIdleConnections(0u));
+  EXPECT_EQ(0u, HTTPClientConnectionPool().IdleConnectionsCount());
+  HTTPClientConnectionPool().SetLimits(HTTPClientConnectionPoolLimits());
+
+  server.join();
+  HTTPClientConnectionPool().Clear();
+  for (auto& t : connection_threads) {
+    t.join();
+  }
+}
+
+#ifdef CURRENT_HTTP_HAS_ASYNC_CLIENT
+TEST(HTTPAPI, AsyncClient) {
+  const auto scope = HTTP(FLAGS_net_api_test_port)
+                         .Register("/async",
+                                   [](Request r) { r("Async " + r.method + ' ' + r.url.query["i"] + r.body); }) +
+                     HTTP(FLAGS_net_api_test_port).Register("/async_redirect", [](Request r) {
+                       r("",
+                         HTTPResponseCode.Found,
+                         current::net::constants::kDefaultHTMLContentType,
+                         Headers({{"Location", "/async?i=redirected"}}));
+                     }) +
+                     HTTP(FLAGS_net_api_test_port).Register("/async_redirect_unresolvable", [](Request r) {
+                       r("",
+                         HTTPResponseCode.Found,
+                         current::net::constants::kDefaultHTMLContentType,
+                         Headers({{"Location", "http://unresolvable.host.name.invalid/"}}));
+                     }) +
+                     HTTP(FLAGS_net_api_test_port).Register("/async_chunks", [](Request r) {
+                       auto response = r.SendChunkedResponse();
+                       response.Send("1\n");
+                       response.Send("23\n");
+                       response.Send("456\n");
+                     });
+  const std::string base_url = Printf("http://localhost:%d", FLAGS_net_api_test_port);
+
+  // Fan out many requests, with no more than four connections open at any time.
+  HTTPAsyncClient client(HTTPAsyncClientOptions().MaxConcurrentRequests(4u));
+  std::vector<std::future<HTTPResponseWithBuffer>> responses;
+  for (int i = 0; i < 50; ++i) {
+    if (i % 2) {
+      responses.push_back(client.Send(GET(base_url + "/async?i=" + current::ToString(i))));
+    } else {
+      responses.push_back(client.Send(POST(base_url + "/async?i=" + current::ToString(i), "+body")));
+    }
+  }
+  for (int i = 0; i < 50; ++i) {
+    const HTTPResponseWithBuffer response = responses[i].get();
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ(Printf("Async %s %d%s", i % 2 ? "GET" : "POST", i, i % 2 ? "" : "+body"), response.body);
+  }
+  EXPECT_EQ(0u, client.InFlightRequestsCount());
+
+  // Callbacks, and the redirects.
+  {
+    std::promise<std::string> result;
+    client.Send(GET(base_url + "/async_redirect").AllowRedirects(),
+                [&result](HTTPResponseWithBuffer&& response) { result.set_value(response.url + ' ' + response.body); },
+                [&result](std::exception_ptr e) { result.set_exception(e); });
+    EXPECT_EQ(base_url + "/async?i=redirected Async GET redirected", result.get_future().get());
+  }
+  ASSERT_THROW(client.Send(GET(base_url + "/async_redirect")).get(), current::net::HTTPRedirectNotAllowedException);
+  // The redirect targets are resolved off the thread of the client, and the failure to resolve is reported.
+  ASSERT_THROW(client.Send(GET(base_url + "/async_redirect_unresolvable").AllowRedirects()).get(),
+               current::net::SocketResolveAddressException);
+
+  // `ChunkedGET` streams the chunks.
+  {
+    std::vector<std::string> chunks;
+    std::future<current::net::HTTPResponseCodeValue> code =
+        client.Send(ChunkedGET(base_url + "/async_chunks",
+                               [](const std::string&, const std::string&) {},
+                               [&chunks](const std::string& s) { chunks.push_back(s); },
+                               [&chunks]() { chunks.push_back("DONE"); }));
+    EXPECT_EQ(200, static_cast<int>(code.get()));
+    EXPECT_EQ("1\n|23\n|456\n|DONE", current::strings::Join(chunks, '|'));
+  }
+
+  // The per-request timeout. The server accepts the connection, but never responds.
+  {
+    current::net::Socket silent_socket(FLAGS_net_api_test_silent_port);
+    const std::string silent_url = Printf("http://localhost:%d/", FLAGS_net_api_test_silent_port);
+    std::future<HTTPResponseWithBuffer> timed_out = client.Send(GET(silent_url), std::chrono::milliseconds(50));
+    std::future<HTTPResponseWithBuffer> fine = client.Send(GET(base_url + "/async?i=fine"));
+    ASSERT_THROW(timed_out.get(), current::net::HTTPRequestTimeoutException);
+    EXPECT_EQ("Async GET fine", fine.get().body);
+
+    // The time spent in the queue counts towards the timeout.
+    HTTPAsyncClient one_at_a_time_client(HTTPAsyncClientOptions().MaxConcurrentRequests(1u));
+    std::future<HTTPResponseWithBuffer> blocking = one_at_a_time_client.Send(GET(silent_url));
+    std::future<HTTPResponseWithBuffer> queued =
+        one_at_a_time_client.Send(GET(base_url + "/async?i=queued"), std::chrono::milliseconds(50));
+    ASSERT_THROW(queued.get(), current::net::HTTPRequestTimeoutException);
+    EXPECT_EQ(1u, one_at_a_time_client.InFlightRequestsCount());
+
+    // The requests still in progress fail as the client is destroyed.
+    std::unique_ptr<HTTPAsyncClient> short_lived_client(new HTTPAsyncClient());
+    std::future<HTTPResponseWithBuffer> abandoned = short_lived_client->Send(GET(silent_url));
+    short_lived_client = nullptr;
+    ASSERT_THROW(abandoned.get(), current::net::HTTPClientShutdownException);
+  }
+
+  ASSERT_THROW(client.Send(GET("http://unresolvable.host.name.invalid/")).get(),
+               current::net::SocketResolveAddressException);
+}
+#endif  // CURRENT_HTTP_HAS_ASYNC_CLIENT
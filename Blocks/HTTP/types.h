@@ -46,6 +46,10 @@ namespace http {
 // TODO(dkorolev): Add another option, to throw if the handler does not exist, while it's expected to?
 enum class ReRegisterRoute { ThrowOnAttempt, SilentlyUpdateExisting };
 
+// Whether the body of the request is read in full before the handler is called, which is the default,
+// or is left for the handler to read chunk by chunk, via `Request::ReadBody()`, while the client is still sending it.
+enum class RequestBody { ReadInFull, Streamed };
+
 // Structures to define HTTP requests.
 // The syntax for creating an instance of a GET request is GET is `GET(url)`.
 // The syntax for creating an instance of a POST request is POST is `POST(url, data, content_type)`'.
@@ -58,6 +62,8 @@ struct HTTPRequestBase {
   std::string custom_user_agent = "";
   current::net::http::Headers custom_headers;
   bool allow_redirects = false;
+  // Whether to reuse an idle connection to the same host and port, and to keep this one open afterwards.
+  bool keep_alive = true;
 
   HTTPRequestBase(const std::string& url) : url(url) {}
 
@@ -71,6 +77,11 @@ struct HTTPRequestBase {
     return static_cast<T&>(*this);
   }
 
+  T& KeepAlive(bool keep_alive_setting = true) {
+    keep_alive = keep_alive_setting;
+    return static_cast<T&>(*this);
+  }
+
   T& SetHeader(const std::string& key, const std::string& value) {
     custom_headers.emplace_back(key, value);
     return static_cast<T&>(*this);
@@ -231,21 +242,24 @@ struct HTTPImpl {
   typedef CHUNKED_CLIENT_IMPL chunked_client_impl_t;
   typedef SERVER_IMPL server_impl_t;
 
-  server_impl_t& operator()(uint16_t port) {
+  // The options, such as the number of handler threads, only apply when the server on this port is first created.
+  server_impl_t& operator()(uint16_t port,
+                            const typename server_impl_t::options_t& options = typename server_impl_t::options_t()) {
     static std::mutex mutex;
     static std::map<uint16_t, std::unique_ptr<server_impl_t>> servers;
     std::lock_guard<std::mutex> lock(mutex);
     std::unique_ptr<server_impl_t>& server = servers[port];
     if (!server) {
-      server.reset(new server_impl_t(port));
+      server.reset(new server_impl_t(port, options));
     }
     return *server;
   }
 
   // TODO(dkorolev): Deprecate the below some time in the future. And perhaps add an `http_port_t`.
-  server_impl_t& operator()(int port) {
+  server_impl_t& operator()(int port,
+                            const typename server_impl_t::options_t& options = typename server_impl_t::options_t()) {
     CURRENT_ASSERT(port > 0 && port < 65536);
-    return operator()(static_cast<uint16_t>(port));
+    return operator()(static_cast<uint16_t>(port), options);
   }
 
   template <typename REQUEST_PARAMS, typename RESPONSE_PARAMS = KeepResponseInMemory>
@@ -0,0 +1,227 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Type-evolves the whole file of a persisted stream, such as the one of Sherlock or of Storage,
+// from the schema of `FROM_NAMESPACE` into the schema of `INTO_NAMESPACE`, with the evolver of choice.
+//
+// The file is memory-mapped and cut into chunks at line breaks. The worker threads parse, evolve and serialize
+// the entries of their chunks, and the results are written into the new file in the order of the input.
+// The `idxts_t` of each entry is kept as is, and so are the `#head` and the other directives,
+// except for `#signature`, which is rewritten to carry the schema of `INTO_ENTRY` under the same names.
+
+#ifndef BLOCKS_PERSISTENCE_EVOLUTION_H
+#define BLOCKS_PERSISTENCE_EVOLUTION_H
+
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "exceptions.h"
+#include "file.h"
+
+#include "../SS/idx_ts.h"
+#include "../SS/signature.h"
+
+#include "../../Bricks/file/file.h"
+#include "../../Bricks/file/mmap.h"
+#include "../../Bricks/file/parallel_lines.h"
+#include "../../Bricks/util/make_scope_guard.h"
+#include "../../TypeSystem/Evolution/type_evolution.h"
+#include "../../TypeSystem/Schema/schema.h"
+#include "../../TypeSystem/Serialization/json.h"
+
+namespace current {
+namespace persistence {
+
+CURRENT_STRUCT(PersistedFileEvolutionStats) {
+  CURRENT_FIELD(entries, uint64_t, 0u);
+  CURRENT_FIELD(directives, uint64_t, 0u);
+  CURRENT_FIELD(bytes_read, uint64_t, 0u);
+  CURRENT_FIELD(bytes_written, uint64_t, 0u);
+  CURRENT_FIELD(elapsed, std::chrono::microseconds, std::chrono::microseconds(0));
+
+  double EntriesPerSecond() const { return elapsed.count() ? 1e6 * entries / elapsed.count() : 0.0; }
+  double MegabytesPerSecond() const { return elapsed.count() ? 1.0 * bytes_read / elapsed.count() : 0.0; }
+};
+
+namespace impl {
+
+struct EvolvedPersistedFileChunk {
+  std::string output;
+  uint64_t entries = 0u;
+  uint64_t directives = 0u;
+  // The first and the last `idxts_t` of the chunk, to validate the order of the entries across the chunks.
+  idxts_t first;
+  idxts_t last;
+};
+
+template <typename FROM_NAMESPACE, typename FROM_ENTRY, typename INTO_NAMESPACE, typename INTO_ENTRY, typename EVOLVER>
+class PersistedFileEvolver final {
+ public:
+  PersistedFileEvolver() {
+    reflection::StructSchema struct_schema;
+    struct_schema.AddType<INTO_ENTRY>();
+    into_schema_ = struct_schema.GetSchemaInfo();
+  }
+
+  // Validates the order of the entries within the chunk the same way `IteratorOverFileOfPersistedEntries` does.
+  void EvolveChunk(const char* begin, const char* end, EvolvedPersistedFileChunk& chunk) const {
+    chunk.output.reserve(static_cast<size_t>(end - begin) + static_cast<size_t>(end - begin) / 4u);
+    ForEachLine(begin, end, [this, &chunk](const char* line, const char* line_end) {
+      if (line_end == line) {
+        return;
+      }
+      if (*line == constants::kDirectiveMarker) {
+        EvolveDirective(line, line_end, chunk.output);
+        ++chunk.directives;
+        return;
+      }
+      const char* tab = static_cast<const char*>(std::memchr(line, '\t', static_cast<size_t>(line_end - line)));
+      if (!tab) {
+        CURRENT_THROW(MalformedEntryException(std::string(line, line_end)));
+      }
+      idxts_t current;
+      ParseJSON(line, static_cast<size_t>(tab - line), current);
+      if (chunk.entries) {
+        if (current.index != chunk.last.index + 1u) {
+          CURRENT_THROW(ss::InconsistentIndexException(chunk.last.index + 1u, current.index));
+        }
+        if (!(current.us > chunk.last.us)) {
+          CURRENT_THROW(ss::InconsistentTimestampException(chunk.last.us + std::chrono::microseconds(1), current.us));
+        }
+      } else {
+        chunk.first = current;
+      }
+      chunk.last = current;
+      ++chunk.entries;
+
+      FROM_ENTRY from;
+      ParseJSON(tab + 1, static_cast<size_t>(line_end - tab - 1), from);
+      INTO_ENTRY into;
+      type_evolution::Evolve<FROM_NAMESPACE, FROM_ENTRY, EVOLVER>::template Go<INTO_NAMESPACE>(from, into);
+      chunk.output.append(line, tab + 1);
+      JSONAppend(chunk.output, into);
+      chunk.output += '\n';
+    });
+  }
+
+ private:
+  void EvolveDirective(const char* line, const char* line_end, std::string& output) const {
+    static const size_t signature_key_length = strlen(constants::kSignatureDirective);
+    if (static_cast<size_t>(line_end - line) > signature_key_length &&
+        !std::memcmp(line, constants::kSignatureDirective, signature_key_length) &&
+        std::isspace(line[signature_key_length])) {
+      const auto names = ParseJSON<ss::StreamNamespaceName>(std::string(line + signature_key_length, line_end));
+      output += constants::kSignatureDirective;
+      output += ' ';
+      JSONAppend(output, ss::StreamSignature(names, into_schema_));
+    } else {
+      output.append(line, line_end);
+    }
+    output += '\n';
+  }
+
+  reflection::SchemaInfo into_schema_;
+};
+
+}  // namespace current::persistence::impl
+
+// Reads the persisted file `from_file_name` and writes the evolved one into `into_file_name`, overwriting it.
+// The evolved file is written under a temporary name and renamed once complete, so that an exception thrown
+// halfway leaves `into_file_name` as it was. `threads` is the number of the worker threads, zero for one per core.
+template <typename FROM_NAMESPACE,
+          typename FROM_ENTRY,
+          typename INTO_NAMESPACE,
+          typename INTO_ENTRY,
+          typename EVOLVER = type_evolution::NaturalEvolver>
+PersistedFileEvolutionStats EvolvePersistedFile(const std::string& from_file_name,
+                                                const std::string& into_file_name,
+                                                size_t threads = 0u) {
+  const auto start = std::chrono::steady_clock::now();
+  PersistedFileEvolutionStats stats;
+
+  if (from_file_name == into_file_name) {
+    CURRENT_THROW(PersistenceEvolutionIntoTheSameFileException(from_file_name));
+  }
+
+  const MemoryMappedFile from_file(from_file_name);
+  const std::string tmp_file_name = into_file_name + ".tmp";
+  std::ofstream into_file(tmp_file_name, std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+  if (!into_file) {
+    CURRENT_THROW(PersistenceFileNotWritable(tmp_file_name));
+  }
+  bool renamed = false;
+  const auto tmp_file_remover = MakeScopeGuard([&tmp_file_name, &renamed]() {
+    if (!renamed) {
+      FileSystem::RmFile(tmp_file_name, FileSystem::RmFileParameters::Silent);
+    }
+  });
+
+  const impl::PersistedFileEvolver<FROM_NAMESPACE, FROM_ENTRY, INTO_NAMESPACE, INTO_ENTRY, EVOLVER> evolver;
+  ParallelLineChunks<impl::EvolvedPersistedFileChunk> chunks(
+      from_file.Data(),
+      from_file.Data() + from_file.Size(),
+      threads,
+      [&evolver](const char* begin, const char* end, impl::EvolvedPersistedFileChunk& chunk) {
+        evolver.EvolveChunk(begin, end, chunk);
+      });
+
+  idxts_t next(0u, std::chrono::microseconds(0));
+  chunks.Run([&](impl::EvolvedPersistedFileChunk& chunk) {
+    if (chunk.entries) {
+      if (chunk.first.index != next.index) {
+        CURRENT_THROW(ss::InconsistentIndexException(next.index, chunk.first.index));
+      }
+      if (chunk.first.us < next.us) {
+        CURRENT_THROW(ss::InconsistentTimestampException(next.us, chunk.first.us));
+      }
+      next = idxts_t(chunk.last.index + 1u, chunk.last.us + std::chrono::microseconds(1));
+    }
+    into_file.write(chunk.output.data(), chunk.output.length());
+    if (!into_file) {
+      CURRENT_THROW(PersistenceFileNotWritable(tmp_file_name));
+    }
+    stats.entries += chunk.entries;
+    stats.directives += chunk.directives;
+    stats.bytes_written += chunk.output.length();
+  });
+  into_file.close();
+  if (!into_file) {
+    CURRENT_THROW(PersistenceFileNotWritable(tmp_file_name));  // LCOV_EXCL_LINE
+  }
+  FileSystem::RenameFile(tmp_file_name, into_file_name);
+  renamed = true;
+
+  stats.bytes_read = from_file.Size();
+  stats.elapsed =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+  return stats;
+}
+
+}  // namespace current::persistence
+}  // namespace current
+
+#endif  // BLOCKS_PERSISTENCE_EVOLUTION_H
@@ -59,6 +59,11 @@ struct InvalidSignatureLocation : PersistenceException {
   using PersistenceException::PersistenceException;
 };
 
+struct PersistenceEvolutionIntoTheSameFileException : PersistenceException {
+  explicit PersistenceEvolutionIntoTheSameFileException(const std::string& filename)
+      : PersistenceException("Cannot evolve the persisted file into itself: `" + filename + "`.") {}
+};
+
 struct PersistenceMemoryBlockNoLongerAvailable : InGracefulShutdownException {
   using InGracefulShutdownException::InGracefulShutdownException;
 };
@@ -134,10 +134,11 @@ class FilePersister {
     std::fstream head_rewriter;
 
     // `offset.size() == end.next_index`, and `offset[i]` is the offset in bytes where the line for index `i` begins.
-    std::mutex& mutex_ref;  // Guards `offset`, `head_offset` and `timestamp`.
+    std::mutex& mutex_ref;  // Guards `offset`, `head_offset`, `timestamp` and `line`.
     std::vector<std::streampos> offset;
     std::streamoff head_offset;
     std::vector<std::chrono::microseconds> timestamp;
+    std::string line;  // Reused for every entry appended, to not allocate per entry.
 
     // Just `std::atomic<end_t> end;` won't work in g++ until 5.1, ref.
     // http://stackoverflow.com/questions/29824570/segfault-in-stdatomic-load/29824840#29824840
@@ -439,26 +440,22 @@ class FilePersister {
   template <current::locks::MutexLockStatus MLS, typename E, typename US>
   idxts_t DoPublish(E&& entry, const US us) {
     current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->mutex_ref);
+    const idxts_t result = AppendEntry(std::forward<E>(entry), current::time::GetTimestampFromLockedSection(us));
+    file_persister_impl_->appender.flush();
+    return result;
+  }
 
-    end_t iterator = file_persister_impl_->end.load();
-    const auto timestamp = current::time::GetTimestampFromLockedSection(us);
-    if (!(timestamp > iterator.head)) {
-      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
+  // Appends the entries one after another, under the same lock, and flushes the file once, after the last one.
+  template <current::locks::MutexLockStatus MLS, typename E>
+  idxts_t DoPublishBatch(std::vector<E>&& entries, const std::vector<std::chrono::microseconds>& timestamps) {
+    CURRENT_ASSERT(entries.size() == timestamps.size());
+    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->mutex_ref);
+    idxts_t result;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      result = AppendEntry(std::move(entries[i]), timestamps[i]);
     }
-
-    iterator.last_entry_us = iterator.head = timestamp;
-    const auto current = idxts_t(iterator.next_index, iterator.last_entry_us);
-    CURRENT_ASSERT(file_persister_impl_->offset.size() == iterator.next_index);
-    CURRENT_ASSERT(file_persister_impl_->timestamp.size() == iterator.next_index);
-    file_persister_impl_->offset.push_back(file_persister_impl_->appender.tellp());
-    file_persister_impl_->timestamp.push_back(timestamp);
-
-    file_persister_impl_->appender << JSON(current) << '\t' << JSON(std::forward<E>(entry)) << std::endl;
-    ++iterator.next_index;
-    file_persister_impl_->head_offset = 0;
-    file_persister_impl_->end.store(iterator);
-
-    return current;
+    file_persister_impl_->appender.flush();
+    return result;
   }
 
   template <current::locks::MutexLockStatus MLS, typename US>
@@ -494,6 +491,8 @@ class FilePersister {
     return file_persister_impl_->end.load().next_index;
   }
 
+  const std::string& FileName() const noexcept { return file_persister_impl_->filename; }
+
   idxts_t LastPublishedIndexAndTimestamp() const {
     const auto iterator = file_persister_impl_->end.load();
     if (iterator.next_index) {
@@ -583,6 +582,35 @@ class FilePersister {
   }
 
  private:
+  // Writes the entry into the file without flushing it. Must be called with the mutex locked.
+  template <typename E>
+  idxts_t AppendEntry(E&& entry, const std::chrono::microseconds timestamp) {
+    end_t iterator = file_persister_impl_->end.load();
+    if (!(timestamp > iterator.head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
+    }
+
+    iterator.last_entry_us = iterator.head = timestamp;
+    const auto current = idxts_t(iterator.next_index, iterator.last_entry_us);
+    CURRENT_ASSERT(file_persister_impl_->offset.size() == iterator.next_index);
+    CURRENT_ASSERT(file_persister_impl_->timestamp.size() == iterator.next_index);
+    file_persister_impl_->offset.push_back(file_persister_impl_->appender.tellp());
+    file_persister_impl_->timestamp.push_back(timestamp);
+
+    std::string& line = file_persister_impl_->line;
+    line.clear();
+    JSONAppend(line, current);
+    line += '\t';
+    JSONAppend(line, entry);
+    line += '\n';
+    file_persister_impl_->appender.write(line.data(), line.length());
+    ++iterator.next_index;
+    file_persister_impl_->head_offset = 0;
+    file_persister_impl_->end.store(iterator);
+
+    return current;
+  }
+
   mutable ScopeOwnedByMe<FilePersisterImpl> file_persister_impl_;
 };
 
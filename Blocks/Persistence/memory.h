@@ -34,6 +34,7 @@ SOFTWARE.
 #include <deque>
 #include <functional>
 #include <mutex>
+#include <vector>
 
 #include "exceptions.h"
 
@@ -113,7 +114,11 @@ class MemoryPersister {
       }
       std::lock_guard<std::mutex> lock(container_->mutex_ref);
       const auto& entry = container_->entries[i_];
-      return JSON(idxts_t(i_, entry.first)) + '\t' + JSON(entry.second);
+      std::string result;
+      JSONAppend(result, idxts_t(i_, entry.first));
+      result += '\t';
+      JSONAppend(result, entry.second);
+      return result;
     }
     IteratorUnsafe& operator++() {
       if (!valid_) {
@@ -173,6 +178,17 @@ class MemoryPersister {
     return idxts_t(index, timestamp);
   }
 
+  template <current::locks::MutexLockStatus MLS, typename E>
+  idxts_t DoPublishBatch(std::vector<E>&& entries, const std::vector<std::chrono::microseconds>& timestamps) {
+    CURRENT_ASSERT(entries.size() == timestamps.size());
+    current::locks::SmartMutexLockGuard<MLS> lock(container_->mutex_ref);
+    idxts_t result;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      result = DoPublish<current::locks::MutexLockStatus::AlreadyLocked>(std::move(entries[i]), timestamps[i]);
+    }
+    return result;
+  }
+
   template <current::locks::MutexLockStatus MLS, typename US>
   void DoUpdateHead(const US us) {
     current::locks::SmartMutexLockGuard<MLS> lock(container_->mutex_ref);
@@ -644,6 +644,59 @@ TEST(PersistenceLayer, FileExceptions) {
   }
 }
 
+TEST(PersistenceLayer, PublishBatch) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  const auto Contents = [](const current::persistence::File<StorableString>& impl) {
+    std::vector<std::string> result;
+    for (const auto& e : impl.Iterate()) {
+      result.push_back(Printf(
+          "%s %d %d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.index), static_cast<int>(e.idx_ts.us.count())));
+    }
+    return Join(result, ",");
+  };
+
+  {
+    std::mutex mutex;
+    current::persistence::Memory<std::string> impl(mutex, namespace_name);
+    impl.Publish("foo", std::chrono::microseconds(100));
+    const auto last =
+        impl.PublishBatch({"bar", "baz"}, {std::chrono::microseconds(200), std::chrono::microseconds(300)});
+    EXPECT_EQ(2u, last.index);
+    EXPECT_EQ(300, last.us.count());
+    EXPECT_EQ(3u, impl.Size());
+    ASSERT_THROW(impl.PublishBatch({"meh"}, {std::chrono::microseconds(300)}),
+                 current::ss::InconsistentTimestampException);
+  }
+
+  {
+    std::mutex mutex;
+    current::persistence::File<StorableString> impl(mutex, namespace_name, persistence_file_name);
+    current::time::SetNow(std::chrono::microseconds(100));
+    impl.Publish(StorableString("foo"));
+    const auto last = impl.PublishBatch({StorableString("bar"), StorableString("baz")},
+                                        {std::chrono::microseconds(200), std::chrono::microseconds(300)});
+    EXPECT_EQ(2u, last.index);
+    EXPECT_EQ(300, last.us.count());
+    EXPECT_EQ("foo 0 100,bar 1 200,baz 2 300", Contents(impl));
+    ASSERT_THROW(impl.PublishBatch({StorableString("meh")}, {std::chrono::microseconds(300)}),
+                 current::ss::InconsistentTimestampException);
+  }
+
+  {
+    // The whole batch has been flushed into the file.
+    std::mutex mutex;
+    current::persistence::File<StorableString> impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ("foo 0 100,bar 1 200,baz 2 300", Contents(impl));
+  }
+}
+
 TEST(PersistenceLayer, FileSignatureExceptions) {
   using namespace persistence_test;
 
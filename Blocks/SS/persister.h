@@ -26,6 +26,8 @@ SOFTWARE.
 #ifndef BLOCKS_SS_PERSISTER_H
 #define BLOCKS_SS_PERSISTER_H
 
+#include <vector>
+
 #include "idx_ts.h"
 
 #include "../../Bricks/sync/locks.h"
@@ -65,6 +67,12 @@ class EntryPersister : public GenericEntryPersister<ENTRY>, public IMPL {
   IndexAndTimestamp Publish(ENTRY&& e, std::chrono::microseconds us) {
     return IMPL::template DoPublish<MLS>(std::move(e), us);
   }
+  // Publishes `entries[i]` at `timestamps[i]`, in order, and returns the index and timestamp of the last entry.
+  template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
+  IndexAndTimestamp PublishBatch(std::vector<ENTRY>&& entries,
+                                 const std::vector<std::chrono::microseconds>& timestamps) {
+    return IMPL::template DoPublishBatch<MLS>(std::move(entries), timestamps);
+  }
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
   void UpdateHead() {
     return IMPL::template DoUpdateHead<MLS>(current::time::DefaultTimeArgument());
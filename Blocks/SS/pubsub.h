@@ -28,6 +28,8 @@ SOFTWARE.
 
 #include "../../port.h"
 
+#include <vector>
+
 #include "idx_ts.h"
 
 #include "../../TypeSystem/variant.h"
@@ -68,6 +70,10 @@ class EntryPublisher : public GenericEntryPublisher<ENTRY>, public IMPL {
     return IMPL::template DoPublish<MLS>(std::move(e), us);
   }
   template <MutexLockStatus MLS = MutexLockStatus::NeedToLock>
+  idxts_t PublishBatch(std::vector<ENTRY>&& entries, const std::vector<std::chrono::microseconds>& timestamps) {
+    return IMPL::template DoPublishBatch<MLS>(std::move(entries), timestamps);
+  }
+  template <MutexLockStatus MLS = MutexLockStatus::NeedToLock>
   void UpdateHead() {
     IMPL::template DoUpdateHead<MLS>(current::time::DefaultTimeArgument());
   }
@@ -0,0 +1,103 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The read-only view of the contents of the file. Memory-mapped, except on Windows, where the file is read in full.
+
+#ifndef BRICKS_FILE_MMAP_H
+#define BRICKS_FILE_MMAP_H
+
+#include "../port.h"
+
+#include <string>
+
+#ifndef CURRENT_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // CURRENT_WINDOWS
+
+#include "exceptions.h"
+#include "file.h"
+
+namespace current {
+
+class MemoryMappedFile final {
+ public:
+  explicit MemoryMappedFile(const std::string& file_name) {
+#ifndef CURRENT_WINDOWS
+    const int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+      CURRENT_THROW(CannotReadFileException(file_name));
+    }
+    struct stat info;
+    if (::fstat(fd, &info)) {
+      ::close(fd);                                        // LCOV_EXCL_LINE
+      CURRENT_THROW(CannotReadFileException(file_name));  // LCOV_EXCL_LINE
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    // Zero-length mappings are not allowed, and not needed.
+    if (size_) {
+      void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        ::close(fd);                                        // LCOV_EXCL_LINE
+        CURRENT_THROW(CannotReadFileException(file_name));  // LCOV_EXCL_LINE
+      }
+      data_ = static_cast<const char*>(data);
+    }
+    // The mapping stays valid after the file is closed.
+    ::close(fd);
+#else
+    contents_ = FileSystem::ReadFileAsString(file_name);
+    data_ = contents_.data();
+    size_ = contents_.length();
+#endif  // CURRENT_WINDOWS
+  }
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+  ~MemoryMappedFile() {
+#ifndef CURRENT_WINDOWS
+    if (data_) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif  // CURRENT_WINDOWS
+  }
+
+  // Not null-terminated.
+  const char* Data() const { return data_; }
+  size_t Size() const { return size_; }
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0u;
+#ifdef CURRENT_WINDOWS
+  std::string contents_;
+#endif  // CURRENT_WINDOWS
+};
+
+}  // namespace current
+
+#endif  // BRICKS_FILE_MMAP_H
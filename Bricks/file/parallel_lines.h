@@ -0,0 +1,185 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Processes a buffer of lines, such as a memory-mapped file, in parallel, keeping the order of the input.
+// The buffer is cut into chunks at line breaks, the chunks are processed by the worker threads,
+// and the per-chunk results are handed over to the calling thread in the order of the chunks.
+
+#ifndef BRICKS_FILE_PARALLEL_LINES_H
+#define BRICKS_FILE_PARALLEL_LINES_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace current {
+
+template <typename RESULT>
+class ParallelLineChunks final {
+ public:
+  using process_t = std::function<void(const char* begin, const char* end, RESULT& result)>;
+
+  // Smaller chunks are not worth the synchronization.
+  constexpr static size_t kMinChunkSize = 64u * 1024u;
+  // More chunks than threads balance the load when the lines vary in length.
+  constexpr static size_t kChunksPerThread = 4u;
+
+  // `threads` is the number of the worker threads, zero for one per core.
+  ParallelLineChunks(const char* begin, const char* end, size_t threads, process_t process)
+      : process_(std::move(process)) {
+    threads = DefaultThreads(threads);
+    const size_t chunk_size = std::max(static_cast<size_t>(end - begin) / (threads * kChunksPerThread), kMinChunkSize);
+    while (begin < end) {
+      const char* chunk_end = (static_cast<size_t>(end - begin) > chunk_size) ? begin + chunk_size : end;
+      if (chunk_end < end) {
+        const void* line_end = std::memchr(chunk_end, '\n', static_cast<size_t>(end - chunk_end));
+        chunk_end = line_end ? static_cast<const char*>(line_end) + 1 : end;
+      }
+      chunks_.emplace_back(begin, chunk_end);
+      begin = chunk_end;
+    }
+    // Each thread runs at most a couple of chunks ahead of the consumer, to not hold the whole input processed.
+    window_ = threads * 2u;
+    threads = std::min(threads, chunks_.size());
+    for (size_t i = 0u; i < threads; ++i) {
+      threads_.emplace_back([this]() { WorkerThread(); });
+    }
+  }
+
+  ~ParallelLineChunks() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    condition_variable_.notify_all();
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Calls `f(RESULT& result)` from the calling thread, for each chunk, in the order of the input.
+  // If processing a chunk has thrown, rethrows that exception once the preceding chunks have been handed over.
+  template <typename F>
+  void Run(F&& f) {
+    for (Chunk& chunk : chunks_) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_variable_.wait(lock, [&chunk]() { return chunk.done; });
+      }
+      if (chunk.error) {
+        std::rethrow_exception(chunk.error);
+      }
+      f(chunk.result);
+      chunk.result = RESULT();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++consumed_;
+      }
+      condition_variable_.notify_all();
+    }
+  }
+
+  static size_t DefaultThreads(size_t threads) {
+    if (!threads) {
+      threads = std::thread::hardware_concurrency();
+    }
+    return threads ? threads : 1u;
+  }
+
+ private:
+  struct Chunk {
+    const char* const begin;
+    const char* const end;
+    RESULT result;
+    std::exception_ptr error;
+    bool done = false;
+
+    Chunk(const char* begin, const char* end) : begin(begin), end(end) {}
+  };
+
+  void WorkerThread() {
+    while (true) {
+      Chunk* chunk;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_variable_.wait(
+            lock, [this]() { return stop_ || (next_chunk_ < chunks_.size() && next_chunk_ < consumed_ + window_); });
+        if (stop_ || next_chunk_ >= chunks_.size()) {
+          return;
+        }
+        chunk = &chunks_[next_chunk_++];
+      }
+      try {
+        process_(chunk->begin, chunk->end, chunk->result);
+      } catch (...) {
+        chunk->error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        chunk->done = true;
+      }
+      condition_variable_.notify_all();
+    }
+  }
+
+  const process_t process_;
+  std::vector<Chunk> chunks_;
+  size_t window_;
+  std::vector<std::thread> threads_;
+  std::mutex mutex_;
+  std::condition_variable condition_variable_;
+  size_t next_chunk_ = 0u;  // The next chunk to process.
+  size_t consumed_ = 0u;    // The number of the chunks handed over.
+  bool stop_ = false;
+};
+
+template <typename RESULT>
+constexpr size_t ParallelLineChunks<RESULT>::kMinChunkSize;
+
+template <typename RESULT>
+constexpr size_t ParallelLineChunks<RESULT>::kChunksPerThread;
+
+// Calls `f(const char* begin, const char* end)` for each line in `[begin, end)`, without the trailing "\r\n" or "\n".
+template <typename F>
+inline void ForEachLine(const char* begin, const char* end, F&& f) {
+  while (begin < end) {
+    const void* newline = std::memchr(begin, '\n', static_cast<size_t>(end - begin));
+    const char* next_line = newline ? static_cast<const char*>(newline) + 1 : end;
+    const char* line_end = newline ? static_cast<const char*>(newline) : end;
+    if (line_end > begin && line_end[-1] == '\r') {
+      --line_end;
+    }
+    f(begin, line_end);
+    begin = next_line;
+  }
+}
+
+}  // namespace current
+
+#endif  // BRICKS_FILE_PARALLEL_LINES_H
@@ -28,13 +28,16 @@ SOFTWARE.
 #include <vector>
 
 #include "file.h"
+#include "mmap.h"
 
 #include "../dflags/dflags.h"
 #include "../strings/join.h"
 #include "../../3rdparty/gtest/gtest-main-with-dflags.h"
 
 using current::FileSystem;
+using current::MemoryMappedFile;
 using current::FileException;
+using current::CannotReadFileException;
 using current::DirDoesNotExistException;
 using current::PathNotDirException;
 using current::DirNotEmptyException;
@@ -224,6 +227,26 @@ TEST(File, ScopedRmFile) {
   ASSERT_THROW(FileSystem::ReadFileAsString(fn), FileException);
 }
 
+TEST(File, MemoryMappedFile) {
+  // Required for Windows tests.
+  FileSystem::MkDir(FLAGS_file_test_tmpdir, FileSystem::MkDirParameters::Silent);
+
+  const std::string fn = FileSystem::JoinPath(FLAGS_file_test_tmpdir, "mmap");
+  const auto file_remover = FileSystem::ScopedRmFile(fn);
+
+  FileSystem::WriteStringToFile("Mapped\n", fn.c_str());
+  {
+    const MemoryMappedFile file(fn);
+    EXPECT_EQ("Mapped\n", std::string(file.Data(), file.Size()));
+  }
+
+  FileSystem::WriteStringToFile("", fn.c_str());
+  EXPECT_EQ(0u, MemoryMappedFile(fn).Size());
+
+  FileSystem::RmFile(fn);
+  ASSERT_THROW(MemoryMappedFile(fn).Size(), CannotReadFileException);
+}
+
 TEST(File, ScanDir) {
   // Required for Windows tests.
   FileSystem::MkDir(FLAGS_file_test_tmpdir, FileSystem::MkDirParameters::Silent);
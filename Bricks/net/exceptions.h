@@ -77,6 +77,7 @@ struct SocketResolveAddressException : ClientSocketException {
 
 struct SocketFcntlException : SocketException {};
 struct SocketReadException : SocketException {};  // LCOV_EXCL_LINE -- TODO(dkorolev): We might want to test it.
+struct SocketReadTimeoutException : SocketReadException {};
 struct SocketWriteException : SocketException {};
 struct SocketCouldNotWriteEverythingException : SocketWriteException {};
 
@@ -100,6 +101,11 @@ struct HTTPRedirectLoopException : HTTPException {
   using HTTPException::HTTPException;
 };
 struct HTTPPayloadTooLarge : HTTPException {};
+struct HTTPRequestTimeoutException : HTTPException {};
+struct HTTPClientShutdownException : HTTPException {};
+struct HTTPMalformedResponseException : HTTPException {
+  using HTTPException::HTTPException;
+};
 struct ChunkSizeNotAValidHEXValue : HTTPException {};
 
 // AttemptedToSendHTTPResponseMoreThanOnce is a user code exception; not really an HTTP one.
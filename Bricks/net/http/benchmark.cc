@@ -0,0 +1,138 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// HTTP request header parsing microbenchmarks.
+//
+// 1) Scanning a typical browser request for line ends and key-value separators:
+//    `strstr()` + `strchr()`, as the parser used to, vs. the scalar and the vectorized `http::scan` primitives.
+// 2) Parsing the whole request with `GenericHTTPRequestData`, with and without accessing the headers.
+//
+// Build with `-mavx2` or `-march=native` to benchmark the AVX2 code path, SSE2 is used on x86-64 by default.
+
+#include "../../port.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "http.h"
+
+#include "../../dflags/dflags.h"
+#include "../../time/chrono.h"
+
+DEFINE_uint32(iterations, 1000000, "The number of times to scan the request.");
+DEFINE_uint32(parse_iterations, 100000, "The number of times to parse the request in full.");
+DEFINE_int32(port, 8383, "The local port to use to parse the request in full.");
+
+namespace scan = current::net::http::scan;
+
+static const std::string kRequest =
+    "GET /static/js/application.min.js?version=20170830 HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "Connection: keep-alive\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/60.0.3112.113\r\n"
+    "Accept: */*\r\n"
+    "Referer: https://www.example.com/static/index.html\r\n"
+    "Accept-Encoding: gzip, deflate, br\r\n"
+    "Accept-Language: en-US,en;q=0.8,ru;q=0.6\r\n"
+    "Cookie: session=0123456789abcdef0123456789abcdef; preferences=compact; _ga=GA1.2.1234567890.1234567890\r\n"
+    "If-None-Match: \"5a3c-59a6b9c0\"\r\n"
+    "If-Modified-Since: Wed, 30 Aug 2017 12:00:00 GMT\r\n"
+    "\r\n";
+
+template <typename F>
+void Measure(const char* name, uint32_t iterations, F&& f) {
+  size_t checksum = 0u;
+  const auto begin = current::time::Now();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    checksum += f();
+  }
+  const auto end = current::time::Now();
+  const double ns = 1e3 * (end - begin).count() / iterations;
+  std::cout << name << ": " << ns << "ns per request (checksum " << checksum << ")." << std::endl;
+}
+
+// Returns the total length of the header keys, to make sure the work is not optimized away.
+size_t ScanLegacy(std::string& buffer) {
+  size_t result = 0u;
+  char* line = &buffer[0];
+  char* crlf;
+  while ((crlf = strstr(line, "\r\n")) && crlf != line) {
+    *crlf = '\0';
+    const char* colon = strchr(line, ':');
+    if (colon) {
+      result += colon - line;
+    }
+    *crlf = '\r';
+    line = crlf + 2;
+  }
+  return result;
+}
+
+template <const char* (*FIND_BYTE)(const char*, const char*, char),
+          const char* (*FIND_CR_OR_LF)(const char*, const char*)>
+size_t Scan(const std::string& buffer) {
+  size_t result = 0u;
+  const char* line = buffer.data();
+  const char* const end = buffer.data() + buffer.length();
+  while (true) {
+    const char* crlf = FIND_CR_OR_LF(line, end);
+    if (crlf == end || crlf == line) {
+      break;
+    }
+    const char* colon = FIND_BYTE(line, crlf, ':');
+    if (colon != crlf) {
+      result += colon - line;
+    }
+    line = crlf + 2;
+  }
+  return result;
+}
+
+int main(int argc, char** argv) {
+  ParseDFlags(&argc, &argv);
+
+  std::cout << "Vectorized implementation: " << scan::VectorizedImplementationName() << '.' << std::endl;
+
+  std::string mutable_request = kRequest;
+  Measure("strstr() + strchr()", FLAGS_iterations, [&]() { return ScanLegacy(mutable_request); });
+  Measure("Scalar scan", FLAGS_iterations, [&]() {
+    return Scan<scan::scalar::FindByte, scan::scalar::FindCROrLF>(kRequest);
+  });
+  Measure("Vectorized scan", FLAGS_iterations, [&]() { return Scan<scan::FindByte, scan::FindCROrLF>(kRequest); });
+
+  // Parse the request from a real connection, which has the request "received ahead" before each parse.
+  current::net::Socket socket(FLAGS_port);
+  current::net::Connection client(current::net::ClientSocket("localhost", FLAGS_port));
+  current::net::Connection server(socket.Accept());
+  Measure("Parse, no headers accessed", FLAGS_parse_iterations, [&]() {
+    server.SetReceivedAhead(kRequest);
+    const current::net::HTTPRequestData request(server);
+    return request.RawPath().length();
+  });
+  Measure("Parse, all headers accessed", FLAGS_parse_iterations, [&]() {
+    server.SetReceivedAhead(kRequest);
+    const current::net::HTTPRequestData request(server);
+    return request.RawPath().length() + request.headers().size();
+  });
+}
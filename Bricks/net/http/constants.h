@@ -49,10 +49,16 @@ constexpr char kContentLengthHeaderKey[] = "Content-Length";
 constexpr char kTransferEncodingHeaderKey[] = "Transfer-Encoding";
 constexpr char kTransferEncodingChunkedValue[] = "chunked";
 constexpr char kHTTPMethodOverrideHeaderKey[] = "X-HTTP-Method-Override";
+constexpr char kConnectionHeaderKey[] = "Connection";
+constexpr char kConnectionCloseValue[] = "close";
+constexpr char kConnectionKeepAliveValue[] = "keep-alive";
 
 constexpr char kHTTPAccessControlAllowOriginHeaderName[] = "Access-Control-Allow-Origin";
 constexpr char kHTTPAccessControlAllowOriginHeaderValue[] = "*";
 
+// How long the client waits for the response over a reused keep-alive connection before giving up on it.
+constexpr int kKeepAliveResponseTimeoutInMilliseconds = 30 * 1000;
+
 #ifndef CURRENT_MAX_HTTP_PAYLOAD
 constexpr size_t kMaxHTTPPayloadSizeInBytes = 1024 * 1024 * 16;
 #else
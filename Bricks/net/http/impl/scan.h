@@ -0,0 +1,164 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The primitives the HTTP parser uses to find the line ends and the header key-value separators.
+// Compare 32 bytes at a time with AVX2, or 16 bytes at a time with SSE2, whichever the compiler is allowed to emit,
+// and fall back to the scalar code for the tail of the buffer, and on other architectures.
+
+#ifndef BRICKS_NET_HTTP_IMPL_SCAN_H
+#define BRICKS_NET_HTTP_IMPL_SCAN_H
+
+#include "../../../port.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) || defined(__clang__)
+#if defined(__AVX2__)
+#define CURRENT_HTTP_SCAN_AVX2
+#include <immintrin.h>
+#endif  // defined(__AVX2__)
+#if defined(__SSE2__)
+#define CURRENT_HTTP_SCAN_SSE2
+#include <emmintrin.h>
+#endif  // defined(__SSE2__)
+#endif  // defined(__GNUC__) || defined(__clang__)
+
+namespace current {
+namespace net {
+namespace http {
+namespace scan {
+
+// The names of the implementations compiled in, for the benchmarks to report.
+inline const char* VectorizedImplementationName() {
+#if defined(CURRENT_HTTP_SCAN_AVX2)
+  return "AVX2";
+#elif defined(CURRENT_HTTP_SCAN_SSE2)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
+
+namespace scalar {
+
+// Returns the pointer to the first `c` in `[begin, end)`, or `end` if there is none.
+inline const char* FindByte(const char* begin, const char* end, char c) {
+  if (begin < end) {
+    const void* result = std::memchr(begin, c, static_cast<size_t>(end - begin));
+    return result ? static_cast<const char*>(result) : end;
+  } else {
+    return end;
+  }
+}
+
+// Returns the pointer to the first CR or LF in `[begin, end)`, or `end` if there is none.
+inline const char* FindCROrLF(const char* begin, const char* end) {
+  while (begin < end && *begin != '\r' && *begin != '\n') {
+    ++begin;
+  }
+  return begin;
+}
+
+}  // namespace current::net::http::scan::scalar
+
+// Returns the pointer to the first `c` in `[begin, end)`, or `end` if there is none.
+inline const char* FindByte(const char* begin, const char* end, char c) {
+#if defined(CURRENT_HTTP_SCAN_AVX2)
+  const __m256i needle32 = _mm256_set1_epi8(c);
+  while (end - begin >= 32) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+    const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle32)));
+    if (mask) {
+      return begin + __builtin_ctz(mask);
+    }
+    begin += 32;
+  }
+#endif
+#if defined(CURRENT_HTTP_SCAN_SSE2)
+  const __m128i needle16 = _mm_set1_epi8(c);
+  while (end - begin >= 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle16)));
+    if (mask) {
+      return begin + __builtin_ctz(mask);
+    }
+    begin += 16;
+  }
+#endif
+  return scalar::FindByte(begin, end, c);
+}
+
+// Returns the pointer to the first CR or LF in `[begin, end)`, or `end` if there is none.
+inline const char* FindCROrLF(const char* begin, const char* end) {
+#if defined(CURRENT_HTTP_SCAN_AVX2)
+  const __m256i cr32 = _mm256_set1_epi8('\r');
+  const __m256i lf32 = _mm256_set1_epi8('\n');
+  while (end - begin >= 32) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+    const __m256i match = _mm256_or_si256(_mm256_cmpeq_epi8(block, cr32), _mm256_cmpeq_epi8(block, lf32));
+    const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(match));
+    if (mask) {
+      return begin + __builtin_ctz(mask);
+    }
+    begin += 32;
+  }
+#endif
+#if defined(CURRENT_HTTP_SCAN_SSE2)
+  const __m128i cr16 = _mm_set1_epi8('\r');
+  const __m128i lf16 = _mm_set1_epi8('\n');
+  while (end - begin >= 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+    const __m128i match = _mm_or_si128(_mm_cmpeq_epi8(block, cr16), _mm_cmpeq_epi8(block, lf16));
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+    if (mask) {
+      return begin + __builtin_ctz(mask);
+    }
+    begin += 16;
+  }
+#endif
+  return scalar::FindCROrLF(begin, end);
+}
+
+// Returns the pointer to the first CRLF in `[begin, end)`, or `nullptr` if there is none.
+// A lone CR or LF, which a well-behaved client would not send within a line, is skipped over.
+inline const char* FindCRLF(const char* begin, const char* end) {
+  while (true) {
+    begin = FindCROrLF(begin, end);
+    if (end - begin < 2) {
+      return nullptr;
+    } else if (begin[0] == '\r' && begin[1] == '\n') {
+      return begin;
+    }
+    ++begin;
+  }
+}
+
+}  // namespace current::net::http::scan
+}  // namespace current::net::http
+}  // namespace current::net
+}  // namespace current
+
+#endif  // BRICKS_NET_HTTP_IMPL_SCAN_H
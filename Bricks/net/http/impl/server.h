@@ -25,6 +25,9 @@ SOFTWARE.
 #ifndef BRICKS_NET_HTTP_IMPL_SERVER_H
 #define BRICKS_NET_HTTP_IMPL_SERVER_H
 
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <map>
 #include <sstream>
 #include <string>
@@ -38,6 +41,8 @@ SOFTWARE.
 
 #include "../headers/headers.h"
 
+#include "scan.h"
+
 #include "../../exceptions.h"
 
 #include "../../tcp/tcp.h"
@@ -134,6 +139,24 @@ struct HTTPResponder {
     connection.BlockingWrite(begin, end, false);
   }
 
+  // Sends `length` bytes of the file opened as `fd`, starting from `offset`, as the body of the response.
+  // The body goes out via `Connection::BlockingWriteFromFile()`, which uses `sendfile()` where available.
+  static void SendHTTPResponseFromFile(Connection& connection,
+                                       int fd,
+                                       uint64_t offset,
+                                       uint64_t length,
+                                       HTTPResponseCodeValue code = HTTPResponseCode.OK,
+                                       const std::string& content_type = constants::kDefaultContentType,
+                                       const http::Headers& extra_headers = http::Headers()) {
+    std::ostringstream os;
+    PrepareHTTPResponseHeader(os, ConnectionClose, code, content_type, extra_headers);
+    os << "Content-Length: " << length << constants::kCRLF << constants::kCRLF;
+    connection.BlockingWrite(os.str(), length > 0u);
+    if (length) {
+      connection.BlockingWriteFromFile(fd, offset, length);
+    }
+  }
+
   // Only support STL containers of chars and bytes, this does not yet cover std::string.
   template <typename T>
   static ENABLE_IF<sizeof(typename T::value_type) == 1> SendHTTPResponse(
@@ -198,11 +221,21 @@ struct HTTPResponder {
 // TODO(dkorolev): This is not yet the case, but will be soon once I fix HTTP parse code.
 class HTTPDefaultHelper {
  public:
-  struct ConstructionParams {};
-  HTTPDefaultHelper(const ConstructionParams&) {}
+  // Only call `OnHeader()` once `headers()` is first accessed, as opposed to while the message is being parsed.
+  // Helpers which do not define `kDefersHeaders`, or set it to `false`, get all the headers before the body.
+  constexpr static bool kDefersHeaders = true;
+
+  struct ConstructionParams {
+    // If set, is called once the headers have been parsed. If it returns `true`, the body is left unread,
+    // for the user code to read it chunk by chunk via `ReadStreamedBody()`, and the payload size limit does not apply.
+    std::function<bool(const current::url::URL&)> stream_body;
+  };
+  HTTPDefaultHelper(const ConstructionParams& params) : stream_body_(params.stream_body) {}
 
   const http::Headers& headers() const { return headers_; }
 
+  bool StreamBody(const current::url::URL& url) const { return stream_body_ && stream_body_(url); }
+
  protected:
   HTTPDefaultHelper() = default;
 
@@ -216,6 +249,7 @@ class HTTPDefaultHelper {
   }
 
  private:
+  std::function<bool(const current::url::URL&)> stream_body_;
   http::Headers headers_;
   std::string body_;
 };
@@ -233,6 +267,28 @@ class HTTPDefaultHelper {
 // * ConnectionResetByPeer       : When the server is using chunked transfer and doesn't fully send one.
 //
 // HTTP message: http://www.w3.org/Protocols/rfc2616/rfc2616.html
+template <typename HELPER>
+constexpr bool HTTPHelperDefersHeaders(char) {
+  return false;
+}
+
+template <typename HELPER>
+constexpr auto HTTPHelperDefersHeaders(int) -> decltype(HELPER::kDefersHeaders, bool()) {
+  return HELPER::kDefersHeaders;
+}
+
+// Helpers which do not define `StreamBody()` always have the body read in full by the constructor.
+template <typename HELPER>
+inline bool HTTPHelperStreamsBody(const HELPER&, const current::url::URL&, char) {
+  return false;
+}
+
+template <typename HELPER>
+inline auto HTTPHelperStreamsBody(const HELPER& helper, const current::url::URL& url, int)
+    -> decltype(helper.StreamBody(url), bool()) {
+  return helper.StreamBody(url);
+}
+
 template <class HELPER>
 class GenericHTTPRequestData : public HELPER {
  public:
@@ -264,6 +320,12 @@ class GenericHTTPRequestData : public HELPER {
     // `receiving_body_in_chunks` is set to true when the parsing is already in the "receive body" mode.
     bool receiving_body_in_chunks = false;
 
+    // The inputs to `KeepAlive()`: the protocol version, the `Connection` header, and whether it is a response.
+    bool is_response = false;
+    bool is_http_1_1 = false;
+    bool connection_close_header = false;
+    bool connection_keep_alive_header = false;
+
     while (offset < length_cap) {
       size_t chunk;
       size_t read_count;
@@ -294,7 +356,8 @@ class GenericHTTPRequestData : public HELPER {
       buffer_[offset] = '\0';
       char* next_crlf_ptr;
       while ((body_offset == static_cast<size_t>(-1) || offset < body_offset) &&
-             (next_crlf_ptr = strstr(&buffer_[current_line_offset], constants::kCRLF))) {
+             (next_crlf_ptr = const_cast<char*>(
+                  http::scan::FindCRLF(&buffer_[current_line_offset], &buffer_[0] + offset)))) {
         const bool line_is_blank = (next_crlf_ptr == &buffer_[current_line_offset]);
         *next_crlf_ptr = '\0';
         // `next_line_offset` is mutable since reading chunked body will change it.
@@ -302,14 +365,38 @@ class GenericHTTPRequestData : public HELPER {
         if (!first_line_parsed) {
           if (!line_is_blank) {
             // It's recommended by W3 to wait for the first line ignoring prior CRLF-s.
-            const std::vector<std::string> pieces =
-                strings::Split<strings::ByWhitespace>(&buffer_[current_line_offset]);
-            if (pieces.size() >= 1) {
-              method_ = pieces[0];
-            }
-            if (pieces.size() >= 2) {
-              raw_path_ = pieces[1];
-              url_ = current::url::URL(raw_path_);
+            // Split the request line in place, as it is "METHOD PATH HTTP/1.1" in all but the pathological cases.
+            const char* p = &buffer_[current_line_offset];
+            const auto IsWhitespace = [](const char c) { return c == ' ' || c == '\t' || c == '\v' || c == '\f'; };
+            const auto NextToken = [&p, next_crlf_ptr, &IsWhitespace](const char*& token_begin) {
+              while (p < next_crlf_ptr && IsWhitespace(*p)) {
+                ++p;
+              }
+              token_begin = p;
+              while (p < next_crlf_ptr && !IsWhitespace(*p)) {
+                ++p;
+              }
+              return static_cast<size_t>(p - token_begin);
+            };
+            const auto IsHTTP11 = [](const char* token, size_t length) {
+              return length == 8u && !std::memcmp(token, "HTTP/1.1", 8u);
+            };
+            const char* token;
+            size_t token_length = NextToken(token);
+            if (token_length) {
+              method_.assign(token, token_length);
+              // The response line is "HTTP/1.1 200 OK", and the request line is "GET /path HTTP/1.1".
+              is_response = (token_length > 5u && !std::memcmp(token, "HTTP/", 5u));
+              is_http_1_1 = is_response && IsHTTP11(token, token_length);
+              token_length = NextToken(token);
+              if (token_length) {
+                raw_path_.assign(token, token_length);
+                url_ = current::url::URL(raw_path_);
+                if (!is_response) {
+                  token_length = NextToken(token);
+                  is_http_1_1 = IsHTTP11(token, token_length);
+                }
+              }
             }
             first_line_parsed = true;
           }
@@ -376,8 +463,9 @@ class GenericHTTPRequestData : public HELPER {
             }
           }
         } else if (!line_is_blank) {
-          char* p = strchr(&buffer_[current_line_offset], constants::kHeaderKeyValueSeparator);
-          if (p) {
+          char* p = const_cast<char*>(
+              http::scan::FindByte(&buffer_[current_line_offset], next_crlf_ptr, constants::kHeaderKeyValueSeparator));
+          if (p != next_crlf_ptr) {
             *p++ = '\0';
             const char* const key = &buffer_[current_line_offset];
             const char* value = p;
@@ -392,26 +480,52 @@ class GenericHTTPRequestData : public HELPER {
             }
             *next_crlf_ptr = '\0';
 
-            HELPER::OnHeader(key, value);
+            // Only keep the positions of the header in `buffer_` for now, see `HTTPHelperDefersHeaders()`.
+            header_offsets_.emplace_back(key - &buffer_[0], value - &buffer_[0]);
             if (HeaderNameEquals(key, constants::kContentLengthHeaderKey)) {
-              body_length = static_cast<size_t>(atoi(value));
-              if (body_length > constants::kMaxHTTPPayloadSizeInBytes) {
-                HTTPResponder::SendHTTPResponse(c,
-                                                net::DefaultRequestEntityTooLargeMessage(),
-                                                HTTPResponseCode.RequestEntityTooLarge,
-                                                net::constants::kDefaultHTMLContentType);
-                CURRENT_THROW(HTTPPayloadTooLarge());
-              }
+              body_length = static_cast<size_t>(std::strtoull(value, nullptr, 10));
             } else if (HeaderNameEquals(key, constants::kHTTPMethodOverrideHeaderKey)) {
               method_ = current::strings::ToUpper(value);
             } else if (HeaderNameEquals(key, constants::kTransferEncodingHeaderKey)) {
               if (HeaderNameEquals(value, constants::kTransferEncodingChunkedValue)) {
                 chunked_transfer_encoding = true;
               }
+            } else if (HeaderNameEquals(key, constants::kConnectionHeaderKey)) {
+              if (HeaderNameEquals(value, constants::kConnectionCloseValue)) {
+                connection_close_header = true;
+              } else if (HeaderNameEquals(value, constants::kConnectionKeepAliveValue)) {
+                connection_keep_alive_header = true;
+              }
             }
           }
         } else {
           CURRENT_BRICKS_LOG_HTTP_EVENT("http header is parsed\n");
+          // The headers of the message with a chunked body are overwritten by the chunks, so pass them on now.
+          if (!HTTPHelperDefersHeaders<HELPER>(0) || chunked_transfer_encoding) {
+            PassHeadersToHelper();
+          }
+          // HTTP/1.1 connections are persistent unless told otherwise, HTTP/1.0 ones are the other way around.
+          // The body of a response with neither `Content-Length` nor chunked encoding ends when the connection does.
+          keep_alive_ = (is_http_1_1 ? !connection_close_header : connection_keep_alive_header) &&
+                        (!is_response || chunked_transfer_encoding || body_length != static_cast<size_t>(-1));
+          if (!is_response && (chunked_transfer_encoding || body_length != static_cast<size_t>(-1)) &&
+              HTTPHelperStreamsBody<HELPER>(*this, url_, 0)) {
+            // Leave the body for `ReadStreamedBody()`. Keep the bytes of it read so far at the front of `buffer_`,
+            // which is free to reuse once the headers have been passed on.
+            PassHeadersToHelper();
+            streamed_body_ = chunked_transfer_encoding ? StreamedBody::Chunked : StreamedBody::ContentLength;
+            streamed_body_length_ = body_length;
+            streamed_ahead_length_ = offset - next_line_offset;
+            std::memmove(&buffer_[0], &buffer_[next_line_offset], streamed_ahead_length_);
+            return;
+          }
+          if (body_length != static_cast<size_t>(-1) && body_length > constants::kMaxHTTPPayloadSizeInBytes) {
+            HTTPResponder::SendHTTPResponse(c,
+                                            net::DefaultRequestEntityTooLargeMessage(),
+                                            HTTPResponseCode.RequestEntityTooLarge,
+                                            net::constants::kDefaultHTMLContentType);
+            CURRENT_THROW(HTTPPayloadTooLarge());
+          }
           // The blank line is what separates HTTP headers from HTTP body.
           if (!chunked_transfer_encoding) {
             // HTTP body starts right after this last CRLF.
@@ -462,6 +576,18 @@ class GenericHTTPRequestData : public HELPER {
 
   inline const std::string& Method() const { return method_; }
   inline const current::url::URL& URL() const { return url_; }
+
+  // Whether the connection can be used for the next message once this one has been read in full.
+  inline bool KeepAlive() const { return keep_alive_; }
+
+  // For the helpers that defer the headers, the `http::Headers` are built on first access, as the handler
+  // may well never look at them. The raw headers remain in `buffer_`, which is immutable once the message is parsed.
+  inline const http::Headers& headers() const {
+    if (!header_offsets_.empty()) {
+      const_cast<GenericHTTPRequestData*>(this)->PassHeadersToHelper();
+    }
+    return HELPER::headers();
+  }
   inline const std::string& RawPath() const { return raw_path_; }
 
   // Note that `Body*()` methods assume that the body was fully read into memory.
@@ -492,7 +618,103 @@ class GenericHTTPRequestData : public HELPER {
     }
   }
 
+  // Whether the body has been left unread by the constructor, for `ReadStreamedBody()` to read it.
+  inline bool BodyIsStreamed() const { return streamed_body_ != StreamedBody::None; }
+
+  // Reads the body from the connection, passing it to `on_chunk` piece by piece, as it arrives.
+  // The next piece is only read once `on_chunk` returns, so a slow `on_chunk` makes the client wait to send more.
+  // The pieces are at most the size of the parse buffer, regardless of the sizes of the HTTP chunks.
+  // If the body has been read in full by the constructor, passes it to `on_chunk` at once.
+  // The body can only be read once; the subsequent calls do nothing.
+  void ReadStreamedBody(Connection& c, const std::function<void(const char*, size_t)>& on_chunk) {
+    const StreamedBody mode = streamed_body_;
+    if (mode == StreamedBody::None) {
+      if (BodyLength() && !body_consumed_) {
+        on_chunk(BodyBegin(), BodyLength());
+      }
+      body_consumed_ = true;
+      return;
+    }
+    if (body_consumed_) {
+      return;
+    }
+    body_consumed_ = true;
+    // Leave room for the '\0' of the chunk size line, as `buffer_` is used to parse it.
+    const size_t capacity = buffer_.size() - 1;
+    size_t begin = 0u;
+    size_t end = streamed_ahead_length_;
+    const auto ReadMore = [&]() {
+      if (begin == end) {
+        begin = end = 0u;
+      } else if (end == capacity) {
+        std::memmove(&buffer_[0], &buffer_[begin], end - begin);
+        end -= begin;
+        begin = 0u;
+      }
+      const size_t read_count = c.BlockingRead(&buffer_[end], capacity - end);
+      if (!read_count) {
+        CURRENT_THROW(ConnectionResetByPeer());  // LCOV_EXCL_LINE
+      }
+      end += read_count;
+    };
+    if (mode == StreamedBody::ContentLength) {
+      size_t remaining = streamed_body_length_;
+      while (remaining) {
+        if (begin == end) {
+          ReadMore();
+        }
+        const size_t n = std::min(end - begin, remaining);
+        on_chunk(&buffer_[begin], n);
+        begin += n;
+        remaining -= n;
+      }
+    } else {
+      while (true) {
+        const char* crlf;
+        while (!(crlf = http::scan::FindCRLF(&buffer_[begin], &buffer_[end]))) {
+          if (begin == 0u && end == capacity) {
+            CURRENT_THROW(ChunkSizeNotAValidHEXValue());  // A chunk size line longer than the whole buffer.
+          }
+          ReadMore();
+        }
+        const size_t line_end = crlf - &buffer_[0];
+        if (line_end == begin) {
+          // Ignore blank lines.
+          begin += constants::kCRLFLength;
+          continue;
+        }
+        buffer_[line_end] = '\0';
+        char* end_of_number;
+        size_t chunk_length = static_cast<size_t>(std::strtoull(&buffer_[begin], &end_of_number, 16));
+        if (end_of_number == &buffer_[begin]) {
+          CURRENT_THROW(ChunkSizeNotAValidHEXValue());
+        }
+        begin = line_end + constants::kCRLFLength;
+        if (!chunk_length) {
+          // Done with the body.
+          return;
+        }
+        while (chunk_length) {
+          if (begin == end) {
+            ReadMore();
+          }
+          const size_t n = std::min(end - begin, chunk_length);
+          on_chunk(&buffer_[begin], n);
+          begin += n;
+          chunk_length -= n;
+        }
+      }
+    }
+  }
+
  private:
+  void PassHeadersToHelper() {
+    for (const auto& key_and_value : header_offsets_) {
+      HELPER::OnHeader(&buffer_[key_and_value.first], &buffer_[key_and_value.second]);
+    }
+    header_offsets_.clear();
+  }
+
   static char NormalizeHeaderChar(char c) { return c != '_' ? std::tolower(c) : '-'; }
   static bool HeaderNameEquals(const char* lhs, const char* rhs) {
     while (*lhs && *rhs) {
@@ -507,12 +729,24 @@ class GenericHTTPRequestData : public HELPER {
   std::string method_;
   current::url::URL url_;
   std::string raw_path_;
+  bool keep_alive_ = false;
 
   // HTTP parsing fields that have to be caried out of the parsing routine.
   std::vector<char> buffer_;                 // The buffer into which data has been read, except for chunked case.
   const char* body_buffer_begin_ = nullptr;  // If BODY has been provided, pointer pair to it.
   const char* body_buffer_end_ = nullptr;    // Will not be nullptr if body_buffer_begin_ is not nullptr.
 
+  // The offsets of the '\0'-terminated keys and values of the headers not yet passed on to `HELPER::OnHeader()`.
+  std::vector<std::pair<size_t, size_t>> header_offsets_;
+
+  // The state of the body left unread by the constructor. `streamed_ahead_length_` is the number of bytes of it
+  // which have already been read, and are kept at the front of `buffer_`.
+  enum class StreamedBody { None, ContentLength, Chunked };
+  StreamedBody streamed_body_ = StreamedBody::None;
+  size_t streamed_body_length_ = 0u;
+  size_t streamed_ahead_length_ = 0u;
+  bool body_consumed_ = false;
+
   // HTTP body gets converted to an std::string representation as it's first requested.
   // TODO(dkorolev): This pattern is worth revisiting. StringPiece?
   mutable std::unique_ptr<std::string> prepared_body_;
@@ -576,6 +810,20 @@ class GenericHTTPServerConnection final : public HTTPResponder {
     }
   }
 
+  void SendHTTPResponseFromFile(int fd,
+                                uint64_t offset,
+                                uint64_t length,
+                                HTTPResponseCodeValue code = HTTPResponseCode.OK,
+                                const std::string& content_type = constants::kDefaultContentType,
+                                const http::Headers& extra_headers = http::Headers()) {
+    if (responded_) {
+      CURRENT_THROW(AttemptedToSendHTTPResponseMoreThanOnce());
+    } else {
+      responded_ = true;
+      HTTPResponder::SendHTTPResponseFromFile(connection_, fd, offset, length, code, content_type, extra_headers);
+    }
+  }
+
   // The wrapper to send HTTP response in chunks.
   struct ChunkedResponseSender final {
     // `struct Impl` is the logic wrapped into an `std::unique_ptr<>` to call the destructor only once.
@@ -702,6 +950,21 @@ class GenericHTTPServerConnection final : public HTTPResponder {
 
   const GenericHTTPRequestData<HTTP_REQUEST_DATA>& HTTPRequest() const { return message_; }
 
+  // Reads the body of the request chunk by chunk, see `GenericHTTPRequestData::ReadStreamedBody()`.
+  // Responds with a "400" to a chunked body with an invalid chunk size, unless a response has already been sent.
+  void ReadStreamedBody(const std::function<void(const char*, size_t)>& on_chunk) {
+    try {
+      message_.ReadStreamedBody(connection_, on_chunk);
+    } catch (const ChunkSizeNotAValidHEXValue&) {
+      if (!responded_) {
+        SendHTTPResponse(net::DefaultInvalidHEXChunkSizeBadRequestMessage(),
+                         HTTPResponseCode.BadRequest,
+                         net::constants::kDefaultHTMLContentType);
+      }
+      throw;
+    }
+  }
+
   const IPAndPort& LocalIPAndPort() const { return connection_.LocalIPAndPort(); }
   const IPAndPort& RemoteIPAndPort() const { return connection_.RemoteIPAndPort(); }
 
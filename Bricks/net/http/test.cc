@@ -892,6 +892,59 @@ TEST(HTTPMimeTypeTest, SmokeTest) {
   EXPECT_EQ("image/x-icon", GetFileMimeType("favicon.ico"));
 }
 
+TEST(HTTPScanTest, VectorizedMatchesScalar) {
+  namespace scan = current::net::http::scan;
+  std::string s(100, '.');
+  for (size_t i = 0; i <= s.length(); ++i) {
+    for (size_t begin = 0; begin <= std::min(i, static_cast<size_t>(17)); ++begin) {
+      const char* b = s.data() + begin;
+      const char* e = s.data() + s.length();
+      EXPECT_EQ(scan::scalar::FindByte(b, e, ':'), scan::FindByte(b, e, ':'));
+      EXPECT_EQ(scan::scalar::FindCROrLF(b, e), scan::FindCROrLF(b, e));
+    }
+    if (i < s.length()) {
+      s[i] = (i % 3 == 0) ? ':' : (i % 3 == 1) ? '\r' : '\n';
+    }
+  }
+  const std::string line = "Host: localhost\rX\nY\r\nNext: line\r\n";
+  EXPECT_EQ(line.find("\r\n"),
+            static_cast<size_t>(scan::FindCRLF(line.data(), line.data() + line.length()) - line.data()));
+  EXPECT_EQ(nullptr, scan::FindCRLF(line.data(), line.data() + line.find("\r\n") + 1));
+  EXPECT_EQ(4, scan::FindByte(line.data(), line.data() + line.length(), ':') - line.data());
+}
+
+TEST(PosixHTTPServerTest, HeadersAreBuiltOnFirstAccess) {
+  std::thread t([](Socket s) {
+    HTTPServerConnection c(s.Accept());
+    const auto& request = c.HTTPRequest();
+    EXPECT_EQ("GET", request.Method());
+    EXPECT_EQ("/path?x=1", request.RawPath());
+    EXPECT_EQ(0u, static_cast<const current::net::HTTPDefaultHelper&>(request).headers().size());
+    EXPECT_EQ(3u, request.headers().size());
+    EXPECT_EQ("localhost", request.headers().Get("Host"));
+    EXPECT_EQ("bar", request.headers().Get("X-Foo"));
+    EXPECT_EQ("", request.headers().Get("X-Empty"));
+    EXPECT_EQ("1", request.headers().cookies.at("a").value);
+    c.SendHTTPResponse("OK");
+  }, Socket(FLAGS_net_http_test_port));
+  Connection connection(ClientSocket("localhost", FLAGS_net_http_test_port));
+  connection.BlockingWrite("GET  /path?x=1  HTTP/1.1\r\n", true);
+  connection.BlockingWrite("Host: localhost\r\n", true);
+  connection.BlockingWrite("X-Foo: \t bar \t\r\n", true);
+  connection.BlockingWrite("X-Empty:\r\n", true);
+  connection.BlockingWrite("Cookie: a=1\r\n", true);
+  connection.BlockingWrite("\r\n", false);
+  ExpectToReceive(
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Type: text/plain\r\n"
+      "Connection: close\r\n"
+      "Content-Length: 2\r\n"
+      "\r\n"
+      "OK",
+      connection);
+  t.join();
+}
+
 // TODO(dkorolev): Figure out a way to test ConnectionResetByPeer exceptions.
 
 #if 0
@@ -31,9 +31,12 @@ SOFTWARE.
 
 #include "../../debug_log.h"
 
+#include "../../../util/make_scope_guard.h"
 #include "../../../util/singleton.h"
 #include "../../../template/enable_if.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <string>
 #include <utility>
@@ -45,9 +48,15 @@ SOFTWARE.
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#ifndef CURRENT_APPLE
+#include <signal.h>
+#include <sys/sendfile.h>
+#endif
+
 // Bricks uses `SOCKET` for socket handles in *nix.
 // Makes it easier to have the code run on both Windows and *nix.
 typedef int SOCKET;
@@ -61,6 +70,12 @@ typedef int SOCKET;
 
 #endif
 
+// Several sockets can listen on the same port, with the kernel spreading the incoming connections across them.
+// Linux-only, as elsewhere `SO_REUSEPORT` either does not exist, or hands all the connections to one socket.
+#if !defined(CURRENT_WINDOWS) && defined(__linux__) && defined(SO_REUSEPORT)
+#define CURRENT_NET_HAS_REUSEPORT
+#endif
+
 namespace current {
 namespace net {
 
@@ -265,6 +280,24 @@ class Connection : public SocketHandle {
       return 0;  // LCOV_EXCL_LINE
     } else {
       uint8_t* buffer = reinterpret_cast<uint8_t*>(output_buffer);
+
+      // Hand out the bytes which were read off this socket before it became this `Connection`, if any.
+      if (received_ahead_offset_ < received_ahead_.length()) {
+        const size_t available = received_ahead_.length() - received_ahead_offset_;
+        const size_t n = std::min(available, max_length);
+        std::memcpy(buffer, received_ahead_.data() + received_ahead_offset_, n);
+        received_ahead_offset_ += n;
+        if (received_ahead_offset_ == received_ahead_.length()) {
+          std::string().swap(received_ahead_);
+          received_ahead_offset_ = 0u;
+        }
+        if (n == max_length || policy == BlockingReadPolicy::ReturnASAP) {
+          return n;
+        } else {
+          return n + BlockingRead(buffer + n, max_length - n, policy);
+        }
+      }
+
       uint8_t* ptr = buffer;
       const uint8_t* end = (buffer + max_length);
       const int flags = ((policy == BlockingReadPolicy::ReturnASAP) ? 0 : MSG_WAITALL);
@@ -414,9 +447,148 @@ class Connection : public SocketHandle {
     BlockingWrite(container.begin(), container.end(), more);
   }
 
+  // Writes `length` bytes of the file opened as `fd`, starting from `offset`, into the socket.
+  // On Linux, uses `sendfile()`, so that the contents of the file never make it into the user space.
+  // Elsewhere, reads the file in blocks and writes them into the socket one by one.
+  inline Connection& BlockingWriteFromFile(int fd, uint64_t offset, uint64_t length) {
+    CURRENT_BRICKS_NET_LOG("S%05d BlockingWriteFromFile(%d bytes) ...\n",
+                           static_cast<SOCKET>(socket),
+                           static_cast<int>(length));
+#if !defined(CURRENT_WINDOWS) && !defined(CURRENT_APPLE)
+    // Unlike `send()`, `sendfile()` has no `MSG_NOSIGNAL`. Block `SIGPIPE` in this thread while writing,
+    // and swallow the one raised by writing into a socket closed by the peer, as it would kill the process.
+    sigset_t sigpipe_mask;
+    sigset_t original_mask;
+    ::sigemptyset(&sigpipe_mask);
+    ::sigaddset(&sigpipe_mask, SIGPIPE);
+    ::pthread_sigmask(SIG_BLOCK, &sigpipe_mask, &original_mask);
+    sigset_t pending;
+    ::sigpending(&pending);
+    const bool sigpipe_was_pending = ::sigismember(&pending, SIGPIPE);
+    const auto restore_signal_mask = MakeScopeGuard([&]() {
+      if (!sigpipe_was_pending) {
+        const struct timespec zero_timeout = {0, 0};
+        while (::sigtimedwait(&sigpipe_mask, nullptr, &zero_timeout) > 0) {
+          // Drain the `SIGPIPE`-s raised by this call.
+        }
+      }
+      ::pthread_sigmask(SIG_SETMASK, &original_mask, nullptr);
+    });
+    off_t position = static_cast<off_t>(offset);
+    while (length) {
+      const size_t block = static_cast<size_t>(std::min(length, static_cast<uint64_t>(1u << 30)));
+      const ssize_t result = ::sendfile(socket, fd, &position, block);
+      if (result < 0) {
+        if (errno == EINTR || errno == EAGAIN) {
+          continue;  // LCOV_EXCL_LINE
+        }
+        CURRENT_THROW(SocketWriteException());
+      } else if (result == 0) {
+        // The file is shorter than expected, most likely it has been truncated meanwhile.
+        CURRENT_THROW(SocketCouldNotWriteEverythingException());  // LCOV_EXCL_LINE
+      }
+      length -= static_cast<uint64_t>(result);
+    }
+#else
+    std::vector<char> buffer(static_cast<size_t>(std::min(length, static_cast<uint64_t>(1u << 16))));
+    while (length) {
+      const size_t block = static_cast<size_t>(std::min(length, static_cast<uint64_t>(buffer.size())));
+#ifndef CURRENT_WINDOWS
+      const ssize_t result = ::pread(fd, &buffer[0], block, static_cast<off_t>(offset));
+#else
+      const int result = (::_lseeki64(fd, static_cast<__int64>(offset), SEEK_SET) < 0)
+                             ? -1
+                             : ::_read(fd, &buffer[0], static_cast<unsigned int>(block));
+#endif
+      if (result <= 0) {
+        CURRENT_THROW(SocketCouldNotWriteEverythingException());
+      }
+      BlockingWrite(&buffer[0], static_cast<size_t>(result), static_cast<uint64_t>(result) < length);
+      offset += static_cast<uint64_t>(result);
+      length -= static_cast<uint64_t>(result);
+    }
+#endif
+    CURRENT_BRICKS_NET_LOG("S%05d BlockingWriteFromFile() : OK\n", static_cast<SOCKET>(socket));
+    return *this;
+  }
+
+  // Whether the peer has neither closed the connection nor sent anything since the last read. Does not block.
+  // Used to check an idle keep-alive connection before sending the next request over it.
+  bool IsIdleAndOpen() {
+    if (received_ahead_offset_ < received_ahead_.length()) {
+      return false;
+    }
+#ifndef CURRENT_WINDOWS
+    pollfd fd;
+    fd.fd = socket;
+    fd.events = POLLIN;
+    fd.revents = 0;
+    return ::poll(&fd, 1, 0) == 0;
+#else
+    WSAPOLLFD fd;
+    fd.fd = socket;
+    fd.events = POLLRDNORM;
+    fd.revents = 0;
+    return ::WSAPoll(&fd, 1, 0) == 0;
+#endif
+  }
+
+  // Blocks until there is data to read. Returns `false` if the peer has closed or reset the connection instead.
+  // Throws `SocketReadTimeoutException` if neither has happened within `timeout`.
+  // Does not consume the data. Used to tell a reused connection the server has just closed from a failed response.
+  bool BlockingWaitForData(std::chrono::milliseconds timeout) {
+    if (received_ahead_offset_ < received_ahead_.length()) {
+      return true;
+    }
+    char byte;
+    while (true) {
+#ifndef CURRENT_WINDOWS
+      pollfd fd;
+      fd.fd = socket;
+      fd.events = POLLIN;
+      fd.revents = 0;
+      const int ready = ::poll(&fd, 1, static_cast<int>(timeout.count()));
+      if (ready < 0 && errno == EINTR) {
+        continue;  // LCOV_EXCL_LINE
+      }
+#else
+      WSAPOLLFD fd;
+      fd.fd = socket;
+      fd.events = POLLRDNORM;
+      fd.revents = 0;
+      const int ready = ::WSAPoll(&fd, 1, static_cast<int>(timeout.count()));
+#endif
+      if (ready == 0) {
+        CURRENT_THROW(SocketReadTimeoutException());
+      } else if (ready < 0) {
+        return false;  // LCOV_EXCL_LINE
+      }
+      const int result = static_cast<int>(::recv(socket, &byte, 1, MSG_PEEK));
+      if (result > 0) {
+        return true;
+      }
+#ifndef CURRENT_WINDOWS
+      if (result < 0 && (errno == EINTR || errno == EAGAIN)) {
+        continue;  // LCOV_EXCL_LINE
+      }
+#endif
+      return false;
+    }
+  }
+
+  // Makes the subsequent `BlockingRead()`-s return `data` first, and only then read from the socket.
+  // Used when the bytes have already been read off the socket by someone else, for instance,
+  // by an event loop that waits for the HTTP request to arrive in full before handing it over.
+  void SetReceivedAhead(std::string data) {
+    received_ahead_ = std::move(data);
+    received_ahead_offset_ = 0u;
+  }
+
  private:
   const IPAndPort local_ip_and_port_;
   const IPAndPort remote_ip_and_port_;
+  std::string received_ahead_;
+  size_t received_ahead_offset_ = 0u;
 
   Connection() = delete;
   Connection(const Connection&) = delete;
@@ -426,10 +598,24 @@ class Connection : public SocketHandle {
 
 class Socket final : public SocketHandle {
  public:
+  // With `reuse_port`, other sockets with `reuse_port` can listen on the same port.
+  // Requires `CURRENT_NET_HAS_REUSEPORT`.
   inline explicit Socket(const int port,
                          const int max_connections = kMaxServerQueuedConnections,
-                         const bool disable_nagle_algorithm = kDisableNagleAlgorithmByDefault)
+                         const bool disable_nagle_algorithm = kDisableNagleAlgorithmByDefault,
+                         const bool reuse_port = false)
       : SocketHandle(SocketHandle::NewHandle(), disable_nagle_algorithm) {
+    if (reuse_port) {
+#ifdef CURRENT_NET_HAS_REUSEPORT
+      int just_one = 1;
+      if (::setsockopt(socket, SOL_SOCKET, SO_REUSEPORT, &just_one, sizeof(just_one))) {
+        CURRENT_THROW(SocketCreateException());  // LCOV_EXCL_LINE
+      }
+#else
+      CURRENT_THROW(SocketCreateException());  // LCOV_EXCL_LINE
+#endif
+    }
+
     sockaddr_in addr_server;
     memset(&addr_server, 0, sizeof(addr_server));
     addr_server.sin_family = AF_INET;
@@ -472,7 +658,12 @@ class Socket final : public SocketHandle {
       CURRENT_THROW(SocketAcceptException());  // LCOV_EXCL_LINE -- Not covered by the unit tests.
     }
     CURRENT_BRICKS_NET_LOG("S%05d accept() : OK, FD = %d.\n", static_cast<SOCKET>(socket), handle);
+    return AcceptedConnection(handle, addr_client);
+  }
 
+  // Wraps the handle returned by an `::accept()` call into a `Connection`.
+  // Public, as the event loop-based HTTP server accepts connections on its own, in non-blocking mode.
+  static Connection AcceptedConnection(SOCKET handle, const sockaddr_in& addr_client) {
     sockaddr_in addr_serv;
 #ifndef CURRENT_WINDOWS
     socklen_t addr_serv_length = sizeof(sockaddr_in);
@@ -183,6 +183,24 @@ TEST(TCPTest, CanNotUseMovedAwayConnection) {
   server.join();
 }
 
+TEST(TCPTest, WaitForData) {
+  thread server([](Socket socket) {
+    Connection connection = socket.Accept();
+    char buffer[2];  // Only respond once the client has timed out waiting.
+    ASSERT_EQ(2u, connection.BlockingRead(buffer, 2, Connection::FillFullBuffer));
+    connection.BlockingWrite("OK", false);
+  }, Socket(FLAGS_net_tcp_test_port));
+  Connection client(ClientSocket("localhost", FLAGS_net_tcp_test_port));
+  ASSERT_THROW(client.BlockingWaitForData(milliseconds(10)), current::net::SocketReadTimeoutException);
+  client.BlockingWrite("GO", false);
+  EXPECT_TRUE(client.BlockingWaitForData(milliseconds(10000)));
+  char response[3] = "??";
+  ASSERT_EQ(2u, client.BlockingRead(response, 2, Connection::FillFullBuffer));
+  EXPECT_EQ("OK", std::string(response));
+  server.join();
+  EXPECT_FALSE(client.BlockingWaitForData(milliseconds(10000)));
+}
+
 TEST(TCPTest, ReceiveMessageOfTwoUInt16) {
   // Note: This tests endianness as well -- D.K.
   thread server_thread([](Socket socket) {
@@ -29,12 +29,15 @@ SOFTWARE.
 #ifndef BRICKS_STRINGS_FIXED_SIZE_SERIALIZER_H
 #define BRICKS_STRINGS_FIXED_SIZE_SERIALIZER_H
 
+#include <cstring>
 #include <iomanip>
 #include <limits>
 #include <sstream>
 #include <string>
 #include <type_traits>
 
+#include "number.h"
+
 namespace current {
 namespace strings {
 
@@ -44,14 +47,15 @@ struct FixedSizeSerializer : std::enable_if<std::is_unsigned<T>::value && std::i
                                             FixedSizeSerializerEnabler>::type {
   enum { size_in_bytes = std::numeric_limits<T>::digits10 + 1 };
   static std::string PackToString(T x) {
-    std::ostringstream os;
-    os << std::setfill('0') << std::setw(size_in_bytes) << x;
-    return os.str();
+    char buffer[kMaxFormattedNumberLength];
+    const size_t length = static_cast<size_t>(FormatNumber(x, buffer) - buffer);
+    std::string result(size_in_bytes, '0');
+    std::memcpy(&result[size_in_bytes - length], buffer, length);
+    return result;
   }
   static T UnpackFromString(std::string const& s) {
-    T x;
-    std::istringstream is(s);
-    is >> x;
+    T x = 0u;
+    ParseNumber(s.data(), s.data() + s.length(), x);
     return x;
   }
 };
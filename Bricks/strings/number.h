@@ -0,0 +1,572 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Allocation-free and locale-independent conversions between numbers and their decimal representations.
+//
+// Integers are formatted two digits at a time, and parsed with range checks.
+//
+// Floating point numbers are formatted as the shortest strings that parse back into the very same value,
+// using the Grisu2 algorithm by Florian Loitsch, in the notation of JavaScript: `0.5`, `100`, `1e+21`, `1.5e-7`.
+// Grisu2 always round-trips, and yields the shortest string for all but a tiny fraction of the inputs.
+// They are parsed exactly right away if their significand fits 53 bits and the decimal exponent is within 22,
+// which covers most real-world inputs, and via `std::strtod()` in the "C" notation otherwise.
+
+#ifndef BRICKS_STRINGS_NUMBER_H
+#define BRICKS_STRINGS_NUMBER_H
+
+#include "../../port.h"
+
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "../template/enable_if.h"
+
+namespace current {
+namespace strings {
+
+// The upper bound for the number of characters `FormatNumber()` outputs.
+constexpr size_t kMaxFormattedNumberLength = 32u;
+
+namespace number {
+
+inline const char* DigitPairs() {
+  return "00010203040506070809101112131415161718192021222324"
+         "25262728293031323334353637383940414243444546474849"
+         "50515253545556575859606162636465666768697071727374"
+         "75767778798081828384858687888990919293949596979899";
+}
+
+// Writes the digits of `value` right to left, ending right before `end`. Returns the pointer to the first digit.
+inline char* FormatUnsignedBackwards(uint64_t value, char* end) {
+  const char* pairs = DigitPairs();
+  while (value >= 100u) {
+    const size_t i = static_cast<size_t>(value % 100u) * 2u;
+    value /= 100u;
+    *--end = pairs[i + 1u];
+    *--end = pairs[i];
+  }
+  if (value >= 10u) {
+    const size_t i = static_cast<size_t>(value) * 2u;
+    *--end = pairs[i + 1u];
+    *--end = pairs[i];
+  } else {
+    *--end = static_cast<char>('0' + value);
+  }
+  return end;
+}
+
+inline char* FormatUnsigned(uint64_t value, char* output) {
+  char buffer[20];
+  char* const end = buffer + sizeof(buffer);
+  const char* begin = FormatUnsignedBackwards(value, end);
+  const size_t length = static_cast<size_t>(end - begin);
+  std::memcpy(output, begin, length);
+  return output + length;
+}
+
+inline char* FormatSigned(int64_t value, char* output) {
+  if (value < 0) {
+    *output++ = '-';
+    return FormatUnsigned(0u - static_cast<uint64_t>(value), output);
+  } else {
+    return FormatUnsigned(static_cast<uint64_t>(value), output);
+  }
+}
+
+// The "do-it-yourself floating point" number, `f * 2^e`, of Grisu.
+struct DiyFp {
+  uint64_t f;
+  int e;
+};
+
+inline DiyFp Multiply(DiyFp a, DiyFp b) {
+  const uint64_t kMask32 = 0xffffffffu;
+  const uint64_t a_hi = a.f >> 32;
+  const uint64_t a_lo = a.f & kMask32;
+  const uint64_t b_hi = b.f >> 32;
+  const uint64_t b_lo = b.f & kMask32;
+  const uint64_t hi_hi = a_hi * b_hi;
+  const uint64_t hi_lo = a_hi * b_lo;
+  const uint64_t lo_hi = a_lo * b_hi;
+  const uint64_t lo_lo = a_lo * b_lo;
+  uint64_t middle = (lo_lo >> 32) + (hi_lo & kMask32) + (lo_hi & kMask32);
+  middle += uint64_t(1) << 31;  // Round the lower 64 bits of the product.
+  return DiyFp{hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + (middle >> 32), a.e + b.e + 64};
+}
+
+inline DiyFp Normalize(DiyFp x) {
+#if defined(__GNUC__) || defined(__clang__)
+  const int shift = __builtin_clzll(x.f);
+  return DiyFp{x.f << shift, x.e - shift};
+#else
+  while (!(x.f & (uint64_t(1) << 63))) {
+    x.f <<= 1;
+    --x.e;
+  }
+  return x;
+#endif
+}
+
+// The normalized `10^k` for `k` from -348 to 340 in steps of 8, and the decimal exponent for the binary one `e`,
+// such that the product of the number with the binary exponent `e` and the cached power is within [2^-60, 2^-32).
+inline DiyFp CachedPower(int e, int& decimal_exponent) {
+  static const uint64_t kSignificands[] = {
+      0xfa8fd5a0081c0288ull, 0xbaaee17fa23ebf76ull, 0x8b16fb203055ac76ull,
+      0xcf42894a5dce35eaull, 0x9a6bb0aa55653b2dull, 0xe61acf033d1a45dfull,
+      0xab70fe17c79ac6caull, 0xff77b1fcbebcdc4full, 0xbe5691ef416bd60cull,
+      0x8dd01fad907ffc3cull, 0xd3515c2831559a83ull, 0x9d71ac8fada6c9b5ull,
+      0xea9c227723ee8bcbull, 0xaecc49914078536dull, 0x823c12795db6ce57ull,
+      0xc21094364dfb5637ull, 0x9096ea6f3848984full, 0xd77485cb25823ac7ull,
+      0xa086cfcd97bf97f4ull, 0xef340a98172aace5ull, 0xb23867fb2a35b28eull,
+      0x84c8d4dfd2c63f3bull, 0xc5dd44271ad3cdbaull, 0x936b9fcebb25c996ull,
+      0xdbac6c247d62a584ull, 0xa3ab66580d5fdaf6ull, 0xf3e2f893dec3f126ull,
+      0xb5b5ada8aaff80b8ull, 0x87625f056c7c4a8bull, 0xc9bcff6034c13053ull,
+      0x964e858c91ba2655ull, 0xdff9772470297ebdull, 0xa6dfbd9fb8e5b88full,
+      0xf8a95fcf88747d94ull, 0xb94470938fa89bcfull, 0x8a08f0f8bf0f156bull,
+      0xcdb02555653131b6ull, 0x993fe2c6d07b7facull, 0xe45c10c42a2b3b06ull,
+      0xaa242499697392d3ull, 0xfd87b5f28300ca0eull, 0xbce5086492111aebull,
+      0x8cbccc096f5088ccull, 0xd1b71758e219652cull, 0x9c40000000000000ull,
+      0xe8d4a51000000000ull, 0xad78ebc5ac620000ull, 0x813f3978f8940984ull,
+      0xc097ce7bc90715b3ull, 0x8f7e32ce7bea5c70ull, 0xd5d238a4abe98068ull,
+      0x9f4f2726179a2245ull, 0xed63a231d4c4fb27ull, 0xb0de65388cc8ada8ull,
+      0x83c7088e1aab65dbull, 0xc45d1df942711d9aull, 0x924d692ca61be758ull,
+      0xda01ee641a708deaull, 0xa26da3999aef774aull, 0xf209787bb47d6b85ull,
+      0xb454e4a179dd1877ull, 0x865b86925b9bc5c2ull, 0xc83553c5c8965d3dull,
+      0x952ab45cfa97a0b3ull, 0xde469fbd99a05fe3ull, 0xa59bc234db398c25ull,
+      0xf6c69a72a3989f5cull, 0xb7dcbf5354e9beceull, 0x88fcf317f22241e2ull,
+      0xcc20ce9bd35c78a5ull, 0x98165af37b2153dfull, 0xe2a0b5dc971f303aull,
+      0xa8d9d1535ce3b396ull, 0xfb9b7cd9a4a7443cull, 0xbb764c4ca7a44410ull,
+      0x8bab8eefb6409c1aull, 0xd01fef10a657842cull, 0x9b10a4e5e9913129ull,
+      0xe7109bfba19c0c9dull, 0xac2820d9623bf429ull, 0x80444b5e7aa7cf85ull,
+      0xbf21e44003acdd2dull, 0x8e679c2f5e44ff8full, 0xd433179d9c8cb841ull,
+      0x9e19db92b4e31ba9ull, 0xeb96bf6ebadf77d9ull, 0xaf87023b9bf0ee6bull,
+  };
+  static const int16_t kExponents[] = {
+      -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+      -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+      -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+      -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+      56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+      375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+      694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+      1013, 1039, 1066,
+  };
+  const double dk = (-61 - e) * 0.30102999566398114 + 347;  // Keep `dk` positive to round it up via a cast.
+  int k = static_cast<int>(dk);
+  if (dk - k > 0.0) {
+    ++k;
+  }
+  const size_t index = static_cast<size_t>((k >> 3) + 1);
+  decimal_exponent = 348 - static_cast<int>(index << 3);
+  return DiyFp{kSignificands[index], kExponents[index]};
+}
+
+inline const uint32_t* PowersOfTen32() {
+  static const uint32_t kPowersOfTen[] = {
+      1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u};
+  return kPowersOfTen;
+}
+
+inline int CountDecimalDigits32(uint32_t n) {
+  const uint32_t* powers = PowersOfTen32();
+  int digits = 1;
+  while (digits < 10 && n >= powers[digits]) {
+    ++digits;
+  }
+  return digits;
+}
+
+inline void GrisuRound(char* digits, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+  while (rest < wp_w && delta - rest >= ten_kappa &&
+         (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+    --digits[length - 1];
+    rest += ten_kappa;
+  }
+}
+
+// Generates the shortest digits of `w` that are within `delta` below `upper`.
+inline void DigitGen(DiyFp w, DiyFp upper, uint64_t delta, char* digits, int& length, int& k) {
+  const uint32_t* powers = PowersOfTen32();
+  const DiyFp one{uint64_t(1) << -upper.e, upper.e};
+  const uint64_t wp_w = upper.f - w.f;
+  uint32_t p1 = static_cast<uint32_t>(upper.f >> -one.e);
+  uint64_t p2 = upper.f & (one.f - 1u);
+  int kappa = CountDecimalDigits32(p1);
+  length = 0;
+  while (kappa > 0) {
+    const uint32_t d = p1 / powers[kappa - 1];
+    p1 %= powers[kappa - 1];
+    if (d || length) {
+      digits[length++] = static_cast<char>('0' + d);
+    }
+    --kappa;
+    const uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+    if (rest <= delta) {
+      k += kappa;
+      GrisuRound(digits, length, delta, rest, static_cast<uint64_t>(powers[kappa]) << -one.e, wp_w);
+      return;
+    }
+  }
+  while (true) {
+    p2 *= 10u;
+    delta *= 10u;
+    const char d = static_cast<char>(p2 >> -one.e);
+    if (d || length) {
+      digits[length++] = static_cast<char>('0' + d);
+    }
+    p2 &= one.f - 1u;
+    --kappa;
+    if (p2 < delta) {
+      k += kappa;
+      GrisuRound(digits, length, delta, p2, one.f, wp_w * (-kappa < 10 ? powers[-kappa] : 0u));
+      return;
+    }
+  }
+}
+
+template <typename T>
+struct IEEE754;
+
+template <>
+struct IEEE754<double> {
+  using bits_t = uint64_t;
+  constexpr static int kSignificandBits = 52;
+  constexpr static int kExponentBits = 11;
+  constexpr static int kExponentBias = 1023 + kSignificandBits;
+};
+
+template <>
+struct IEEE754<float> {
+  using bits_t = uint32_t;
+  constexpr static int kSignificandBits = 23;
+  constexpr static int kExponentBits = 8;
+  constexpr static int kExponentBias = 127 + kSignificandBits;
+};
+
+// For a positive finite `value`, generates the shortest `digits`, such that `value == digits * 10^k`.
+template <typename T>
+inline void Grisu2(T value, char* digits, int& length, int& k) {
+  using ieee754_t = IEEE754<T>;
+  typename ieee754_t::bits_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint64_t hidden_bit = uint64_t(1) << ieee754_t::kSignificandBits;
+  const uint64_t significand = static_cast<uint64_t>(bits) & (hidden_bit - 1u);
+  const int biased_exponent =
+      static_cast<int>((bits >> ieee754_t::kSignificandBits) & ((1u << ieee754_t::kExponentBits) - 1u));
+  const DiyFp v = biased_exponent ? DiyFp{significand + hidden_bit, biased_exponent - ieee754_t::kExponentBias}
+                                  : DiyFp{significand, 1 - ieee754_t::kExponentBias};
+
+  // The boundaries are halfway to the neighboring values; the lower one is closer at the powers of two.
+  const DiyFp upper = Normalize(DiyFp{(v.f << 1) + 1u, v.e - 1});
+  DiyFp lower = (v.f == hidden_bit && biased_exponent > 1) ? DiyFp{(v.f << 2) - 1u, v.e - 2}
+                                                           : DiyFp{(v.f << 1) - 1u, v.e - 1};
+  lower.f <<= lower.e - upper.e;
+  lower.e = upper.e;
+
+  const DiyFp cached_power = CachedPower(upper.e, k);
+  const DiyFp w = Multiply(Normalize(v), cached_power);
+  DiyFp w_upper = Multiply(upper, cached_power);
+  DiyFp w_lower = Multiply(lower, cached_power);
+  ++w_lower.f;
+  --w_upper.f;
+  DigitGen(w, w_upper, w_upper.f - w_lower.f, digits, length, k);
+}
+
+// Outputs `digits * 10^k` in the notation of JavaScript.
+inline char* FormatDecimal(const char* digits, int length, int k, char* output) {
+  const int point = length + k;  // The position of the decimal point relative to the first digit.
+  if (length <= point && point <= 21) {
+    std::memcpy(output, digits, length);
+    output += length;
+    for (int i = length; i < point; ++i) {
+      *output++ = '0';
+    }
+  } else if (0 < point && point <= 21) {
+    std::memcpy(output, digits, point);
+    output += point;
+    *output++ = '.';
+    std::memcpy(output, digits + point, length - point);
+    output += length - point;
+  } else if (-6 < point && point <= 0) {
+    *output++ = '0';
+    *output++ = '.';
+    for (int i = point; i < 0; ++i) {
+      *output++ = '0';
+    }
+    std::memcpy(output, digits, length);
+    output += length;
+  } else {
+    *output++ = digits[0];
+    if (length > 1) {
+      *output++ = '.';
+      std::memcpy(output, digits + 1, length - 1);
+      output += length - 1;
+    }
+    const int exponent = point - 1;
+    *output++ = 'e';
+    *output++ = exponent < 0 ? '-' : '+';
+    output = FormatUnsigned(static_cast<uint64_t>(exponent < 0 ? -exponent : exponent), output);
+  }
+  return output;
+}
+
+template <typename T>
+inline char* FormatFloatingPoint(T value, char* output) {
+  if (std::isnan(value)) {
+    std::memcpy(output, "nan", 3u);
+    return output + 3u;
+  }
+  if (std::signbit(value)) {
+    *output++ = '-';
+    value = -value;
+  }
+  if (std::isinf(value)) {
+    std::memcpy(output, "inf", 3u);
+    return output + 3u;
+  } else if (value == 0) {
+    *output++ = '0';
+    return output;
+  } else {
+    char digits[20];
+    int length;
+    int k;
+    Grisu2(value, digits, length, k);
+    return FormatDecimal(digits, length, k, output);
+  }
+}
+
+// Parses the digits into `output`, failing if the number does not fit `limit`.
+inline const char* ParseUnsigned(const char* begin, const char* end, uint64_t limit, uint64_t& output) {
+  const char* p = begin;
+  uint64_t value = 0u;
+  while (p < end && *p >= '0' && *p <= '9') {
+    const uint64_t digit = static_cast<uint64_t>(*p - '0');
+    if (value > (limit - digit) / 10u) {
+      return nullptr;
+    }
+    value = value * 10u + digit;
+    ++p;
+  }
+  if (p == begin) {
+    return nullptr;
+  }
+  output = value;
+  return p;
+}
+
+inline const double* ExactPowersOfTen() {
+  static const double kPowersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  return kPowersOfTen;
+}
+
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline const char* ParseFloatingPoint(const char* begin, const char* end, double& output) {
+  const char* p = begin;
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (end - p >= 3 && !std::memcmp(p, "nan", 3u)) {
+    output = std::numeric_limits<double>::quiet_NaN();
+    return p + 3;
+  }
+  if (end - p >= 3 && !std::memcmp(p, "inf", 3u)) {
+    output = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    return p + 3;
+  }
+
+  // Up to 19 significant digits fit `uint64_t`; the rest only matter to tell whether the fast path is exact.
+  uint64_t significand = 0u;
+  int significant_digits = 0;
+  int exponent = 0;
+  bool has_digits = false;
+  bool inexact = false;
+  while (p < end && IsDigit(*p)) {
+    has_digits = true;
+    if (significant_digits < 19) {
+      significand = significand * 10u + static_cast<uint64_t>(*p - '0');
+      significant_digits += (significand != 0u);
+    } else {
+      ++exponent;
+      inexact |= (*p != '0');
+    }
+    ++p;
+  }
+  if (p < end && *p == '.') {
+    ++p;
+    while (p < end && IsDigit(*p)) {
+      has_digits = true;
+      if (significant_digits < 19) {
+        significand = significand * 10u + static_cast<uint64_t>(*p - '0');
+        significant_digits += (significand != 0u);
+        --exponent;
+      } else {
+        inexact |= (*p != '0');
+      }
+      ++p;
+    }
+  }
+  if (!has_digits) {
+    return nullptr;
+  }
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char* q = p + 1;
+    bool negative_exponent = false;
+    if (q < end && (*q == '-' || *q == '+')) {
+      negative_exponent = (*q == '-');
+      ++q;
+    }
+    if (q < end && IsDigit(*q)) {
+      int explicit_exponent = 0;
+      while (q < end && IsDigit(*q)) {
+        if (explicit_exponent < 100000) {
+          explicit_exponent = explicit_exponent * 10 + (*q - '0');
+        }
+        ++q;
+      }
+      exponent += negative_exponent ? -explicit_exponent : explicit_exponent;
+      p = q;
+    }
+  }
+
+  if (significand == 0u) {
+    output = negative ? -0.0 : 0.0;
+  } else if (!inexact && significand <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+    // Both the significand and the power of ten are exact doubles, so is the correctly rounded result.
+    const double value = static_cast<double>(significand);
+    const double scaled = exponent < 0 ? value / ExactPowersOfTen()[-exponent] : value * ExactPowersOfTen()[exponent];
+    output = negative ? -scaled : scaled;
+  } else {
+    // `std::strtod()` respects the locale, so the decimal point is replaced by the one it expects.
+    const char decimal_point = *std::localeconv()->decimal_point;
+    const size_t length = static_cast<size_t>(p - begin);
+    char buffer[128];
+    std::string long_buffer;
+    char* copy = buffer;
+    if (length >= sizeof(buffer)) {
+      long_buffer.resize(length + 1u);
+      copy = &long_buffer[0];
+    }
+    std::memcpy(copy, begin, length);
+    copy[length] = '\0';
+    if (decimal_point != '.') {
+      char* point = static_cast<char*>(std::memchr(copy, '.', length));
+      if (point) {
+        *point = decimal_point;
+      }
+    }
+    output = std::strtod(copy, nullptr);
+  }
+  return p;
+}
+
+}  // namespace current::strings::number
+
+// Writes the number, with no terminating zero byte, and returns the pointer past its last character.
+// Writes at most `kMaxFormattedNumberLength` characters.
+template <typename T>
+inline ENABLE_IF<std::is_integral<T>::value && std::is_signed<T>::value && !std::is_same<T, bool>::value, char*>
+FormatNumber(T value, char* output) {
+  return number::FormatSigned(static_cast<int64_t>(value), output);
+}
+
+template <typename T>
+inline ENABLE_IF<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value, char*>
+FormatNumber(T value, char* output) {
+  return number::FormatUnsigned(static_cast<uint64_t>(value), output);
+}
+
+inline char* FormatNumber(double value, char* output) { return number::FormatFloatingPoint(value, output); }
+
+inline char* FormatNumber(float value, char* output) { return number::FormatFloatingPoint(value, output); }
+
+// With the precision of `double`.
+inline char* FormatNumber(long double value, char* output) {
+  return number::FormatFloatingPoint(static_cast<double>(value), output);
+}
+
+template <typename T>
+inline void AppendNumber(std::string& output, T value) {
+  char buffer[kMaxFormattedNumberLength];
+  output.append(buffer, FormatNumber(value, buffer));
+}
+
+// Parses the number at the very beginning of `[begin, end)`, and returns the pointer past it,
+// or returns `nullptr`, leaving `output` intact, if there is no number there, or if it is out of the range of `T`.
+template <typename T>
+inline ENABLE_IF<std::is_integral<T>::value && std::is_signed<T>::value && !std::is_same<T, bool>::value, const char*>
+ParseNumber(const char* begin, const char* end, T& output) {
+  const bool negative = (begin < end && *begin == '-');
+  if (begin < end && (*begin == '-' || *begin == '+')) {
+    ++begin;
+  }
+  const uint64_t max = static_cast<uint64_t>(std::numeric_limits<T>::max());
+  uint64_t magnitude;
+  const char* result = number::ParseUnsigned(begin, end, negative ? max + 1u : max, magnitude);
+  if (result) {
+    output = negative ? static_cast<T>(-static_cast<int64_t>(magnitude - 1u) - 1) : static_cast<T>(magnitude);
+  }
+  return result;
+}
+
+template <typename T>
+inline ENABLE_IF<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, bool>::value,
+                 const char*>
+ParseNumber(const char* begin, const char* end, T& output) {
+  if (begin < end && *begin == '+') {
+    ++begin;
+  }
+  uint64_t value;
+  const char* result = number::ParseUnsigned(begin, end, std::numeric_limits<T>::max(), value);
+  if (result) {
+    output = static_cast<T>(value);
+  }
+  return result;
+}
+
+template <typename T>
+inline ENABLE_IF<std::is_floating_point<T>::value, const char*> ParseNumber(const char* begin,
+                                                                          const char* end,
+                                                                          T& output) {
+  double value;
+  const char* result = number::ParseFloatingPoint(begin, end, value);
+  if (result) {
+    output = static_cast<T>(value);
+  }
+  return result;
+}
+
+}  // namespace current::strings
+}  // namespace current
+
+#endif  // BRICKS_STRINGS_NUMBER_H
@@ -30,6 +30,7 @@ SOFTWARE.
 #include "fixed_size_serializer.h"
 #include "is_string_type.h"
 #include "join.h"
+#include "number.h"
 #include "printf.h"
 #include "split.h"
 #include "util.h"
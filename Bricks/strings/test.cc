@@ -24,6 +24,9 @@ SOFTWARE.
 
 #include <chrono>
 #include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
 #include <set>
 #include <string>
 #include <vector>
@@ -34,6 +37,8 @@ SOFTWARE.
 
 using current::strings::Printf;
 using current::strings::FixedSizeSerializer;
+using current::strings::FormatNumber;
+using current::strings::ParseNumber;
 using current::strings::PackToString;
 using current::strings::UnpackFromString;
 using current::strings::CompileTimeStringLength;
@@ -139,6 +144,21 @@ TEST(Util, FromString) {
   EXPECT_EQ(32767, static_cast<int>(current::FromString<int16_t>("32767")));
   EXPECT_EQ(65535, static_cast<int>(current::FromString<uint16_t>("65535")));
 
+  // Same as `operator>>`, negative numbers wrap around for the unsigned types, unless they are out of range.
+  EXPECT_EQ(65535, static_cast<int>(current::FromString<uint16_t>("-1")));
+  EXPECT_EQ(1, static_cast<int>(current::FromString<uint16_t>("-65535")));
+  EXPECT_EQ(0, static_cast<int>(current::FromString<uint16_t>("-65536")));
+  EXPECT_EQ(4294967295u, current::FromString<uint32_t>(" -1"));
+  EXPECT_EQ(0u, current::FromString<uint32_t>("-0"));
+  EXPECT_EQ(0u, current::FromString<uint32_t>("-+1"));
+  EXPECT_EQ(std::numeric_limits<uint64_t>::max(), current::FromString<uint64_t>("-1"));
+  EXPECT_EQ(-1, current::FromString<int>("-1"));
+
+  // The whitespace is skipped, and the non-ASCII bytes are not mistaken for it.
+  EXPECT_EQ(42, current::FromString<int>(" \t\n42"));
+  EXPECT_EQ(0, current::FromString<int>("\xa0" "42"));
+  EXPECT_EQ("\xa0x\xa0", Trim(" \xa0x\xa0 "));
+
   double tmp_double;
   EXPECT_EQ(0.25, current::FromString("0.25", tmp_double));
   EXPECT_EQ(0.25, tmp_double);
@@ -187,7 +207,7 @@ TEST(ToString, SmokeTest) {
   EXPECT_EQ("one two", current::ToString("one two"));
   EXPECT_EQ("three four", current::ToString(std::string("three four")));
   EXPECT_EQ("42", current::ToString(42));
-  EXPECT_EQ("0.500000", current::ToString(0.5));
+  EXPECT_EQ("0.5", current::ToString(0.5));
   EXPECT_EQ("c", current::ToString('c'));
   EXPECT_EQ("true", current::ToString(true));
   EXPECT_EQ("false", current::ToString(false));
@@ -196,6 +216,196 @@ TEST(ToString, SmokeTest) {
   EXPECT_EQ("100000042", current::ToString(std::chrono::microseconds(100000042)));
 }
 
+namespace strings_test {
+
+template <typename T>
+std::string Format(T value) {
+  char buffer[current::strings::kMaxFormattedNumberLength];
+  return std::string(buffer, FormatNumber(value, buffer));
+}
+
+// Returns the number of characters parsed, or -1 on failure.
+template <typename T>
+int Parse(const std::string& input, T& output) {
+  const char* end = ParseNumber(input.data(), input.data() + input.length(), output);
+  return end ? static_cast<int>(end - input.data()) : -1;
+}
+
+template <typename T, typename BITS>
+void RandomRoundTrips(size_t count) {
+  std::mt19937_64 random(42);
+  for (size_t i = 0u; i < count; ++i) {
+    const BITS bits = static_cast<BITS>(random());
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    if (std::isfinite(value)) {
+      const std::string formatted = Format(value);
+      T parsed;
+      ASSERT_EQ(static_cast<int>(formatted.length()), Parse(formatted, parsed)) << formatted;
+      ASSERT_EQ(value, parsed) << formatted;
+      ASSERT_EQ(std::signbit(value), std::signbit(parsed)) << formatted;
+      ASSERT_EQ(value, static_cast<T>(std::strtod(formatted.c_str(), nullptr))) << formatted;
+    }
+  }
+}
+
+}  // namespace strings_test
+
+TEST(Number, FormatIntegers) {
+  using strings_test::Format;
+  EXPECT_EQ("0", Format(0));
+  EXPECT_EQ("7", Format(7u));
+  EXPECT_EQ("-7", Format(-7));
+  EXPECT_EQ("10", Format(10));
+  EXPECT_EQ("99", Format(99));
+  EXPECT_EQ("100", Format(100));
+  EXPECT_EQ("-12345", Format(static_cast<int16_t>(-12345)));
+  EXPECT_EQ("65535", Format(std::numeric_limits<uint16_t>::max()));
+  EXPECT_EQ("-2147483648", Format(std::numeric_limits<int32_t>::min()));
+  EXPECT_EQ("4294967295", Format(std::numeric_limits<uint32_t>::max()));
+  EXPECT_EQ("-9223372036854775808", Format(std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ("9223372036854775807", Format(std::numeric_limits<int64_t>::max()));
+  EXPECT_EQ("18446744073709551615", Format(std::numeric_limits<uint64_t>::max()));
+  for (int64_t i = -100000; i <= 100000; i += 7) {
+    ASSERT_EQ(std::to_string(i), Format(i));
+  }
+}
+
+TEST(Number, ParseIntegers) {
+  using strings_test::Parse;
+  int32_t i32 = 0;
+  EXPECT_EQ(2, Parse("42", i32));
+  EXPECT_EQ(42, i32);
+  EXPECT_EQ(3, Parse("-42 and more", i32));
+  EXPECT_EQ(-42, i32);
+  EXPECT_EQ(3, Parse("+42", i32));
+  EXPECT_EQ(42, i32);
+  EXPECT_EQ(11, Parse("-2147483648", i32));
+  EXPECT_EQ(std::numeric_limits<int32_t>::min(), i32);
+  EXPECT_EQ(10, Parse("2147483647", i32));
+  EXPECT_EQ(std::numeric_limits<int32_t>::max(), i32);
+  EXPECT_EQ(-1, Parse("2147483648", i32));
+  EXPECT_EQ(-1, Parse("-2147483649", i32));
+  EXPECT_EQ(-1, Parse("", i32));
+  EXPECT_EQ(-1, Parse("-", i32));
+  EXPECT_EQ(-1, Parse("x1", i32));
+  EXPECT_EQ(std::numeric_limits<int32_t>::max(), i32) << "The output should be left intact on failure.";
+
+  int64_t i64 = 0;
+  EXPECT_EQ(20, Parse("-9223372036854775808", i64));
+  EXPECT_EQ(std::numeric_limits<int64_t>::min(), i64);
+  EXPECT_EQ(-1, Parse("9223372036854775808", i64));
+
+  uint64_t u64 = 0u;
+  EXPECT_EQ(20, Parse("18446744073709551615", u64));
+  EXPECT_EQ(std::numeric_limits<uint64_t>::max(), u64);
+  EXPECT_EQ(-1, Parse("18446744073709551616", u64));
+  EXPECT_EQ(-1, Parse("-1", u64));
+
+  uint16_t u16 = 0u;
+  EXPECT_EQ(5, Parse("65535", u16));
+  EXPECT_EQ(65535u, u16);
+  EXPECT_EQ(-1, Parse("65536", u16));
+}
+
+TEST(Number, FormatDoubles) {
+  using strings_test::Format;
+  EXPECT_EQ("0", Format(0.0));
+  EXPECT_EQ("-0", Format(-0.0));
+  EXPECT_EQ("1", Format(1.0));
+  EXPECT_EQ("-1", Format(-1.0));
+  EXPECT_EQ("0.5", Format(0.5));
+  EXPECT_EQ("0.1", Format(0.1));
+  EXPECT_EQ("0.3", Format(0.3));
+  // Seventeen digits are the shortest form here, yet Grisu2 may pick a neighbor of the closest one in such cases.
+  EXPECT_EQ(19u, Format(0.1 + 0.2).length());
+  EXPECT_EQ(0.1 + 0.2, current::FromString<double>(Format(0.1 + 0.2)));
+  EXPECT_EQ("3.14", Format(3.14));
+  EXPECT_EQ("100", Format(100.0));
+  EXPECT_EQ("123456789012", Format(123456789012.0));
+  EXPECT_EQ("9007199254740992", Format(9007199254740992.0));
+  EXPECT_EQ("100000000000000000000", Format(1e20));
+  EXPECT_EQ("1e+21", Format(1e21));
+  EXPECT_EQ("1.5e+300", Format(1.5e300));
+  EXPECT_EQ("0.000001", Format(1e-6));
+  EXPECT_EQ("1e-7", Format(1e-7));
+  EXPECT_EQ("1.5e-7", Format(1.5e-7));
+  EXPECT_EQ("1.7976931348623157e+308", Format(std::numeric_limits<double>::max()));
+  EXPECT_EQ("2.2250738585072014e-308", Format(std::numeric_limits<double>::min()));
+  EXPECT_EQ("5e-324", Format(std::numeric_limits<double>::denorm_min()));
+  EXPECT_EQ("2.220446049250313e-16", Format(std::numeric_limits<double>::epsilon()));
+  EXPECT_EQ("inf", Format(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("-inf", Format(-std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("nan", Format(std::numeric_limits<double>::quiet_NaN()));
+
+  EXPECT_EQ("0.1", Format(0.1f));
+  EXPECT_EQ("3.4028235e+38", Format(std::numeric_limits<float>::max()));
+  EXPECT_EQ("1e-45", Format(std::numeric_limits<float>::denorm_min()));
+  EXPECT_EQ("16777216", Format(16777216.0f));
+}
+
+TEST(Number, ParseDoubles) {
+  using strings_test::Parse;
+  double d = 0.0;
+  EXPECT_EQ(3, Parse("0.5", d));
+  EXPECT_EQ(0.5, d);
+  EXPECT_EQ(2, Parse(".5", d));
+  EXPECT_EQ(0.5, d);
+  EXPECT_EQ(2, Parse("5.", d));
+  EXPECT_EQ(5.0, d);
+  EXPECT_EQ(5, Parse("-1e10", d));
+  EXPECT_EQ(-1e10, d);
+  EXPECT_EQ(7, Parse("1.5E-07", d));
+  EXPECT_EQ(1.5e-7, d);
+  EXPECT_EQ(1, Parse("1e", d)) << "The dangling exponent is not a part of the number.";
+  EXPECT_EQ(1.0, d);
+  EXPECT_EQ(2, Parse("-0", d));
+  EXPECT_TRUE(std::signbit(d));
+  EXPECT_EQ(19, Parse("0.30000000000000004", d));
+  EXPECT_EQ(0.1 + 0.2, d);
+  EXPECT_EQ(23, Parse("1.7976931348623157e+308", d));
+  EXPECT_EQ(std::numeric_limits<double>::max(), d);
+  EXPECT_EQ(6, Parse("5e-324", d));
+  EXPECT_EQ(std::numeric_limits<double>::denorm_min(), d);
+  EXPECT_EQ(24, Parse("123456789012345678901234", d));
+  EXPECT_EQ(123456789012345678901234.0, d);
+  EXPECT_EQ(22, Parse("9007199254740993.00001", d)) << "Rounds correctly past 2^53.";
+  EXPECT_EQ(9007199254740994.0, d);
+  EXPECT_EQ(3, Parse("inf", d));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), d);
+  EXPECT_EQ(3, Parse("nan", d));
+  EXPECT_TRUE(std::isnan(d));
+  EXPECT_EQ(-1, Parse("", d));
+  EXPECT_EQ(-1, Parse(".", d));
+  EXPECT_EQ(-1, Parse("-e5", d));
+
+  float f = 0.0f;
+  EXPECT_EQ(3, Parse("0.1", f));
+  EXPECT_EQ(0.1f, f);
+  EXPECT_EQ(13, Parse("3.4028235e+38", f));
+  EXPECT_EQ(std::numeric_limits<float>::max(), f);
+}
+
+TEST(Number, RandomRoundTrips) {
+  strings_test::RandomRoundTrips<double, uint64_t>(100000u);
+  strings_test::RandomRoundTrips<float, uint32_t>(100000u);
+}
+
+TEST(Number, FromStringAndToString) {
+  EXPECT_EQ(42, current::FromString<int>("  42"));
+  EXPECT_EQ(42, current::FromString<int>(std::string("42 is the answer")));
+  EXPECT_EQ(0, current::FromString<int>("the answer is 42"));
+  EXPECT_EQ(0, current::FromString<int16_t>("100000"));
+  EXPECT_EQ(0.25, current::FromString<double>("0.25"));
+  EXPECT_EQ(1e100, current::FromString<double>(current::ToString(1e100)));
+  EXPECT_EQ(0.1f, current::FromString<float>(current::ToString(0.1f)));
+  EXPECT_EQ("0.1", current::ToString(0.1f));
+  EXPECT_EQ("-9223372036854775808", current::ToString(std::numeric_limits<int64_t>::min()));
+  std::string s = "x=";
+  current::strings::AppendNumber(s, 1.25);
+  EXPECT_EQ("x=1.25", s);
+}
+
 TEST(Util, ToUpperAndToLower) {
   EXPECT_EQ("test passed", ToLower("TeSt pAsSeD"));
   EXPECT_EQ("TEST PASSED", ToUpper("TeSt pAsSeD"));
@@ -218,7 +428,7 @@ TEST(JoinAndSplit, Join) {
   EXPECT_EQ("a,b,b,c", Join(std::multiset<std::string>({"a", "b", "c", "b"}), ','));
 
   EXPECT_EQ("x->y->z", Join(std::set<char>({'x', 'z', 'y'}), "->"));
-  EXPECT_EQ("0.500000<0.750000<0.875000<1.000000", Join(std::multiset<double>({1, 0.5, 0.75, 0.875}), '<'));
+  EXPECT_EQ("0.5<0.75<0.875<1", Join(std::multiset<double>({1, 0.5, 0.75, 0.875}), '<'));
 }
 
 TEST(JoinAndSplit, Split) {
@@ -32,6 +32,7 @@ SOFTWARE.
 #include <string>
 
 #include "is_string_type.h"
+#include "number.h"
 
 #include "../template/enable_if.h"
 #include "../template/decay.h"
@@ -64,12 +65,15 @@ constexpr auto HasMemberFromString(int) -> decltype(std::declval<T>().FromString
 
 }  // namespace sfinae
 
-// Default implepentation for arithmetic types calling `std::to_string`.
+// Default implepentation for arithmetic types calling `FormatNumber()`.
+// Unlike `std::to_string()`, it is locale-independent,
+// and outputs the shortest round-trip form of floating point numbers.
 template <typename DECAYED_T, bool HAS_MEMBER_TO_STRING, bool IS_ENUM>
 struct ToStringImpl {
   template <bool B = std::is_arithmetic<DECAYED_T>::value>
   static ENABLE_IF<B, std::string> DoIt(DECAYED_T value) {
-    return std::to_string(value);
+    char buffer[kMaxFormattedNumberLength];
+    return std::string(buffer, FormatNumber(value, buffer));
   }
 };
 
@@ -89,7 +93,9 @@ struct ToStringImpl<DECAYED_T, true, false> {
 template <typename DECAYED_T>
 struct ToStringImpl<DECAYED_T, false, true> {
   static std::string DoIt(DECAYED_T value) {
-    return std::to_string(static_cast<typename std::underlying_type<DECAYED_T>::type>(value));
+    char buffer[kMaxFormattedNumberLength];
+    return std::string(buffer,
+                       FormatNumber(static_cast<typename std::underlying_type<DECAYED_T>::type>(value), buffer));
   }
 };
 
@@ -122,13 +128,19 @@ struct ToStringImpl<char, false, false> {
 // `std::chrono::milliseconds`.
 template <>
 struct ToStringImpl<std::chrono::milliseconds, false, false> {
-  static std::string DoIt(std::chrono::milliseconds t) { return std::to_string(t.count()); }
+  static std::string DoIt(std::chrono::milliseconds t) {
+    char buffer[kMaxFormattedNumberLength];
+    return std::string(buffer, FormatNumber(static_cast<int64_t>(t.count()), buffer));
+  }
 };
 
 // `std::chrono::microseconds`.
 template <>
 struct ToStringImpl<std::chrono::microseconds, false, false> {
-  static std::string DoIt(std::chrono::microseconds t) { return std::to_string(t.count()); }
+  static std::string DoIt(std::chrono::microseconds t) {
+    char buffer[kMaxFormattedNumberLength];
+    return std::string(buffer, FormatNumber(static_cast<int64_t>(t.count()), buffer));
+  }
 };
 
 template <typename T>
@@ -138,6 +150,47 @@ inline std::string ToString(T&& something) {
       std::forward<T>(something));
 }
 
+namespace impl {
+
+// The numbers `FromString()` parses via `ParseNumber()`. The single-byte integers are read as characters instead.
+template <typename T>
+struct IsParsedAsNumber {
+  constexpr static bool value = std::is_floating_point<T>::value ||
+                                (std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) > 1u);
+};
+
+// Mimics `std::istream::operator>>`: skips the leading whitespace, and reads the longest prefix that is a number.
+// As with `operator>>`, a negative number is read into an unsigned type modulo its range, so that "-1" is the maximum.
+template <typename T>
+inline void ParseNumberFromString(const char* begin, const char* end, T& output) {
+  while (begin < end && ::isspace(static_cast<unsigned char>(*begin))) {
+    ++begin;
+  }
+  if (std::is_unsigned<T>::value && end - begin > 1 && *begin == '-' && begin[1] >= '0' && begin[1] <= '9') {
+    T magnitude;
+    if (ParseNumber(begin + 1, end, magnitude)) {
+      output = static_cast<T>(T(0) - magnitude);
+    } else {
+      output = T();
+    }
+  } else if (!ParseNumber(begin, end, output)) {
+    // Default initializer, zero for primitive types.
+    output = T();
+  }
+}
+
+template <typename T>
+inline void ParseNumberFromString(const std::string& input, T& output) {
+  ParseNumberFromString(input.data(), input.data() + input.length(), output);
+}
+
+template <typename T>
+inline void ParseNumberFromString(const char* input, T& output) {
+  ParseNumberFromString(input, input + ::strlen(input), output);
+}
+
+}  // namespace current::strings::impl
+
 template <typename INPUT, typename OUTPUT, bool HAS_MEMBER_FROM_STRING, bool IS_ENUM>
 struct FromStringImpl;
 
@@ -151,7 +204,14 @@ struct FromStringImpl<INPUT, OUTPUT, true, false> {
 
 template <typename INPUT, typename OUTPUT>
 struct FromStringImpl<INPUT, OUTPUT, false, false> {
-  static const OUTPUT& Go(INPUT&& input, OUTPUT& output) {
+  template <bool B = impl::IsParsedAsNumber<OUTPUT>::value>
+  static ENABLE_IF<B, const OUTPUT&> Go(INPUT&& input, OUTPUT& output) {
+    impl::ParseNumberFromString(input, output);
+    return output;
+  }
+
+  template <bool B = impl::IsParsedAsNumber<OUTPUT>::value>
+  static ENABLE_IF<!B, const OUTPUT&> Go(INPUT&& input, OUTPUT& output) {
     std::istringstream is(input);
     if (!(is >> output)) {
       // Default initializer, zero for primitive types.
@@ -164,13 +224,9 @@ struct FromStringImpl<INPUT, OUTPUT, false, false> {
 template <typename INPUT, typename OUTPUT>
 struct FromStringImpl<INPUT, OUTPUT, false, true> {
   static const OUTPUT& Go(INPUT&& input, OUTPUT& output) {
-    std::istringstream is(input);
     using underlying_output_t = typename std::underlying_type<OUTPUT>::type;
     underlying_output_t underlying_output;
-    if (!(is >> underlying_output)) {
-      // Default initializer, zero for primitive types.
-      underlying_output = underlying_output_t();
-    }
+    FromStringImpl<INPUT, underlying_output_t, false, false>::Go(std::forward<INPUT>(input), underlying_output);
     output = static_cast<OUTPUT>(underlying_output);
     return output;
   }
@@ -188,11 +244,8 @@ struct FromStringImpl<INPUT, bool, false, false> {
 template <typename INPUT>
 struct FromStringImpl<INPUT, std::chrono::milliseconds, false, false> {
   static const std::chrono::milliseconds& Go(INPUT&& input, std::chrono::milliseconds& output) {
-    std::istringstream is(input);
     int64_t underlying_output;
-    if (!(is >> underlying_output)) {
-      underlying_output = 0ll;
-    }
+    impl::ParseNumberFromString(input, underlying_output);
     output = static_cast<std::chrono::milliseconds>(underlying_output);
     return output;
   }
@@ -201,11 +254,8 @@ struct FromStringImpl<INPUT, std::chrono::milliseconds, false, false> {
 template <typename INPUT>
 struct FromStringImpl<INPUT, std::chrono::microseconds, false, false> {
   static const std::chrono::microseconds& Go(INPUT&& input, std::chrono::microseconds& output) {
-    std::istringstream is(input);
     int64_t underlying_output;
-    if (!(is >> underlying_output)) {
-      underlying_output = 0ll;
-    }
+    impl::ParseNumberFromString(input, underlying_output);
     output = static_cast<std::chrono::microseconds>(underlying_output);
     return output;
   }
@@ -241,11 +291,11 @@ inline std::string Trim(const char* input, const size_t length) {
   const char* begin = input;
   const char* end = input + length;
   const char* output_begin = begin;
-  while (output_begin < end && ::isspace(*output_begin)) {
+  while (output_begin < end && ::isspace(static_cast<unsigned char>(*output_begin))) {
     ++output_begin;
   }
   const char* output_end = end;
-  while (output_end > output_begin && ::isspace(*(output_end - 1))) {
+  while (output_end > output_begin && ::isspace(static_cast<unsigned char>(*(output_end - 1)))) {
     --output_end;
   }
   return std::string(output_begin, output_end);
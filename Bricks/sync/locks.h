@@ -25,6 +25,7 @@ SOFTWARE.
 #ifndef CURRENT_BRICKS_UTIL_LOCK_H
 #define CURRENT_BRICKS_UTIL_LOCK_H
 
+#include <condition_variable>
 #include <mutex>
 #include <type_traits>
 
@@ -45,6 +46,83 @@ using SmartMutexLockGuard =
 static_assert(std::is_same<std::lock_guard<std::mutex>, SmartMutexLockGuard<MutexLockStatus::NeedToLock>>::value, "");
 static_assert(std::is_same<NoOpLock, SmartMutexLockGuard<MutexLockStatus::AlreadyLocked>>::value, "");
 
+// The reader-writer mutex, as `std::shared_timed_mutex` is C++14. Meets the requirements of `std::lock_guard<>`
+// for the exclusive ownership, and of `SharedLockGuard<>` below for the shared one.
+// The writers are preferred: once a writer is waiting, the new readers wait for it too, so that the steady flow
+// of readers can not starve the writers.
+class SharedMutex final {
+ public:
+  SharedMutex() = default;
+  SharedMutex(const SharedMutex&) = delete;
+  SharedMutex& operator=(const SharedMutex&) = delete;
+
+  void lock() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++waiting_writers_;
+    writers_cv_.wait(lock, [this]() { return !writer_ && !readers_; });
+    --waiting_writers_;
+    writer_ = true;
+  }
+
+  bool try_lock() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (writer_ || readers_) {
+      return false;
+    }
+    writer_ = true;
+    return true;
+  }
+
+  void unlock() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writer_ = false;
+    if (waiting_writers_) {
+      writers_cv_.notify_one();
+    } else {
+      readers_cv_.notify_all();
+    }
+  }
+
+  void lock_shared() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    readers_cv_.wait(lock, [this]() { return !writer_ && !waiting_writers_; });
+    ++readers_;
+  }
+
+  void unlock_shared() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!--readers_ && waiting_writers_) {
+      writers_cv_.notify_one();
+    }
+  }
+
+  // The number of writers blocked in `lock()`, for the unit test to wait for without relying on timing.
+  size_t WaitingWritersCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return waiting_writers_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable readers_cv_;
+  std::condition_variable writers_cv_;
+  size_t readers_ = 0u;
+  size_t waiting_writers_ = 0u;
+  bool writer_ = false;
+};
+
+template <class MUTEX>
+class SharedLockGuard final {
+ public:
+  explicit SharedLockGuard(MUTEX& mutex) : mutex_(mutex) { mutex_.lock_shared(); }
+  ~SharedLockGuard() { mutex_.unlock_shared(); }
+  SharedLockGuard(const SharedLockGuard&) = delete;
+  SharedLockGuard& operator=(const SharedLockGuard&) = delete;
+
+ private:
+  MUTEX& mutex_;
+};
+
 }  // namespace locks
 }  // namespace current
 
@@ -22,11 +22,15 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 *******************************************************************************/
 
+#include "locks.h"
 #include "scope_owned.h"
 #include "waitable_atomic.h"
 
+#include <atomic>
 #include <thread>
 
+#include "../strings/join.h"
+
 #include "../../3rdparty/gtest/gtest-main.h"
 
 // Test using `ScopeOwnedByMe<>` as a `shared_ptr<>`.
@@ -297,3 +301,53 @@ TEST(WaitableAtomic, IntrusiveClientsCanBeTransferred) {
   auto f = [](IntrusiveClient& c) { static_cast<void>(c); };
   std::thread([&f](IntrusiveClient c) { f(c); }, object.RegisterScopedClient()).detach();
 }
+
+TEST(Locks, SharedMutex) {
+  using current::locks::SharedMutex;
+  using current::locks::SharedLockGuard;
+
+  SharedMutex mutex;
+
+  // The readers share the mutex.
+  {
+    SharedLockGuard<SharedMutex> first(mutex);
+    std::atomic_bool second_reader_entered(false);
+    std::thread([&mutex, &second_reader_entered]() {
+      SharedLockGuard<SharedMutex> second(mutex);
+      second_reader_entered = true;
+    }).join();
+    EXPECT_TRUE(second_reader_entered);
+    EXPECT_FALSE(mutex.try_lock());
+  }
+
+  // The writer waits for the reader, and the reader which comes after the writer waits for both.
+  std::vector<std::string> log;
+  std::mutex log_mutex;
+  const auto Log = [&log, &log_mutex](const std::string& s) {
+    std::lock_guard<std::mutex> lock(log_mutex);
+    log.push_back(s);
+  };
+  {
+    std::unique_ptr<SharedLockGuard<SharedMutex>> reader = std::make_unique<SharedLockGuard<SharedMutex>>(mutex);
+    std::thread writer([&mutex, &Log]() {
+      std::lock_guard<SharedMutex> lock(mutex);
+      Log("writer");
+    });
+    while (!mutex.WaitingWritersCount()) {
+      std::this_thread::yield();
+    }
+    // Once the writer is waiting, the late reader can not get ahead of it, whenever it gets to the mutex.
+    std::thread late_reader([&mutex, &Log]() {
+      SharedLockGuard<SharedMutex> lock(mutex);
+      Log("late reader");
+    });
+    Log("reader");
+    reader = nullptr;
+    writer.join();
+    late_reader.join();
+  }
+  EXPECT_EQ("reader writer late reader", current::strings::Join(log, ' '));
+
+  EXPECT_TRUE(mutex.try_lock());
+  mutex.unlock();
+}
@@ -91,6 +91,34 @@ static_assert(TypeListContains<TypeListImpl<int, double, char>, char>::value, ""
 static_assert(TypeListContains<TypeListImpl<char, int>, char>::value, "");
 static_assert(TypeListContains<TypeListImpl<int, char>, char>::value, "");
 
+// `TypeListIndex<TypeListImpl<TS...>, T>::value` is the zero-based index of the first `T` in `TS...`,
+// or `sizeof...(TS)` if `T` is not contained in `TS...`.
+template <typename TYPE_LIST_IMPL, typename TYPE>
+struct TypeListIndex;
+
+template <typename T>
+struct TypeListIndex<TypeListImpl<>, T> {
+  constexpr static size_t value = 0u;
+};
+
+template <typename T, typename... TS>
+struct TypeListIndex<TypeListImpl<T, TS...>, T> {
+  constexpr static size_t value = 0u;
+};
+
+template <typename X, typename... TS, typename T>
+struct TypeListIndex<TypeListImpl<X, TS...>, T> {
+  constexpr static size_t value = 1u + TypeListIndex<TypeListImpl<TS...>, T>::value;
+};
+
+static_assert(TypeListIndex<TypeListImpl<>, int>::value == 0u, "");
+static_assert(TypeListIndex<TypeListImpl<int>, int>::value == 0u, "");
+static_assert(TypeListIndex<TypeListImpl<int>, char>::value == 1u, "");
+static_assert(TypeListIndex<TypeListImpl<char, int, double>, char>::value == 0u, "");
+static_assert(TypeListIndex<TypeListImpl<char, int, double>, int>::value == 1u, "");
+static_assert(TypeListIndex<TypeListImpl<char, int, double>, double>::value == 2u, "");
+static_assert(TypeListIndex<TypeListImpl<char, int, double>, float>::value == 3u, "");
+
 // `TypeListCat` creates a `TypeList<LHS..., RHS...>` given `TypeList<LHS...>` and `TypeList<RHS...>`.
 // By design, it would fail at compile tim if `LHS...` and `RHS...` have at least one shared type.
 template <typename LHS, typename RHS>
@@ -404,6 +432,7 @@ static_assert(std::is_same<char, TypeListElement<1, TypeListImpl<long, char>>>::
 using current::metaprogramming::TypeList;
 using current::metaprogramming::SlowTypeList;
 using current::metaprogramming::TypeListContains;
+using current::metaprogramming::TypeListIndex;
 using current::metaprogramming::IsTypeList;
 using current::metaprogramming::TypeListSize;
 using current::metaprogramming::TypeListElement;
@@ -141,15 +141,10 @@ template <>
 struct FixedSizeSerializer<std::chrono::microseconds> {
   enum { size_in_bytes = std::numeric_limits<uint64_t>::digits10 + 1 };
   static std::string PackToString(std::chrono::microseconds x) {
-    std::ostringstream os;
-    os << std::setfill('0') << std::setw(size_in_bytes) << static_cast<uint64_t>(x.count());
-    return os.str();
+    return FixedSizeSerializer<uint64_t>::PackToString(static_cast<uint64_t>(x.count()));
   }
   static std::chrono::microseconds UnpackFromString(std::string const& s) {
-    uint64_t x;
-    std::istringstream is(s);
-    is >> x;
-    return std::chrono::microseconds(x);
+    return std::chrono::microseconds(FixedSizeSerializer<uint64_t>::UnpackFromString(s));
   }
 };
 
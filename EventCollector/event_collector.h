@@ -95,7 +95,7 @@ class EventCollectorHTTPServer {
                                             entry.c = r.headers.CookiesAsString();
                                             entry.b = r.body;
                                             entry.f = r.url.fragment;
-                                            ostream_ << JSON(entry) << std::endl;
+                                            WriteEntry(entry);
                                             ++events_pushed_;
                                             last_event_t_ = now;
                                             if (callback_) {
@@ -128,7 +128,7 @@ class EventCollectorHTTPServer {
           LogEntryWithHeaders entry;
           entry.t = now.count();
           entry.m = "TICK";
-          ostream_ << JSON(entry) << std::endl;
+          WriteEntry(entry);
           ++events_pushed_;
           last_event_t_ = now;
           if (callback_) {
@@ -148,9 +148,18 @@ class EventCollectorHTTPServer {
   size_t EventsPushed() const { return events_pushed_; }
 
  private:
+  // Must be called with `mutex_` locked.
+  void WriteEntry(const LogEntryWithHeaders& entry) {
+    line_.clear();
+    JSONAppend(line_, entry);
+    line_ += '\n';
+    ostream_.write(line_.data(), line_.length()).flush();
+  }
+
   std::mutex mutex_;
   const int http_port_;
   std::ostream& ostream_;
+  std::string line_;  // Reused for every entry written, to not allocate per entry.
   const std::string route_;
   const std::string response_text_;
   std::function<void(const LogEntryWithHeaders&)> callback_;
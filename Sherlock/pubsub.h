@@ -286,14 +286,14 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
         if (to_timestamp_.count() && current.us > to_timestamp_) {
           return ss::EntryResponse::Done;
         }
-        const std::string entry_json = [this, &current, &entry]() {
-          if (params_.entries_only) {
-            return JSON<J>(entry) + '\n';
-          } else {
-            return JSON<J>(current) + '\t' + JSON<J>(entry) + '\n';
-          }
-        }();
-        current_response_size_ += entry_json.length();
+        entry_json_.clear();
+        if (!params_.entries_only) {
+          JSONAppend<J>(entry_json_, current);
+          entry_json_ += '\t';
+        }
+        JSONAppend<J>(entry_json_, entry);
+        entry_json_ += '\n';
+        current_response_size_ += entry_json_.length();
         try {
           if (params_.array) {
             if (!output_started_) {
@@ -303,7 +303,7 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
               http_response_(",\n");
             }
           }
-          http_response_(std::move(entry_json));
+          http_response_(entry_json_);
         } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
           return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
         }
@@ -345,7 +345,10 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
         return ss::EntryResponse::Done;
       }
       if (!params_.array && !params_.entries_only) {
-        http_response_(JSON<J>(ts_optidx_t(us)) + '\n');
+        entry_json_.clear();
+        JSONAppend<J>(entry_json_, ts_optidx_t(us));
+        entry_json_ += '\n';
+        http_response_(entry_json_);
       }
     }
     return ss::EntryResponse::More;
@@ -384,6 +387,8 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
   current::net::HTTPServerConnection::ChunkedResponseSender http_response_;
   // Current response size in bytes.
   size_t current_response_size_ = 0u;
+  // The line being sent, reused to not allocate per entry.
+  std::string entry_json_;
 
   // Conditions on which parts of the stream to serve.
   bool serving_ = true;
@@ -33,6 +33,7 @@ SOFTWARE.
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "exceptions.h"
 #include "stream_data.h"
@@ -147,6 +148,20 @@ class StreamImpl {
       return PublishImpl<MLS>(std::move(entry), us);
     }
 
+    template <current::locks::MutexLockStatus MLS>
+    idxts_t DoPublishBatch(std::vector<entry_t>&& entries, const std::vector<std::chrono::microseconds>& timestamps) {
+      try {
+        auto& data = *data_;
+        current::locks::SmartMutexLockGuard<MLS> lock(data.publish_mutex);
+        const auto result = data.persistence.template PublishBatch<current::locks::MutexLockStatus::AlreadyLocked>(
+            std::move(entries), timestamps);
+        data.notifier.NotifyAllOfExternalWaitableEvent();
+        return result;
+      } catch (const current::sync::InDestructingModeException&) {
+        CURRENT_THROW(StreamInGracefulShutdownException());
+      }
+    }
+
     template <current::locks::MutexLockStatus MLS>
     void DoUpdateHead(const current::time::DefaultTimeArgument) {
       UpdateHeadImpl<MLS>();
@@ -252,6 +267,18 @@ class StreamImpl {
 
   idxts_t Publish(entry_t&& entry, const std::chrono::microseconds us) { return PublishImpl(std::move(entry), us); }
 
+  // Publishes `entries[i]` at `timestamps[i]`, in order, under one lock, and wakes up the subscribers once.
+  // The file persister flushes the file once per batch, not once per entry.
+  idxts_t PublishBatch(std::vector<entry_t>&& entries, const std::vector<std::chrono::microseconds>& timestamps) {
+    std::lock_guard<std::mutex> lock(publisher_mutex_);
+    if (publisher_) {
+      return publisher_->template PublishBatch<current::locks::MutexLockStatus::AlreadyLocked>(std::move(entries),
+                                                                                              timestamps);
+    } else {
+      CURRENT_THROW(PublishToStreamWithReleasedPublisherException());
+    }
+  }
+
   void UpdateHead() { UpdateHeadImpl(); }
 
   void UpdateHead(const std::chrono::microseconds us) { UpdateHeadImpl(us); }
@@ -35,6 +35,7 @@ SOFTWARE.
 
 #include "../TypeSystem/struct.h"
 
+#include "../Bricks/sync/locks.h"
 #include "../Bricks/time/chrono.h"
 
 #include "../Bricks/template/typelist.h"
@@ -43,6 +44,10 @@ SOFTWARE.
 namespace current {
 namespace storage {
 
+// The mutex of the storage: held exclusively by the read-write transactions and while replaying the mutations,
+// and shared by the read-only transactions, which thus run concurrently.
+using storage_mutex_t = current::locks::SharedMutex;
+
 // Instantiation types.
 struct DeclareFields {};
 struct CountFields {};
@@ -133,6 +133,23 @@ class GenericDictionary {
     map_.erase(e.key);
   }
 
+  // Calls `f` with the events which, replayed into an empty container, restore its entries and last modified times.
+  // The deletion events go first, as replaying them after the updates might erase the entries that are present.
+  template <typename F>
+  void ExportEvents(F&& f) const {
+    for (const auto& last_modified : last_modified_) {
+      if (map_.find(last_modified.first) == map_.end()) {
+        DELETE_EVENT event;
+        event.us = last_modified.second;
+        event.key = last_modified.first;
+        f(std::move(event));
+      }
+    }
+    for (const auto& element : map_) {
+      f(UPDATE_EVENT(last_modified_.at(element.first), element.second));
+    }
+  }
+
   struct Iterator final {
     using iterator_t = typename map_t::const_iterator;
     using value_t = sfinae::CF<T>;
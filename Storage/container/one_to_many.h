@@ -193,6 +193,22 @@ class GenericOneToMany {
   }
   void operator()(const DELETE_EVENT& e) { DoEraseWithLastModified(e.us, std::make_pair(e.key.first, e.key.second)); }
 
+  // The events to restore this container from scratch, the deletions first. See `GenericDictionary::ExportEvents()`.
+  template <typename F>
+  void ExportEvents(F&& f) const {
+    for (const auto& last_modified : last_modified_) {
+      if (map_.find(last_modified.first) == map_.end()) {
+        DELETE_EVENT event;
+        event.us = last_modified.second;
+        event.key = last_modified.first;
+        f(std::move(event));
+      }
+    }
+    for (const auto& element : map_) {
+      f(UPDATE_EVENT(last_modified_.at(element.first), *element.second));
+    }
+  }
+
   template <typename ROWS_MAP>
   struct RowsAccessor final {
     using key_t = typename ROWS_MAP::key_type;
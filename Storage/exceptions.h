@@ -80,6 +80,16 @@ struct StorageInGracefulShutdownException : InGracefulShutdownException {
   using InGracefulShutdownException::InGracefulShutdownException;
 };
 
+struct StorageSnapshotsNotSupportedException : StorageException {
+  StorageSnapshotsNotSupportedException()
+      : StorageException("Storage snapshots require the persister to be backed by a file.") {}
+};
+
+struct StorageCannotWriteSnapshotException : StorageException {
+  explicit StorageCannotWriteSnapshotException(const std::string& filename)
+      : StorageException("Cannot write the snapshot into: `" + filename + "`.") {}
+};
+
 }  // namespace current::storage
 }  // namespace current
 
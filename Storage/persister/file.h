@@ -47,7 +47,7 @@ class JSONFilePersister<MUTATIONS_VARIANT, NoCustomPersisterParam> {
   using transaction_t = std::vector<variant_t>;  // Mock to make it compile.
   using fields_update_function_t = std::function<void(const variant_t&)>;
 
-  explicit JSONFilePersister(std::mutex&, fields_update_function_t f, const std::string& filename)
+  explicit JSONFilePersister(storage_mutex_t&, fields_update_function_t f, const std::string& filename)
       : filename_(filename) {
     Replay(f);
   }
@@ -67,6 +67,19 @@ class JSONFilePersister<MUTATIONS_VARIANT, NoCustomPersisterParam> {
     journal.Clear();
   }
 
+  void PersistJournals(std::vector<MutationJournal>& journals) {
+    std::ofstream os(filename_, std::fstream::app);
+    if (os.bad()) {
+      CURRENT_THROW(StorageCannotAppendToFileException(filename_));  // LCOV_EXCL_LINE
+    }
+    for (auto& journal : journals) {
+      for (auto&& entry : journal.commit_log) {
+        os << JSON(variant_t(BypassVariantTypeCheck(), std::move(entry))) << '\n';
+      }
+      journal.Clear();
+    }
+  }
+
   void InternalExposeStream() {}  // No-op to make it compile.
 
  private:
@@ -26,7 +26,11 @@ SOFTWARE.
 #ifndef CURRENT_STORAGE_PERSISTER_SHERLOCK_H
 #define CURRENT_STORAGE_PERSISTER_SHERLOCK_H
 
+#include <atomic>
+#include <thread>
+
 #include "common.h"
+#include "snapshot.h"
 #include "../base.h"
 #include "../exceptions.h"
 #include "../transaction.h"
@@ -48,6 +52,8 @@ class SherlockStreamPersisterImpl {
                                                      STREAM_RECORD_TYPE>::type;
   using sherlock_t = sherlock::Stream<sherlock_entry_t, UNDERLYING_PERSISTER>;
   using fields_update_function_t = std::function<void(const variant_t&)>;
+  // Returns the mutations to restore the current state of all the storage fields. Called with the storage mutex held.
+  using fields_export_function_t = std::function<std::vector<variant_t>()>;
 
   struct SherlockSubscriberImpl {
     using EntryResponse = current::ss::EntryResponse;
@@ -72,7 +78,7 @@ class SherlockStreamPersisterImpl {
   using SherlockSubscriber = current::ss::StreamSubscriber<SherlockSubscriberImpl, transaction_t>;
 
   template <typename... ARGS>
-  explicit SherlockStreamPersisterImpl(std::mutex& storage_mutex, fields_update_function_t f, ARGS&&... args)
+  explicit SherlockStreamPersisterImpl(storage_mutex_t& storage_mutex, fields_update_function_t f, ARGS&&... args)
       : storage_mutex_ref_(storage_mutex),
         fields_update_f_(f),
         stream_owned_if_any_(
@@ -80,11 +86,11 @@ class SherlockStreamPersisterImpl {
         stream_used_(*stream_owned_if_any_.get()),
         authority_(PersisterDataAuthority::Own) {
     // Do not use lock since we are in ctor.
-    SyncReplayStream<current::locks::MutexLockStatus::AlreadyLocked>();
+    SyncReplayStream<current::locks::MutexLockStatus::AlreadyLocked>(LoadNewestSnapshot());
   }
 
   // TODO(dkorolev): `ScopeOwnedBySomeoneElse<>` ?
-  explicit SherlockStreamPersisterImpl(std::mutex& storage_mutex,
+  explicit SherlockStreamPersisterImpl(storage_mutex_t& storage_mutex,
                                        fields_update_function_t f,
                                        sherlock_t& stream_owned_by_someone_else)
       : storage_mutex_ref_(storage_mutex), fields_update_f_(f), stream_used_(stream_owned_by_someone_else) {
@@ -95,36 +101,82 @@ class SherlockStreamPersisterImpl {
         std::make_unique<SherlockSubscriber>([this](const transaction_t& transaction) { ApplyMutations(transaction); });
     if (authority_ == PersisterDataAuthority::Own) {
       // Do not use lock since we are in ctor.
-      SyncReplayStream<current::locks::MutexLockStatus::AlreadyLocked>();
+      SyncReplayStream<current::locks::MutexLockStatus::AlreadyLocked>(LoadNewestSnapshot());
     } else {
       SubscribeToStream();
     }
   }
 
-  ~SherlockStreamPersisterImpl() { TerminateStreamSubscription(); }
+  ~SherlockStreamPersisterImpl() {
+    TerminateStreamSubscription();
+    if (snapshot_thread_.joinable()) {
+      snapshot_thread_.join();
+    }
+  }
 
   PersisterDataAuthority DataAuthority() const {
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
     return authority_;
   }
 
   void PersistJournal(MutationJournal& journal) {
     if (!journal.commit_log.empty()) {
-#ifndef CURRENT_MOCK_TIME
-      CURRENT_ASSERT(journal.transaction_meta.begin_us < journal.transaction_meta.end_us);
-#else
-      CURRENT_ASSERT(journal.transaction_meta.begin_us <= journal.transaction_meta.end_us);
-#endif
-      transaction_t transaction;
-      for (auto&& entry : journal.commit_log) {
-        transaction.mutations.emplace_back(BypassVariantTypeCheck(), std::move(entry));
-      }
-      std::swap(transaction.meta, journal.transaction_meta);
-      stream_used_.Publish(std::move(transaction));
+      stream_used_.Publish(JournalToTransaction(journal));
+      AfterTransactionsPersisted(1u);
     }
     journal.Clear();
   }
 
+  // Publishes the transactions of the group commit in one go, still one stream entry per transaction, for the
+  // followers to replay them as usual. The entries are timestamped with the times the transactions have ended at.
+  void PersistJournals(std::vector<MutationJournal>& journals) {
+    std::vector<sherlock_entry_t> transactions;
+    std::vector<std::chrono::microseconds> timestamps;
+    for (auto& journal : journals) {
+      if (!journal.commit_log.empty()) {
+        timestamps.push_back(journal.transaction_meta.end_us);
+        transactions.emplace_back(JournalToTransaction(journal));
+      }
+      journal.Clear();
+    }
+    if (!transactions.empty()) {
+      stream_used_.PublishBatch(std::move(transactions), timestamps);
+      AfterTransactionsPersisted(timestamps.size());
+    }
+  }
+
+  // The periodic snapshots are taken after the commits of the transactions, with the storage mutex held, which the
+  // writers are blocked by only while the contents of the fields are being copied. The file is written by a thread.
+  void SetSnapshotPolicy(const StorageSnapshotPolicy& policy, fields_export_function_t export_f) {
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
+    if (policy.every_n_transactions && snapshot_stream_file_name_.empty()) {
+      CURRENT_THROW(StorageSnapshotsNotSupportedException());
+    }
+    snapshot_policy_ = policy;
+    fields_export_f_ = export_f;
+  }
+
+  // Takes the snapshot right away, and returns once it has been written.
+  StorageSnapshotInfo TakeSnapshot(fields_export_function_t export_f) {
+    StorageSnapshotHeader header;
+    std::vector<variant_t> events;
+    size_t keep_snapshots;
+    {
+      // The fields are only read, so the read-only transactions need not wait for the snapshot.
+      current::locks::SharedLockGuard<storage_mutex_t> lock(storage_mutex_ref_);
+      if (snapshot_stream_file_name_.empty()) {
+        CURRENT_THROW(StorageSnapshotsNotSupportedException());
+      }
+      events = export_f();
+      header = SnapshotHeader(events.size());
+      keep_snapshots = snapshot_policy_.keep_snapshots;
+    }
+    return WriteSnapshot(header, events, keep_snapshots);
+  }
+
+  // The index of the snapshot the storage has been restored from at startup, or zero if there was none.
+  uint64_t LoadedSnapshotIndex() const { return loaded_snapshot_index_; }
+
   void ExposeRawLogViaHTTP(uint16_t port, const std::string& route) {
     handlers_scope_ +=
         HTTP(port).Register(route, URLPathArgs::CountMask::None | URLPathArgs::CountMask::One, stream_used_);
@@ -134,11 +186,12 @@ class SherlockStreamPersisterImpl {
 
   template <current::locks::MutexLockStatus MLS>
   void AcquireDataAuthority() {
-    current::locks::SmartMutexLockGuard<MLS> lock(storage_mutex_ref_);
+    current::locks::SmartMutexLockGuard<MLS, storage_mutex_t> lock(storage_mutex_ref_);
     if (stream_used_.DataAuthority() == current::sherlock::StreamDataAuthority::Own) {
       TerminateStreamSubscription();
       SyncReplayStream<current::locks::MutexLockStatus::AlreadyLocked>(subscriber_->next_replay_index_);
       subscriber_ = nullptr;
+      snapshot_stream_file_name_ = impl::StreamFileName(stream_used_.Persister(), 0);
     } else {
       CURRENT_THROW(UnderlyingStreamHasExternalDataAuthorityException());
     }
@@ -157,7 +210,7 @@ class SherlockStreamPersisterImpl {
 
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
   void ApplyMutations(const transaction_t& transaction) {
-    current::locks::SmartMutexLockGuard<MLS> lock(storage_mutex_ref_);
+    current::locks::SmartMutexLockGuard<MLS, storage_mutex_t> lock(storage_mutex_ref_);
     for (const auto& mutation : transaction.mutations) {
       fields_update_f_(mutation);
     }
@@ -171,8 +224,98 @@ class SherlockStreamPersisterImpl {
 
   void TerminateStreamSubscription() { subscriber_scope_ = nullptr; }
 
+  // Applies the newest valid snapshot, if any, and returns the index of the stream entry to continue replaying from.
+  uint64_t LoadNewestSnapshot() {
+    snapshot_stream_file_name_ = impl::StreamFileName(stream_used_.Persister(), 0);
+    if (snapshot_stream_file_name_.empty()) {
+      return 0u;
+    }
+    const auto& persister = stream_used_.Persister();
+    const auto stream_entry_us = [&persister](uint64_t index) {
+      return (*persister.Iterate(index, index + 1u).begin()).idx_ts.us;
+    };
+    StorageSnapshotHeader header;
+    std::vector<variant_t> events;
+    for (const auto& snapshot : impl::ListStorageSnapshots(snapshot_stream_file_name_)) {
+      if (impl::ReadStorageSnapshot(snapshot.second, persister.Size(), stream_entry_us, header, events)) {
+        for (const auto& event : events) {
+          fields_update_f_(event);
+        }
+        loaded_snapshot_index_ = header.index;
+        return header.index;
+      }
+    }
+    return 0u;
+  }
+
+  StorageSnapshotHeader SnapshotHeader(size_t events) const {
+    StorageSnapshotHeader header;
+    header.index = stream_used_.Persister().Size();
+    if (header.index) {
+      header.us = stream_used_.Persister().LastPublishedIndexAndTimestamp().us;
+    }
+    header.events = events;
+    return header;
+  }
+
+  StorageSnapshotInfo WriteSnapshot(const StorageSnapshotHeader& header,
+                                    const std::vector<variant_t>& events,
+                                    size_t keep_snapshots) {
+    std::lock_guard<std::mutex> lock(snapshot_write_mutex_);
+    const auto info = impl::WriteStorageSnapshot(snapshot_stream_file_name_, header, events);
+    impl::RemoveOldStorageSnapshots(snapshot_stream_file_name_, keep_snapshots);
+    return info;
+  }
+
+  transaction_t JournalToTransaction(MutationJournal& journal) {
+#ifndef CURRENT_MOCK_TIME
+    CURRENT_ASSERT(journal.transaction_meta.begin_us < journal.transaction_meta.end_us);
+#else
+    CURRENT_ASSERT(journal.transaction_meta.begin_us <= journal.transaction_meta.end_us);
+#endif
+    transaction_t transaction;
+    for (auto&& entry : journal.commit_log) {
+      transaction.mutations.emplace_back(BypassVariantTypeCheck(), std::move(entry));
+    }
+    std::swap(transaction.meta, journal.transaction_meta);
+    return transaction;
+  }
+
+  void AfterTransactionsPersisted(uint64_t count) {
+    const uint64_t every_n_transactions = snapshot_policy_.every_n_transactions;
+    if (every_n_transactions && (transactions_since_snapshot_ += count) >= every_n_transactions &&
+        !snapshot_in_progress_) {
+      StartSnapshotInBackground();
+    }
+  }
+
+  // Called with the storage mutex held, while no other periodic snapshot is being written.
+  // With the `GroupCommit` transaction policy the storage mutex is only held shared, and the calls are serialized
+  // by its `persist_mutex_` instead.
+  void StartSnapshotInBackground() {
+    if (snapshot_thread_.joinable()) {
+      snapshot_thread_.join();
+    }
+    transactions_since_snapshot_ = 0u;
+    snapshot_in_progress_ = true;
+    const auto events = std::make_shared<std::vector<variant_t>>(fields_export_f_());
+    const StorageSnapshotHeader header = SnapshotHeader(events->size());
+    const StorageSnapshotPolicy policy = snapshot_policy_;
+    snapshot_thread_ = std::thread([this, header, events, policy]() {
+      try {
+        WriteSnapshot(header, *events, policy.keep_snapshots);
+      } catch (const current::Exception& e) {
+        // LCOV_EXCL_START
+        std::cerr << "Storage snapshot failed, will retry in " << policy.every_n_transactions
+                  << " transactions: " << e.what() << std::endl;
+        // LCOV_EXCL_STOP
+      }
+      snapshot_in_progress_ = false;
+    });
+  }
+
  private:
-  std::mutex& storage_mutex_ref_;
+  storage_mutex_t& storage_mutex_ref_;
   fields_update_function_t fields_update_f_;
   // `stream_{used/owned}_` are two variables to support both owning and non-owning Storage usage patterns.
   std::unique_ptr<sherlock::Stream<transaction_t, UNDERLYING_PERSISTER>> stream_owned_if_any_;
@@ -181,6 +324,15 @@ class SherlockStreamPersisterImpl {
   current::sherlock::SubscriberScope subscriber_scope_;
   PersisterDataAuthority authority_;
   HTTPRoutesScope handlers_scope_;
+
+  std::string snapshot_stream_file_name_;  // Empty unless the stream is backed by a file.
+  uint64_t loaded_snapshot_index_ = 0u;
+  StorageSnapshotPolicy snapshot_policy_;
+  fields_export_function_t fields_export_f_;
+  uint64_t transactions_since_snapshot_ = 0u;
+  std::mutex snapshot_write_mutex_;
+  std::atomic_bool snapshot_in_progress_{false};
+  std::thread snapshot_thread_;
 };
 
 template <typename TYPELIST, typename STREAM_RECORD_TYPE = NoCustomPersisterParam>
@@ -0,0 +1,206 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Storage snapshots: all the fields of the storage, dumped into a file next to the stream it is persisted into.
+//
+// A snapshot is tagged with the stream index it covers: it is equivalent to replaying the first `index` entries.
+// At startup, the newest valid snapshot is loaded, and only the stream entries after it are replayed.
+//
+// The file `<stream file>.snapshot.<index, 20 digits>` is the header line followed by `header.events` lines,
+// each being a mutation in the same JSON format as in the stream. It is written under a temporary name and renamed,
+// so it is either complete or absent. Still, a snapshot is only used if it parses in full, if the stream has at least
+// `index` entries, and if the entry `index - 1` has the timestamp `us`; otherwise the next older one is tried.
+
+#ifndef CURRENT_STORAGE_PERSISTER_SNAPSHOT_H
+#define CURRENT_STORAGE_PERSISTER_SNAPSHOT_H
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../exceptions.h"
+
+#include "../../TypeSystem/struct.h"
+#include "../../TypeSystem/Serialization/json.h"
+
+#include "../../Bricks/file/file.h"
+#include "../../Bricks/strings/printf.h"
+
+namespace current {
+namespace storage {
+namespace persister {
+
+CURRENT_STRUCT(StorageSnapshotHeader) {
+  CURRENT_FIELD(index, uint64_t, 0u);  // The number of the stream entries the snapshot covers.
+  CURRENT_FIELD(us, std::chrono::microseconds, std::chrono::microseconds(0));  // The timestamp of the last of them.
+  CURRENT_FIELD(events, uint64_t, 0u);  // The number of the mutations which follow the header.
+};
+
+CURRENT_STRUCT(StorageSnapshotInfo, StorageSnapshotHeader) {
+  CURRENT_FIELD(file_name, std::string);
+  CURRENT_FIELD(elapsed, std::chrono::microseconds, std::chrono::microseconds(0));  // Spent writing the file.
+};
+
+struct StorageSnapshotPolicy {
+  // Take a snapshot once this many transactions have been committed since the previous one. Zero stands for "never".
+  uint64_t every_n_transactions = 0u;
+  // The number of the most recent snapshots to keep on disk. Zero stands for "keep all".
+  size_t keep_snapshots = 2u;
+
+  StorageSnapshotPolicy& EveryNTransactions(uint64_t value) {
+    every_n_transactions = value;
+    return *this;
+  }
+  StorageSnapshotPolicy& KeepSnapshots(size_t value) {
+    keep_snapshots = value;
+    return *this;
+  }
+};
+
+namespace impl {
+
+constexpr static const char* kStorageSnapshotInfix = ".snapshot.";
+constexpr static size_t kStorageSnapshotIndexDigits = 20u;
+
+// The name of the file the stream is persisted into, or an empty string for the streams which are not file-backed.
+template <typename PERSISTER>
+inline auto StreamFileName(const PERSISTER& persister, int) -> decltype(std::string(persister.FileName())) {
+  return persister.FileName();
+}
+
+template <typename PERSISTER>
+inline std::string StreamFileName(const PERSISTER&, ...) {
+  return "";
+}
+
+inline std::string StorageSnapshotFileName(const std::string& stream_file_name, uint64_t index) {
+  return stream_file_name + kStorageSnapshotInfix + current::strings::Printf("%020llu", (unsigned long long)index);
+}
+
+// The `{ index, file name }` pairs of the snapshots of the stream, the newest first.
+inline std::vector<std::pair<uint64_t, std::string>> ListStorageSnapshots(const std::string& stream_file_name) {
+  const size_t separator = stream_file_name.rfind(FileSystem::GetPathSeparator());
+  const std::string dir = (separator == std::string::npos) ? "." : stream_file_name.substr(0, separator);
+  const std::string prefix =
+      ((separator == std::string::npos) ? stream_file_name : stream_file_name.substr(separator + 1)) +
+      kStorageSnapshotInfix;
+  std::vector<std::pair<uint64_t, std::string>> result;
+  FileSystem::ScanDir(dir, [&](const FileSystem::ScanDirItemInfo& item) {
+    const std::string& name = item.basename;
+    if (name.length() == prefix.length() + kStorageSnapshotIndexDigits && !name.compare(0, prefix.length(), prefix) &&
+        std::all_of(name.begin() + prefix.length(), name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+      result.emplace_back(current::FromString<uint64_t>(name.substr(prefix.length())), item.pathname);
+    }
+  });
+  std::sort(result.rbegin(), result.rend());
+  return result;
+}
+
+template <typename VARIANT>
+StorageSnapshotInfo WriteStorageSnapshot(const std::string& stream_file_name,
+                                         const StorageSnapshotHeader& header,
+                                         const std::vector<VARIANT>& events) {
+  const auto begin = current::time::Now();
+  StorageSnapshotInfo info;
+  info.index = header.index;
+  info.us = header.us;
+  info.events = header.events;
+  info.file_name = StorageSnapshotFileName(stream_file_name, header.index);
+  const std::string tmp_file_name = info.file_name + ".tmp";
+  {
+    std::ofstream os(tmp_file_name);
+    std::string line;
+    JSONAppend(line, header);
+    line += '\n';
+    os << line;
+    for (const auto& event : events) {
+      line.clear();
+      JSONAppend(line, event);
+      line += '\n';
+      os << line;
+    }
+    os.flush();
+    if (!os) {
+      FileSystem::RmFile(tmp_file_name, FileSystem::RmFileParameters::Silent);
+      CURRENT_THROW(StorageCannotWriteSnapshotException(tmp_file_name));
+    }
+  }
+  FileSystem::RenameFile(tmp_file_name, info.file_name);
+  info.elapsed = current::time::Now() - begin;
+  return info;
+}
+
+// Removes all but `keep` most recent snapshots of the stream.
+inline void RemoveOldStorageSnapshots(const std::string& stream_file_name, size_t keep) {
+  if (keep) {
+    const auto snapshots = ListStorageSnapshots(stream_file_name);
+    for (size_t i = keep; i < snapshots.size(); ++i) {
+      FileSystem::RmFile(snapshots[i].second, FileSystem::RmFileParameters::Silent);
+    }
+  }
+}
+
+// Parses the snapshot in full, or returns `false` if it is incomplete, corrupted, or does not match the stream.
+// `stream_entry_us(i)` should return the timestamp of the stream entry `i`.
+// The header is not trusted beyond what the file can hold: each mutation takes at least two bytes, one per line.
+template <typename VARIANT, typename F>
+bool ReadStorageSnapshot(const std::string& file_name,
+                         uint64_t stream_size,
+                         F&& stream_entry_us,
+                         StorageSnapshotHeader& header,
+                         std::vector<VARIANT>& events) {
+  std::ifstream fi(file_name);
+  std::string line;
+  try {
+    if (!std::getline(fi, line)) {
+      return false;
+    }
+    ParseJSON(line, header);
+    if (header.index > stream_size || (header.index && stream_entry_us(header.index - 1u) != header.us)) {
+      return false;
+    }
+    events.clear();
+    events.reserve(static_cast<size_t>(std::min(header.events, FileSystem::GetFileSize(file_name) / 2u)));
+    while (events.size() < header.events && std::getline(fi, line)) {
+      events.emplace_back(ParseJSON<VARIANT>(line));
+    }
+    return events.size() == header.events && !std::getline(fi, line);
+  } catch (const std::exception&) {
+    // Not only `current::Exception`, but also `std::bad_alloc` and the like, so that the older snapshot is used.
+    return false;
+  }
+}
+
+}  // namespace current::storage::persister::impl
+
+}  // namespace current::storage::persister
+}  // namespace current::storage
+}  // namespace current
+
+using current::storage::persister::StorageSnapshotInfo;
+using current::storage::persister::StorageSnapshotPolicy;
+
+#endif  // CURRENT_STORAGE_PERSISTER_SNAPSHOT_H
@@ -56,6 +56,7 @@ SOFTWARE.
 #include "container/one_to_many.h"
 
 #include "persister/file.h"
+#include "persister/snapshot.h"
 
 #include "../TypeSystem/struct.h"
 #include "../TypeSystem/Serialization/json.h"
@@ -206,7 +207,7 @@ class GenericStorageImpl {
   using persister_t = PERSISTER<fields_variant_t, CUSTOM_PERSISTER_PARAM>;
 
  private:
-  std::mutex mutex_;
+  storage_mutex_t mutex_;
   FIELDS fields_;
   WaitableAtomic<uint64_t> transactions_count_;
   persister_t persister_;
@@ -295,7 +296,7 @@ class GenericStorageImpl {
   }
 
   void FlipToMaster() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<storage_mutex_t> lock(mutex_);
     if (role_ == StorageRole::Follower) {
       persister_.template AcquireDataAuthority<current::locks::MutexLockStatus::AlreadyLocked>();
       role_ = StorageRole::Master;
@@ -305,6 +306,44 @@ class GenericStorageImpl {
   }
 
   void GracefulShutdown() { transaction_policy_.GracefulShutdown(); }
+
+  // Dumps all the fields next to the stream, for the next startup to not replay the transactions before this point.
+  persister::StorageSnapshotInfo TakeSnapshot() {
+    return persister_.TakeSnapshot([this]() {
+      // Called with the storage mutex held, so the transactions committed but not yet persisted, if the transaction
+      // policy has any, are all persisted here, for the snapshot to match the stream.
+      transaction_policy_.PersistPendingTransactions();
+      return ExportFieldsEvents();
+    });
+  }
+
+  // Takes the snapshots automatically, from within the transactions which commit the mutations.
+  void SetSnapshotPolicy(const persister::StorageSnapshotPolicy& policy) {
+    persister_.SetSnapshotPolicy(policy, [this]() { return ExportFieldsEvents(); });
+  }
+
+ private:
+  struct FieldsEventsExporter final {
+    std::vector<fields_variant_t>& events;
+    template <typename EVENT>
+    void operator()(EVENT&& event) {
+      events.emplace_back(std::forward<EVENT>(event));
+    }
+  };
+
+  template <int... NS>
+  void ExportFieldsEventsImpl(FieldsEventsExporter& exporter, current::variadic_indexes::indexes<NS...>) const {
+    const int unused[] = {0, (fields_(ImmutableFieldByIndex<NS>()).ExportEvents(exporter), 0)...};
+    static_cast<void>(unused);
+  }
+
+  // The mutations which, applied to the empty fields, restore their current state. Requires the mutex to be locked.
+  std::vector<fields_variant_t> ExportFieldsEvents() const {
+    std::vector<fields_variant_t> events;
+    FieldsEventsExporter exporter{events};
+    ExportFieldsEventsImpl(exporter, current::variadic_indexes::generate_indexes<FIELDS_COUNT>());
+    return events;
+  }
 };
 
 #define CURRENT_STORAGE_IMPLEMENTATION(name)                                                                   \
@@ -333,15 +372,21 @@ class NullStoragePersisterImpl {
 
   // NOTE(dkorolev): Commented out to not make the compiler match the type.
   // using fields_update_function_t = std::function<void(const variant_t&)>;
-  // NullStoragePersisterImpl(std::mutex&, fields_update_function_t) {}
+  // NullStoragePersisterImpl(storage_mutex_t&, fields_update_function_t) {}
 
   template <typename T>
-  NullStoragePersisterImpl(std::mutex&, T) {}
+  NullStoragePersisterImpl(storage_mutex_t&, T) {}
 
   void InternalExposeStream() {}
 
   void PersistJournal(MutationJournal& journal) { journal.Clear(); }
 
+  void PersistJournals(std::vector<MutationJournal>& journals) {
+    for (auto& journal : journals) {
+      journal.Clear();
+    }
+  }
+
   PersisterDataAuthority DataAuthority() const { return PersisterDataAuthority::Own; }
 };
 
@@ -28,7 +28,9 @@ SOFTWARE.
 
 #define CURRENT_MOCK_TIME
 
+#include <atomic>
 #include <set>
+#include <thread>
 #include <type_traits>
 
 #ifndef STORAGE_ONLY_RUN_RESTFUL_TESTS
@@ -1656,6 +1658,285 @@ TEST(TransactionalStorage, WaitUntilLocalLogIsReplayed) {
   }
 }
 
+TEST(TransactionalStorage, Snapshots) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using Storage = TestStorage<SherlockStreamPersister>;
+
+  const std::string storage_file_name =
+      current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "storage_snapshots");
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(storage_file_name);
+  const auto RemoveSnapshots = [&storage_file_name]() {
+    for (const auto& snapshot : current::storage::persister::impl::ListStorageSnapshots(storage_file_name)) {
+      current::FileSystem::RmFile(snapshot.second);
+    }
+  };
+  RemoveSnapshots();
+  const auto snapshots_remover = current::MakeScopeGuard(RemoveSnapshots);
+
+  {
+    Storage storage(storage_file_name);
+    EXPECT_EQ(0u, storage.Persister().LoadedSnapshotIndex());
+    current::time::SetNow(std::chrono::microseconds(100));
+    storage.ReadWriteTransaction([](MutableFields<Storage> fields) {
+      fields.d.Add(Record{"one", 1});
+      fields.umany_to_umany.Add(Cell{1, "a", 10});
+      fields.oone_to_oone.Add(Cell{1, "a", 11});
+    }).Go();
+    current::time::SetNow(std::chrono::microseconds(200));
+    storage.ReadWriteTransaction([](MutableFields<Storage> fields) {
+      fields.d.Erase("one");
+      fields.d.Add(Record{"two", 2});
+    }).Go();
+
+    const auto snapshot = storage.TakeSnapshot();
+    EXPECT_EQ(2u, snapshot.index);
+    EXPECT_EQ(200, snapshot.us.count());
+    EXPECT_EQ(4u, snapshot.events);  // The deleted "one", "two", and two cells.
+    EXPECT_EQ(current::storage::persister::impl::StorageSnapshotFileName(storage_file_name, 2u), snapshot.file_name);
+
+    current::time::SetNow(std::chrono::microseconds(300));
+    storage.ReadWriteTransaction([](MutableFields<Storage> fields) {
+      fields.d.Add(Record{"three", 3});
+      fields.oone_to_oone.Add(Cell{1, "b", 12});  // Replaces the `{1, "a"}` cell, which has the same row.
+    }).Go();
+  }
+
+  const auto VerifyContents = [](Storage& storage) {
+    const auto result = storage.ReadOnlyTransaction([](ImmutableFields<Storage> fields) {
+      EXPECT_FALSE(Exists(fields.d["one"]));
+      ASSERT_TRUE(Exists(fields.d.LastModified("one")));
+      EXPECT_EQ(200, Value(fields.d.LastModified("one")).count());
+      ASSERT_TRUE(Exists(fields.d["two"]));
+      EXPECT_EQ(2, Value(fields.d["two"]).rhs);
+      ASSERT_TRUE(Exists(fields.d["three"]));
+      EXPECT_EQ(3, Value(fields.d["three"]).rhs);
+      ASSERT_TRUE(Exists(fields.umany_to_umany.Get(1, "a")));
+      EXPECT_EQ(10, Value(fields.umany_to_umany.Get(1, "a")).phew);
+      EXPECT_FALSE(Exists(fields.oone_to_oone.Get(1, "a")));
+      ASSERT_TRUE(Exists(fields.oone_to_oone.Get(1, "b")));
+      EXPECT_EQ(12, Value(fields.oone_to_oone.Get(1, "b")).phew);
+      EXPECT_EQ(300, Value(fields.oone_to_oone.LastModified(1, "a")).count());
+    }).Go();
+    EXPECT_TRUE(WasCommitted(result));
+  };
+
+  {
+    // The snapshot is loaded, and only the last transaction is replayed.
+    Storage storage(storage_file_name);
+    EXPECT_EQ(2u, storage.Persister().LoadedSnapshotIndex());
+    VerifyContents(storage);
+    EXPECT_EQ(3u, storage.TakeSnapshot().index);
+  }
+
+  // A snapshot which is incomplete is ignored, and the previous one is used instead.
+  {
+    const std::string file_name = current::storage::persister::impl::StorageSnapshotFileName(storage_file_name, 3u);
+    const std::string contents = current::FileSystem::ReadFileAsString(file_name);
+    current::FileSystem::WriteStringToFile(contents.substr(0, contents.length() - 10u), file_name.c_str());
+    Storage storage(storage_file_name);
+    EXPECT_EQ(2u, storage.Persister().LoadedSnapshotIndex());
+    VerifyContents(storage);
+  }
+
+  // So is a snapshot whose header claims more mutations than the file can possibly hold.
+  {
+    const std::string file_name = current::storage::persister::impl::StorageSnapshotFileName(storage_file_name, 3u);
+    const std::string contents = current::FileSystem::ReadFileAsString(file_name);
+    const size_t header_end = contents.find('\n');
+    auto header = ParseJSON<current::storage::persister::StorageSnapshotHeader>(contents.substr(0, header_end));
+    header.events = static_cast<uint64_t>(-1) / 2u;
+    current::FileSystem::WriteStringToFile(JSON(header) + contents.substr(header_end), file_name.c_str());
+    Storage storage(storage_file_name);
+    EXPECT_EQ(2u, storage.Persister().LoadedSnapshotIndex());
+    VerifyContents(storage);
+  }
+
+  // Periodic snapshots, of which only the most recent one is kept.
+  {
+    Storage storage(storage_file_name);
+    storage.SetSnapshotPolicy(StorageSnapshotPolicy().EveryNTransactions(2u).KeepSnapshots(1u));
+    current::time::SetNow(std::chrono::microseconds(400));
+    storage.ReadWriteTransaction([](MutableFields<Storage> fields) { fields.d.Add(Record{"four", 4}); }).Go();
+    current::time::SetNow(std::chrono::microseconds(500));
+    storage.ReadWriteTransaction([](MutableFields<Storage> fields) { fields.d.Add(Record{"five", 5}); }).Go();
+  }
+  {
+    const auto snapshots = current::storage::persister::impl::ListStorageSnapshots(storage_file_name);
+    ASSERT_EQ(1u, snapshots.size());
+    EXPECT_EQ(5u, snapshots[0].first);
+    Storage storage(storage_file_name);
+    EXPECT_EQ(5u, storage.Persister().LoadedSnapshotIndex());
+    VerifyContents(storage);
+    const auto result = storage.ReadOnlyTransaction([](ImmutableFields<Storage> fields) {
+      EXPECT_EQ(4u, fields.d.Size());
+      EXPECT_EQ(5, Value(fields.d["five"]).rhs);
+    }).Go();
+    EXPECT_TRUE(WasCommitted(result));
+  }
+
+  // A snapshot of another stream, or of the older version of this one, is ignored.
+  current::FileSystem::RmFile(storage_file_name);
+  {
+    Storage storage(storage_file_name);
+    EXPECT_EQ(0u, storage.Persister().LoadedSnapshotIndex());
+    const auto result =
+        storage.ReadOnlyTransaction([](ImmutableFields<Storage> fields) { EXPECT_TRUE(fields.d.Empty()); }).Go();
+    EXPECT_TRUE(WasCommitted(result));
+  }
+
+  // Snapshots require the stream to be backed by a file.
+  {
+    TestStorage<SherlockInMemoryStreamPersister> storage;
+    ASSERT_THROW(storage.TakeSnapshot(), current::storage::StorageSnapshotsNotSupportedException);
+  }
+}
+
+TEST(TransactionalStorage, ReadOnlyTransactionsRunConcurrently) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using Storage = TestStorage<SherlockInMemoryStreamPersister>;
+
+  Storage storage;
+  current::time::SetNow(std::chrono::microseconds(100));
+  storage.ReadWriteTransaction([](MutableFields<Storage> fields) { fields.d.Add(Record{"one", 1}); }).Go();
+
+  // Each of the two read-only transactions waits for the other one to start, which would never happen
+  // if they were run one after another. The wait is bounded, for the test to fail instead of hanging.
+  std::atomic_size_t readers_inside(0u);
+  const auto ReadOnlyTransaction = [&storage, &readers_inside]() {
+    return Value(storage.ReadOnlyTransaction([&readers_inside](ImmutableFields<Storage> fields) {
+      ++readers_inside;
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (readers_inside < 2u && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+      }
+      return readers_inside == 2u && Value(fields.d["one"]).rhs == 1;
+    }).Go());
+  };
+  bool other_reader_result = false;
+  std::thread other_reader([&ReadOnlyTransaction, &other_reader_result]() {
+    other_reader_result = ReadOnlyTransaction();
+  });
+  EXPECT_TRUE(ReadOnlyTransaction());
+  other_reader.join();
+  EXPECT_TRUE(other_reader_result);
+
+  // The read-write transactions are unaffected.
+  current::time::SetNow(std::chrono::microseconds(200));
+  const auto result = storage.ReadWriteTransaction([](MutableFields<Storage> fields) {
+    fields.d.Add(Record{"two", 2});
+    return fields.d.Size();
+  }).Go();
+  ASSERT_TRUE(WasCommitted(result));
+  EXPECT_EQ(2u, Value(result));
+}
+
+TEST(TransactionalStorage, GroupCommit) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using Storage = TestStorage<SherlockStreamPersister, current::storage::transaction_policy::GroupCommit>;
+
+  const std::string storage_file_name =
+      current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "storage_group_commit");
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(storage_file_name);
+  const auto RemoveSnapshots = [&storage_file_name]() {
+    for (const auto& snapshot : current::storage::persister::impl::ListStorageSnapshots(storage_file_name)) {
+      current::FileSystem::RmFile(snapshot.second);
+    }
+  };
+  RemoveSnapshots();
+  const auto snapshots_remover = current::MakeScopeGuard(RemoveSnapshots);
+
+  {
+    Storage storage(storage_file_name);
+    auto& stream = storage.InternalExposeStream();
+
+    // The transactions are applied right away, and their futures are fulfilled once they have been persisted.
+    current::time::SetNow(std::chrono::microseconds(100));
+    auto one = storage.ReadWriteTransaction([](MutableFields<Storage> fields) { fields.d.Add(Record{"one", 1}); });
+    current::time::SetNow(std::chrono::microseconds(200));
+    auto rolled_back = storage.ReadWriteTransaction([](MutableFields<Storage> fields) {
+      fields.d.Add(Record{"oops", 0});
+      CURRENT_STORAGE_THROW_ROLLBACK();
+    });
+    current::time::SetNow(std::chrono::microseconds(300));
+    auto two = storage.ReadWriteTransaction([](MutableFields<Storage> fields) {
+      fields.d.Add(Record{"two", 2});
+      return fields.d.Size();
+    });
+    EXPECT_EQ(2u,
+              Value(storage.ReadOnlyTransaction([](ImmutableFields<Storage> fields) { return fields.d.Size(); }).Go()));
+    EXPECT_TRUE(WasCommitted(one.Go()));
+    EXPECT_FALSE(WasCommitted(rolled_back.Go()));
+    const auto two_result = two.Go();
+    ASSERT_TRUE(WasCommitted(two_result));
+    EXPECT_EQ(2u, Value(two_result));
+    EXPECT_EQ(2u, stream.Persister().Size());
+    EXPECT_EQ(300, stream.Persister().LastPublishedIndexAndTimestamp().us.count());
+
+    // The `f2` of a two-step transaction is called once `f1` has been persisted.
+    current::time::SetNow(std::chrono::microseconds(400));
+    uint64_t persisted_before_f2 = 0u;
+    const auto three = storage.ReadWriteTransaction(
+        [](MutableFields<Storage> fields) {
+          fields.d.Add(Record{"three", 3});
+          return 3;
+        },
+        [&stream, &persisted_before_f2](int value) {
+          EXPECT_EQ(3, value);
+          persisted_before_f2 = stream.Persister().Size();
+        }).Go();
+    EXPECT_TRUE(WasCommitted(three));
+    EXPECT_EQ(3u, persisted_before_f2);
+
+    // The snapshot persists the transactions committed before it first, to match the stream.
+    current::time::SetNow(std::chrono::microseconds(500));
+    auto four = storage.ReadWriteTransaction([](MutableFields<Storage> fields) { fields.d.Add(Record{"four", 4}); });
+    EXPECT_EQ(4u, storage.TakeSnapshot().index);
+    EXPECT_TRUE(WasCommitted(four.Go()));
+
+    // The concurrent writers, with the mock clock ticking by itself.
+    current::time::SetNow(std::chrono::microseconds(1000), std::chrono::microseconds(1000 * 1000));
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+      writers.emplace_back([&storage, t]() {
+        for (int i = 0; i < 25; ++i) {
+          const std::string key = "w" + current::ToString(t * 100 + i);
+          EXPECT_TRUE(WasCommitted(storage.ReadWriteTransaction([&key, i](MutableFields<Storage> fields) {
+            fields.d.Add(Record{key, i});
+          }).Go()));
+        }
+      });
+    }
+    for (auto& writer : writers) {
+      writer.join();
+    }
+    EXPECT_EQ(104u, stream.Persister().Size());
+  }
+
+  // The stream is replayed as usual, one transaction per entry, in the order of the commits.
+  {
+    TestStorage<SherlockStreamPersister> storage(storage_file_name);
+    EXPECT_EQ(4u, storage.Persister().LoadedSnapshotIndex());
+    uint64_t previous_us = 0u;
+    for (const auto& e : storage.InternalExposeStream().Persister().Iterate()) {
+      EXPECT_LT(previous_us, static_cast<uint64_t>(e.idx_ts.us.count()));
+      previous_us = e.idx_ts.us.count();
+    }
+    const auto result = storage.ReadOnlyTransaction([](ImmutableFields<Storage> fields) {
+      EXPECT_EQ(104u, fields.d.Size());
+      EXPECT_FALSE(Exists(fields.d["oops"]));
+      EXPECT_EQ(4, Value(fields.d["four"]).rhs);
+      EXPECT_EQ(24, Value(fields.d["w324"]).rhs);
+    }).Go();
+    EXPECT_TRUE(WasCommitted(result));
+  }
+}
+
 TEST(TransactionalStorage, ReplicationViaHTTP) {
   current::time::ResetToZero();
 
@@ -25,7 +25,11 @@ SOFTWARE.
 #ifndef CURRENT_STORAGE_TRANSACTION_POLICY_H
 #define CURRENT_STORAGE_TRANSACTION_POLICY_H
 
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include "base.h"
 #include "exceptions.h"
@@ -40,16 +44,18 @@ namespace current {
 namespace storage {
 namespace transaction_policy {
 
+// Runs the transactions in the calling thread, under the storage mutex: the read-write ones one at a time,
+// and the read-only ones concurrently with each other.
 template <class PERSISTER>
 class Synchronous final {
  public:
   using transaction_t = typename PERSISTER::transaction_t;
 
-  Synchronous(std::mutex& storage_mutex, PERSISTER& persister, MutationJournal& journal)
+  Synchronous(storage_mutex_t& storage_mutex, PERSISTER& persister, MutationJournal& journal)
       : storage_mutex_ref_(storage_mutex), persister_(persister), journal_(journal) {}
 
   ~Synchronous() {
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
     destructing_ = true;
   }
 
@@ -60,7 +66,7 @@ class Synchronous final {
   template <typename F, class = std::enable_if_t<!std::is_void<f_result_t<F>>::value>>
   Future<TransactionResult<f_result_t<F>>, StrictFuture::Strict> Transaction(F&& f) {
     using result_t = f_result_t<F>;
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
     journal_.AssertEmpty();
     std::promise<TransactionResult<result_t>> promise;
     if (destructing_) {
@@ -102,7 +108,7 @@ class Synchronous final {
   template <typename F, class = std::enable_if_t<!std::is_void<f_result_t<F>>::value>>
   Future<TransactionResult<f_result_t<F>>, StrictFuture::Strict> Transaction(F&& f) const {
     using result_t = f_result_t<F>;
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    current::locks::SharedLockGuard<storage_mutex_t> lock(storage_mutex_ref_);
     journal_.AssertEmpty();
     std::promise<TransactionResult<result_t>> promise;
     if (destructing_) {
@@ -137,7 +143,7 @@ class Synchronous final {
   // Read-write transaction returning void type.
   template <typename F, class = std::enable_if_t<std::is_void<f_result_t<F>>::value>>
   Future<TransactionResult<void>, StrictFuture::Strict> Transaction(F&& f) {
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
     journal_.AssertEmpty();
     std::promise<TransactionResult<void>> promise;
     if (destructing_) {
@@ -176,7 +182,7 @@ class Synchronous final {
   // Read-only transaction returning void type.
   template <typename F, class = std::enable_if_t<std::is_void<f_result_t<F>>::value>>
   Future<TransactionResult<void>, StrictFuture::Strict> Transaction(F&& f) const {
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    current::locks::SharedLockGuard<storage_mutex_t> lock(storage_mutex_ref_);
     journal_.AssertEmpty();
     std::promise<TransactionResult<void>> promise;
     if (destructing_) {
@@ -210,7 +216,7 @@ class Synchronous final {
   template <typename F1, typename F2, class = std::enable_if_t<!std::is_void<f_result_t<F1>>::value>>
   Future<TransactionResult<void>, StrictFuture::Strict> Transaction(F1&& f1, F2&& f2) {
     using result_t = f_result_t<F1>;
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
     journal_.AssertEmpty();
     std::promise<TransactionResult<void>> promise;
     if (destructing_) {
@@ -252,7 +258,7 @@ class Synchronous final {
   template <typename F1, typename F2, class = std::enable_if_t<!std::is_void<f_result_t<F1>>::value>>
   Future<TransactionResult<void>, StrictFuture::Strict> Transaction(F1&& f1, F2&& f2) const {
     using result_t = f_result_t<F1>;
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    current::locks::SharedLockGuard<storage_mutex_t> lock(storage_mutex_ref_);
     journal_.AssertEmpty();
     std::promise<TransactionResult<void>> promise;
     if (destructing_) {
@@ -283,10 +289,13 @@ class Synchronous final {
   }
 
   void GracefulShutdown() {
-    std::lock_guard<std::mutex> lock(storage_mutex_ref_);
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
     destructing_ = true;
   }
 
+  // Nothing is ever pending, as each read-write transaction is persisted before its storage mutex is released.
+  void PersistPendingTransactions() {}
+
  private:
   void PersistJournal() {
     try {
@@ -304,13 +313,288 @@ class Synchronous final {
     }
   }
 
-  std::mutex& storage_mutex_ref_;
+  storage_mutex_t& storage_mutex_ref_;
   PERSISTER& persister_;
   MutationJournal& journal_;
   std::mutex mutex_;
   bool destructing_ = false;
 };
 
+// Applies the read-write transactions in memory right away, one at a time, and persists them in batches: the thread
+// of the policy publishes together all the transactions committed while the previous batch was being persisted,
+// having waited for `WINDOW_US` more microseconds after the first of them, to let the batch grow.
+// The future of a read-write transaction is fulfilled, and the `f2` of a two-step one is called, only once its batch
+// has been persisted, in the order of the commits. The stream still has one entry per transaction, at the time the
+// transaction has ended, so the followers replay it as before.
+// The read-only transactions run as in `Synchronous`, and may see the mutations which are not persisted yet.
+template <class PERSISTER, uint64_t WINDOW_US>
+class GroupCommitImpl final {
+ public:
+  using transaction_t = typename PERSISTER::transaction_t;
+
+  GroupCommitImpl(storage_mutex_t& storage_mutex, PERSISTER& persister, MutationJournal& journal)
+      : storage_mutex_ref_(storage_mutex),
+        persister_(persister),
+        journal_(journal),
+        read_only_(storage_mutex, persister, journal),
+        thread_([this]() { Thread(); }) {}
+
+  ~GroupCommitImpl() {
+    {
+      std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
+      destructing_ = true;
+    }
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      stopping_ = true;
+    }
+    pending_cv_.notify_one();
+    thread_.join();
+  }
+
+  template <typename F>
+  using f_result_t = typename std::result_of<F()>::type;
+
+  // Read-write transaction returning non-void type.
+  template <typename F, class = std::enable_if_t<!std::is_void<f_result_t<F>>::value>>
+  Future<TransactionResult<f_result_t<F>>, StrictFuture::Strict> Transaction(F&& f) {
+    using result_t = f_result_t<F>;
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
+    journal_.AssertEmpty();
+    auto promise = std::make_shared<std::promise<TransactionResult<result_t>>>();
+    if (destructing_) {
+      promise->set_exception(std::make_exception_ptr(StorageInGracefulShutdownException()));  // LCOV_EXCL_LINE
+    } else {
+      auto f_result = std::make_shared<result_t>();
+      try {
+        journal_.BeforeTransaction();
+        *f_result = f();
+        journal_.AfterTransaction();
+        Commit([promise, f_result]() {
+          promise->set_value(TransactionResult<result_t>::Committed(std::move(*f_result)));
+        });
+      } catch (StorageRollbackExceptionWithValue<result_t> e) {
+        journal_.Rollback();
+        promise->set_value(TransactionResult<result_t>::RolledBack(std::move(e.value)));
+      } catch (StorageRollbackExceptionWithNoValue) {
+        journal_.Rollback();
+        promise->set_value(TransactionResult<result_t>::RolledBack(OptionalResultMissing()));
+      } catch (...) {  // The exception is captured with `std::current_exception()` below.
+        journal_.Rollback();
+        // LCOV_EXCL_START
+        try {
+          promise->set_exception(std::current_exception());
+        } catch (const std::exception& e) {
+          std::cerr << "`promise.set_exception()` failed in GroupCommit::Transaction: " << e.what() << std::endl;
+          std::exit(-1);
+        }
+        // LCOV_EXCL_STOP
+      }
+    }
+    return Future<TransactionResult<result_t>, StrictFuture::Strict>(promise->get_future());
+  }
+
+  // Read-write transaction returning void type.
+  template <typename F, class = std::enable_if_t<std::is_void<f_result_t<F>>::value>>
+  Future<TransactionResult<void>, StrictFuture::Strict> Transaction(F&& f) {
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
+    journal_.AssertEmpty();
+    auto promise = std::make_shared<std::promise<TransactionResult<void>>>();
+    if (destructing_) {
+      // LCOV_EXCL_START
+      promise->set_exception(std::make_exception_ptr(StorageInGracefulShutdownException()));
+      // LCOV_EXCL_STOP
+    } else {
+      try {
+        journal_.BeforeTransaction();
+        f();
+        journal_.AfterTransaction();
+        Commit([promise]() { promise->set_value(TransactionResult<void>::Committed(OptionalResultExists())); });
+      } catch (StorageRollbackExceptionWithNoValue) {
+        journal_.Rollback();
+        promise->set_value(TransactionResult<void>::RolledBack(OptionalResultExists()));
+      } catch (...) {  // The exception is captured with `std::current_exception()` below.
+        journal_.Rollback();
+        // LCOV_EXCL_START
+        try {
+          promise->set_exception(std::current_exception());
+        } catch (const std::exception& e) {
+          std::cerr << "`promise.set_exception()` failed in GroupCommit::Transaction: " << e.what() << std::endl;
+          std::exit(-1);
+        }
+        // LCOV_EXCL_STOP
+      }
+    }
+    return Future<TransactionResult<void>, StrictFuture::Strict>(promise->get_future());
+  }
+
+  // Read-write two-step transaction. The `f2` is called from the thread of the policy, once `f1` is persisted.
+  template <typename F1, typename F2, class = std::enable_if_t<!std::is_void<f_result_t<F1>>::value>>
+  Future<TransactionResult<void>, StrictFuture::Strict> Transaction(F1&& f1, F2&& f2) {
+    using result_t = f_result_t<F1>;
+    std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
+    journal_.AssertEmpty();
+    auto promise = std::make_shared<std::promise<TransactionResult<void>>>();
+    if (destructing_) {
+      promise->set_exception(std::make_exception_ptr(StorageInGracefulShutdownException()));  // LCOV_EXCL_LINE
+    } else {
+      auto f1_result = std::make_shared<result_t>();
+      try {
+        journal_.BeforeTransaction();
+        *f1_result = f1();
+        journal_.AfterTransaction();
+        auto f2_copy = std::make_shared<typename std::decay<F2>::type>(std::forward<F2>(f2));
+        Commit([promise, f1_result, f2_copy]() {
+          try {
+            (*f2_copy)(std::move(*f1_result));
+            promise->set_value(TransactionResult<void>::Committed(OptionalResultExists()));
+          } catch (...) {
+            promise->set_exception(std::current_exception());
+          }
+        });
+      } catch (StorageRollbackExceptionWithValue<result_t> e) {
+        // Transaction was rolled back, but returned a value, which we try to pass again to `f2`.
+        journal_.Rollback();
+        f2(std::move(e.value));
+        promise->set_value(TransactionResult<void>::RolledBack(OptionalResultMissing()));
+      } catch (StorageRollbackExceptionWithNoValue) {
+        // Transaction was rolled back and returned nothing we can pass to `f2`.
+        journal_.Rollback();
+        promise->set_value(TransactionResult<void>::RolledBack(OptionalResultMissing()));
+      } catch (...) {  // The exception is captured with `std::current_exception()` below.
+        // LCOV_EXCL_START
+        journal_.Rollback();
+        try {
+          promise->set_exception(std::current_exception());
+        } catch (const std::exception& e) {
+          std::cerr << "`promise.set_exception()` failed in GroupCommit::Transaction: " << e.what() << std::endl;
+          std::exit(-1);
+        }
+        // LCOV_EXCL_STOP
+      }
+    }
+    return Future<TransactionResult<void>, StrictFuture::Strict>(promise->get_future());
+  }
+
+  // Read-only transactions, both the one-step and the two-step ones.
+  template <typename F>
+  Future<TransactionResult<f_result_t<F>>, StrictFuture::Strict> Transaction(F&& f) const {
+    return read_only_.Transaction(std::forward<F>(f));
+  }
+
+  template <typename F1, typename F2, class = std::enable_if_t<!std::is_void<f_result_t<F1>>::value>>
+  Future<TransactionResult<void>, StrictFuture::Strict> Transaction(F1&& f1, F2&& f2) const {
+    return read_only_.Transaction(std::forward<F1>(f1), std::forward<F2>(f2));
+  }
+
+  void GracefulShutdown() {
+    {
+      std::lock_guard<storage_mutex_t> lock(storage_mutex_ref_);
+      destructing_ = true;
+    }
+    read_only_.GracefulShutdown();
+  }
+
+  // Persists the transactions committed so far right away. Must be called with the storage mutex held, shared or
+  // exclusive, so that the stream is up to date with the fields once this call returns.
+  void PersistPendingTransactions() {
+    std::lock_guard<std::mutex> lock(persist_mutex_);
+    for (auto& done : PersistPendingTransactionsUnderLocks()) {
+      done();
+    }
+  }
+
+ private:
+  // Must be called with the storage mutex locked exclusively.
+  void Commit(std::function<void()> done) {
+    bool was_empty;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      was_empty = pending_journals_.empty();
+      pending_journals_.push_back(std::move(journal_));
+      pending_done_.push_back(std::move(done));
+    }
+    journal_.Clear();
+    if (was_empty) {
+      pending_cv_.notify_one();
+    }
+  }
+
+  void Thread() {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(pending_mutex_);
+        pending_cv_.wait(lock, [this]() { return !pending_journals_.empty() || stopping_; });
+        if (pending_journals_.empty()) {
+          return;
+        }
+        if (WINDOW_US && !stopping_) {
+          pending_cv_.wait_for(lock, std::chrono::microseconds(WINDOW_US), [this]() { return stopping_; });
+        }
+      }
+      // The storage mutex is locked before `persist_mutex_`, as when `PersistPendingTransactions()` is called.
+      // It is locked shared, to not block the read-only transactions while the batch is being persisted.
+      std::unique_lock<std::mutex> persist_lock(persist_mutex_, std::defer_lock);
+      std::vector<std::function<void()>> done;
+      {
+        current::locks::SharedLockGuard<storage_mutex_t> lock(storage_mutex_ref_);
+        persist_lock.lock();
+        done = PersistPendingTransactionsUnderLocks();
+      }
+      for (auto& f : done) {
+        f();
+      }
+    }
+  }
+
+  // Must be called with both the storage mutex and `persist_mutex_` locked.
+  std::vector<std::function<void()>> PersistPendingTransactionsUnderLocks() {
+    std::vector<MutationJournal> journals;
+    std::vector<std::function<void()>> done;
+    {
+      std::lock_guard<std::mutex> lock(pending_mutex_);
+      journals.swap(pending_journals_);
+      done.swap(pending_done_);
+    }
+    if (!journals.empty()) {
+      try {
+        persister_.PersistJournals(journals);
+      } catch (const ss::InconsistentTimestampException& e) {
+        std::cerr << "PersistJournals() failed with InconsistentTimestampException: " << e.what() << std::endl;
+#ifdef CURRENT_MOCK_TIME
+        std::cerr << "Binary is compiled with `CURRENT_MOCK_TIME`. Probably `SetNow()` wasn't properly called."
+                  << std::endl;
+#endif
+        std::exit(-1);
+      } catch (const std::exception& e) {
+        std::cerr << "PersistJournals() failed with exception: " << e.what() << std::endl;
+        std::exit(-1);
+      }
+    }
+    return done;
+  }
+
+  storage_mutex_t& storage_mutex_ref_;
+  PERSISTER& persister_;
+  MutationJournal& journal_;
+  Synchronous<PERSISTER> read_only_;
+  bool destructing_ = false;
+
+  std::mutex pending_mutex_;
+  std::condition_variable pending_cv_;
+  std::vector<MutationJournal> pending_journals_;
+  std::vector<std::function<void()>> pending_done_;
+  bool stopping_ = false;
+
+  std::mutex persist_mutex_;  // Keeps the batches, and the futures of their transactions, in the commit order.
+  std::thread thread_;
+};
+
+// Does not wait beyond the time it takes to persist the previous batch. A longer window pays off only if persisting
+// a batch costs much more than persisting a transaction, as the callers waiting for their futures are delayed by it.
+template <class PERSISTER>
+using GroupCommit = GroupCommitImpl<PERSISTER, 0u>;
+
 }  // namespace transaction_policy
 }  // namespace storage
 }  // namespace current
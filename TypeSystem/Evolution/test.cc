@@ -44,6 +44,8 @@ SOFTWARE.
 #include "../../Storage/storage.h"
 #include "../../Storage/persister/sherlock.h"
 
+#include "../../Blocks/Persistence/evolution.h"
+
 #include "../../Bricks/file/file.h"
 #include "../../Bricks/dflags/dflags.h"
 
@@ -1341,4 +1343,78 @@ TEST(TypeEvolutionTest, StorageTransactionsEvolution) {
   }
 }
 
+TEST(TypeEvolutionTest, EvolvePersistedFile) {
+  const std::string from_file_name = current::FileSystem::JoinPath(FLAGS_type_evolution_test_tmpdir, "evolve_from");
+  const auto from_file_remover = current::FileSystem::ScopedRmFile(from_file_name);
+
+  const std::string into_file_name = current::FileSystem::JoinPath(FLAGS_type_evolution_test_tmpdir, "evolve_into");
+  const auto into_file_remover = current::FileSystem::ScopedRmFile(into_file_name);
+
+  // The golden pre-evolution storage log, with the head moved past the last transaction.
+  const std::string from_contents =
+      current::FileSystem::ReadFileAsString(current::FileSystem::JoinPath("golden", "storage_pre_evolution.txt")) +
+      "#head 00000000000000000010\n";
+  current::FileSystem::WriteStringToFile(from_contents, from_file_name.c_str());
+
+  const auto evolve = [&from_file_name, &into_file_name]() {
+    return current::persistence::EvolvePersistedFile<SchemaOriginalStorage,
+                                                     typename SchemaOriginalStorage::Transaction,
+                                                     SchemaModifiedStorage,
+                                                     typename SchemaModifiedStorage::Transaction,
+                                                     current::type_evolution::OriginalStorageToModifiedStorageEvolver>(
+        from_file_name, into_file_name, 2u);
+  };
+
+  const current::persistence::PersistedFileEvolutionStats stats = evolve();
+  EXPECT_EQ(2u, stats.entries);
+  EXPECT_EQ(2u, stats.directives);
+  EXPECT_EQ(from_contents.length(), stats.bytes_read);
+
+  const std::string into_contents = current::FileSystem::ReadFileAsString(into_file_name);
+  EXPECT_EQ(into_contents.length(), stats.bytes_written);
+  const std::vector<std::string> from_lines = current::strings::Split<current::strings::ByLines>(from_contents);
+  const std::vector<std::string> into_lines = current::strings::Split<current::strings::ByLines>(into_contents);
+  ASSERT_EQ(4u, into_lines.size());
+
+  // The signature now carries the evolved schema.
+  EXPECT_EQ(current::strings::Split<current::strings::ByLines>(current::FileSystem::ReadFileAsString(
+                current::FileSystem::JoinPath("golden", "storage_post_evolution.txt")))[0],
+            into_lines[0]);
+
+  // The indexes and the timestamps of the entries, as well as the `#head` directive, are kept as is.
+  const auto idxts = [](const std::string& line) { return line.substr(0, line.find('\t')); };
+  EXPECT_EQ("{\"index\":0,\"us\":3}", idxts(into_lines[1]));
+  EXPECT_EQ(idxts(from_lines[1]), idxts(into_lines[1]));
+  EXPECT_EQ(idxts(from_lines[2]), idxts(into_lines[2]));
+  EXPECT_EQ("#head 00000000000000000010", into_lines[3]);
+
+  // The evolved file is a valid storage log of the new schema.
+  using restored_post_storage_t = type_evolution_test::post_evolution::Storage<SherlockStreamPersister>;
+  restored_post_storage_t replayed_post_evolution_storage(into_file_name);
+  replayed_post_evolution_storage.ReadOnlyTransaction([](ImmutableFields<restored_post_storage_t> fields) {
+    EXPECT_EQ(3u, fields.user.Size());
+    EXPECT_EQ("MARX, K", Value(fields.user["karl"]).full);
+    EXPECT_EQ("KOROLEV, D", Value(fields.user["dima"]).full);
+    EXPECT_EQ("ZHUROVICH, M", Value(fields.user["max"]).full);
+  }).Wait();
+  EXPECT_EQ(10, replayed_post_evolution_storage.InternalExposeStream().Persister().CurrentHead().count());
+
+  // The entries out of order are reported, and the previously evolved file is left intact.
+  current::FileSystem::WriteStringToFile(from_lines[0] + '\n' + from_lines[2] + '\n', from_file_name.c_str());
+  ASSERT_THROW(evolve(), current::ss::InconsistentIndexException);
+  EXPECT_EQ(into_contents, current::FileSystem::ReadFileAsString(into_file_name));
+  ASSERT_THROW(current::FileSystem::GetFileSize(into_file_name + ".tmp"), current::FileException);
+
+  // The file can not be evolved into itself.
+  const auto evolve_into_itself = [&from_file_name]() {
+    return current::persistence::EvolvePersistedFile<SchemaOriginalStorage,
+                                                     typename SchemaOriginalStorage::Transaction,
+                                                     SchemaModifiedStorage,
+                                                     typename SchemaModifiedStorage::Transaction,
+                                                     current::type_evolution::OriginalStorageToModifiedStorageEvolver>(
+        from_file_name, from_file_name);
+  };
+  ASSERT_THROW(evolve_into_itself(), current::persistence::PersistenceEvolutionIntoTheSameFileException);
+}
+
 #endif  // CURRENT_TYPE_SYSTEM_EVOLUTION_TEST_CC
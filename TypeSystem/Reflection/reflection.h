@@ -62,9 +62,13 @@ reflection::TypeID InternalCurrentTypeID(std::type_index top_level_type, const c
 // `CurrentTypeID<T>()` is the "user-facing" type ID of `T`, whereas for each individual `T` the values
 // of correponding calls to `InternalCurrentTypeID` may and will be different in case of cyclic dependencies,
 // as the order of their resolution by definition depends on which part of the cycle was the starting point.
+// Since the starting point of `CurrentTypeID<T>()` is always `T` itself, its value is the same for every thread,
+// and is computed once per process: the thread-safe initialization of the function-local static lets the first
+// caller traverse the type, and the rest of the callers, from any thread, only read the value, lock-free.
 template <typename T>
 reflection::TypeID CurrentTypeID() {
-  return InternalCurrentTypeID<T>(typeid(T), CurrentTypeName<T, NameFormat::Z>());
+  static const reflection::TypeID type_id = InternalCurrentTypeID<T>(typeid(T), CurrentTypeName<T, NameFormat::Z>());
+  return type_id;
 }
 
 #ifdef TODO_DKOROLEV_EXTRA_PARANOID_DEBUG_SYMBOL_NAME
@@ -737,7 +737,7 @@ TEST(Reflection, VisitAllFieldsWithObject) {
       "1e+38,1e+308,"
       "The String,"
       "2,"
-      "Minus eight point five:-9.500000,"
+      "Minus eight point five:-9.5,"
       "[-1,-2,-4],"
       "[key1:value1,key2:value2],"
       "128,null",
@@ -838,8 +838,7 @@ TEST(Reflection, OrderDoesNotMatter) {
   auto const two = current::reflection::CurrentTypeID<Two>();
   EXPECT_EQ(9201293424144532153ull, static_cast<uint64_t>(one));
   EXPECT_EQ(9207292435550686765ull, static_cast<uint64_t>(two));
-  // `Reflector` is thread local, so starting another thread is the easiest way to ensure a stateless run.
-  // Also note that the order of computations of TypeIDs is flipped in the two threads.
+  // The TypeIDs do not depend on the thread, nor on the order of computations, which is flipped in the two threads.
   std::thread([one, two]() {
     EXPECT_EQ(static_cast<uint64_t>(one), static_cast<uint64_t>(current::reflection::CurrentTypeID<One>()));
     EXPECT_EQ(static_cast<uint64_t>(two), static_cast<uint64_t>(current::reflection::CurrentTypeID<Two>()));
@@ -852,6 +851,50 @@ TEST(Reflection, OrderDoesNotMatter) {
 
 namespace reflection_test {
 
+CURRENT_FORWARD_DECLARE_STRUCT(CachedOne);
+CURRENT_FORWARD_DECLARE_STRUCT(CachedTwo);
+
+CURRENT_STRUCT(CachedOne) { CURRENT_FIELD(two, std::vector<CachedTwo>); };
+
+CURRENT_STRUCT(CachedTwo) {
+  CURRENT_FIELD(one, Optional<CachedOne>);
+  CURRENT_FIELD(map, (std::map<std::string, std::vector<CachedOne>>));
+};
+
+}  // namespace reflection_test
+
+TEST(Reflection, TypeIDIsComputedOncePerProcess) {
+  using namespace reflection_test;
+  using current::reflection::CurrentTypeID;
+  using current::reflection::TypeID;
+  // Race the threads to compute the TypeIDs first, each thread starting from its own end of the cycle.
+  std::vector<std::pair<TypeID, TypeID>> results(8u);
+  std::vector<std::thread> threads;
+  for (size_t i = 0u; i < results.size(); ++i) {
+    threads.emplace_back([&results, i]() {
+      if (i & 1u) {
+        results[i].second = CurrentTypeID<CachedTwo>();
+        results[i].first = CurrentTypeID<CachedOne>();
+      } else {
+        results[i].first = CurrentTypeID<CachedOne>();
+        results[i].second = CurrentTypeID<CachedTwo>();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const auto& result : results) {
+    EXPECT_EQ(9202274755689632704ull, static_cast<uint64_t>(result.first));
+    EXPECT_EQ(9201850277742060742ull, static_cast<uint64_t>(result.second));
+  }
+  EXPECT_EQ(static_cast<uint64_t>(results.front().first),
+            static_cast<uint64_t>(Value<current::reflection::ReflectedTypeBase>(
+                                      current::reflection::Reflector().ReflectType<CachedOne>()).type_id));
+}
+
+namespace reflection_test {
+
 CURRENT_STRUCT_T(RSRange) {
   CURRENT_FIELD(min, Optional<T>);
   CURRENT_FIELD(max, Optional<T>);
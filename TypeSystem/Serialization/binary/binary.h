@@ -0,0 +1,349 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The compact binary format of Current types. The schema is not part of the data, so the reader has to know the type.
+//
+// * `bool`, `char`, `int8_t`, `uint8_t`: one byte.
+// * Other unsigned integers, `TypeID`-s, lengths and counts: varints, seven bits per byte, the lowest bits first.
+// * Other signed integers and `std::chrono::*`: varints of zigzag-encoded values, so that small negatives stay short.
+// * `float` and `double`: IEEE 754, four and eight bytes, little endian.
+// * Enums: as their underlying types.
+// * Strings: the length, followed by the bytes.
+// * Containers: the number of elements, followed by the elements; for maps, the keys and the values interleaved.
+// * Pairs: the first element, followed by the second one.
+// * `Optional`: zero if there is no value, or one followed by the value.
+// * `Variant`: the `TypeID` of the value, followed by the value; zero for an uninitialized `Variant`.
+// * `CURRENT_STRUCT`: the length of the rest of its record, the number of its own fields, the record of its base
+//   `CURRENT_STRUCT` unless it is `CurrentStruct`, and its own fields in the order of their declaration.
+//
+// The fields are matched by position, not by name. With `BinaryDecoding::Strict` the number of fields of each
+// struct must match exactly. With `BinaryDecoding::SkipUnknownFields` the fields appended to a struct after
+// the reader was built are skipped, and the fields the writer did not know about keep their default values.
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "exceptions.h"
+
+#include "../serialization.h"
+
+#include "../../struct.h"
+#include "../../optional.h"
+#include "../../helpers.h"
+
+namespace current {
+namespace serialization {
+namespace binary {
+
+struct BinaryDecoding {
+  struct Strict {};
+  struct SkipUnknownFields {};
+};
+
+template <class DECODING>
+struct BinarySkipsUnknownFields {
+  constexpr static bool value = false;
+};
+template <>
+struct BinarySkipsUnknownFields<BinaryDecoding::SkipUnknownFields> {
+  constexpr static bool value = true;
+};
+
+constexpr static size_t kMaxVarintLength = 10u;
+
+// Returns the number of bytes written into `output`, which must have room for `kMaxVarintLength` bytes.
+inline size_t EncodeVarint(uint64_t value, char* output) {
+  size_t size = 0u;
+  while (value >= 0x80u) {
+    output[size++] = static_cast<char>((value & 0x7fu) | 0x80u);
+    value >>= 7;
+  }
+  output[size++] = static_cast<char>(value);
+  return size;
+}
+
+inline uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1u);
+}
+
+// Appends to the string it is constructed with.
+class BinaryWriter final {
+ public:
+  explicit BinaryWriter(std::string& output) : output_(output) {}
+
+  void WriteByte(uint8_t value) { output_.push_back(static_cast<char>(value)); }
+
+  void WriteBytes(const char* data, size_t size) { output_.append(data, size); }
+
+  void WriteVarint(uint64_t value) {
+    char buffer[kMaxVarintLength];
+    output_.append(buffer, EncodeVarint(value, buffer));
+  }
+
+  void WriteSignedVarint(int64_t value) { WriteVarint(ZigZagEncode(value)); }
+
+  void WriteFixed32(uint32_t value) {
+    char buffer[4];
+    for (size_t i = 0u; i < 4u; ++i) {
+      buffer[i] = static_cast<char>(value >> (i * 8u));
+    }
+    output_.append(buffer, 4u);
+  }
+
+  void WriteFixed64(uint64_t value) {
+    char buffer[8];
+    for (size_t i = 0u; i < 8u; ++i) {
+      buffer[i] = static_cast<char>(value >> (i * 8u));
+    }
+    output_.append(buffer, 8u);
+  }
+
+  // A length-prefixed block. One byte is reserved for the length upfront, and in the rare case the block is
+  // 128 bytes or longer, the block is shifted to make room for the longer length once it is known.
+  size_t BeginBlock() {
+    output_.push_back('\0');
+    return output_.length();
+  }
+
+  void EndBlock(size_t begin) {
+    char buffer[kMaxVarintLength];
+    const size_t size = EncodeVarint(output_.length() - begin, buffer);
+    output_[begin - 1u] = buffer[0];
+    if (size > 1u) {
+      output_.insert(begin, buffer + 1u, size - 1u);
+    }
+  }
+
+ private:
+  std::string& output_;
+};
+
+template <class DECODING>
+class BinaryReader final {
+ public:
+  BinaryReader(const char* begin, const char* end) : current_(begin), end_(end) {}
+
+  bool AtEnd() const { return current_ == end_; }
+
+  uint8_t ReadByte() {
+    Require(1u);
+    return static_cast<uint8_t>(*current_++);
+  }
+
+  const char* ReadBytes(size_t size) {
+    Require(size);
+    const char* result = current_;
+    current_ += size;
+    return result;
+  }
+
+  uint64_t ReadVarint() {
+    uint64_t result = 0u;
+    for (size_t shift = 0u; shift < 64u; shift += 7u) {
+      const uint8_t byte = ReadByte();
+      result |= static_cast<uint64_t>(byte & 0x7fu) << shift;
+      if (!(byte & 0x80u)) {
+        return result;
+      }
+    }
+    CURRENT_THROW(BinaryLoadFromStreamException("Malformed varint."));
+  }
+
+  int64_t ReadSignedVarint() { return ZigZagDecode(ReadVarint()); }
+
+  uint32_t ReadFixed32() {
+    const char* bytes = ReadBytes(4u);
+    uint32_t result = 0u;
+    for (size_t i = 0u; i < 4u; ++i) {
+      result |= static_cast<uint32_t>(static_cast<uint8_t>(bytes[i])) << (i * 8u);
+    }
+    return result;
+  }
+
+  uint64_t ReadFixed64() {
+    const char* bytes = ReadBytes(8u);
+    uint64_t result = 0u;
+    for (size_t i = 0u; i < 8u; ++i) {
+      result |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[i])) << (i * 8u);
+    }
+    return result;
+  }
+
+  // The number of elements of a container. Each element takes at least one byte, so a count greater than
+  // the number of bytes left is malformed input, and should not result in an attempt to allocate that much.
+  size_t ReadCount() {
+    const uint64_t count = ReadVarint();
+    if (count > static_cast<uint64_t>(end_ - current_)) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Container size exceeds the input size."));
+    }
+    return static_cast<size_t>(count);
+  }
+
+  // Enters a length-prefixed block. Returns the end of the enclosing block, to be passed to `EndBlock()`.
+  const char* BeginBlock() {
+    const uint64_t size = ReadVarint();
+    Require(size);
+    const char* enclosing_end = end_;
+    end_ = current_ + size;
+    return enclosing_end;
+  }
+
+  // Leaves the block, skipping its unread bytes, or, in the strict mode, throwing if there are any.
+  void EndBlock(const char* enclosing_end) {
+    if (current_ != end_) {
+      if (!BinarySkipsUnknownFields<DECODING>::value) {
+        CURRENT_THROW(BinarySchemaException("Unexpected trailing data in a struct."));
+      }
+      current_ = end_;
+    }
+    end_ = enclosing_end;
+  }
+
+ private:
+  void Require(uint64_t size) const {
+    if (size > static_cast<uint64_t>(end_ - current_)) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Unexpected end of input."));
+    }
+  }
+
+  const char* current_;
+  const char* end_;
+};
+
+template <typename T>
+inline void AppendBinary(std::string& output, const T& source) {
+  BinaryWriter writer(output);
+  Serialize(writer, source);
+}
+
+template <typename T>
+inline std::string Binary(const T& source) {
+  std::string result;
+  AppendBinary(result, source);
+  return result;
+}
+
+template <typename T, class D = BinaryDecoding::Strict>
+inline void ParseBinary(const char* begin, const char* end, T& destination) {
+  try {
+    BinaryReader<D> reader(begin, end);
+    Deserialize(reader, destination);
+    if (!reader.AtEnd()) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Unexpected trailing data."));
+    }
+    CheckIntegrity(destination);
+  } catch (UninitializedVariant) {
+    CURRENT_THROW(BinaryUninitializedVariantObjectException());
+  }
+}
+
+template <typename T, class D = BinaryDecoding::Strict>
+inline void ParseBinary(const std::string& source, T& destination) {
+  ParseBinary<T, D>(source.data(), source.data() + source.length(), destination);
+}
+
+template <typename T, class D = BinaryDecoding::Strict>
+inline T ParseBinary(const std::string& source) {
+  T result;
+  ParseBinary<T, D>(source, result);
+  return result;
+}
+
+// Stream I/O. Each object is preceded by the length of its binary representation, so that several objects
+// can be saved into and loaded from the same stream one after another.
+template <typename T>
+inline void SaveIntoBinary(std::ostream& os, const T& source) {
+  const std::string body = Binary(source);
+  char prefix[kMaxVarintLength];
+  os.write(prefix, static_cast<std::streamsize>(EncodeVarint(body.length(), prefix)));
+  os.write(body.data(), static_cast<std::streamsize>(body.length()));
+  if (!os) {
+    CURRENT_THROW(BinarySaveIntoStreamException("Failed to write into the stream."));  // LCOV_EXCL_LINE
+  }
+}
+
+template <typename T, class D = BinaryDecoding::Strict>
+inline void LoadFromBinary(std::istream& is, T& destination) {
+  uint64_t size = 0u;
+  for (size_t shift = 0u;; shift += 7u) {
+    const int c = is.get();
+    if (c == std::istream::traits_type::eof() || shift >= 64u) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Malformed length prefix in the stream."));
+    }
+    size |= static_cast<uint64_t>(c & 0x7f) << shift;
+    if (!(c & 0x80)) {
+      break;
+    }
+  }
+  // Read in chunks, so that a malformed length does not result in an attempt to allocate that much upfront.
+  constexpr static uint64_t kChunkSize = 1u << 20;
+  std::string body;
+  while (body.length() < size) {
+    const size_t offset = body.length();
+    const size_t chunk = static_cast<size_t>(std::min(size - offset, kChunkSize));
+    body.resize(offset + chunk);
+    is.read(&body[offset], static_cast<std::streamsize>(chunk));
+    if (static_cast<size_t>(is.gcount()) != chunk) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Unexpected end of stream."));
+    }
+  }
+  ParseBinary<T, D>(body, destination);
+}
+
+template <typename T, class D = BinaryDecoding::Strict>
+inline T LoadFromBinary(std::istream& is) {
+  T result;
+  LoadFromBinary<T, D>(is, result);
+  return result;
+}
+
+}  // namespace current::serialization::binary
+}  // namespace current::serialization
+
+// Keep top-level symbols both in `current::` and in global namespace.
+using serialization::binary::Binary;
+using serialization::binary::AppendBinary;
+using serialization::binary::ParseBinary;
+using serialization::binary::SaveIntoBinary;
+using serialization::binary::LoadFromBinary;
+using serialization::binary::BinaryDecoding;
+}  // namespace current
+
+using current::Binary;
+using current::AppendBinary;
+using current::ParseBinary;
+using current::SaveIntoBinary;
+using current::LoadFromBinary;
+using current::BinaryDecoding;
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
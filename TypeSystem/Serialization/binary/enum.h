@@ -0,0 +1,56 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_ENUM_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_ENUM_H
+
+#include <type_traits>
+
+#include "primitives.h"
+
+#include "../../../Bricks/template/enable_if.h"
+
+namespace current {
+namespace serialization {
+
+template <typename T>
+struct SerializeImpl<binary::BinaryWriter, T, std::enable_if_t<std::is_enum<T>::value>> {
+  static void DoSerialize(binary::BinaryWriter& writer, const T enum_value) {
+    Serialize(writer, static_cast<typename std::underlying_type<T>::type>(enum_value));
+  }
+};
+
+template <class D, typename T>
+struct DeserializeImpl<binary::BinaryReader<D>, T, std::enable_if_t<std::is_enum<T>::value>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, T& destination) {
+    typename std::underlying_type<T>::type value;
+    Deserialize(reader, value);
+    destination = static_cast<T>(value);
+  }
+};
+
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_ENUM_H
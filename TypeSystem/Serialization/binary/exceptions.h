@@ -0,0 +1,66 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_EXCEPTIONS_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_EXCEPTIONS_H
+
+#include "../../../port.h"
+
+#include "../../exceptions.h"
+
+namespace current {
+namespace serialization {
+namespace binary {
+
+struct TypeSystemParseBinaryException : Exception {
+  using Exception::Exception;
+};
+
+// The input is truncated or malformed.
+struct BinaryLoadFromStreamException : TypeSystemParseBinaryException {
+  using TypeSystemParseBinaryException::TypeSystemParseBinaryException;
+};
+
+// The input is well-formed, but does not match the type it is being loaded into.
+struct BinarySchemaException : TypeSystemParseBinaryException {
+  using TypeSystemParseBinaryException::TypeSystemParseBinaryException;
+};
+
+struct BinaryUninitializedVariantObjectException : TypeSystemParseBinaryException {};
+
+struct BinarySaveIntoStreamException : Exception {
+  using Exception::Exception;
+};
+
+}  // namespace current::serialization::binary
+}  // namespace current::serialization
+}  // namespace current
+
+using current::serialization::binary::TypeSystemParseBinaryException;
+using current::serialization::binary::BinaryLoadFromStreamException;
+using current::serialization::binary::BinarySchemaException;
+using current::serialization::binary::BinaryUninitializedVariantObjectException;
+using current::serialization::binary::BinarySaveIntoStreamException;
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_EXCEPTIONS_H
@@ -0,0 +1,64 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_MAP_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_MAP_H
+
+#include <map>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+template <typename K, typename V, class C, class A>
+struct SerializeImpl<binary::BinaryWriter, std::map<K, V, C, A>> {
+  static void DoSerialize(binary::BinaryWriter& writer, const std::map<K, V, C, A>& value) {
+    writer.WriteVarint(value.size());
+    for (const auto& element : value) {
+      Serialize(writer, element.first);
+      Serialize(writer, element.second);
+    }
+  }
+};
+
+template <class D, typename K, typename V, class C, class A>
+struct DeserializeImpl<binary::BinaryReader<D>, std::map<K, V, C, A>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, std::map<K, V, C, A>& destination) {
+    const size_t size = reader.ReadCount();
+    destination.clear();
+    for (size_t i = 0u; i < size; ++i) {
+      K k;
+      V v;
+      Deserialize(reader, k);
+      Deserialize(reader, v);
+      destination.emplace(std::move(k), std::move(v));
+    }
+  }
+};
+
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_MAP_H
@@ -0,0 +1,54 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PAIR_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PAIR_H
+
+#include <utility>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+template <typename TF, typename TS>
+struct SerializeImpl<binary::BinaryWriter, std::pair<TF, TS>> {
+  static void DoSerialize(binary::BinaryWriter& writer, const std::pair<TF, TS>& value) {
+    Serialize(writer, value.first);
+    Serialize(writer, value.second);
+  }
+};
+
+template <class D, typename TF, typename TS>
+struct DeserializeImpl<binary::BinaryReader<D>, std::pair<TF, TS>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, std::pair<TF, TS>& destination) {
+    Deserialize(reader, destination.first);
+    Deserialize(reader, destination.second);
+  }
+};
+
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PAIR_H
@@ -0,0 +1,175 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
+
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "binary.h"
+
+#include "../../../Bricks/template/enable_if.h"
+
+namespace current {
+namespace serialization {
+
+// `bool`, `char`, `int8_t`, `uint8_t`.
+template <typename T>
+struct SerializeImpl<binary::BinaryWriter, T, std::enable_if_t<std::numeric_limits<T>::is_integer && sizeof(T) == 1u>> {
+  static void DoSerialize(binary::BinaryWriter& writer, T value) { writer.WriteByte(static_cast<uint8_t>(value)); }
+};
+
+template <class D, typename T>
+struct DeserializeImpl<binary::BinaryReader<D>,
+                       T,
+                       std::enable_if_t<std::numeric_limits<T>::is_integer && sizeof(T) == 1u>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, T& destination) {
+    destination = static_cast<T>(reader.ReadByte());
+  }
+};
+
+// `uint*_t`.
+template <typename T>
+struct SerializeImpl<binary::BinaryWriter,
+                     T,
+                     std::enable_if_t<std::numeric_limits<T>::is_integer && !std::numeric_limits<T>::is_signed &&
+                                      (sizeof(T) > 1u)>> {
+  static void DoSerialize(binary::BinaryWriter& writer, T value) { writer.WriteVarint(value); }
+};
+
+template <class D, typename T>
+struct DeserializeImpl<binary::BinaryReader<D>,
+                       T,
+                       std::enable_if_t<std::numeric_limits<T>::is_integer && !std::numeric_limits<T>::is_signed &&
+                                        (sizeof(T) > 1u)>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, T& destination) {
+    const uint64_t value = reader.ReadVarint();
+    if (value > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+      CURRENT_THROW(BinarySchemaException("Unsigned integer out of range."));
+    }
+    destination = static_cast<T>(value);
+  }
+};
+
+// `int*_t`.
+template <typename T>
+struct SerializeImpl<binary::BinaryWriter,
+                     T,
+                     std::enable_if_t<std::numeric_limits<T>::is_integer && std::numeric_limits<T>::is_signed &&
+                                      (sizeof(T) > 1u)>> {
+  static void DoSerialize(binary::BinaryWriter& writer, T value) { writer.WriteSignedVarint(value); }
+};
+
+template <class D, typename T>
+struct DeserializeImpl<binary::BinaryReader<D>,
+                       T,
+                       std::enable_if_t<std::numeric_limits<T>::is_integer && std::numeric_limits<T>::is_signed &&
+                                        (sizeof(T) > 1u)>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, T& destination) {
+    const int64_t value = reader.ReadSignedVarint();
+    if (value < static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+        value > static_cast<int64_t>(std::numeric_limits<T>::max())) {
+      CURRENT_THROW(BinarySchemaException("Signed integer out of range."));
+    }
+    destination = static_cast<T>(value);
+  }
+};
+
+// `float`.
+template <>
+struct SerializeImpl<binary::BinaryWriter, float> {
+  static void DoSerialize(binary::BinaryWriter& writer, float value) {
+    static_assert(sizeof(float) == sizeof(uint32_t), "`float` must be IEEE 754 single precision.");
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writer.WriteFixed32(bits);
+  }
+};
+
+template <class D>
+struct DeserializeImpl<binary::BinaryReader<D>, float> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, float& destination) {
+    const uint32_t bits = reader.ReadFixed32();
+    std::memcpy(&destination, &bits, sizeof(bits));
+  }
+};
+
+// `double`.
+template <>
+struct SerializeImpl<binary::BinaryWriter, double> {
+  static void DoSerialize(binary::BinaryWriter& writer, double value) {
+    static_assert(sizeof(double) == sizeof(uint64_t), "`double` must be IEEE 754 double precision.");
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writer.WriteFixed64(bits);
+  }
+};
+
+template <class D>
+struct DeserializeImpl<binary::BinaryReader<D>, double> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, double& destination) {
+    const uint64_t bits = reader.ReadFixed64();
+    std::memcpy(&destination, &bits, sizeof(bits));
+  }
+};
+
+// `std::string`.
+template <>
+struct SerializeImpl<binary::BinaryWriter, std::string> {
+  static void DoSerialize(binary::BinaryWriter& writer, const std::string& value) {
+    writer.WriteVarint(value.length());
+    writer.WriteBytes(value.data(), value.length());
+  }
+};
+
+template <class D>
+struct DeserializeImpl<binary::BinaryReader<D>, std::string> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, std::string& destination) {
+    const size_t length = reader.ReadCount();
+    destination.assign(reader.ReadBytes(length), length);
+  }
+};
+
+// `std::chrono::milliseconds` and `std::chrono::microseconds`.
+template <typename R, typename P>
+struct SerializeImpl<binary::BinaryWriter, std::chrono::duration<R, P>> {
+  static void DoSerialize(binary::BinaryWriter& writer, std::chrono::duration<R, P> value) {
+    writer.WriteSignedVarint(static_cast<int64_t>(value.count()));
+  }
+};
+
+template <class D, typename R, typename P>
+struct DeserializeImpl<binary::BinaryReader<D>, std::chrono::duration<R, P>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, std::chrono::duration<R, P>& destination) {
+    destination = std::chrono::duration<R, P>(static_cast<R>(reader.ReadSignedVarint()));
+  }
+};
+
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
@@ -0,0 +1,138 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_STRUCT_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_STRUCT_H
+
+#include <type_traits>
+
+#include "binary.h"
+
+#include "../../Reflection/reflection.h"
+
+#include "../../../Bricks/template/enable_if.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+
+class BinaryStructFieldsSerializer {
+ public:
+  explicit BinaryStructFieldsSerializer(BinaryWriter& writer) : writer_(writer) {}
+
+  template <typename U>
+  void operator()(const char*, const U& source) const {
+    Serialize(writer_, source);
+  }
+
+ private:
+  BinaryWriter& writer_;
+};
+
+template <typename T>
+struct SerializeStructImpl {
+  static void SerializeStruct(BinaryWriter& writer, const T& source) {
+    using decayed_t = current::decay<T>;
+    using super_t = current::reflection::SuperType<decayed_t>;
+
+    const size_t block = writer.BeginBlock();
+    writer.WriteVarint(current::reflection::FieldCounter<decayed_t>::value);
+    SerializeStructImpl<super_t>::SerializeStruct(writer, source);
+    current::reflection::VisitAllFields<decayed_t, current::reflection::FieldNameAndImmutableValue>::WithObject(
+        source, BinaryStructFieldsSerializer(writer));
+    writer.EndBlock(block);
+  }
+};
+
+template <>
+struct SerializeStructImpl<CurrentStruct> {
+  static void SerializeStruct(BinaryWriter&, const CurrentStruct&) {}
+};
+
+}  // namespace current::serialization::binary
+
+template <typename T>
+struct SerializeImpl<binary::BinaryWriter,
+                     T,
+                     std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same<T, CurrentStruct>::value>> {
+  static void DoSerialize(binary::BinaryWriter& writer, const T& value) {
+    binary::SerializeStructImpl<T>::SerializeStruct(writer, value);
+  }
+};
+
+template <class D>
+struct DeserializeImpl<binary::BinaryReader<D>, CurrentStruct> {
+  static void DoDeserialize(binary::BinaryReader<D>&, CurrentStruct&) {}
+};
+
+template <class D, typename T>
+struct DeserializeImpl<binary::BinaryReader<D>,
+                       T,
+                       std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same<T, CurrentStruct>::value>> {
+  // Only the first `fields_present` fields are in the input; the rest keep their default values.
+  class DeserializeSingleField {
+   public:
+    DeserializeSingleField(binary::BinaryReader<D>& reader, uint64_t fields_present)
+        : reader_(reader), fields_present_(fields_present) {}
+
+    template <typename U>
+    void operator()(const char*, U& value) const {
+      if (index_ < fields_present_) {
+        Deserialize(reader_, value);
+      }
+      ++index_;
+    }
+
+   private:
+    binary::BinaryReader<D>& reader_;
+    const uint64_t fields_present_;
+    mutable uint64_t index_ = 0u;
+  };
+
+  static void DoDeserialize(binary::BinaryReader<D>& reader, T& destination) {
+    using decayed_t = current::decay<T>;
+    using super_t = current::reflection::SuperType<decayed_t>;
+    constexpr uint64_t fields_expected = current::reflection::FieldCounter<decayed_t>::value;
+
+    const char* enclosing_end = reader.BeginBlock();
+    const uint64_t fields_present = reader.ReadVarint();
+    if (fields_present != fields_expected && !binary::BinarySkipsUnknownFields<D>::value) {
+      CURRENT_THROW(BinarySchemaException("Expected " + current::ToString(fields_expected) + " fields in `" +
+                                          reflection::CurrentTypeName<decayed_t>() + "`, got " +
+                                          current::ToString(fields_present) + '.'));
+    }
+    if (!std::is_same<super_t, CurrentStruct>::value) {
+      Deserialize(reader, static_cast<super_t&>(destination));
+    }
+    current::reflection::VisitAllFields<decayed_t, current::reflection::FieldNameAndMutableValue>::WithObject(
+        destination, DeserializeSingleField(reader, fields_present));
+    reader.EndBlock(enclosing_end);
+  }
+};
+
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_STRUCT_H
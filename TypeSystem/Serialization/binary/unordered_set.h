@@ -0,0 +1,61 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_UNORDERED_SET_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_UNORDERED_SET_H
+
+#include <unordered_set>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+template <typename T, class H, class E, class A>
+struct SerializeImpl<binary::BinaryWriter, std::unordered_set<T, H, E, A>> {
+  static void DoSerialize(binary::BinaryWriter& writer, const std::unordered_set<T, H, E, A>& value) {
+    writer.WriteVarint(value.size());
+    for (const auto& element : value) {
+      Serialize(writer, element);
+    }
+  }
+};
+
+template <class D, typename T, class H, class E, class A>
+struct DeserializeImpl<binary::BinaryReader<D>, std::unordered_set<T, H, E, A>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, std::unordered_set<T, H, E, A>& destination) {
+    const size_t size = reader.ReadCount();
+    destination.clear();
+    for (size_t i = 0u; i < size; ++i) {
+      T element;
+      Deserialize(reader, element);
+      destination.insert(std::move(element));
+    }
+  }
+};
+
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_UNORDERED_SET_H
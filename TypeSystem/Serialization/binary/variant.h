@@ -0,0 +1,147 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
+
+#include <type_traits>
+#include <unordered_map>
+
+#include "binary.h"
+
+#include "../../variant.h"
+#include "../../Reflection/reflection.h"
+
+#include "../../../Bricks/template/call_all_constructors.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+
+// Reflecting a type takes a lock, so do it once per type.
+template <typename X>
+reflection::TypeID BinaryVariantCaseTypeID() {
+  static const reflection::TypeID type_id =
+      Value<reflection::ReflectedTypeBase>(reflection::Reflector().ReflectType<X>()).type_id;
+  return type_id;
+}
+
+class BinaryVariantSerializer {
+ public:
+  explicit BinaryVariantSerializer(BinaryWriter& writer) : writer_(writer) {}
+
+  template <typename X>
+  void operator()(const X& object) {
+    writer_.WriteVarint(static_cast<uint64_t>(BinaryVariantCaseTypeID<X>()));
+    Serialize(writer_, object);
+  }
+
+ private:
+  BinaryWriter& writer_;
+};
+
+template <class D>
+struct BinaryVariantCases {
+  using deserializer_t = void (*)(BinaryReader<D>&, IHasUncheckedMoveFromUniquePtr&);
+  using deserializers_map_t =
+      std::unordered_map<reflection::TypeID, deserializer_t, CurrentHashFunction<::current::reflection::TypeID>>;
+
+  template <typename X>
+  static void DeserializeCase(BinaryReader<D>& reader, IHasUncheckedMoveFromUniquePtr& destination) {
+    auto result = std::make_unique<X>();
+    Deserialize(reader, *result);
+    destination.UncheckedMoveFromUniquePtr(std::move(result));
+  }
+
+  template <typename X>
+  struct Registerer {
+    Registerer(deserializers_map_t& deserializers) {
+      deserializers[BinaryVariantCaseTypeID<X>()] = &DeserializeCase<X>;
+    }
+  };
+};
+
+template <class D, typename VARIANT>
+class BinaryVariantDeserializer {
+ public:
+  template <typename X>
+  using Registerer = typename BinaryVariantCases<D>::template Registerer<X>;
+  using deserializers_map_t = typename BinaryVariantCases<D>::deserializers_map_t;
+
+  BinaryVariantDeserializer() {
+    current::metaprogramming::call_all_constructors_with<Registerer,
+                                                         deserializers_map_t,
+                                                         typename VARIANT::typelist_t>(deserializers_);
+  }
+
+  void DoLoadVariant(BinaryReader<D>& reader, VARIANT& destination) const {
+    const auto type_id = static_cast<reflection::TypeID>(reader.ReadVarint());
+    if (type_id == static_cast<reflection::TypeID>(0u)) {
+      CURRENT_THROW(BinaryUninitializedVariantObjectException());
+    }
+    const auto cit = deserializers_.find(type_id);
+    if (cit != deserializers_.end()) {
+      cit->second(reader, destination);
+    } else {
+      CURRENT_THROW(BinarySchemaException("A type id listed in the type list of `" +
+                                          std::string(reflection::CurrentTypeName<VARIANT>()) + "`, got T" +
+                                          current::ToString(static_cast<uint64_t>(type_id)) + '.'));
+    }
+  }
+
+  static const BinaryVariantDeserializer& Instance() {
+    static BinaryVariantDeserializer impl;
+    return impl;
+  }
+
+ private:
+  deserializers_map_t deserializers_;
+};
+
+}  // namespace current::serialization::binary
+
+template <typename T>
+struct SerializeImpl<binary::BinaryWriter, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
+  static void DoSerialize(binary::BinaryWriter& writer, const T& value) {
+    if (Exists(value)) {
+      binary::BinaryVariantSerializer impl(writer);
+      value.Call(impl);
+    } else {
+      writer.WriteVarint(0u);
+    }
+  }
+};
+
+template <class D, typename T>
+struct DeserializeImpl<binary::BinaryReader<D>, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
+  static void DoDeserialize(binary::BinaryReader<D>& reader, T& value) {
+    binary::BinaryVariantDeserializer<D, T>::Instance().DoLoadVariant(reader, value);
+  }
+};
+
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
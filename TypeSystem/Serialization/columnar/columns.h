@@ -0,0 +1,245 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The values of the fields of `CURRENT_STRUCT`-s, written into and read from the columns, in the order of the columns
+// of `ColumnarLayout<T>()`.
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_COLUMNS_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_COLUMNS_H
+
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "exceptions.h"
+
+#include "../../optional.h"
+#include "../../struct.h"
+#include "../../Reflection/reflection.h"
+
+#include "../../../Bricks/strings/chunk.h"
+#include "../../../Bricks/strings/util.h"
+
+namespace current {
+namespace serialization {
+namespace columnar {
+namespace impl {
+
+class ColumnarColumnBuilder final {
+ public:
+  template <typename T>
+  void AppendValue(const T& value) {
+    values_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  void AppendString(const std::string& value) {
+    const auto cit = codes_.find(value);
+    uint32_t code;
+    if (cit != codes_.end()) {
+      code = cit->second;
+    } else {
+      if (dictionary_.size() > static_cast<size_t>(std::numeric_limits<uint32_t>::max())) {
+        CURRENT_THROW(ColumnarSchemaException("Too many distinct strings in one column."));  // LCOV_EXCL_LINE
+      }
+      code = static_cast<uint32_t>(dictionary_.size());
+      dictionary_.push_back(&codes_.emplace(value, code).first->first);
+    }
+    AppendValue(code);
+  }
+
+  void AppendPresence(bool present) {
+    if (!(rows_ & 7u)) {
+      nulls_.push_back('\0');
+    }
+    if (present) {
+      nulls_.back() = static_cast<char>(nulls_.back() | (1 << (rows_ & 7u)));
+    }
+    ++rows_;
+  }
+
+  const std::string& Values() const { return values_; }
+  const std::string& Nulls() const { return nulls_; }
+  // The keys of `codes_` do not move as more strings are added, so `dictionary_` can point to them.
+  const std::vector<const std::string*>& Dictionary() const { return dictionary_; }
+
+ private:
+  std::string values_;
+  std::string nulls_;
+  uint64_t rows_ = 0u;
+  std::unordered_map<std::string, uint32_t> codes_;
+  std::vector<const std::string*> dictionary_;
+};
+
+struct ColumnarColumnData {
+  uint64_t rows = 0u;
+  const char* values = nullptr;
+  const uint8_t* nulls = nullptr;  // `nullptr` if the column is not nullable.
+  uint64_t dictionary_size = 0u;
+  const uint64_t* dictionary_offsets = nullptr;
+  const char* dictionary_blob = nullptr;
+
+  bool Exists(size_t row) const { return !nulls || ((nulls[row >> 3] >> (row & 7u)) & 1u); }
+
+  strings::Chunk DictionaryEntry(uint32_t code) const {
+    if (code >= dictionary_size) {
+      CURRENT_THROW(ColumnarFormatException("String code " + current::ToString(code) + " is out of the dictionary."));
+    }
+    return strings::Chunk(dictionary_blob + dictionary_offsets[code],
+                          static_cast<size_t>(dictionary_offsets[code + 1u] - dictionary_offsets[code] - 1u));
+  }
+};
+
+template <typename T>
+struct IsColumnarFixedWidth {
+  constexpr static bool value = std::is_arithmetic<T>::value || std::is_same<T, std::chrono::microseconds>::value ||
+                                std::is_same<T, std::chrono::milliseconds>::value;
+};
+
+// A single value: a primitive, an enum, or a string.
+template <typename T, typename ENABLE = void>
+struct ColumnarScalar {
+  constexpr static bool supported = false;
+};
+
+template <typename T>
+struct ColumnarScalar<T, std::enable_if_t<IsColumnarFixedWidth<T>::value>> {
+  constexpr static bool supported = true;
+  static void Append(ColumnarColumnBuilder& column, const T& value) { column.AppendValue(value); }
+  static void AppendNull(ColumnarColumnBuilder& column) { column.AppendValue(T()); }
+  static void Read(const ColumnarColumnData& column, size_t row, T& value) {
+    std::memcpy(&value, column.values + row * sizeof(T), sizeof(T));
+  }
+};
+
+template <typename T>
+struct ColumnarScalar<T, std::enable_if_t<std::is_enum<T>::value>> {
+  using underlying_t = typename std::underlying_type<T>::type;
+  constexpr static bool supported = true;
+  static void Append(ColumnarColumnBuilder& column, T value) { column.AppendValue(static_cast<underlying_t>(value)); }
+  static void AppendNull(ColumnarColumnBuilder& column) { column.AppendValue(underlying_t()); }
+  static void Read(const ColumnarColumnData& column, size_t row, T& value) {
+    underlying_t underlying;
+    ColumnarScalar<underlying_t>::Read(column, row, underlying);
+    value = static_cast<T>(underlying);
+  }
+};
+
+template <>
+struct ColumnarScalar<std::string> {
+  constexpr static bool supported = true;
+  static void Append(ColumnarColumnBuilder& column, const std::string& value) { column.AppendString(value); }
+  static void AppendNull(ColumnarColumnBuilder& column) { column.AppendValue(uint32_t(0u)); }
+  static void Read(const ColumnarColumnData& column, size_t row, std::string& value) {
+    uint32_t code;
+    ColumnarScalar<uint32_t>::Read(column, row, code);
+    const strings::Chunk chunk = column.DictionaryEntry(code);
+    value.assign(chunk.c_str(), chunk.length());
+  }
+};
+
+// A field: a scalar, an `Optional<>` of a scalar, or a `CURRENT_STRUCT`, the fields of which are flattened.
+// `column` points to the column of the field, and is advanced past the columns of the field.
+template <typename T, typename ENABLE = void>
+struct ColumnarField {
+  static_assert(ColumnarScalar<T>::supported,
+                "Only the primitives, the enums, the `Optional<>`-s of them, and the `CURRENT_STRUCT`-s of these "
+                "can be stored in columns.");
+  static void Write(ColumnarColumnBuilder*& column, const T& value) { ColumnarScalar<T>::Append(*column++, value); }
+  static void Read(const ColumnarColumnData*& column, size_t row, T& value) {
+    ColumnarScalar<T>::Read(*column++, row, value);
+  }
+};
+
+template <typename T>
+struct ColumnarField<Optional<T>> {
+  static_assert(ColumnarScalar<T>::supported,
+                "Only the `Optional<>`-s of the primitives and of the enums can be stored in columns.");
+  static void Write(ColumnarColumnBuilder*& column, const Optional<T>& value) {
+    column->AppendPresence(Exists(value));
+    if (Exists(value)) {
+      ColumnarScalar<T>::Append(*column++, Value(value));
+    } else {
+      ColumnarScalar<T>::AppendNull(*column++);
+    }
+  }
+  static void Read(const ColumnarColumnData*& column, size_t row, Optional<T>& value) {
+    if (column->Exists(row)) {
+      T inner;
+      ColumnarScalar<T>::Read(*column, row, inner);
+      value = std::move(inner);
+    } else {
+      value = nullptr;
+    }
+    ++column;
+  }
+};
+
+template <typename T>
+struct ColumnarField<T, std::enable_if_t<IS_CURRENT_STRUCT(T)>> {
+  using super_t = reflection::SuperType<T>;
+
+  struct FieldWriter {
+    ColumnarColumnBuilder*& column;
+    template <typename U>
+    void operator()(const char*, const U& value) const {
+      ColumnarField<U>::Write(column, value);
+    }
+  };
+
+  struct FieldReader {
+    const ColumnarColumnData*& column;
+    const size_t row;
+    template <typename U>
+    void operator()(const char*, U& value) const {
+      ColumnarField<U>::Read(column, row, value);
+    }
+  };
+
+  static void Write(ColumnarColumnBuilder*& column, const T& value) {
+    ColumnarField<super_t>::Write(column, value);
+    reflection::VisitAllFields<T, reflection::FieldNameAndImmutableValue>::WithObject(value, FieldWriter{column});
+  }
+
+  static void Read(const ColumnarColumnData*& column, size_t row, T& value) {
+    ColumnarField<super_t>::Read(column, row, value);
+    reflection::VisitAllFields<T, reflection::FieldNameAndMutableValue>::WithObject(value, FieldReader{column, row});
+  }
+};
+
+template <>
+struct ColumnarField<CurrentStruct> {
+  static void Write(ColumnarColumnBuilder*&, const CurrentStruct&) {}
+  static void Read(const ColumnarColumnData*&, size_t, CurrentStruct&) {}
+};
+
+}  // namespace current::serialization::columnar::impl
+}  // namespace current::serialization::columnar
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_COLUMNS_H
@@ -0,0 +1,141 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The columnar format of `std::vector<T>`, where `T` is a `CURRENT_STRUCT`. Each primitive field is one column.
+//
+// The columns are derived from the schema of `T`, as `reflection::StructSchema` sees it: the fields of the base
+// `CURRENT_STRUCT` first, then the own fields in the order of their declaration. The fields of the nested structs
+// are flattened into the columns named "outer.inner". The enums are stored as their underlying types.
+// `Optional<>` of a primitive or of an enum is a nullable column. The other types can not be stored in columns.
+//
+// The file is:
+// * The eight bytes of `kColumnarMagic`, and the length of the header as an eight-byte integer.
+// * The header, the JSON of `ColumnarHeader`, which also carries the schema of `T`.
+// * The data of the columns, with each section aligned to eight bytes, the offsets in the header counting
+//   from the beginning of the data:
+//   - The values, in the native byte order, one after another; the value of a null is zero.
+//   - For a nullable column, the bitmap of the rows that have a value, the lowest bit of the first byte first.
+//   - For a string column, the values are the `uint32_t` codes of the strings in the dictionary. The dictionary
+//     is `dictionary_size + 1` eight-byte offsets into the blob, followed by the blob of the strings,
+//     each followed by a zero byte. The strings are in the order of their first occurrence.
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_LAYOUT_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_LAYOUT_H
+
+#include <string>
+#include <vector>
+
+#include "exceptions.h"
+
+#include "../../struct.h"
+#include "../../Reflection/reflection.h"
+#include "../../Schema/schema.h"
+
+namespace current {
+namespace serialization {
+namespace columnar {
+
+constexpr char kColumnarMagic[] = "C5TCOL01";
+constexpr size_t kColumnarAlignment = 8u;
+
+CURRENT_STRUCT(ColumnarColumn) {
+  CURRENT_FIELD(name, std::string);
+  // The primitive type of the values; the underlying type for the enums.
+  CURRENT_FIELD(type_id, reflection::TypeID, reflection::TypeID::UninitializedType);
+  CURRENT_FIELD(nullable, bool, false);
+  CURRENT_FIELD(values_offset, uint64_t, 0u);
+  CURRENT_FIELD(nulls_offset, uint64_t, 0u);
+  CURRENT_FIELD(dictionary_size, uint64_t, 0u);
+  CURRENT_FIELD(dictionary_offset, uint64_t, 0u);
+
+  CURRENT_DEFAULT_CONSTRUCTOR(ColumnarColumn) {}
+  CURRENT_CONSTRUCTOR(ColumnarColumn)(const std::string& name, reflection::TypeID type_id, bool nullable)
+      : name(name), type_id(type_id), nullable(nullable) {}
+};
+
+CURRENT_STRUCT(ColumnarHeader) {
+  CURRENT_FIELD(type_id, reflection::TypeID, reflection::TypeID::UninitializedType);
+  CURRENT_FIELD(rows, uint64_t, 0u);
+  CURRENT_FIELD(columns, std::vector<ColumnarColumn>);
+  CURRENT_FIELD(schema, reflection::SchemaInfo);
+};
+
+namespace impl {
+
+inline void AppendColumnarColumns(const reflection::SchemaInfo& schema,
+                                  reflection::TypeID type_id,
+                                  const std::string& name,
+                                  bool nullable,
+                                  std::vector<ColumnarColumn>& columns) {
+  const auto cit = schema.types.find(type_id);
+  if (cit == schema.types.end()) {
+    CURRENT_THROW(ColumnarSchemaException("The type of `" + name + "` is not in the schema."));  // LCOV_EXCL_LINE
+  }
+  const reflection::ReflectedType& type = cit->second;
+  if (Exists<reflection::ReflectedType_Primitive>(type)) {
+    columns.emplace_back(name, type_id, nullable);
+  } else if (Exists<reflection::ReflectedType_Enum>(type)) {
+    columns.emplace_back(name, Value<reflection::ReflectedType_Enum>(type).underlying_type, nullable);
+  } else if (Exists<reflection::ReflectedType_Optional>(type) && !nullable) {
+    AppendColumnarColumns(schema, Value<reflection::ReflectedType_Optional>(type).optional_type, name, true, columns);
+  } else if (Exists<reflection::ReflectedType_Struct>(type) && !nullable) {
+    const reflection::ReflectedType_Struct& s = Value<reflection::ReflectedType_Struct>(type);
+    if (Exists(s.super_id)) {
+      AppendColumnarColumns(schema, Value(s.super_id), name, false, columns);
+    }
+    for (const reflection::ReflectedType_Struct_Field& field : s.fields) {
+      AppendColumnarColumns(schema, field.type_id, name.empty() ? field.name : name + '.' + field.name, false, columns);
+    }
+  } else {
+    CURRENT_THROW(ColumnarSchemaException("The field `" + name + "` can not be stored in columns."));
+  }
+}
+
+}  // namespace current::serialization::columnar::impl
+
+// The columns of the struct `type_id` described by `schema`, with their offsets not filled in.
+inline std::vector<ColumnarColumn> ColumnarLayout(const reflection::SchemaInfo& schema, reflection::TypeID type_id) {
+  std::vector<ColumnarColumn> columns;
+  impl::AppendColumnarColumns(schema, type_id, "", false, columns);
+  return columns;
+}
+
+template <typename T>
+inline reflection::SchemaInfo ColumnarSchema() {
+  static_assert(IS_CURRENT_STRUCT(T), "Only the `CURRENT_STRUCT`-s can be stored in columns.");
+  reflection::StructSchema struct_schema;
+  struct_schema.AddType<T>();
+  return struct_schema.GetSchemaInfo();
+}
+
+template <typename T>
+inline std::vector<ColumnarColumn> ColumnarLayout() {
+  return ColumnarLayout(ColumnarSchema<T>(), reflection::CurrentTypeID<T>());
+}
+
+}  // namespace current::serialization::columnar
+}  // namespace current::serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_LAYOUT_H
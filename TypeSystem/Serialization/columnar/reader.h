@@ -0,0 +1,271 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The read access to the columnar data, in memory or in a memory-mapped file. The columns are not copied:
+// `Column<U>(name)` returns the view into the data, and `Parse<T>()` puts the rows back together.
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_READER_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_READER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "columns.h"
+#include "exceptions.h"
+#include "layout.h"
+
+#include "../json.h"
+
+#include "../../../Bricks/file/mmap.h"
+
+namespace current {
+namespace serialization {
+namespace columnar {
+
+namespace impl {
+
+template <typename U, bool IS_ENUM = std::is_enum<U>::value>
+struct ColumnarStoredType {
+  using type = U;
+};
+
+template <typename U>
+struct ColumnarStoredType<U, true> {
+  using type = typename std::underlying_type<U>::type;
+};
+
+// The size of one value in the column of the primitive `type_id`, or zero if it is not a primitive.
+inline size_t ColumnarValueSize(reflection::TypeID type_id) {
+  if (type_id == reflection::CurrentTypeID<std::string>()) {
+    return sizeof(uint32_t);
+  }
+#define CURRENT_DECLARE_PRIMITIVE_TYPE(typeid_index, cpp_type, current_type, fs_type, md_type, typescript_type) \
+  if (type_id == reflection::CurrentTypeID<cpp_type>()) {                                                      \
+    return sizeof(cpp_type);                                                                                    \
+  }
+#include "../../primitive_types.dsl.h"
+#undef CURRENT_DECLARE_PRIMITIVE_TYPE
+  return 0u;
+}
+
+}  // namespace current::serialization::columnar::impl
+
+// The values of one column, `U` being the type of the field, or the type of the value of the `Optional<>` field.
+// The value of a null is `U()`.
+template <typename U>
+class ColumnarColumnView final {
+ public:
+  explicit ColumnarColumnView(const impl::ColumnarColumnData& data) : data_(data) {}
+
+  size_t Size() const { return static_cast<size_t>(data_.rows); }
+  bool Exists(size_t row) const { return data_.Exists(row); }
+  const U* Data() const { return reinterpret_cast<const U*>(data_.values); }
+  U operator[](size_t row) const { return Data()[row]; }
+
+ private:
+  const impl::ColumnarColumnData data_;
+};
+
+// The values of a string column are the codes of the strings in the dictionary of the column.
+template <>
+class ColumnarColumnView<std::string> final {
+ public:
+  explicit ColumnarColumnView(const impl::ColumnarColumnData& data) : data_(data) {}
+
+  size_t Size() const { return static_cast<size_t>(data_.rows); }
+  bool Exists(size_t row) const { return data_.Exists(row); }
+  const uint32_t* Codes() const { return reinterpret_cast<const uint32_t*>(data_.values); }
+  size_t DictionarySize() const { return static_cast<size_t>(data_.dictionary_size); }
+  strings::Chunk Dictionary(uint32_t code) const { return data_.DictionaryEntry(code); }
+  strings::Chunk operator[](size_t row) const { return Exists(row) ? Dictionary(Codes()[row]) : strings::Chunk(); }
+
+ private:
+  const impl::ColumnarColumnData data_;
+};
+
+// The columnar data in `[begin, end)`, which must be aligned to eight bytes and outlive the view.
+class ColumnarView {
+ public:
+  ColumnarView(const char* begin, const char* end) {
+    const uint64_t size = static_cast<uint64_t>(end - begin);
+    uint64_t header_length;
+    if (size < 2u * kColumnarAlignment || std::memcmp(begin, kColumnarMagic, kColumnarAlignment)) {
+      CURRENT_THROW(ColumnarFormatException("Not the columnar data."));
+    }
+    if (reinterpret_cast<uintptr_t>(begin) % kColumnarAlignment) {
+      CURRENT_THROW(ColumnarFormatException("The columnar data is not aligned."));
+    }
+    std::memcpy(&header_length, begin + kColumnarAlignment, sizeof(header_length));
+    if (header_length > size - 2u * kColumnarAlignment) {
+      CURRENT_THROW(ColumnarFormatException("The columnar header is truncated."));
+    }
+    try {
+      ParseJSON(begin + 2u * kColumnarAlignment, static_cast<size_t>(header_length), header_);
+    } catch (const TypeSystemParseJSONException&) {
+      CURRENT_THROW(ColumnarFormatException("The columnar header is malformed."));
+    }
+    const uint64_t data_offset =
+        (2u * kColumnarAlignment + header_length + kColumnarAlignment - 1u) / kColumnarAlignment * kColumnarAlignment;
+    data_ = begin + std::min(data_offset, size);
+    data_size_ = size - std::min(data_offset, size);
+    for (const ColumnarColumn& column : header_.columns) {
+      columns_.push_back(ColumnData(column));
+    }
+  }
+
+  const ColumnarHeader& Header() const { return header_; }
+  size_t Rows() const { return static_cast<size_t>(header_.rows); }
+  const std::vector<ColumnarColumn>& Columns() const { return header_.columns; }
+
+  template <typename U>
+  ColumnarColumnView<U> Column(const std::string& name) const {
+    using stored_t = typename impl::ColumnarStoredType<U>::type;
+    for (size_t i = 0u; i < header_.columns.size(); ++i) {
+      if (header_.columns[i].name == name) {
+        if (header_.columns[i].type_id != reflection::CurrentTypeID<stored_t>()) {
+          CURRENT_THROW(ColumnarSchemaException("The column `" + name + "` is not of type `" +
+                                                reflection::CurrentTypeName<U>() + "`."));
+        }
+        return ColumnarColumnView<U>(columns_[i]);
+      }
+    }
+    CURRENT_THROW(ColumnarSchemaException("No column `" + name + "`."));
+  }
+
+  template <typename T>
+  void Parse(std::vector<T>& rows) const {
+    const std::vector<ColumnarColumn> expected = ColumnarLayout<T>();
+    bool match = (expected.size() == header_.columns.size());
+    for (size_t i = 0u; match && i < expected.size(); ++i) {
+      const ColumnarColumn& actual = header_.columns[i];
+      match = (expected[i].name == actual.name && expected[i].type_id == actual.type_id &&
+               expected[i].nullable == actual.nullable);
+    }
+    if (!match) {
+      CURRENT_THROW(ColumnarSchemaException("The columns of `" + std::string(reflection::CurrentTypeName<T>()) +
+                                            "` do not match the columns of the data."));
+    }
+    rows.resize(Rows());
+    for (size_t row = 0u; row < rows.size(); ++row) {
+      const impl::ColumnarColumnData* column = columns_.data();
+      impl::ColumnarField<T>::Read(column, row, rows[row]);
+    }
+  }
+
+  template <typename T>
+  std::vector<T> Parse() const {
+    std::vector<T> rows;
+    Parse(rows);
+    return rows;
+  }
+
+ private:
+  // Makes sure the sections of the column are within the data, and that the dictionary is well-formed.
+  impl::ColumnarColumnData ColumnData(const ColumnarColumn& column) const {
+    impl::ColumnarColumnData result;
+    result.rows = header_.rows;
+    const uint64_t value_size = impl::ColumnarValueSize(column.type_id);
+    if (!value_size) {
+      CURRENT_THROW(ColumnarFormatException("The column `" + column.name + "` is not of a primitive type."));
+    }
+    if (header_.rows > data_size_ / value_size) {
+      CURRENT_THROW(ColumnarFormatException("The column `" + column.name + "` is truncated."));
+    }
+    result.values = Section(column, column.values_offset, header_.rows * value_size);
+    if (column.nullable) {
+      result.nulls = reinterpret_cast<const uint8_t*>(Section(column, column.nulls_offset, (header_.rows + 7u) / 8u));
+    }
+    if (column.type_id == reflection::CurrentTypeID<std::string>()) {
+      if (column.dictionary_size >= data_size_ / sizeof(uint64_t)) {
+        CURRENT_THROW(ColumnarFormatException("The column `" + column.name + "` is truncated."));
+      }
+      const uint64_t offsets_length = (column.dictionary_size + 1u) * sizeof(uint64_t);
+      const char* dictionary = Section(column, column.dictionary_offset, offsets_length);
+      result.dictionary_size = column.dictionary_size;
+      result.dictionary_offsets = reinterpret_cast<const uint64_t*>(dictionary);
+      result.dictionary_blob = dictionary + offsets_length;
+      Section(column, column.dictionary_offset + offsets_length, result.dictionary_offsets[column.dictionary_size]);
+      for (uint64_t i = 0u; i < column.dictionary_size; ++i) {
+        const uint64_t begin = result.dictionary_offsets[i];
+        const uint64_t end = result.dictionary_offsets[i + 1u];
+        if (!(begin < end && end <= result.dictionary_offsets[column.dictionary_size] &&
+              result.dictionary_blob[end - 1u] == '\0')) {
+          CURRENT_THROW(ColumnarFormatException("The dictionary of the column `" + column.name + "` is malformed."));
+        }
+      }
+    }
+    return result;
+  }
+
+  const char* Section(const ColumnarColumn& column, uint64_t offset, uint64_t length) const {
+    if (offset % kColumnarAlignment || offset > data_size_ || length > data_size_ - offset) {
+      CURRENT_THROW(ColumnarFormatException("The column `" + column.name + "` is truncated."));
+    }
+    return data_ + offset;
+  }
+
+  ColumnarHeader header_;
+  const char* data_;
+  uint64_t data_size_;
+  std::vector<impl::ColumnarColumnData> columns_;
+};
+
+namespace impl {
+// The base class of `ColumnarFile`, for the file to be mapped before `ColumnarView` is constructed.
+struct ColumnarMappedFile {
+  const MemoryMappedFile mapped_file;
+  explicit ColumnarMappedFile(const std::string& file_name) : mapped_file(file_name) {}
+};
+}  // namespace current::serialization::columnar::impl
+
+// The memory-mapped columnar file.
+class ColumnarFile final : private impl::ColumnarMappedFile, public ColumnarView {
+ public:
+  explicit ColumnarFile(const std::string& file_name)
+      : impl::ColumnarMappedFile(file_name),
+        ColumnarView(mapped_file.Data(), mapped_file.Data() + mapped_file.Size()) {}
+};
+
+template <typename T>
+inline std::vector<T> ParseColumnar(const std::string& source) {
+  return ColumnarView(source.data(), source.data() + source.length()).template Parse<T>();
+}
+
+}  // namespace current::serialization::columnar
+}  // namespace current::serialization
+
+using serialization::columnar::ColumnarColumnView;
+using serialization::columnar::ColumnarView;
+using serialization::columnar::ColumnarFile;
+using serialization::columnar::ParseColumnar;
+}  // namespace current
+
+using current::ColumnarView;
+using current::ColumnarFile;
+using current::ParseColumnar;
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_READER_H
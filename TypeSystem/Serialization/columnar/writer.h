@@ -0,0 +1,139 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_WRITER_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_WRITER_H
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "columns.h"
+#include "exceptions.h"
+#include "layout.h"
+
+#include "../json.h"
+
+namespace current {
+namespace serialization {
+namespace columnar {
+
+namespace impl {
+
+inline uint64_t ColumnarAligned(uint64_t length) {
+  return (length + kColumnarAlignment - 1u) / kColumnarAlignment * kColumnarAlignment;
+}
+
+inline void WriteColumnarSection(std::ostream& os, const char* data, uint64_t length) {
+  static const char zeros[kColumnarAlignment] = {0};
+  os.write(data, static_cast<std::streamsize>(length));
+  os.write(zeros, static_cast<std::streamsize>(ColumnarAligned(length) - length));
+}
+
+}  // namespace current::serialization::columnar::impl
+
+template <typename T>
+inline void SaveIntoColumnar(std::ostream& os, const std::vector<T>& rows) {
+  ColumnarHeader header;
+  header.type_id = reflection::CurrentTypeID<T>();
+  header.rows = rows.size();
+  header.schema = ColumnarSchema<T>();
+  header.columns = ColumnarLayout(header.schema, header.type_id);
+
+  std::vector<impl::ColumnarColumnBuilder> builders(header.columns.size());
+  for (const T& row : rows) {
+    impl::ColumnarColumnBuilder* column = builders.data();
+    impl::ColumnarField<T>::Write(column, row);
+    CURRENT_ASSERT(column == builders.data() + builders.size());
+  }
+
+  // The dictionary of each string column is its offsets, followed by the zero-terminated strings.
+  const reflection::TypeID string_type_id = reflection::CurrentTypeID<std::string>();
+  std::vector<std::string> dictionaries(header.columns.size());
+  uint64_t offset = 0u;
+  for (size_t i = 0u; i < header.columns.size(); ++i) {
+    ColumnarColumn& column = header.columns[i];
+    const impl::ColumnarColumnBuilder& builder = builders[i];
+    column.values_offset = offset;
+    offset += impl::ColumnarAligned(builder.Values().length());
+    if (column.nullable) {
+      column.nulls_offset = offset;
+      offset += impl::ColumnarAligned(builder.Nulls().length());
+    }
+    if (column.type_id == string_type_id) {
+      std::string& dictionary = dictionaries[i];
+      std::vector<uint64_t> offsets;
+      offsets.reserve(builder.Dictionary().size() + 1u);
+      std::string blob;
+      for (const std::string* value : builder.Dictionary()) {
+        offsets.push_back(blob.length());
+        blob.append(*value);
+        blob += '\0';
+      }
+      offsets.push_back(blob.length());
+      dictionary.assign(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+      dictionary.append(blob);
+      column.dictionary_size = builder.Dictionary().size();
+      column.dictionary_offset = offset;
+      offset += impl::ColumnarAligned(dictionary.length());
+    }
+  }
+
+  const std::string json = JSON(header);
+  const uint64_t json_length = json.length();
+  os.write(kColumnarMagic, static_cast<std::streamsize>(kColumnarAlignment));
+  os.write(reinterpret_cast<const char*>(&json_length), sizeof(json_length));
+  impl::WriteColumnarSection(os, json.data(), json_length);
+  for (size_t i = 0u; i < header.columns.size(); ++i) {
+    const impl::ColumnarColumnBuilder& builder = builders[i];
+    impl::WriteColumnarSection(os, builder.Values().data(), builder.Values().length());
+    if (header.columns[i].nullable) {
+      impl::WriteColumnarSection(os, builder.Nulls().data(), builder.Nulls().length());
+    }
+    impl::WriteColumnarSection(os, dictionaries[i].data(), dictionaries[i].length());
+  }
+  if (!os) {
+    CURRENT_THROW(ColumnarException("Failed to write into the stream."));  // LCOV_EXCL_LINE
+  }
+}
+
+template <typename T>
+inline std::string Columnar(const std::vector<T>& rows) {
+  std::ostringstream os;
+  SaveIntoColumnar(os, rows);
+  return os.str();
+}
+
+}  // namespace current::serialization::columnar
+}  // namespace current::serialization
+
+using serialization::columnar::Columnar;
+using serialization::columnar::SaveIntoColumnar;
+}  // namespace current
+
+using current::Columnar;
+using current::SaveIntoColumnar;
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_COLUMNAR_WRITER_H
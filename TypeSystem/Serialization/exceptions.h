@@ -26,6 +26,8 @@ SOFTWARE.
 #define TYPE_SYSTEM_SERIALIZATION_EXCEPTIONS_H
 
 #include "exceptions_base.h"
+#include "binary/exceptions.h"
+#include "columnar/exceptions.h"
 #include "json/exceptions.h"
 
 #endif  // TYPE_SYSTEM_SERIALIZATION_EXCEPTIONS_H
@@ -29,10 +29,12 @@ SOFTWARE.
 #include "serialization.h"
 
 #include "json/enum.h"
+#include "json/lines.h"
 #include "json/map.h"
 #include "json/optional.h"
 #include "json/pair.h"
 #include "json/primitives.h"
+#include "json/projection.h"
 #include "json/set.h"
 #include "json/struct.h"
 #include "json/typeid.h"
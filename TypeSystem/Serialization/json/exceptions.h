@@ -41,35 +41,7 @@ struct JSONSchemaException : TypeSystemParseJSONException {
   JSONSchemaException(const std::string& expected, JSON_PARSER& parser)
       : TypeSystemParseJSONException("Expected " +
                                      (expected + (parser.PathIsEmpty() ? "" : " for `" + parser.Path() + "`") +
-                                      ", got: " + NonThrowingFormatRapidJSONValueAsString(parser.CurrentAsPtr()))) {}
-  // Attempt to generate a human-readable description of the part of the JSON,
-  // that has been parsed but is of wrong schema.
-  static std::string NonThrowingFormatRapidJSONValueAsString(rapidjson::Value* value) {
-    if (value) {
-      try {
-        rapidjson::StringBuffer string_buffer;
-        rapidjson::Writer<rapidjson::StringBuffer> writer(string_buffer);
-        rapidjson::Document document;
-        if (value->IsObject() || value->IsArray()) {
-          // Objects and arrays can be dumped directly.
-          value->Accept(writer);
-          return string_buffer.GetString();
-        } else {
-          // Every other type of value has to be wrapped into an object or an array.
-          // Hack to extract the actual value: wrap into an array and peel off the '[' and ']'. -- D.K.
-          document.SetArray();
-          document.PushBack(*value, document.GetAllocator());
-          document.Accept(writer);
-          const std::string result = string_buffer.GetString();
-          return result.substr(1u, result.length() - 2u);
-        }
-      } catch (const std::exception&) {     // LCOV_EXCL_LINE
-        return "field can not be parsed.";  // LCOV_EXCL_LINE
-      }
-    } else {
-      return "missing field.";
-    }
-  }
+                                      ", got: " + parser.NonThrowingFormatCurrentValueAsString())) {}
 };
 
 }  // namespace current::serialization::json
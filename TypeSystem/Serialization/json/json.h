@@ -26,6 +26,11 @@ SOFTWARE.
 #ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_JSON_H
 #define CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_JSON_H
 
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
 #include "exceptions.h"
 #include "rapidjson.h"
 
@@ -119,64 +124,89 @@ struct IsJSONSerializableImpl<false, false, false, T> {
   constexpr static bool value = false;
 };
 
-// For RapidJSON value assignments, specifically strings (use `SetString`, not `SetValue`) and `std::chrono::*`.
+// The RapidJSON output stream appending to a caller-owned `std::string`.
+class JSONStringOutputStream final {
+ public:
+  using Ch = char;
+  explicit JSONStringOutputStream(std::string& output) : output_(output) {}
+  void Put(char c) { output_.push_back(c); }
+  void Flush() {}
+
+ private:
+  std::string& output_;
+};
+
+// The writer keeps its stack of the open arrays and objects in the buffer within `JSONStringifier`,
+// so that, unless the nesting is unusually deep, serializing into a reused string does not touch the heap.
+using JSONWriterStackAllocator = rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>;
+using JSONWriter =
+    rapidjson::Writer<JSONStringOutputStream, rapidjson::UTF8<>, rapidjson::UTF8<>, JSONWriterStackAllocator>;
+
+// Emit the numbers the way `rapidjson::Value` would have stored them, to keep the output the same as it was
+// when the JSON was built as a DOM first: `char` and the shorter integers are promoted to `int`, `float` to `double`.
+inline void WriteJSONValue(JSONWriter& writer, bool value) { writer.Bool(value); }
+inline void WriteJSONValue(JSONWriter& writer, int value) { writer.Int(value); }
+inline void WriteJSONValue(JSONWriter& writer, unsigned value) { writer.Uint(value); }
+inline void WriteJSONValue(JSONWriter& writer, int64_t value) { writer.Int64(value); }
+inline void WriteJSONValue(JSONWriter& writer, uint64_t value) { writer.Uint64(value); }
+inline void WriteJSONValue(JSONWriter& writer, double value) { writer.Double(value); }
+
+// Specialized for strings and `std::chrono::*`.
 template <typename T>
 struct JSONValueAssignerImpl {
-  static void AssignValue(rapidjson::Value& destination, current::copy_free<T> value) { destination = value; }
+  static void AssignValue(JSONWriter& writer, current::copy_free<T> value) { WriteJSONValue(writer, value); }
 };
 
+// Writes the JSON straight into the output string, appending to it, with no intermediate DOM.
 template <class JSON_FORMAT>
 class JSONStringifier final {
  public:
-  JSONStringifier() {
-    // Can't assign in the initializer list, `current_` is the field before `document_`.
-    // And I've confirmed keeping `document_` first results in performance degradation. -- D.K.
-    current_ = &document_;
+  explicit JSONStringifier(std::string& output)
+      : stack_allocator_(stack_buffer_, sizeof(stack_buffer_)), stream_(output), writer_(stream_, &stack_allocator_) {}
+
+  JSONStringifier(const JSONStringifier&) = delete;
+  JSONStringifier& operator=(const JSONStringifier&) = delete;
+
+  // The writer to emit the next value with. If this value is the value of a struct field,
+  // the key is emitted first, as only now it is known the value is not absent.
+  JSONWriter& Writer() {
+    if (pending_key_) {
+      writer_.Key(pending_key_);
+      pending_key_ = nullptr;
+    }
+    return writer_;
   }
 
-  rapidjson::Value& Current() { return *current_; }
-  rapidjson::Document::AllocatorType& Allocator() { return document_.GetAllocator(); }
-
   template <typename T>
   void operator=(T&& x) {
-    JSONValueAssignerImpl<current::decay<T>>::AssignValue(*current_, std::forward<T>(x));
+    JSONValueAssignerImpl<current::decay<T>>::AssignValue(Writer(), std::forward<T>(x));
   }
 
-  // Serialize another object, in an inner scope. The object is guaranteed to result in a valid value.
+  // Serialize the value of a struct field. The value may end up a no-op, in which case the key is omitted too.
+  // Example: A `Variant` or `Optional` in the `Minimalistic` format.
   template <typename T>
-  void Inner(rapidjson::Value* inner_value, T&& x) {
-    std::swap(current_, inner_value);
+  void Field(const char* name, T&& x) {
+    pending_key_ = name;
     Serialize(*this, std::forward<T>(x));
-    std::swap(current_, inner_value);
+    pending_key_ = nullptr;
   }
 
-  // Serialize another object, in an inner scope. The object may end up a no-op, which should be ignored.
-  // Example: A `Variant` or `Optional` in the `Minimalistic` format.
-  void MarkAsAbsentValue() { current_ = nullptr; }
-  template <typename T>
-  bool MaybeInner(rapidjson::Value* inner_value, T&& x) {
-    rapidjson::Value* previous = current_;
-    current_ = inner_value;
-    Serialize(*this, std::forward<T>(x));
-    if (current_) {
-      current_ = previous;
-      return true;
+  // The absent value of a struct field is omitted altogether, while elsewhere it is a `null`.
+  void MarkAsAbsentValue() {
+    if (pending_key_) {
+      pending_key_ = nullptr;
     } else {
-      current_ = previous;
-      return false;
+      writer_.Null();
     }
   }
 
-  std::string ResultingJSON() const {
-    rapidjson::StringBuffer string_buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(string_buffer);
-    document_.Accept(writer);
-    return string_buffer.GetString();
-  }
-
  private:
-  rapidjson::Value* current_;
-  rapidjson::Document document_;
+  // Room for the initial stack of the writer, of `rapidjson::Writer<>::kDefaultLevelDepth` levels, and the header.
+  alignas(8) char stack_buffer_[1024];
+  JSONWriterStackAllocator stack_allocator_;
+  JSONStringOutputStream stream_;
+  JSONWriter writer_;
+  const char* pending_key_ = nullptr;
 };
 
 enum class JSONVariantStyle : int { Current, Simple, NewtonsoftFSharp };
@@ -238,29 +268,416 @@ struct JSONPatchMode<JSONPatcher<J>> {
   constexpr static bool value = true;
 };
 
+// The input JSON is parsed in a single pass of the SAX `rapidjson::Reader` over its own in-situ copy, into a "tape":
+// the flat array of all the values in document order, where each array or object is followed by its contents,
+// and each member of an object is the key followed by the value. No DOM is built, and no string is copied.
+struct JSONTapeEntry {
+  rapidjson::Value value;  // The scalar or the key as is; the array or the object as an empty one of the same type.
+  size_t size;             // The number of elements of the array, or of the members of the object.
+  size_t end;              // The index on the tape right past this value, including its contents.
+};
+
+class JSONTapeBuilder final {
+ public:
+  explicit JSONTapeBuilder(std::vector<JSONTapeEntry>& tape) : tape_(tape) {}
+
+  bool Null() {
+    Push();
+    return true;
+  }
+  bool Bool(bool b) {
+    Push().SetBool(b);
+    return true;
+  }
+  bool Int(int i) {
+    Push().SetInt(i);
+    return true;
+  }
+  bool Uint(unsigned u) {
+    Push().SetUint(u);
+    return true;
+  }
+  bool Int64(int64_t i) {
+    Push().SetInt64(i);
+    return true;
+  }
+  bool Uint64(uint64_t u) {
+    Push().SetUint64(u);
+    return true;
+  }
+  bool Double(double d) {
+    Push().SetDouble(d);
+    return true;
+  }
+  // Only in-situ parsing is used, so the strings can always be referred to, not copied.
+  bool String(const char* s, rapidjson::SizeType length, bool) {
+    Push().SetString(rapidjson::StringRef(s, length));
+    return true;
+  }
+  bool RawNumber(const char* s, rapidjson::SizeType length, bool copy) { return String(s, length, copy); }
+  bool Key(const char* s, rapidjson::SizeType length, bool copy) { return String(s, length, copy); }
+  bool StartObject() {
+    open_.push_back(tape_.size());
+    Push().SetObject();
+    return true;
+  }
+  bool EndObject(rapidjson::SizeType members) {
+    Close(members);
+    return true;
+  }
+  bool StartArray() {
+    open_.push_back(tape_.size());
+    Push().SetArray();
+    return true;
+  }
+  bool EndArray(rapidjson::SizeType elements) {
+    Close(elements);
+    return true;
+  }
+
+ private:
+  rapidjson::Value& Push() {
+    tape_.emplace_back();
+    JSONTapeEntry& entry = tape_.back();
+    entry.size = 0u;
+    entry.end = tape_.size();
+    return entry.value;
+  }
+
+  void Close(size_t size) {
+    JSONTapeEntry& entry = tape_[open_.back()];
+    open_.pop_back();
+    entry.size = size;
+    entry.end = tape_.size();
+  }
+
+  std::vector<JSONTapeEntry>& tape_;
+  std::vector<size_t> open_;
+};
+
+// The fields to parse, as the set of dot-separated paths of the keys, e.g. `{"codename", "last_status.timestamp"}`.
+// Each path selects the value under it as a whole. The paths go through the arrays as if they were not there,
+// i.e. `"events.timestamp"` selects the `timestamp` of each element of the array `events`.
+class JSONFieldsProjection final {
+ public:
+  // The node of the value to keep in full, or of the value to skip, in place of the index of the node in `nodes_`.
+  enum : size_t { kWhole = static_cast<size_t>(-1), kSkip = static_cast<size_t>(-2) };
+
+  JSONFieldsProjection() : nodes_(1u) {}
+  JSONFieldsProjection(std::initializer_list<std::string> paths) : JSONFieldsProjection() {
+    for (const std::string& path : paths) {
+      Add(path);
+    }
+  }
+
+  // The empty path selects the whole input.
+  JSONFieldsProjection& Add(const std::string& path) {
+    size_t node = 0u;
+    size_t begin = 0u;
+    while (!nodes_[node].whole && begin < path.length()) {
+      size_t end = path.find('.', begin);
+      if (end == std::string::npos) {
+        end = path.length();
+      }
+      node = AddChild(node, path.substr(begin, end - begin));
+      begin = end + 1u;
+    }
+    nodes_[node].whole = true;
+    nodes_[node].children.clear();
+    return *this;
+  }
+
+  // The node of the top-level value.
+  size_t Root() const { return nodes_[0].whole ? static_cast<size_t>(kWhole) : 0u; }
+
+  // The node of the value under `key` of the object at `node`.
+  size_t Child(size_t node, const char* key, size_t length) const {
+    for (size_t child : nodes_[node].children) {
+      const std::string& name = nodes_[child].key;
+      if (name.length() == length && !std::memcmp(name.data(), key, length)) {
+        return nodes_[child].whole ? static_cast<size_t>(kWhole) : child;
+      }
+    }
+    return kSkip;
+  }
+
+ private:
+  struct Node {
+    std::string key;
+    std::vector<size_t> children;
+    bool whole = false;
+  };
+
+  size_t AddChild(size_t node, const std::string& key) {
+    for (size_t child : nodes_[node].children) {
+      if (nodes_[child].key == key) {
+        return child;
+      }
+    }
+    const size_t child = nodes_.size();
+    nodes_.emplace_back();
+    nodes_.back().key = key;
+    nodes_[node].children.push_back(child);
+    return child;
+  }
+
+  std::vector<Node> nodes_;
+};
+
+// Builds the tape of only the values selected by the `JSONFieldsProjection`. The rest of the input is still
+// validated, yet the values not selected do not make it to the tape, so skipping them does not allocate.
+// The empty key, the type ID of a `Variant` in the `Current` format, is always kept, for the paths through `Variant`-s
+// to work, as in `"payload.Event.timestamp"`.
+class JSONProjectedTapeBuilder final {
+ public:
+  JSONProjectedTapeBuilder(std::vector<JSONTapeEntry>& tape, const JSONFieldsProjection& projection)
+      : tape_(tape), projection_(projection) {}
+
+  bool Null() {
+    Push();
+    return true;
+  }
+  bool Bool(bool b) {
+    if (rapidjson::Value* value = Push()) {
+      value->SetBool(b);
+    }
+    return true;
+  }
+  bool Int(int i) {
+    if (rapidjson::Value* value = Push()) {
+      value->SetInt(i);
+    }
+    return true;
+  }
+  bool Uint(unsigned u) {
+    if (rapidjson::Value* value = Push()) {
+      value->SetUint(u);
+    }
+    return true;
+  }
+  bool Int64(int64_t i) {
+    if (rapidjson::Value* value = Push()) {
+      value->SetInt64(i);
+    }
+    return true;
+  }
+  bool Uint64(uint64_t u) {
+    if (rapidjson::Value* value = Push()) {
+      value->SetUint64(u);
+    }
+    return true;
+  }
+  bool Double(double d) {
+    if (rapidjson::Value* value = Push()) {
+      value->SetDouble(d);
+    }
+    return true;
+  }
+  bool String(const char* s, rapidjson::SizeType length, bool) {
+    if (rapidjson::Value* value = Push()) {
+      value->SetString(rapidjson::StringRef(s, length));
+    }
+    return true;
+  }
+  bool RawNumber(const char* s, rapidjson::SizeType length, bool copy) { return String(s, length, copy); }
+  bool Key(const char* s, rapidjson::SizeType length, bool) {
+    if (!skipped_depth_) {
+      const Frame& object = open_.back();
+      next_node_ = (object.node == JSONFieldsProjection::kWhole || !length)
+                       ? static_cast<size_t>(JSONFieldsProjection::kWhole)
+                       : projection_.Child(object.node, s, length);
+      if (next_node_ != JSONFieldsProjection::kSkip) {
+        tape_.emplace_back();
+        JSONTapeEntry& entry = tape_.back();
+        entry.value.SetString(rapidjson::StringRef(s, length));
+        entry.size = 0u;
+        entry.end = tape_.size();
+      }
+    }
+    return true;
+  }
+  bool StartObject() {
+    Open(true);
+    return true;
+  }
+  bool EndObject(rapidjson::SizeType) {
+    Close();
+    return true;
+  }
+  bool StartArray() {
+    Open(false);
+    return true;
+  }
+  bool EndArray(rapidjson::SizeType) {
+    Close();
+    return true;
+  }
+
+ private:
+  struct Frame {
+    size_t index;  // On the tape.
+    size_t node;   // Of the projection, for the members of the object, or for the elements of the array.
+    size_t kept;
+    bool is_object;
+  };
+
+  // The node of the value the next event starts.
+  size_t NextNode() const {
+    if (open_.empty()) {
+      return projection_.Root();
+    } else if (open_.back().is_object) {
+      return next_node_;
+    } else {
+      return open_.back().node;
+    }
+  }
+
+  // Returns `nullptr` if the value is skipped.
+  rapidjson::Value* Push() {
+    if (skipped_depth_ || NextNode() == JSONFieldsProjection::kSkip) {
+      return nullptr;
+    }
+    if (!open_.empty()) {
+      ++open_.back().kept;
+    }
+    tape_.emplace_back();
+    JSONTapeEntry& entry = tape_.back();
+    entry.size = 0u;
+    entry.end = tape_.size();
+    return &entry.value;
+  }
+
+  void Open(bool is_object) {
+    const size_t node = skipped_depth_ ? JSONFieldsProjection::kSkip : NextNode();
+    if (rapidjson::Value* value = Push()) {
+      if (is_object) {
+        value->SetObject();
+      } else {
+        value->SetArray();
+      }
+      open_.push_back(Frame{tape_.size() - 1u, node, 0u, is_object});
+    } else {
+      ++skipped_depth_;
+    }
+  }
+
+  void Close() {
+    if (skipped_depth_) {
+      --skipped_depth_;
+    } else {
+      JSONTapeEntry& entry = tape_[open_.back().index];
+      entry.size = open_.back().kept;
+      entry.end = tape_.size();
+      open_.pop_back();
+    }
+  }
+
+  std::vector<JSONTapeEntry>& tape_;
+  const JSONFieldsProjection& projection_;
+  std::vector<Frame> open_;
+  size_t next_node_ = JSONFieldsProjection::kSkip;
+  // The depth of the arrays and objects being skipped, zero if the value is being kept.
+  size_t skipped_depth_ = 0u;
+};
+
 template <class JSON_FORMAT>
 class JSONParser final {
  public:
-  explicit JSONParser(const char* json) {
-    if (document_.Parse(json).HasParseError()) {
-      CURRENT_THROW(InvalidJSONException(json));
-    }
-    current_ = &document_;
+  explicit JSONParser(const char* json) : buffer_(json) {
+    // The tape is usually a few times shorter than the JSON, in entries vs. bytes, so reserve a conservative guess.
+    tape_.reserve(buffer_.length() / 8u + 1u);
+    JSONTapeBuilder builder(tape_);
+    Parse(json, builder);
   }
 
+  // The JSON of `length` bytes at `json`, which need not be null-terminated.
+  JSONParser(const char* json, size_t length) : buffer_(json, length) {
+    tape_.reserve(buffer_.length() / 8u + 1u);
+    JSONTapeBuilder builder(tape_);
+    Parse(json, builder);
+  }
+
+  // Only keeps the values selected by `projection`, see `JSONProjectedTapeBuilder`.
+  JSONParser(const char* json, const JSONFieldsProjection& projection) : buffer_(json) {
+    JSONProjectedTapeBuilder builder(tape_, projection);
+    Parse(json, builder);
+  }
+
+  JSONParser(const JSONParser&) = delete;
+  JSONParser& operator=(const JSONParser&) = delete;
+
   operator bool() const { return current_ != nullptr; }
-  rapidjson::Value& Current() { return *current_; }
-  rapidjson::Value* CurrentAsPtr() { return current_; }
+  rapidjson::Value& Current() { return current_->value; }
+
+  // The number of elements of the current array, or of the members of the current object.
+  size_t Size() const { return current_->size; }
+
+  // The first element of the current array, or the key of the first member of the current object.
+  JSONTapeEntry* FirstInner() { return current_ + 1; }
+
+  // The value right after `entry` and its contents, i.e. the next element of the array, or the next key of the object.
+  JSONTapeEntry* NextSibling(JSONTapeEntry* entry) { return &tape_[0] + entry->end; }
+
+  // Calls `f(element, index)` for each element of the current array.
+  template <typename F>
+  void ForEachElement(F&& f) {
+    JSONTapeEntry* element = FirstInner();
+    for (size_t i = 0u; i < current_->size; ++i) {
+      f(element, i);
+      element = NextSibling(element);
+    }
+  }
+
+  // Calls `f(key, value)` for each member of the current object, in the order of the input JSON.
+  template <typename F>
+  void ForEachMember(F&& f) {
+    JSONTapeEntry* key = FirstInner();
+    for (size_t i = 0u; i < current_->size; ++i) {
+      f(key, key + 1);
+      key = NextSibling(key + 1);
+    }
+  }
+
+  // The value of the first member of the current object named `name`, or `nullptr` if there is none.
+  JSONTapeEntry* FindMember(const char* name) {
+    const size_t length = std::strlen(name);
+    JSONTapeEntry* result = nullptr;
+    JSONTapeEntry* key = FirstInner();
+    for (size_t i = 0u; !result && i < current_->size; ++i) {
+      if (key->value.GetStringLength() == length && !std::memcmp(key->value.GetString(), name, length)) {
+        result = key + 1;
+      } else {
+        key = NextSibling(key + 1);
+      }
+    }
+    return result;
+  }
+
+  // The current value as JSON, or "missing field.", for the error messages.
+  std::string NonThrowingFormatCurrentValueAsString() const {
+    if (current_) {
+      try {
+        rapidjson::StringBuffer string_buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(string_buffer);
+        WriteTapeValue(current_, writer);
+        return string_buffer.GetString();
+      } catch (const std::exception&) {     // LCOV_EXCL_LINE
+        return "field can not be parsed.";  // LCOV_EXCL_LINE
+      }
+    } else {
+      return "missing field.";
+    }
+  }
 
   template <typename T>
-  void Inner(rapidjson::Value* inner_value, T&& x) {
+  void Inner(JSONTapeEntry* inner_value, T&& x) {
     std::swap(current_, inner_value);
     Deserialize(*this, std::forward<T>(x));
     std::swap(current_, inner_value);
   }
 
   template <typename T, typename P1>
-  void Inner(rapidjson::Value* inner_value, T&& x, P1 p1) {
+  void Inner(JSONTapeEntry* inner_value, T&& x, P1 p1) {
     path_.emplace_back(p1);
     std::swap(current_, inner_value);
     Deserialize(*this, std::forward<T>(x));
@@ -270,7 +687,7 @@ class JSONParser final {
 
   // The `P1, P2, P3` and `CharPtrOrInt` magic are optimizations for fast JSON path construction. -- D.K.
   template <typename T, typename P1, typename P2>
-  void Inner(rapidjson::Value* inner_value, T&& x, P1 p1, P2 p2) {
+  void Inner(JSONTapeEntry* inner_value, T&& x, P1 p1, P2 p2) {
     path_.emplace_back(p1);
     path_.emplace_back(p2);
     std::swap(current_, inner_value);
@@ -281,7 +698,7 @@ class JSONParser final {
   }
 
   template <typename T, typename P1, typename P2, typename P3>
-  void Inner(rapidjson::Value* inner_value, T&& x, P1 p1, P2 p2, P3 p3) {
+  void Inner(JSONTapeEntry* inner_value, T&& x, P1 p1, P2 p2, P3 p3) {
     path_.emplace_back(p1);
     path_.emplace_back(p2);
     path_.emplace_back(p3);
@@ -318,9 +735,45 @@ class JSONParser final {
   }
 
  private:
-  rapidjson::Value* current_;
+  template <typename BUILDER>
+  void Parse(const char* json, BUILDER& builder) {
+    rapidjson::InsituStringStream stream(&buffer_[0]);
+    rapidjson::Reader reader;
+    if (reader.Parse<rapidjson::kParseInsituFlag>(stream, builder).IsError()) {
+      CURRENT_THROW(InvalidJSONException(std::string(json, buffer_.length())));
+    }
+    current_ = &tape_[0];
+  }
+
+  // Replays the events of the value, and of its contents, from the tape into `writer`.
+  template <typename WRITER>
+  const JSONTapeEntry* WriteTapeValue(const JSONTapeEntry* entry, WRITER& writer) const {
+    const rapidjson::Value& value = entry->value;
+    if (value.IsObject()) {
+      writer.StartObject();
+      const JSONTapeEntry* key = entry + 1;
+      for (size_t i = 0u; i < entry->size; ++i) {
+        writer.Key(key->value.GetString(), key->value.GetStringLength());
+        key = WriteTapeValue(key + 1, writer);
+      }
+      writer.EndObject();
+    } else if (value.IsArray()) {
+      writer.StartArray();
+      const JSONTapeEntry* element = entry + 1;
+      for (size_t i = 0u; i < entry->size; ++i) {
+        element = WriteTapeValue(element, writer);
+      }
+      writer.EndArray();
+    } else {
+      value.Accept(writer);
+    }
+    return &tape_[0] + entry->end;
+  }
+
+  std::string buffer_;
+  std::vector<JSONTapeEntry> tape_;
+  JSONTapeEntry* current_;
   std::vector<CharPtrOrInt> path_;
-  rapidjson::Document document_;
 };
 
 template <class J, typename T>
@@ -329,11 +782,29 @@ void ParseJSONViaRapidJSON(const char* json, T& destination) {
   Deserialize(json_parser, destination);
 }
 
+template <class J, typename T>
+void ParseJSONViaRapidJSON(const char* json, size_t length, T& destination) {
+  JSONParser<J> json_parser(json, length);
+  Deserialize(json_parser, destination);
+}
+
+// Appends the JSON of `source` to `output`. Reusing `output` across calls saves on the allocations.
 template <class J = JSONFormat::Current, typename T>
-inline std::string JSON(const T& source) {
-  JSONStringifier<J> json_stringifier;
+inline void JSONAppend(std::string& output, const T& source) {
+  JSONStringifier<J> json_stringifier(output);
   Serialize(json_stringifier, source);
-  return json_stringifier.ResultingJSON();
+}
+
+template <class J = JSONFormat::Current>
+inline void JSONAppend(std::string& output, const char* special_case_bare_c_string) {
+  JSONAppend<J>(output, std::string(special_case_bare_c_string));
+}
+
+template <class J = JSONFormat::Current, typename T>
+inline std::string JSON(const T& source) {
+  std::string result;
+  JSONAppend<J>(result, source);
+  return result;
 }
 
 template <class J = JSONFormat::Current>
@@ -351,6 +822,17 @@ inline void ParseJSON(const char* source, T& destination) {
   }
 }
 
+// Parses the JSON of `length` bytes at `source`, which need not be null-terminated, e.g. a line of a larger text.
+template <typename T, class J = JSONFormat::Current>
+inline void ParseJSON(const char* source, size_t length, T& destination) {
+  try {
+    ParseJSONViaRapidJSON<J>(source, length, destination);
+    CheckIntegrity(destination);
+  } catch (UninitializedVariant) {
+    CURRENT_THROW(JSONUninitializedVariantObjectException());
+  }
+}
+
 template <typename T, class J = JSONFormat::Current>
 inline void ParseJSON(const std::string& source, T& destination) {
   ParseJSON(source.c_str(), destination);
@@ -399,6 +881,42 @@ inline T ParseJSON(const strings::Chunk& source) {
   return ParseJSON<T, J>(source.c_str());
 }
 
+// Parses only the fields of `destination` selected by `projection`, leaving the rest of `destination` as is.
+// The values not selected are skipped over, see `JSONProjectedTapeBuilder`. As in `PatchObjectWithJSON`,
+// the selected fields missing from the input are left as is too, and the integrity of the result is not checked.
+template <typename T, class J = JSONFormat::Current>
+inline void ParseJSONFields(const char* source, T& destination, const JSONFieldsProjection& projection) {
+  JSONParser<JSONPatcher<J>> json_parser(source, projection);
+  Deserialize(json_parser, destination);
+}
+
+template <typename T, class J = JSONFormat::Current>
+inline void ParseJSONFields(const std::string& source, T& destination, const JSONFieldsProjection& projection) {
+  ParseJSONFields<T, J>(source.c_str(), destination, projection);
+}
+
+template <typename T, class J = JSONFormat::Current>
+inline void ParseJSONFields(const strings::Chunk& source, T& destination, const JSONFieldsProjection& projection) {
+  ParseJSONFields<T, J>(source.c_str(), destination, projection);
+}
+
+template <typename T, class J = JSONFormat::Current>
+inline T ParseJSONFields(const char* source, const JSONFieldsProjection& projection) {
+  T result;
+  ParseJSONFields<T, J>(source, result, projection);
+  return result;
+}
+
+template <typename T, class J = JSONFormat::Current>
+inline T ParseJSONFields(const std::string& source, const JSONFieldsProjection& projection) {
+  return ParseJSONFields<T, J>(source.c_str(), projection);
+}
+
+template <typename T, class J = JSONFormat::Current>
+inline T ParseJSONFields(const strings::Chunk& source, const JSONFieldsProjection& projection) {
+  return ParseJSONFields<T, J>(source.c_str(), projection);
+}
+
 template <typename T, class J = JSONFormat::Current>
 inline Optional<T> TryParseJSON(const char* source) {
   try {
@@ -425,8 +943,11 @@ inline Optional<T> TryParseJSON(const strings::Chunk& source) {
 
 // Keep top-level symbols both in `current::` and in global namespace.
 using serialization::json::JSON;
+using serialization::json::JSONAppend;
 using serialization::json::ParseJSON;
 using serialization::json::TryParseJSON;
+using serialization::json::ParseJSONFields;
+using serialization::json::JSONFieldsProjection;
 using serialization::json::PatchObjectWithJSON;
 using serialization::json::JSONFormat;
 using serialization::json::TypeSystemParseJSONException;
@@ -436,8 +957,11 @@ using serialization::json::JSONUninitializedVariantObjectException;
 }  // namespace current
 
 using current::JSON;
+using current::JSONAppend;
 using current::ParseJSON;
 using current::TryParseJSON;
+using current::ParseJSONFields;
+using current::JSONFieldsProjection;
 using current::PatchObjectWithJSON;
 using current::JSONFormat;
 using current::TypeSystemParseJSONException;
@@ -0,0 +1,126 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2015 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+          (c) 2016 Maxim Zhurovich <zhurovich@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Parses the files of one JSON per line in parallel. The file is memory-mapped and cut into chunks at line breaks,
+// the chunks are parsed by the worker threads, and the parsed entries are handed over in the order of the input.
+// The empty lines are skipped. The parse errors are reported with the line numbers, counting from one,
+// once the entries of all the lines before the invalid one have been handed over.
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_LINES_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_LINES_H
+
+#include <string>
+#include <vector>
+
+#include "json.h"
+
+#include "../../../Bricks/file/mmap.h"
+#include "../../../Bricks/file/parallel_lines.h"
+#include "../../../Bricks/strings/util.h"
+#include "../../../Bricks/template/enable_if.h"
+
+namespace current {
+namespace serialization {
+namespace json {
+
+struct InvalidJSONLineException : TypeSystemParseJSONException {
+  const size_t line_number;
+  InvalidJSONLineException(size_t line_number, const std::string& description)
+      : TypeSystemParseJSONException("Line " + current::ToString(line_number) + ": " + description),
+        line_number(line_number) {}
+};
+
+namespace impl {
+
+template <typename T>
+struct ParsedJSONLinesChunk {
+  std::vector<T> entries;
+  size_t lines = 0u;
+  // Zero if there is no error, the number of the line within the chunk otherwise.
+  // The `entries` are then those of the lines before it.
+  size_t error_line = 0u;
+  std::string error_description;
+};
+
+// Does not parse the lines past the first error, as their entries would not be handed over anyway.
+template <typename T, class J>
+inline void ParseJSONLinesChunk(const char* begin, const char* end, ParsedJSONLinesChunk<T>& chunk) {
+  ForEachLine(begin, end, [&chunk](const char* line, const char* line_end) {
+    ++chunk.lines;
+    if (line_end > line && !chunk.error_line) {
+      chunk.entries.emplace_back();
+      try {
+        ParseJSON<T, J>(line, static_cast<size_t>(line_end - line), chunk.entries.back());
+      } catch (const current::Exception& e) {
+        chunk.entries.pop_back();
+        chunk.error_line = chunk.lines;
+        chunk.error_description = e.OriginalDescription();
+      }
+    }
+  });
+}
+
+}  // namespace current::serialization::json::impl
+
+// Calls `f(T&& entry)` for each line of the file, in order, from the calling thread.
+// `threads` is the number of the worker threads, zero for one per core.
+template <typename T,
+          class J = JSONFormat::Current,
+          typename F,
+          class = ENABLE_IF<!std::is_integral<current::decay<F>>::value>>
+inline void ParseJSONLines(const std::string& file_name, F&& f, size_t threads = 0u) {
+  const MemoryMappedFile file(file_name);
+  ParallelLineChunks<impl::ParsedJSONLinesChunk<T>> chunks(
+      file.Data(), file.Data() + file.Size(), threads, impl::ParseJSONLinesChunk<T, J>);
+  size_t lines_before_chunk = 0u;
+  chunks.Run([&f, &lines_before_chunk](impl::ParsedJSONLinesChunk<T>& chunk) {
+    for (T& entry : chunk.entries) {
+      f(std::move(entry));
+    }
+    if (chunk.error_line) {
+      CURRENT_THROW(InvalidJSONLineException(lines_before_chunk + chunk.error_line, chunk.error_description));
+    }
+    lines_before_chunk += chunk.lines;
+  });
+}
+
+template <typename T, class J = JSONFormat::Current>
+inline std::vector<T> ParseJSONLines(const std::string& file_name, size_t threads = 0u) {
+  std::vector<T> result;
+  ParseJSONLines<T, J>(file_name, [&result](T&& entry) { result.push_back(std::move(entry)); }, threads);
+  return result;
+}
+
+}  // namespace current::serialization::json
+}  // namespace current::serialization
+
+using serialization::json::ParseJSONLines;
+using serialization::json::InvalidJSONLineException;
+}  // namespace current
+
+using current::ParseJSONLines;
+using current::InvalidJSONLineException;
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_LINES_H
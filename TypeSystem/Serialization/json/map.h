@@ -39,18 +39,14 @@ namespace serialization {
 template <class JSON_FORMAT, typename TK, typename TV, typename TC, typename TA>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::map<TK, TV, TC, TA>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const std::map<TK, TV, TC, TA>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.Writer().StartArray();
     for (const auto& element : value) {
-      rapidjson::Value key_value_as_array;
-      key_value_as_array.SetArray();
-      rapidjson::Value populated_key;
-      rapidjson::Value populated_value;
-      json_stringifier.Inner(&populated_key, element.first);
-      json_stringifier.Inner(&populated_value, element.second);
-      key_value_as_array.PushBack(std::move(populated_key.Move()), json_stringifier.Allocator());
-      key_value_as_array.PushBack(std::move(populated_value.Move()), json_stringifier.Allocator());
-      json_stringifier.Current().PushBack(std::move(key_value_as_array.Move()), json_stringifier.Allocator());
+      json_stringifier.Writer().StartArray();
+      Serialize(json_stringifier, element.first);
+      Serialize(json_stringifier, element.second);
+      json_stringifier.Writer().EndArray();
     }
+    json_stringifier.Writer().EndArray();
   }
 };
 
@@ -58,13 +54,12 @@ template <class JSON_FORMAT, typename TV, typename TC, typename TA>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::map<std::string, TV, TC, TA>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier,
                           const std::map<std::string, TV, TC, TA>& value) {
-    json_stringifier.Current().SetObject();
+    json_stringifier.Writer().StartObject();
     for (const auto& element : value) {
-      rapidjson::Value populated_value;
-      json_stringifier.Inner(&populated_value, element.second);
-      json_stringifier.Current().AddMember(
-          rapidjson::StringRef(element.first), std::move(populated_value.Move()), json_stringifier.Allocator());
+      json_stringifier.Writer().Key(element.first.data(), static_cast<rapidjson::SizeType>(element.first.length()));
+      Serialize(json_stringifier, element.second);
     }
+    json_stringifier.Writer().EndObject();
   }
 };
 
@@ -77,13 +72,11 @@ struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::map<TK, TV, TC, TA>,
       destination.clear();
       TK k;
       TV v;
-      for (rapidjson::Value::MemberIterator cit = json_parser.Current().MemberBegin();
-           cit != json_parser.Current().MemberEnd();
-           ++cit) {
-        json_parser.Inner(&cit->name, k);
-        json_parser.Inner(&cit->value, v);
+      json_parser.ForEachMember([&](json::JSONTapeEntry* key, json::JSONTapeEntry* value) {
+        json_parser.Inner(key, k);
+        json_parser.Inner(value, v);
         destination.emplace(std::move(k), std::move(v));
-      }
+      });
     } else if (!json::JSONPatchMode<J>::value || (json_parser && !json_parser.Current().IsObject())) {
       throw JSONSchemaException("map as object", json_parser);  // LCOV_EXCL_LINE
     }
@@ -94,20 +87,19 @@ struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::map<TK, TV, TC, TA>,
       json::JSONParser<JSON_FORMAT>& json_parser, std::map<TK, TV, TC, TA>& destination) {
     if (json_parser && json_parser.Current().IsArray()) {
       destination.clear();
-      for (rapidjson::Value::ValueIterator cit = json_parser.Current().Begin(); cit != json_parser.Current().End();
-           ++cit) {
-        if (!cit->IsArray()) {
+      json_parser.ForEachElement([&](json::JSONTapeEntry* entry, size_t) {
+        if (!entry->value.IsArray()) {
           throw JSONSchemaException("map entry as array", json_parser);  // LCOV_EXCL_LINE
         }
-        if (cit->Size() != 2u) {
+        if (entry->size != 2u) {
           throw JSONSchemaException("map entry as array of two elements", json_parser);  // LCOV_EXCL_LINE
         }
         TK k;
         TV v;
-        json_parser.Inner(&(*cit)[static_cast<rapidjson::SizeType>(0)], k);
-        json_parser.Inner(&(*cit)[static_cast<rapidjson::SizeType>(1)], v);
+        json_parser.Inner(entry + 1, k);
+        json_parser.Inner(json_parser.NextSibling(entry + 1), v);
         destination.emplace(std::move(k), std::move(v));
-      }
+      });
     } else if (!json::JSONPatchMode<J>::value || (json_parser && !json_parser.Current().IsArray())) {
       throw JSONSchemaException("map as array", json_parser);  // LCOV_EXCL_LINE
     }
@@ -43,7 +43,7 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, Optional<T>> {
     } else {
       // Current's default JSON parser would accept a missing field as well for no value,
       // but output it as `null` nonetheless, for clarity.
-      json_stringifier.Current().SetNull();
+      json_stringifier.Writer().Null();
     }
   }
 };
@@ -68,16 +68,14 @@ struct SerializeImpl<json::JSONStringifier<json::JSONFormat::NewtonsoftFSharp>,
   static void DoSerialize(json::JSONStringifier<json::JSONFormat::NewtonsoftFSharp>& json_stringifier,
                           const Optional<T>& value) {
     if (Exists(value)) {
-      rapidjson::Value ultimate_destination;
-      json_stringifier.Inner(&ultimate_destination, Value(value));
-      rapidjson::Value array_of_one_element_containing_value;
-      array_of_one_element_containing_value.SetArray();
-      array_of_one_element_containing_value.PushBack(std::move(ultimate_destination.Move()),
-                                                     json_stringifier.Allocator());
-      json_stringifier.Current().SetObject();
-      json_stringifier.Current().AddMember("Case", "Some", json_stringifier.Allocator());
-      json_stringifier.Current().AddMember(
-          "Fields", std::move(array_of_one_element_containing_value.Move()), json_stringifier.Allocator());
+      json_stringifier.Writer().StartObject();
+      json_stringifier.Writer().Key("Case");
+      json_stringifier.Writer().String("Some");
+      json_stringifier.Writer().Key("Fields");
+      json_stringifier.Writer().StartArray();
+      Serialize(json_stringifier, Value(value));
+      json_stringifier.Writer().EndArray();
+      json_stringifier.Writer().EndObject();
     } else {
       json_stringifier.MarkAsAbsentValue();
     }
@@ -110,19 +108,19 @@ struct DeserializeImpl<json::JSONParser<JSONFormat::NewtonsoftFSharp>, Optional<
       destination = nullptr;
     } else {
       bool ok = false;
-      if (json_parser.Current().IsObject() && json_parser.Current().HasMember("Case")) {
-        const auto& case_field = json_parser.Current()["Case"];
-        if (case_field.IsString()) {
-          const char* case_field_value = case_field.GetString();
+      json::JSONTapeEntry* case_field = nullptr;
+      if (json_parser.Current().IsObject() && (case_field = json_parser.FindMember("Case"))) {
+        if (case_field->value.IsString()) {
+          const char* case_field_value = case_field->value.GetString();
+          json::JSONTapeEntry* fields_field = nullptr;
           if (!strcmp(case_field_value, "None")) {
             // Unnecessary, but to be safe. -- D.K.
             destination = nullptr;
             ok = true;
-          } else if (!strcmp(case_field_value, "Some") && json_parser.Current().HasMember("Fields")) {
-            auto& fields_field = json_parser.Current()["Fields"];
-            if (fields_field.IsArray() && fields_field.Size() == 1u) {
+          } else if (!strcmp(case_field_value, "Some") && (fields_field = json_parser.FindMember("Fields"))) {
+            if (fields_field->value.IsArray() && fields_field->size == 1u) {
               destination = T();
-              json_parser.Inner(&fields_field[0u], Value(destination));
+              json_parser.Inner(fields_field + 1, Value(destination));
               ok = true;
             }
           }
@@ -36,13 +36,10 @@ namespace serialization {
 template <class JSON_FORMAT, typename TF, typename TS>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::pair<TF, TS>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const std::pair<TF, TS>& value) {
-    rapidjson::Value first_value;
-    rapidjson::Value second_value;
-    json_stringifier.Inner(&first_value, value.first);
-    json_stringifier.Inner(&second_value, value.second);
-    json_stringifier.Current().SetArray();
-    json_stringifier.Current().PushBack(std::move(first_value.Move()), json_stringifier.Allocator());
-    json_stringifier.Current().PushBack(std::move(second_value.Move()), json_stringifier.Allocator());
+    json_stringifier.Writer().StartArray();
+    Serialize(json_stringifier, value.first);
+    Serialize(json_stringifier, value.second);
+    json_stringifier.Writer().EndArray();
   }
 };
 
@@ -50,24 +47,24 @@ template <typename TF, typename TS>
 struct SerializeImpl<json::JSONStringifier<json::JSONFormat::NewtonsoftFSharp>, std::pair<TF, TS>> {
   static void DoSerialize(json::JSONStringifier<json::JSONFormat::NewtonsoftFSharp>& json_stringifier,
                           const std::pair<TF, TS>& value) {
-    rapidjson::Value first_value;
-    rapidjson::Value second_value;
-    json_stringifier.Inner(&first_value, value.first);
-    json_stringifier.Inner(&second_value, value.second);
-    json_stringifier.Current().SetObject();
-    json_stringifier.Current().AddMember("Item1", std::move(first_value.Move()), json_stringifier.Allocator());
-    json_stringifier.Current().AddMember("Item2", std::move(second_value.Move()), json_stringifier.Allocator());
+    json_stringifier.Writer().StartObject();
+    json_stringifier.Writer().Key("Item1");
+    Serialize(json_stringifier, value.first);
+    json_stringifier.Writer().Key("Item2");
+    Serialize(json_stringifier, value.second);
+    json_stringifier.Writer().EndObject();
   }
 };
 
 template <class JSON_FORMAT, typename TF, typename TS>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::pair<TF, TS>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, std::pair<TF, TS>& destination) {
-    if (json_parser && json_parser.Current().IsArray() && json_parser.Current().Size() == 2u) {
-      json_parser.Inner(&json_parser.Current()[static_cast<rapidjson::SizeType>(0)], destination.first);
-      json_parser.Inner(&json_parser.Current()[static_cast<rapidjson::SizeType>(1)], destination.second);
+    if (json_parser && json_parser.Current().IsArray() && json_parser.Size() == 2u) {
+      json::JSONTapeEntry* first = json_parser.FirstInner();
+      json_parser.Inner(first, destination.first);
+      json_parser.Inner(json_parser.NextSibling(first), destination.second);
     } else if (!json::JSONPatchMode<JSON_FORMAT>::value ||
-               (json_parser && !(json_parser.Current().IsArray() && json_parser.Current().Size() == 2u))) {
+               (json_parser && !(json_parser.Current().IsArray() && json_parser.Size() == 2u))) {
       throw JSONSchemaException("pair as array", json_parser);  // LCOV_EXCL_LINE
     }
   }
@@ -77,10 +74,12 @@ template <typename TF, typename TS>
 struct DeserializeImpl<json::JSONParser<JSONFormat::NewtonsoftFSharp>, std::pair<TF, TS>> {
   static void DoDeserialize(json::JSONParser<JSONFormat::NewtonsoftFSharp>& json_parser,
                             std::pair<TF, TS>& destination) {
-    if (json_parser && json_parser.Current().IsObject() && json_parser.Current().HasMember("Item1") &&
-        json_parser.Current().HasMember("Item2")) {
-      json_parser.Inner(&json_parser.Current()["Item1"], destination.first);
-      json_parser.Inner(&json_parser.Current()["Item2"], destination.second);
+    json::JSONTapeEntry* item1 = nullptr;
+    json::JSONTapeEntry* item2 = nullptr;
+    if (json_parser && json_parser.Current().IsObject() && (item1 = json_parser.FindMember("Item1")) &&
+        (item2 = json_parser.FindMember("Item2"))) {
+      json_parser.Inner(item1, destination.first);
+      json_parser.Inner(item2, destination.second);
     } else {
       throw JSONSchemaException("pair as an object of {Item1,Item2}", json_parser);  // LCOV_EXCL_LINE
     }
@@ -37,23 +37,19 @@ namespace serialization {
 namespace json {
 template <>
 struct JSONValueAssignerImpl<std::string> {
-  static void AssignValue(rapidjson::Value& destination, const std::string& value) {
-    destination = rapidjson::StringRef(value);
+  static void AssignValue(JSONWriter& writer, const std::string& value) {
+    writer.String(value.data(), static_cast<rapidjson::SizeType>(value.length()));
   }
 };
 
 template <>
 struct JSONValueAssignerImpl<std::chrono::microseconds> {
-  static void AssignValue(rapidjson::Value& destination, std::chrono::microseconds value) {
-    destination.SetInt64(value.count());
-  }
+  static void AssignValue(JSONWriter& writer, std::chrono::microseconds value) { writer.Int64(value.count()); }
 };
 
 template <>
 struct JSONValueAssignerImpl<std::chrono::milliseconds> {
-  static void AssignValue(rapidjson::Value& destination, std::chrono::milliseconds value) {
-    destination.SetInt64(value.count());
-  }
+  static void AssignValue(JSONWriter& writer, std::chrono::milliseconds value) { writer.Int64(value.count()); }
 };
 }  // namespace curent::serialization::json
 
@@ -0,0 +1,111 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2015 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+          (c) 2016 Maxim Zhurovich <zhurovich@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_PROJECTION_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_PROJECTION_H
+
+#include <string>
+#include <vector>
+
+#include "json.h"
+
+#include "../../optional.h"
+#include "../../Reflection/reflection.h"
+
+namespace current {
+namespace serialization {
+namespace json {
+
+namespace impl {
+
+// Adds the paths of all the fields of `T`, recursively, to the projection. The values other than `CURRENT_STRUCT`-s,
+// and the `std::vector`-s and `Optional`-s of them, are selected as a whole.
+template <typename T, typename ENABLE = void>
+struct JSONFieldsProjectionPaths {
+  static void Add(JSONFieldsProjection& projection, const std::string& prefix) { projection.Add(prefix); }
+};
+
+template <>
+struct JSONFieldsProjectionPaths<CurrentStruct> {
+  static void Add(JSONFieldsProjection&, const std::string&) {}
+};
+
+template <typename T>
+struct JSONFieldsProjectionPaths<T, std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same<T, CurrentStruct>::value>> {
+  struct FieldsVisitor {
+    JSONFieldsProjection& projection;
+    const std::string& prefix;
+
+    template <typename U>
+    void operator()(current::reflection::TypeSelector<U>, const char* name) const {
+      JSONFieldsProjectionPaths<U>::Add(projection, prefix.empty() ? std::string(name) : prefix + '.' + name);
+    }
+  };
+
+  static void Add(JSONFieldsProjection& projection, const std::string& prefix) {
+    JSONFieldsProjectionPaths<current::reflection::SuperType<T>>::Add(projection, prefix);
+    FieldsVisitor visitor{projection, prefix};
+    current::reflection::VisitAllFields<T, current::reflection::FieldTypeAndName>::WithoutObject(visitor);
+  }
+};
+
+template <typename T, typename ALLOC>
+struct JSONFieldsProjectionPaths<std::vector<T, ALLOC>> {
+  static void Add(JSONFieldsProjection& projection, const std::string& prefix) {
+    JSONFieldsProjectionPaths<T>::Add(projection, prefix);
+  }
+};
+
+template <typename T>
+struct JSONFieldsProjectionPaths<Optional<T>> {
+  static void Add(JSONFieldsProjection& projection, const std::string& prefix) {
+    JSONFieldsProjectionPaths<T>::Add(projection, prefix);
+  }
+};
+
+}  // namespace current::serialization::json::impl
+
+// The compile-time counterpart of listing the paths: the projection selecting the fields `VIEW` has.
+// `VIEW` is usually the `CURRENT_STRUCT` with the subset of the fields of the type the JSON was made of,
+// so that `ParseJSONFields<VIEW>(json, JSONFieldsProjectionOf<VIEW>())` skips everything else in the input.
+template <typename VIEW>
+inline const JSONFieldsProjection& JSONFieldsProjectionOf() {
+  static const JSONFieldsProjection projection = []() {
+    JSONFieldsProjection result;
+    impl::JSONFieldsProjectionPaths<VIEW>::Add(result, "");
+    return result;
+  }();
+  return projection;
+}
+
+}  // namespace current::serialization::json
+}  // namespace current::serialization
+
+using serialization::json::JSONFieldsProjectionOf;
+}  // namespace current
+
+using current::JSONFieldsProjectionOf;
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_PROJECTION_H
@@ -26,7 +26,10 @@ SOFTWARE.
 #ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_STRUCT_H
 #define CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_STRUCT_H
 
+#include <cstring>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 #include "json.h"
 
@@ -44,15 +47,9 @@ class JSONStructFieldsSerializer {
   explicit JSONStructFieldsSerializer(json::JSONStringifier<JSON_FORMAT>& json_stringifier)
       : json_stringifier_(json_stringifier) {}
 
-  // IMPORTANT: Must take name as `const char* name`, as `const std::string& name`
-  // would fail memory-allocation-wise due to over-smartness of RapidJSON.
   template <typename U>
   void operator()(const char* name, const U& source) const {
-    rapidjson::Value placeholder;
-    if (json_stringifier_.MaybeInner(&placeholder, source)) {
-      json_stringifier_.Current().AddMember(
-          rapidjson::StringRef(name), std::move(placeholder.Move()), json_stringifier_.Allocator());
-    }
+    json_stringifier_.Field(name, source);
   }
 
  private:
@@ -84,9 +81,10 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>,
                      T,
                      std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same<T, CurrentStruct>::value>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const T& value) {
-    json_stringifier.Current().SetObject();
+    json_stringifier.Writer().StartObject();
     json::JSONStructFieldsSerializer<JSON_FORMAT> visitor(json_stringifier);
     json::SerializeStructImpl<JSON_FORMAT, T>::SerializeStruct(visitor, value);
+    json_stringifier.Writer().EndObject();
   }
 };
 
@@ -95,39 +93,131 @@ struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, CurrentStruct> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>&, CurrentStruct&) {}
 };
 
+namespace json {
+
+// The per-type table to match the keys of the input JSON object to the indexes of the fields of `T`.
+// Only the fields declared in `T` itself are listed, the fields of its base are matched on the level of the base.
+template <typename T>
+class JSONStructFieldsIndex final {
+ public:
+  constexpr static size_t fields_count = current::reflection::FieldCounter<T>::value;
+
+  static const JSONStructFieldsIndex& Instance() {
+    static JSONStructFieldsIndex instance;
+    return instance;
+  }
+
+  // Returns the index of the field named `key`, or `fields_count` if there is none.
+  // The keys usually come in the order of the fields, so the field at `hint` is tried first.
+  size_t Find(const rapidjson::Value& key, size_t hint) const {
+    const char* name = key.GetString();
+    const size_t length = key.GetStringLength();
+    if (hint < fields_count && Matches(hint, name, length)) {
+      return hint;
+    }
+    const size_t mask = slots_.size() - 1u;
+    for (size_t slot = Hash(name, length) & mask; slots_[slot] != fields_count; slot = (slot + 1u) & mask) {
+      if (Matches(slots_[slot], name, length)) {
+        return slots_[slot];
+      }
+    }
+    return fields_count;
+  }
+
+  // Collects the names of the fields, as the visitor of `VisitAllFields`.
+  template <typename U>
+  void operator()(current::reflection::TypeSelector<U>, const char* name) {
+    names_.push_back(name);
+  }
+
+ private:
+  JSONStructFieldsIndex() {
+    current::reflection::VisitAllFields<T, current::reflection::FieldTypeAndName>::WithoutObject(*this);
+    // Open addressing, with at least half of the slots empty.
+    size_t slots = 2u;
+    while (slots < names_.size() * 2u) {
+      slots *= 2u;
+    }
+    slots_.assign(slots, fields_count);
+    for (size_t index = 0u; index < names_.size(); ++index) {
+      size_t slot = Hash(names_[index].c_str(), names_[index].length()) & (slots - 1u);
+      while (slots_[slot] != fields_count) {
+        slot = (slot + 1u) & (slots - 1u);
+      }
+      slots_[slot] = index;
+    }
+  }
+
+  // FNV-1a.
+  static size_t Hash(const char* s, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0u; i < length; ++i) {
+      hash = (hash ^ static_cast<unsigned char>(s[i])) * 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+  }
+
+  bool Matches(size_t index, const char* name, size_t length) const {
+    return names_[index].length() == length && !std::memcmp(names_[index].data(), name, length);
+  }
+
+  std::vector<std::string> names_;
+  std::vector<size_t> slots_;
+};
+
+template <typename T>
+constexpr size_t JSONStructFieldsIndex<T>::fields_count;
+
+}  // namespace current::serialization::json
+
 template <class JSON_FORMAT, typename T>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>,
                        T,
                        std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same<T, CurrentStruct>::value>> {
+  using decayed_t = current::decay<T>;
+  using fields_index_t = json::JSONStructFieldsIndex<decayed_t>;
+  // Never zero-sized, to not have the zero-length array for the structs with no fields of their own.
+  constexpr static size_t fields_count_or_one = fields_index_t::fields_count ? fields_index_t::fields_count : 1u;
+
   class DeserializeSingleField {
    public:
-    explicit DeserializeSingleField(json::JSONParser<JSON_FORMAT>& json_parser) : json_parser_(json_parser) {}
+    DeserializeSingleField(json::JSONParser<JSON_FORMAT>& json_parser, json::JSONTapeEntry** values)
+        : json_parser_(json_parser), values_(values) {}
 
-    // IMPORTANT: Must take `name` as `const char* name`, since `const std::string& name`
-    // would fail memory-allocation-wise due to over-smartness of RapidJSON.
     template <typename U>
-    void operator()(const char* name, U& value) const {
-      if (json_parser_.Current().HasMember(name)) {
-        json_parser_.Inner(&json_parser_.Current()[name], value, ".", name);
-      } else {
-        json_parser_.Inner(nullptr, value, ".", name);
-      }
+    void operator()(const char* name, U& value) {
+      json_parser_.Inner(values_[index_++], value, ".", name);
     }
 
    private:
     json::JSONParser<JSON_FORMAT>& json_parser_;
+    json::JSONTapeEntry** values_;
+    size_t index_ = 0u;
   };
 
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, T& destination) {
-    using decayed_t = current::decay<T>;
     using super_t = current::reflection::SuperType<decayed_t>;
 
     if (json_parser && json_parser.Current().IsObject()) {
       if (!std::is_same<super_t, CurrentStruct>::value) {
         Deserialize(json_parser, static_cast<super_t&>(destination));
       }
+      // Match the keys to the fields in a single pass over the object. Of the duplicate keys, the first one wins.
+      json::JSONTapeEntry* values[fields_count_or_one] = {};
+      const fields_index_t& fields_index = fields_index_t::Instance();
+      size_t hint = 0u;
+      json_parser.ForEachMember([&](json::JSONTapeEntry* key, json::JSONTapeEntry* value) {
+        const size_t index = fields_index.Find(key->value, hint);
+        if (index != fields_index_t::fields_count) {
+          if (!values[index]) {
+            values[index] = value;
+          }
+          hint = index + 1u;
+        }
+      });
+      DeserializeSingleField visitor(json_parser, values);
       current::reflection::VisitAllFields<decayed_t, current::reflection::FieldNameAndMutableValue>::WithObject(
-          destination, DeserializeSingleField(json_parser));
+          destination, visitor);
     } else if (!json::JSONPatchMode<JSON_FORMAT>::value || (json_parser && !json_parser.Current().IsObject())) {
       throw JSONSchemaException("object", json_parser);  // LCOV_EXCL_LINE
     }
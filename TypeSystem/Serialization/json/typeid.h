@@ -38,7 +38,7 @@ namespace serialization {
 template <class JSON_FORMAT>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, reflection::TypeID> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, reflection::TypeID value) {
-    json_stringifier.Current().SetString("T" + current::ToString(value), json_stringifier.Allocator());
+    json_stringifier = "T" + current::ToString(value);
   }
 };
 
@@ -38,12 +38,11 @@ template <class JSON_FORMAT, typename T, class HASH, class EQ, class ALLOCATOR>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::unordered_set<T, HASH, EQ, ALLOCATOR>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier,
                           const std::unordered_set<T, HASH, EQ, ALLOCATOR>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.Writer().StartArray();
     for (const auto& element : value) {
-      rapidjson::Value element_to_push;
-      json_stringifier.Inner(&element_to_push, element);
-      json_stringifier.Current().PushBack(std::move(element_to_push.Move()), json_stringifier.Allocator());
+      Serialize(json_stringifier, element);
     }
+    json_stringifier.Writer().EndArray();
   }
 };
 
@@ -53,12 +52,11 @@ struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::unordered_set<T, HASH
                             std::unordered_set<T, HASH, EQ, ALLOCATOR>& destination) {
     destination.clear();
     if (json_parser && json_parser.Current().IsArray()) {
-      const size_t size = json_parser.Current().Size();
-      for (rapidjson::SizeType i = 0; i < static_cast<rapidjson::SizeType>(size); ++i) {
+      json_parser.ForEachElement([&](json::JSONTapeEntry* entry, size_t i) {
         T element;
-        json_parser.Inner(&json_parser.Current()[i], element, "[", static_cast<int>(i), "]");
+        json_parser.Inner(entry, element, "[", static_cast<int>(i), "]");
         destination.insert(std::move(element));
-      }
+      });
     } else if (!json::JSONPatchMode<JSON_FORMAT>::value || (json_parser && !json_parser.Current().IsArray())) {
       throw JSONSchemaException("[unordered_]set as array", json_parser);  // LCOV_EXCL_LINE
     }
@@ -61,29 +61,23 @@ class JSONVariantSerializer<json::JSONVariantStyle::Current, JSON_FORMAT> {
 
   template <typename X>
   std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(X)> operator()(const X& object) {
-    rapidjson::Value serialized_object;
-    json_stringifier_.Inner(&serialized_object, object);
+    JSONWriter& writer = json_stringifier_.Writer();
+    writer.StartObject();
 
-    using namespace ::current::reflection;
-    rapidjson::Value serialized_type_id;
-    json_stringifier_.Inner(&serialized_type_id, Value<ReflectedTypeBase>(Reflector().ReflectType<X>()).type_id);
-
-    json_stringifier_.Current().SetObject();
-
-    json_stringifier_.Current().AddMember(
-        rapidjson::StringRef(reflection::CurrentTypeName<X, reflection::NameFormat::Z>()),
-        std::move(serialized_object.Move()),
-        json_stringifier_.Allocator());
+    writer.Key(reflection::CurrentTypeName<X, reflection::NameFormat::Z>());
+    Serialize(json_stringifier_, object);
 
     if (json::JSONVariantTypeIDInEmptyKey<JSON_FORMAT>::value) {
-      json_stringifier_.Current().AddMember("", std::move(serialized_type_id.Move()), json_stringifier_.Allocator());
+      using namespace ::current::reflection;
+      writer.Key("");
+      Serialize(json_stringifier_, Value<ReflectedTypeBase>(Reflector().ReflectType<X>()).type_id);
     }
     if (json::JSONVariantTypeNameInDollarKey<JSON_FORMAT>::value) {
-      json_stringifier_.Current().AddMember(
-          "$",
-          rapidjson::StringRef(reflection::CurrentTypeName<X, reflection::NameFormat::Z>()),
-          json_stringifier_.Allocator());
+      writer.Key("$");
+      writer.String(reflection::CurrentTypeName<X, reflection::NameFormat::Z>());
     }
+
+    writer.EndObject();
   }
 
  private:
@@ -104,24 +98,20 @@ class JSONVariantSerializer<json::JSONVariantStyle::NewtonsoftFSharp, JSON_FORMA
 
   template <typename X>
   std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(X)> operator()(const X& object) {
-    rapidjson::Value serialized_object;
-    json_stringifier_.Inner(&serialized_object, object);
+    JSONWriter& writer = json_stringifier_.Writer();
+    writer.StartObject();
 
-    json_stringifier_.Current().SetObject();
-    json_stringifier_.Current().AddMember(
-        "Case",
-        rapidjson::StringRef(reflection::CurrentTypeName<X, reflection::NameFormat::Z>()),
-        json_stringifier_.Allocator());
+    writer.Key("Case");
+    writer.String(reflection::CurrentTypeName<X, reflection::NameFormat::Z>());
 
     if (IS_CURRENT_VARIANT(X) || !IS_EMPTY_CURRENT_STRUCT(X)) {
-      rapidjson::Value fields_as_array;
-      fields_as_array.SetArray();
-      fields_as_array.PushBack(std::move(serialized_object.Move()), json_stringifier_.Allocator());
-
-      json_stringifier_.Current().AddMember(std::move(rapidjson::Value("Fields", json_stringifier_.Allocator()).Move()),
-                                            std::move(fields_as_array.Move()),
-                                            json_stringifier_.Allocator());
+      writer.Key("Fields");
+      writer.StartArray();
+      Serialize(json_stringifier_, object);
+      writer.EndArray();
     }
+
+    writer.EndObject();
   }
 
  private:
@@ -141,9 +131,10 @@ class JSONVariantCaseGeneric : public JSONVariantCaseAbstractBase<JSON_FORMAT> {
   explicit JSONVariantCaseGeneric(const char* key_name) : key_name_(key_name) {}
 
   void Deserialize(JSONParser<JSON_FORMAT>& json_parser, IHasUncheckedMoveFromUniquePtr& destination) override {
-    if (json_parser && json_parser.Current().HasMember(key_name_)) {
+    JSONTapeEntry* value = json_parser ? json_parser.FindMember(key_name_) : nullptr;
+    if (value) {
       auto result = std::make_unique<T>();
-      json_parser.Inner(&json_parser.Current()[key_name_], *result, "[\"", key_name_, "\"]");
+      json_parser.Inner(value, *result, "[\"", key_name_, "\"]");
       destination.UncheckedMoveFromUniquePtr(std::move(result));
     } else if (!JSONPatchMode<JSON_FORMAT>::value) {
       // LCOV_EXCL_START
@@ -163,7 +154,7 @@ class JSONVariantCaseMinimalistic : public JSONVariantCaseAbstractBase<JSON_FORM
 
   void Deserialize(JSONParser<JSON_FORMAT>& json_parser, IHasUncheckedMoveFromUniquePtr& destination) override {
     auto result = std::make_unique<T>();
-    json_parser.Inner(&json_parser.Current()[key_name_], *result, "[\"", key_name_, "\"]");
+    json_parser.Inner(json_parser.FindMember(key_name_), *result, "[\"", key_name_, "\"]");
     destination.UncheckedMoveFromUniquePtr(std::move(result));
   }
 
@@ -175,11 +166,11 @@ template <typename T, typename JSON_FORMAT>
 class JSONVariantCaseFSharp : public JSONVariantCaseAbstractBase<JSON_FORMAT> {
  public:
   void Deserialize(JSONParser<JSON_FORMAT>& json_parser, IHasUncheckedMoveFromUniquePtr& destination) override {
-    if (json_parser.Current().HasMember("Fields")) {
-      rapidjson::Value& fields = json_parser.Current()["Fields"];
-      if (fields.IsArray() && fields.Size() == 1u) {
+    JSONTapeEntry* fields = json_parser.FindMember("Fields");
+    if (fields) {
+      if (fields->value.IsArray() && fields->size == 1u) {
         auto result = std::make_unique<T>();
-        json_parser.Inner(&fields[static_cast<rapidjson::SizeType>(0)], *result, ".", "Fields[0]");
+        json_parser.Inner(fields + 1, *result, ".", "Fields[0]");
         destination.UncheckedMoveFromUniquePtr(std::move(result));
       } else {
         // No PATCH for F#. -- D.K.
@@ -262,8 +253,9 @@ class JSONVariantPerStyle<JSONVariantStyle::Current, JSON_FORMAT, VARIANT> {
     void DoLoadVariant(JSONParser<JSON_FORMAT>& json_parser, VARIANT& destination) const {
       if (json_parser && json_parser.Current().IsObject()) {
         reflection::TypeID type_id;
-        if (json_parser.Current().HasMember("")) {
-          json_parser.Inner(&json_parser.Current()[""], type_id, "[\"\"]");
+        JSONTapeEntry* type_id_value = json_parser.FindMember("");
+        if (type_id_value) {
+          json_parser.Inner(type_id_value, type_id, "[\"\"]");
           const auto cit = deserializers_.find(type_id);
           if (cit != deserializers_.end()) {
             cit->second->Deserialize(json_parser, destination);
@@ -308,18 +300,18 @@ class JSONVariantPerStyle<JSONVariantStyle::Simple, JSON_FORMAT, VARIANT> {
     void DoLoadVariant(JSONParser<JSON_FORMAT>& json_parser, VARIANT& destination) const {
       if (json_parser && json_parser.Current().IsObject()) {
         std::string case_name = "";
-        rapidjson::Value* value = nullptr;
-        for (auto cit = json_parser.Current().MemberBegin(); cit != json_parser.Current().MemberEnd(); ++cit) {
-          if (!cit->name.IsString()) {
+        JSONTapeEntry* value = nullptr;
+        json_parser.ForEachMember([&](JSONTapeEntry* key_entry, JSONTapeEntry* value_entry) {
+          if (!key_entry->value.IsString()) {
             // Should never happen, just a sanity check. -- D.K.
             throw JSONSchemaException("key name as string", json_parser);  // LCOV_EXCL_LINE
           }
-          const std::string key = cit->name.GetString();
+          const std::string key = key_entry->value.GetString();
           // Skip keys "" and "$" for "backwards" compatibility with the "Current" format.
           if (!key.empty() && key != "$") {
             if (!value) {
               case_name = key;
-              value = &cit->value;
+              value = value_entry;
             } else {
               // LCOV_EXCL_START
               throw JSONSchemaException(std::string("no other key after `") + case_name + "`, seeing `" + key + "`",
@@ -327,9 +319,12 @@ class JSONVariantPerStyle<JSONVariantStyle::Simple, JSON_FORMAT, VARIANT> {
               // LCOV_EXCL_STOP
             }
           }
-        }
+        });
         if (!value) {
-          throw JSONSchemaException("a key-value entry with a variant type", json_parser);  // LCOV_EXCL_LINE
+          // When patching, the case may have been left out by `JSONFieldsProjection`; then keep the `Variant` as is.
+          if (!JSONPatchMode<JSON_FORMAT>::value) {
+            throw JSONSchemaException("a key-value entry with a variant type", json_parser);  // LCOV_EXCL_LINE
+          }
         } else {
           const auto cit = deserializers_.find(case_name);
           if (cit != deserializers_.end()) {
@@ -371,16 +366,17 @@ class JSONVariantPerStyle<JSONVariantStyle::NewtonsoftFSharp, JSON_FORMAT, VARIA
 
     void DoLoadVariant(JSONParser<JSON_FORMAT>& json_parser, VARIANT& destination) const {
       if (json_parser && json_parser.Current().IsObject()) {
-        if (json_parser.Current().HasMember("Case")) {
+        JSONTapeEntry* case_value = json_parser.FindMember("Case");
+        if (case_value) {
           std::string case_name;
-          json_parser.Inner(&json_parser.Current()["Case"], case_name, ".", "Case");
+          json_parser.Inner(case_value, case_name, ".", "Case");
           const auto cit = deserializers_.find(case_name);
           if (cit != deserializers_.end()) {
             cit->second->Deserialize(json_parser, destination);
           } else {
             throw JSONSchemaException("one of requested values of \"Case\"", json_parser);  // LCOV_EXCL_LINE
           }
-        } else {
+        } else if (!JSONPatchMode<JSON_FORMAT>::value) {
           throw JSONSchemaException("a type name in \"Case\"", json_parser);  // LCOV_EXCL_LINE
         }
       } else if (!JSONPatchMode<JSON_FORMAT>::value || (json_parser && !json_parser.Current().IsObject())) {
@@ -410,7 +406,7 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, T, std::enable_if_t<IS_
       value.Call(impl);
     } else {
       if (json::JSONVariantStyleUseNulls<JSON_FORMAT::variant_style>::value) {
-        json_stringifier.Current().SetNull();
+        json_stringifier.Writer().Null();
       } else {
         json_stringifier.MarkAsAbsentValue();
       }
@@ -422,7 +418,9 @@ template <class JSON_FORMAT, typename T>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, T& value) {
     if (!json_parser || json_parser.Current().IsNull()) {
-      if (json::JSONVariantStyleUseNulls<JSON_FORMAT::variant_style>::value) {
+      // The `Variant` missing from the input is left as is when patching.
+      if (json::JSONVariantStyleUseNulls<JSON_FORMAT::variant_style>::value &&
+          !(json::JSONPatchMode<JSON_FORMAT>::value && !json_parser)) {
         throw JSONUninitializedVariantObjectException();
       }
     } else {
@@ -36,12 +36,11 @@ namespace serialization {
 template <class JSON_FORMAT, typename T>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::vector<T>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const std::vector<T>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.Writer().StartArray();
     for (const auto& element : value) {
-      rapidjson::Value element_to_push;
-      json_stringifier.Inner(&element_to_push, element);
-      json_stringifier.Current().PushBack(std::move(element_to_push.Move()), json_stringifier.Allocator());
+      Serialize(json_stringifier, element);
     }
+    json_stringifier.Writer().EndArray();
   }
 };
 
@@ -49,11 +48,10 @@ template <class JSON_FORMAT, typename TT, typename TA>
 struct DeserializeImpl<json::JSONParser<JSON_FORMAT>, std::vector<TT, TA>> {
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, std::vector<TT, TA>& destination) {
     if (json_parser && json_parser.Current().IsArray()) {
-      const size_t size = json_parser.Current().Size();
-      destination.resize(size);
-      for (rapidjson::SizeType i = 0; i < static_cast<rapidjson::SizeType>(size); ++i) {
-        json_parser.Inner(&json_parser.Current()[i], destination[i], "[", static_cast<int>(i), "]");
-      }
+      destination.resize(json_parser.Size());
+      json_parser.ForEachElement([&](json::JSONTapeEntry* element, size_t i) {
+        json_parser.Inner(element, destination[i], "[", static_cast<int>(i), "]");
+      });
     } else if (!json::JSONPatchMode<JSON_FORMAT>::value || (json_parser && !json_parser.Current().IsArray())) {
       throw JSONSchemaException("array", json_parser);  // LCOV_EXCL_LINE
     }
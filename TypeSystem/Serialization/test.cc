@@ -28,6 +28,7 @@ SOFTWARE.
 #define CURRENT_TYPE_SYSTEM_SERIALIZATION_TEST_CC
 
 #include "binary.h"
+#include "columnar.h"
 #include "json.h"
 
 #include "../struct.h"
@@ -88,6 +89,11 @@ using simple_variant_t = Variant<Empty, AlternativeEmpty, Serializable, ComplexS
 
 CURRENT_STRUCT(ContainsVariant) { CURRENT_FIELD(variant, simple_variant_t); };
 
+CURRENT_STRUCT(NameAndVariant) {
+  CURRENT_FIELD(name, std::string);
+  CURRENT_FIELD(v, simple_variant_t);
+};
+
 CURRENT_STRUCT(DerivedSerializable, Serializable) { CURRENT_FIELD(d, double); };
 
 CURRENT_STRUCT(WithVectorOfPairs) { CURRENT_FIELD(v, (std::vector<std::pair<int32_t, std::string>>)); };
@@ -118,6 +124,39 @@ CURRENT_STRUCT(WithTime) {
   CURRENT_FIELD(micros, std::chrono::microseconds, std::chrono::microseconds(0));
 };
 
+CURRENT_STRUCT(WithPrimitives) {
+  CURRENT_FIELD(b, bool, false);
+  CURRENT_FIELD(c, char, 'x');
+  CURRENT_FIELD(u8, uint8_t, 0u);
+  CURRENT_FIELD(i8, int8_t, 0);
+  CURRENT_FIELD(u16, uint16_t, 0u);
+  CURRENT_FIELD(i16, int16_t, 0);
+  CURRENT_FIELD(u32, uint32_t, 0u);
+  CURRENT_FIELD(i32, int32_t, 0);
+  CURRENT_FIELD(u64, uint64_t, 0u);
+  CURRENT_FIELD(i64, int64_t, 0);
+  CURRENT_FIELD(f, float, 0.0f);
+  CURRENT_FIELD(d, double, 0.0);
+  CURRENT_FIELD(s, std::string);
+  CURRENT_FIELD(ms, std::chrono::milliseconds, std::chrono::milliseconds(0));
+  CURRENT_FIELD(e, Enum, Enum::DEFAULT);
+};
+
+// Two versions of the same record, the latter with a field appended.
+CURRENT_STRUCT(RecordV1) {
+  CURRENT_FIELD(a, int32_t, 0);
+  CURRENT_FIELD(b, std::string);
+};
+
+CURRENT_STRUCT(RecordV2) {
+  CURRENT_FIELD(a, int32_t, 0);
+  CURRENT_FIELD(b, std::string);
+  CURRENT_FIELD(c, (std::vector<std::string>));
+};
+
+CURRENT_STRUCT(RecordsV1) { CURRENT_FIELD(records, std::vector<RecordV1>); };
+CURRENT_STRUCT(RecordsV2) { CURRENT_FIELD(records, std::vector<RecordV2>); };
+
 static_assert(current::serialization::json::IsJSONSerializable<int>::value, "");
 static_assert(current::serialization::json::IsJSONSerializable<std::string>::value, "");
 static_assert(current::serialization::json::IsJSONSerializable<bool>::value, "");
@@ -166,8 +205,6 @@ CURRENT_STRUCT(WithInnerVariant) { CURRENT_FIELD(v, InnerVariant); };
 }  // namespace serialization_test::named_variant
 }  // namespace serialization_test
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, Binary) {
   using namespace serialization_test;
 
@@ -238,7 +275,6 @@ TEST(Serialization, Binary) {
     ASSERT_THROW(LoadFromBinary<ComplexSerializable>(is), BinaryLoadFromStreamException);
   }
 }
-#endif
 
 TEST(JSONSerialization, CPPTypes) {
   // `bool`.
@@ -316,8 +352,6 @@ TEST(JSONSerialization, CPPTypes) {
   }
 }
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, OptionalAsBinary) {
   using namespace serialization_test;
 
@@ -360,7 +394,6 @@ TEST(Serialization, OptionalAsBinary) {
     EXPECT_TRUE(Value(parsed_with_b.b));
   }
 }
-#endif
 
 TEST(JSONSerialization, CurrentStructs) {
   using namespace serialization_test;
@@ -829,8 +862,6 @@ TEST(JSONSerialization, Time) {
   }
 }
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, TimeAsBinary) {
   using namespace serialization_test;
 
@@ -838,7 +869,7 @@ TEST(Serialization, TimeAsBinary) {
     WithTime zero;
     std::ostringstream oss;
     SaveIntoBinary(oss, zero);
-    EXPECT_EQ(16u, oss.str().length());
+    EXPECT_EQ(5u, oss.str().length());
   }
 
   {
@@ -853,7 +884,221 @@ TEST(Serialization, TimeAsBinary) {
     EXPECT_EQ(6ll, parsed.micros.count());
   }
 }
-#endif
+
+TEST(Serialization, BinaryPrimitives) {
+  using namespace serialization_test;
+
+  {
+    WithPrimitives zero;
+    zero.c = '\0';
+    const std::string binary = Binary(zero);
+    // Two bytes for the length and the number of fields, one per each varint and byte, and 4 + 8 for floats.
+    EXPECT_EQ(2u + 13u + 4u + 8u, binary.length());
+    EXPECT_EQ(JSON(zero), JSON(ParseBinary<WithPrimitives>(binary)));
+  }
+
+  {
+    WithPrimitives min;
+    min.b = true;
+    min.c = '\xff';
+    min.u8 = 0u;
+    min.i8 = std::numeric_limits<int8_t>::min();
+    min.u16 = 0u;
+    min.i16 = std::numeric_limits<int16_t>::min();
+    min.u32 = 0u;
+    min.i32 = std::numeric_limits<int32_t>::min();
+    min.u64 = 0u;
+    min.i64 = std::numeric_limits<int64_t>::min();
+    min.f = -std::numeric_limits<float>::max();
+    min.d = -std::numeric_limits<double>::max();
+    min.s = std::string("\0\n\xff", 3u);
+    min.ms = std::chrono::milliseconds(-1);
+    min.e = Enum::SET;
+    const auto parsed = ParseBinary<WithPrimitives>(Binary(min));
+    EXPECT_EQ(JSON(min), JSON(parsed));
+    EXPECT_EQ(3u, parsed.s.length());
+  }
+
+  {
+    WithPrimitives max;
+    max.u8 = std::numeric_limits<uint8_t>::max();
+    max.i8 = std::numeric_limits<int8_t>::max();
+    max.u16 = std::numeric_limits<uint16_t>::max();
+    max.i16 = std::numeric_limits<int16_t>::max();
+    max.u32 = std::numeric_limits<uint32_t>::max();
+    max.i32 = std::numeric_limits<int32_t>::max();
+    max.u64 = std::numeric_limits<uint64_t>::max();
+    max.i64 = std::numeric_limits<int64_t>::max();
+    max.f = std::numeric_limits<float>::denorm_min();
+    max.d = 0.1;
+    max.s = std::string(1000u, 'z');
+    max.ms = std::chrono::milliseconds(1500000000000ll);
+    const auto parsed = ParseBinary<WithPrimitives>(Binary(max));
+    EXPECT_EQ(JSON(max), JSON(parsed));
+    EXPECT_EQ(0.1, parsed.d);
+    EXPECT_EQ(std::numeric_limits<float>::denorm_min(), parsed.f);
+  }
+
+  // Raw values, not only structs.
+  EXPECT_EQ(1u, Binary(static_cast<uint64_t>(127u)).length());
+  EXPECT_EQ(2u, Binary(static_cast<uint64_t>(128u)).length());
+  EXPECT_EQ(1u, Binary(static_cast<int64_t>(-64)).length());
+  EXPECT_EQ(10u, Binary(std::numeric_limits<uint64_t>::max()).length());
+  EXPECT_EQ(std::string("\x03" "foo"), Binary(std::string("foo")));
+  EXPECT_EQ(-42, ParseBinary<int32_t>(Binary(-42)));
+  EXPECT_EQ("bar", ParseBinary<std::string>(Binary(std::string("bar"))));
+}
+
+TEST(Serialization, BinaryContainers) {
+  using namespace serialization_test;
+
+  {
+    WithVectorOfPairs object;
+    object.v.emplace_back(-1, "minus one");
+    object.v.emplace_back(100500, "");
+    EXPECT_EQ(JSON(object), JSON(ParseBinary<WithVectorOfPairs>(Binary(object))));
+  }
+  {
+    WithTrivialMap object;
+    object.m["one"] = "1";
+    object.m["two"] = "2";
+    EXPECT_EQ(JSON(object), JSON(ParseBinary<WithTrivialMap>(Binary(object))));
+  }
+  {
+    WithNontrivialUnorderedMap object;
+    object.q[Serializable(1, "one", false, Enum::DEFAULT)] = "1";
+    object.q[Serializable(2, "two", true, Enum::SET)] = "2";
+    const auto parsed = ParseBinary<WithNontrivialUnorderedMap>(Binary(object));
+    ASSERT_EQ(2u, parsed.q.size());
+    EXPECT_EQ("1", parsed.q.at(Serializable(1)));
+    EXPECT_EQ("2", parsed.q.at(Serializable(2)));
+  }
+  {
+    WithTrivialSet object;
+    object.s.insert("foo");
+    object.s.insert("bar");
+    EXPECT_EQ(JSON(object), JSON(ParseBinary<WithTrivialSet>(Binary(object))));
+  }
+  {
+    WithNontrivialUnorderedSet object;
+    object.s.insert(Serializable(1, "one", false, Enum::DEFAULT));
+    object.s.insert(Serializable(2, "two", true, Enum::SET));
+    const auto parsed = ParseBinary<WithNontrivialUnorderedSet>(Binary(object));
+    ASSERT_EQ(2u, parsed.s.size());
+    EXPECT_EQ(1u, parsed.s.count(Serializable(1)));
+    EXPECT_EQ(1u, parsed.s.count(Serializable(2)));
+  }
+  {
+    ComplexSerializable object('a', 'z');
+    object.j = 1u;
+    object.q = "q";
+    object.z = Serializable(2, "two", true, Enum::SET);
+    const std::string binary = Binary(object);
+    EXPECT_EQ(JSON(object), JSON(ParseBinary<ComplexSerializable>(binary)));
+    EXPECT_LT(binary.length() * 2u, JSON(object).length());
+  }
+}
+
+TEST(Serialization, BinaryVariant) {
+  using namespace serialization_test;
+
+  {
+    ContainsVariant object;
+    object.variant = Serializable(42, "answer", true, Enum::SET);
+    const auto parsed = ParseBinary<ContainsVariant>(Binary(object));
+    ASSERT_TRUE(Exists<Serializable>(parsed.variant));
+    EXPECT_EQ(JSON(object), JSON(parsed));
+  }
+  {
+    ContainsVariant object;
+    object.variant = ComplexSerializable('x', 'z');
+    const auto parsed = ParseBinary<ContainsVariant>(Binary(object));
+    ASSERT_TRUE(Exists<ComplexSerializable>(parsed.variant));
+    EXPECT_EQ(JSON(object), JSON(parsed));
+  }
+  {
+    ContainsVariant object;
+    object.variant = Empty();
+    const auto parsed = ParseBinary<ContainsVariant>(Binary(object));
+    EXPECT_TRUE(Exists<Empty>(parsed.variant));
+    EXPECT_FALSE(Exists<AlternativeEmpty>(parsed.variant));
+  }
+  {
+    named_variant::WithInnerVariant object;
+    object.v = WithOptional();
+    Value<WithOptional>(object.v).i = 42;
+    const auto parsed = ParseBinary<named_variant::WithInnerVariant>(Binary(object));
+    ASSERT_TRUE(Exists<WithOptional>(parsed.v));
+    EXPECT_EQ(42, Value(Value<WithOptional>(parsed.v).i));
+    EXPECT_FALSE(Exists(Value<WithOptional>(parsed.v).b));
+  }
+#ifndef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
+  {
+    const named_variant::NestedQ object = named_variant::InnerB(named_variant::T());
+    const auto parsed = ParseBinary<named_variant::NestedQ>(Binary(object));
+    EXPECT_EQ(JSON(object), JSON(parsed));
+  }
+#endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
+
+  // An uninitialized `Variant` can be serialized, but not parsed back.
+  ASSERT_THROW(ParseBinary<ContainsVariant>(Binary(ContainsVariant())), BinaryUninitializedVariantObjectException);
+
+  // A case missing from the type list.
+  {
+    Variant<Empty, Serializable> object(Serializable(1));
+    ASSERT_THROW((ParseBinary<Variant<Empty, AlternativeEmpty>>(Binary(object))), BinarySchemaException);
+  }
+}
+
+TEST(Serialization, BinarySkipUnknownFields) {
+  using namespace serialization_test;
+
+  RecordsV2 v2;
+  for (int32_t i = 0; i < 3; ++i) {
+    RecordV2 record;
+    record.a = i;
+    record.b = current::ToString(i);
+    record.c.assign(static_cast<size_t>(i) * 100u, "extra");
+    v2.records.push_back(record);
+  }
+  const std::string v2_binary = Binary(v2);
+
+  ASSERT_THROW(ParseBinary<RecordsV1>(v2_binary), BinarySchemaException);
+  {
+    const auto v1 = ParseBinary<RecordsV1, BinaryDecoding::SkipUnknownFields>(v2_binary);
+    ASSERT_EQ(3u, v1.records.size());
+    for (int32_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(i, v1.records[i].a);
+      EXPECT_EQ(current::ToString(i), v1.records[i].b);
+    }
+    const auto v2_from_v1 = ParseBinary<RecordsV2, BinaryDecoding::SkipUnknownFields>(Binary(v1));
+    ASSERT_EQ(3u, v2_from_v1.records.size());
+    for (int32_t i = 0; i < 3; ++i) {
+      EXPECT_EQ(i, v2_from_v1.records[i].a);
+      EXPECT_EQ(current::ToString(i), v2_from_v1.records[i].b);
+      EXPECT_TRUE(v2_from_v1.records[i].c.empty());
+    }
+    ASSERT_THROW(ParseBinary<RecordsV2>(Binary(v1)), BinarySchemaException);
+  }
+}
+
+TEST(Serialization, BinaryMalformedInput) {
+  using namespace serialization_test;
+
+  const std::string binary = Binary(ComplexSerializable('a', 'c'));
+  for (size_t length = 0u; length < binary.length(); ++length) {
+    ASSERT_THROW(ParseBinary<ComplexSerializable>(binary.substr(0u, length)), BinaryLoadFromStreamException);
+  }
+  ASSERT_THROW(ParseBinary<ComplexSerializable>(binary + '\0'), BinaryLoadFromStreamException);
+
+  // A container claiming more elements than there are bytes.
+  ASSERT_THROW(ParseBinary<std::vector<std::string>>(Binary(static_cast<uint64_t>(1000000000u))),
+               BinaryLoadFromStreamException);
+
+  // An integer too large for the destination type.
+  ASSERT_THROW(ParseBinary<uint16_t>(Binary(static_cast<uint32_t>(65536u))), BinarySchemaException);
+  ASSERT_THROW(ParseBinary<int8_t>(Binary(std::string("xx"))), BinaryLoadFromStreamException);
+}
 
 TEST(JSONSerialization, Optional) {
   using namespace serialization_test;
@@ -1502,4 +1747,357 @@ TEST(JSONSerialization, IntegerZeroIsADouble) {
   EXPECT_EQ(0, ParseJSON<Float>(JSON(Int())).x);
 }
 
+TEST(JSONSerialization, KeysInAnyOrder) {
+  using namespace serialization_test;
+
+  {
+    const auto parsed = ParseJSON<DerivedSerializable>(
+        "{\"d\":0.5,\"unknown\":{\"b\":[1,{\"i\":2}]},\"e\":0,\"b\":true,\"s\":\"foo\",\"i\":42}");
+    EXPECT_EQ(42ull, parsed.i);
+    EXPECT_EQ("foo", parsed.s);
+    EXPECT_TRUE(parsed.b);
+    EXPECT_EQ(0.5, parsed.d);
+  }
+
+  {
+    // As with the DOM, the first of the duplicate keys wins.
+    const auto parsed = ParseJSON<Int>("{\"x\":1,\"x\":2}");
+    EXPECT_EQ(1, parsed.x);
+  }
+
+  {
+    const auto parsed = ParseJSON<ComplexSerializable>(
+        "{\"z\":{\"e\":0,\"b\":false,\"s\":\"\",\"i\":1},\"v\":[\"a\",\"b\"],\"q\":\"q\",\"j\":2}");
+    EXPECT_EQ(2ull, parsed.j);
+    EXPECT_EQ("q", parsed.q);
+    EXPECT_EQ("a,b", current::strings::Join(parsed.v, ','));
+    EXPECT_EQ(1ull, parsed.z.i);
+  }
+
+  try {
+    ParseJSON<ComplexSerializable>(
+        "{\"z\":{\"e\":0,\"b\":false,\"i\":1,\"s\":[1,{\"x\":null}]},\"v\":[],\"q\":\"q\",\"j\":2}");
+    ASSERT_TRUE(false);
+  } catch (const JSONSchemaException& e) {
+    EXPECT_EQ(std::string("Expected string for `z.s`, got: [1,{\"x\":null}]"), e.OriginalDescription());
+  }
+}
+
+TEST(JSONSerialization, ParseJSONFields) {
+  using namespace serialization_test;
+
+  {
+    ComplexSerializable parsed;
+    parsed.j = 42u;
+    ParseJSONFields(
+        "{\"j\":1,\"q\":\"q\",\"v\":[\"a\",{\"b\":[]}],\"z\":{\"i\":2,\"s\":\"s\",\"b\":true,\"e\":0}}",
+        parsed,
+        JSONFieldsProjection({"q", "z.i"}));
+    EXPECT_EQ(42ull, parsed.j);
+    EXPECT_EQ("q", parsed.q);
+    EXPECT_TRUE(parsed.v.empty());
+    EXPECT_EQ(2ull, parsed.z.i);
+    EXPECT_EQ("", parsed.z.s);
+  }
+
+  {
+    // The paths selecting the whole value prevail, and the fields of the base struct can be selected too.
+    DerivedSerializable parsed;
+    parsed.s = "untouched";
+    ParseJSONFields("{\"i\":1,\"s\":\"s\",\"b\":true,\"e\":0,\"d\":0.5}",
+                    parsed,
+                    JSONFieldsProjection({"d", "d.x"}).Add("i"));
+    EXPECT_EQ(1ull, parsed.i);
+    EXPECT_EQ("untouched", parsed.s);
+    EXPECT_EQ(0.5, parsed.d);
+  }
+
+  {
+    // The paths go through the arrays and the `Variant`-s.
+    RecordsV2 records;
+    records.records.resize(2u);
+    records.records[0].a = 1;
+    records.records[0].b = "one";
+    records.records[1].a = 2;
+    records.records[1].c.push_back("two");
+    const auto parsed = ParseJSONFields<RecordsV2>(JSON(records), JSONFieldsProjection({"records.a"}));
+    ASSERT_EQ(2u, parsed.records.size());
+    EXPECT_EQ(1, parsed.records[0].a);
+    EXPECT_EQ("", parsed.records[0].b);
+    EXPECT_EQ(2, parsed.records[1].a);
+    EXPECT_TRUE(parsed.records[1].c.empty());
+
+    ContainsVariant with_variant;
+    with_variant.variant = Serializable(42, "foo", true, Enum::SET);
+    const auto parsed_variant =
+        ParseJSONFields<ContainsVariant>(JSON(with_variant), JSONFieldsProjection({"variant.Serializable.s"}));
+    EXPECT_EQ("foo", Value<Serializable>(parsed_variant.variant).s);
+  }
+
+  {
+    // The `Variant`-s not selected, or holding a case other than the selected one, are left as is.
+    NameAndVariant input;
+    input.name = "input";
+    input.v = ComplexSerializable('a', 'c');
+    const auto Check = [](const NameAndVariant& parsed, const std::string& name) {
+      EXPECT_EQ(name, parsed.name);
+      EXPECT_EQ("untouched", Value<Serializable>(parsed.v).s);
+    };
+    NameAndVariant parsed;
+    parsed.v = Serializable(1, "untouched", false, Enum::DEFAULT);
+
+    ParseJSONFields(JSON(input), parsed, JSONFieldsProjection({"name"}));
+    Check(parsed, "input");
+
+    parsed.name = "";
+    ParseJSONFields(JSON(input), parsed, JSONFieldsProjection({"v.Serializable.s"}));
+    Check(parsed, "");
+    ParseJSONFields<NameAndVariant, JSONFormat::Minimalistic>(
+        JSON<JSONFormat::Minimalistic>(input), parsed, JSONFieldsProjection({"v.Serializable.s"}));
+    Check(parsed, "");
+    ParseJSONFields<NameAndVariant, JSONFormat::NewtonsoftFSharp>(
+        JSON<JSONFormat::NewtonsoftFSharp>(input), parsed, JSONFieldsProjection({"v.Serializable.s"}));
+    Check(parsed, "");
+
+    ParseJSONFields<NameAndVariant, JSONFormat::Minimalistic>(
+        JSON<JSONFormat::Minimalistic>(input), parsed, JSONFieldsProjection({"name"}));
+    Check(parsed, "input");
+    parsed.name = "";
+    ParseJSONFields<NameAndVariant, JSONFormat::NewtonsoftFSharp>(
+        JSON<JSONFormat::NewtonsoftFSharp>(input), parsed, JSONFieldsProjection({"name"}));
+    Check(parsed, "input");
+  }
+
+  {
+    // The compile-time projection: only the fields of the "view" type are parsed.
+    RecordsV2 records;
+    records.records.resize(1u);
+    records.records[0].a = 3;
+    records.records[0].b = "three";
+    records.records[0].c.assign(1000u, "skipped");
+    const auto parsed = ParseJSONFields<RecordsV1>(JSON(records), JSONFieldsProjectionOf<RecordsV1>());
+    EXPECT_EQ("{\"records\":[{\"a\":3,\"b\":\"three\"}]}", JSON(parsed));
+  }
+
+  // The values not selected are still validated.
+  EXPECT_THROW(ParseJSONFields<Int>("{\"x\":1,\"y\":[}", JSONFieldsProjection({"x"})), InvalidJSONException);
+}
+
+TEST(JSONSerialization, ParseJSONLines) {
+  using namespace serialization_test;
+
+  const std::string tmp_file = current::FileSystem::GenTmpFileName();
+  const auto tmp_file_remover = current::FileSystem::ScopedRmFile(tmp_file);
+
+  // Large enough to be split into chunks, and parsed by more than one thread.
+  const size_t n = 100000u;
+  {
+    std::string contents;
+    for (size_t i = 0u; i < n; ++i) {
+      RecordV1 record;
+      record.a = static_cast<int32_t>(i);
+      record.b = std::string(i % 20u, 'x');
+      JSONAppend(contents, record);
+      contents += (i % 3u) ? "\n" : "\r\n";
+      if (i % 1000u == 999u) {
+        contents += '\n';
+      }
+    }
+    current::FileSystem::WriteStringToFile(contents, tmp_file.c_str());
+  }
+
+  {
+    const std::vector<RecordV1> parsed = ParseJSONLines<RecordV1>(tmp_file, 4u);
+    ASSERT_EQ(n, parsed.size());
+    bool all_match = true;
+    for (size_t i = 0u; i < n; ++i) {
+      all_match &= (parsed[i].a == static_cast<int32_t>(i) && parsed[i].b.length() == i % 20u);
+    }
+    EXPECT_TRUE(all_match);
+  }
+
+  {
+    size_t count = 0u;
+    int32_t last = -1;
+    ParseJSONLines<RecordV1>(tmp_file, [&](RecordV1&& record) {
+      EXPECT_EQ(last + 1, record.a);
+      last = record.a;
+      ++count;
+    });
+    EXPECT_EQ(n, count);
+  }
+
+  {
+    std::string contents = current::FileSystem::ReadFileAsString(tmp_file);
+    // Break the JSON on the line 50101: there are 50000 records and 50 empty lines before it.
+    contents.insert(contents.find("{\"a\":50050,"), "?");
+    current::FileSystem::WriteStringToFile(contents, tmp_file.c_str());
+    try {
+      ParseJSONLines<RecordV1>(tmp_file, 4u);
+      ASSERT_TRUE(false);
+    } catch (const InvalidJSONLineException& e) {
+      EXPECT_EQ(50101u, e.line_number);
+      EXPECT_EQ("Line 50101: ?{", e.OriginalDescription().substr(0u, 14u));
+    }
+    // The entries of all the lines before the invalid one are handed over first, including those of its chunk.
+    size_t count = 0u;
+    EXPECT_THROW(ParseJSONLines<RecordV1>(tmp_file, [&count](RecordV1&&) { ++count; }, 4u), InvalidJSONLineException);
+    EXPECT_EQ(50050u, count);
+  }
+
+  current::FileSystem::WriteStringToFile("", tmp_file.c_str());
+  EXPECT_TRUE(ParseJSONLines<RecordV1>(tmp_file).empty());
+
+  EXPECT_THROW(ParseJSONLines<RecordV1>(tmp_file + ".does_not_exist"), current::CannotReadFileException);
+}
+
+namespace serialization_test {
+
+CURRENT_ENUM(ColumnarColor, uint8_t){Red = 1u, Green = 2u};
+
+CURRENT_STRUCT(ColumnarPoint) {
+  CURRENT_FIELD(x, double, 0.0);
+  CURRENT_FIELD(y, double, 0.0);
+};
+
+CURRENT_STRUCT(ColumnarBase) { CURRENT_FIELD(id, uint64_t, 0u); };
+
+CURRENT_STRUCT(ColumnarRow, ColumnarBase) {
+  CURRENT_FIELD(name, std::string);
+  CURRENT_FIELD(color, ColumnarColor, ColumnarColor::Red);
+  CURRENT_FIELD(when, std::chrono::microseconds, std::chrono::microseconds(0));
+  CURRENT_FIELD(point, ColumnarPoint);
+  CURRENT_FIELD(score, Optional<int32_t>);
+  CURRENT_FIELD(tag, Optional<std::string>);
+  CURRENT_FIELD(flag, bool, false);
+};
+
+CURRENT_STRUCT(ColumnarWithVector) { CURRENT_FIELD(values, std::vector<int32_t>); };
+
+CURRENT_STRUCT(ColumnarWithOptionalStruct) { CURRENT_FIELD(point, Optional<ColumnarPoint>); };
+
+}  // namespace serialization_test
+
+TEST(ColumnarSerialization, Layout) {
+  using namespace serialization_test;
+  using current::serialization::columnar::ColumnarColumn;
+  using current::serialization::columnar::ColumnarLayout;
+
+  std::vector<std::string> names;
+  std::vector<std::string> nullable;
+  for (const ColumnarColumn& column : ColumnarLayout<ColumnarRow>()) {
+    names.push_back(column.name);
+    if (column.nullable) {
+      nullable.push_back(column.name);
+    }
+  }
+  EXPECT_EQ("id name color when point.x point.y score tag flag", current::strings::Join(names, ' '));
+  EXPECT_EQ("score tag", current::strings::Join(nullable, ' '));
+  EXPECT_EQ(current::reflection::CurrentTypeID<uint8_t>(), ColumnarLayout<ColumnarRow>()[2].type_id);
+
+  EXPECT_THROW(ColumnarLayout<ColumnarWithVector>(), ColumnarSchemaException);
+  EXPECT_THROW(ColumnarLayout<ColumnarWithOptionalStruct>(), ColumnarSchemaException);
+}
+
+TEST(ColumnarSerialization, RoundTrip) {
+  using namespace serialization_test;
+
+  const std::vector<std::string> names = {"alpha", "beta", "gamma"};
+  std::vector<ColumnarRow> rows(1000u);
+  for (size_t i = 0u; i < rows.size(); ++i) {
+    ColumnarRow& row = rows[i];
+    row.id = i;
+    row.name = names[i % 3u];
+    row.color = (i & 1u) ? ColumnarColor::Green : ColumnarColor::Red;
+    row.when = std::chrono::microseconds(1000000ll * i);
+    row.point.x = 0.5 * i;
+    row.point.y = -1.0 * i;
+    if (i % 4u) {
+      row.score = static_cast<int32_t>(i) - 500;
+    }
+    if (i % 5u == 0u) {
+      row.tag = "tag" + current::ToString(i % 10u);
+    }
+    row.flag = (i % 7u == 0u);
+  }
+
+  const std::string columnar = Columnar(rows);
+  EXPECT_EQ(JSON(rows), JSON(ParseColumnar<ColumnarRow>(columnar)));
+  EXPECT_TRUE(ParseColumnar<ColumnarRow>(Columnar(std::vector<ColumnarRow>())).empty());
+
+  // The strings are stored once per column, and the numbers take their size, not the length of their JSON.
+  EXPECT_LT(columnar.length() * 2u, JSON(rows).length());
+
+  const std::string tmp_file = current::FileSystem::GenTmpFileName();
+  const auto tmp_file_remover = current::FileSystem::ScopedRmFile(tmp_file);
+  {
+    std::ofstream os(tmp_file, std::ofstream::binary);
+    SaveIntoColumnar(os, rows);
+  }
+
+  const ColumnarFile file(tmp_file);
+  ASSERT_EQ(1000u, file.Rows());
+  EXPECT_EQ(JSON(rows), JSON(file.Parse<ColumnarRow>()));
+
+  const auto id = file.Column<uint64_t>("id");
+  EXPECT_EQ(1000u, id.Size());
+  EXPECT_EQ(42u, id[42]);
+  EXPECT_EQ(999u, id.Data()[999]);
+
+  const auto name = file.Column<std::string>("name");
+  EXPECT_EQ(3u, name.DictionarySize());
+  EXPECT_EQ("beta", std::string(name[4]));
+  EXPECT_EQ(2u, name.Codes()[5]);
+
+  EXPECT_EQ(ColumnarColor::Green, file.Column<ColumnarColor>("color")[3]);
+  EXPECT_EQ(2u, file.Column<uint8_t>("color")[3]);
+  EXPECT_EQ(std::chrono::microseconds(3000000), file.Column<std::chrono::microseconds>("when")[3]);
+  EXPECT_EQ(-3.0, file.Column<double>("point.y")[3]);
+  EXPECT_TRUE(file.Column<bool>("flag")[7]);
+
+  const auto score = file.Column<int32_t>("score");
+  EXPECT_FALSE(score.Exists(4));
+  EXPECT_EQ(0, score[4]);
+  EXPECT_TRUE(score.Exists(5));
+  EXPECT_EQ(-495, score[5]);
+
+  const auto tag = file.Column<std::string>("tag");
+  EXPECT_TRUE(tag.Exists(15));
+  EXPECT_EQ("tag5", std::string(tag[15]));
+  EXPECT_FALSE(tag.Exists(16));
+  EXPECT_EQ(0u, tag[16].length());
+
+  EXPECT_THROW(file.Column<int32_t>("id"), ColumnarSchemaException);
+  EXPECT_THROW(file.Column<int32_t>("point"), ColumnarSchemaException);
+  EXPECT_THROW(file.Parse<ColumnarPoint>(), ColumnarSchemaException);
+
+  EXPECT_THROW(ParseColumnar<ColumnarRow>(JSON(rows)), ColumnarFormatException);
+  EXPECT_THROW(ParseColumnar<ColumnarRow>(columnar.substr(0u, columnar.length() - 100u)), ColumnarFormatException);
+}
+
+TEST(JSONSerialization, JSONAppend) {
+  using namespace serialization_test;
+
+  std::string output = "prefix\t";
+  JSONAppend(output, Int());
+  output += '\t';
+  JSONAppend(output, "foo");
+  output += '\t';
+  JSONAppend<JSONFormat::Minimalistic>(output, ContainsVariant());
+  EXPECT_EQ("prefix\t{\"x\":0}\t\"foo\"\t{}", output);
+
+  // The buffer is reused as is once it is large enough.
+  const std::vector<std::string> object(100u, "foo");
+  const std::string golden = JSON(object);
+  output.clear();
+  output.reserve(golden.length());
+  const char* data = output.data();
+  for (int i = 0; i < 10; ++i) {
+    output.clear();
+    JSONAppend(output, object);
+    EXPECT_EQ(golden, output);
+  }
+  EXPECT_EQ(data, output.data());
+}
+
 #endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_TEST_CC
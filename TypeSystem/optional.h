@@ -38,6 +38,8 @@ SOFTWARE.
 #include "../port.h"  // `make_unique<>`.
 
 #include <memory>
+#include <new>
+#include <type_traits>
 
 #include "types.h"
 #include "exceptions.h"
@@ -253,7 +255,7 @@ class Optional<T, std::enable_if_t<std::is_pod<T>::value>> final {
     return *this;
   }
 
-  Optional<T>& operator=(Optional<T>&& rhs) {
+  Optional<T>& operator=(Optional<T>&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) {
     value_ = rhs.value_;
     exists_ = rhs.exists_;
     rhs.exists_ = false;
@@ -291,78 +293,93 @@ class Optional<T, std::enable_if_t<std::is_pod<T>::value>> final {
   bool exists_;
 };
 
+namespace optional {
+
+// The values of up to this many bytes are kept within the non-POD `Optional` itself, the larger ones are allocated
+// on the heap, for the empty `Optional`-s of large types to not take the space of the value.
+constexpr size_t kInlineObjectSize = 64u;
+
+template <typename T>
+struct StoredInline {
+  constexpr static bool value = sizeof(T) <= kInlineObjectSize;
+};
+
+// The storage for the value kept inline, and nothing, not even a byte, for the values allocated on the heap.
+template <typename T, bool INLINE = StoredInline<T>::value>
+class InlineStorage {
+ protected:
+  T* InlineObject() { return reinterpret_cast<T*>(&inline_object_storage_); }
+  bool IsInlineObject(const T* object) const { return object == reinterpret_cast<const T*>(&inline_object_storage_); }
+
+ private:
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type inline_object_storage_;
+};
+
+template <typename T>
+class InlineStorage<T, false> {
+ protected:
+  bool IsInlineObject(const T*) const { return false; }
+};
+
+}  // namespace optional
+
+// The non-POD `Optional` keeps its value within itself, to not allocate it on the heap, unless the value is large.
+// It can also point to an object it does not own, or own an object allocated on the heap that it has been given.
 template <typename T>
-class Optional<T, std::enable_if_t<!std::is_pod<T>::value>> final {
+class Optional<T, std::enable_if_t<!std::is_pod<T>::value>> final : optional::InlineStorage<T> {
  public:
   Optional() = default;
 
-  Optional(std::nullptr_t) : optional_object_(nullptr) {}
+  Optional(std::nullptr_t) {}
 
   Optional(const FromBarePointer&, T* ptr) : optional_object_(ptr) {}
 
-  Optional(const T& object)
-      : owned_optional_object_(std::make_unique<T>(object)), optional_object_(owned_optional_object_.get()) {}
+  Optional(const T& object) { Construct(object); }
 
-  Optional(T&& object)
-      : owned_optional_object_(std::make_unique<T>(std::move(object))),
-        optional_object_(owned_optional_object_.get()) {}
+  Optional(T&& object) { Construct(std::move(object)); }
 
   Optional(std::unique_ptr<T>&& uptr)
       : owned_optional_object_(std::move(uptr)), optional_object_(owned_optional_object_.get()) {}
 
   Optional(const Optional<T>& rhs) {
     if (rhs.ExistsImpl()) {
-      owned_optional_object_ = std::make_unique<T>(rhs.ValueImpl());
-    } else {
-      owned_optional_object_ = nullptr;
+      Construct(rhs.ValueImpl());
     }
-    optional_object_ = owned_optional_object_.get();
   }
 
-  Optional(Optional<T>&& rhs) {
-    if (rhs.ExistsImpl()) {
-      owned_optional_object_ = std::move(rhs.owned_optional_object_);
-      rhs = nullptr;
-    } else {
-      owned_optional_object_ = nullptr;
-    }
-    optional_object_ = owned_optional_object_.get();
-  }
+  Optional(Optional<T>&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) { MoveFrom(rhs); }
 
   Optional(const ImmutableOptional<T>& rhs) {
     if (rhs.ExistsImpl()) {
-      owned_optional_object_ = std::make_unique<T>(rhs.ValueImpl());
-    } else {
-      owned_optional_object_ = nullptr;
+      Construct(rhs.ValueImpl());
     }
-    optional_object_ = owned_optional_object_.get();
   }
 
+  ~Optional() { Destroy(); }
+
   Optional<T>& operator=(std::nullptr_t) {
-    owned_optional_object_ = nullptr;
-    optional_object_ = nullptr;
+    Destroy();
     return *this;
   }
 
   Optional<T>& operator=(const T& object) {
-    owned_optional_object_ = std::make_unique<T>(object);
-    optional_object_ = owned_optional_object_.get();
+    Assign(object);
     return *this;
   }
 
   Optional<T>& operator=(T&& object) {
-    owned_optional_object_ = std::make_unique<T>(std::move(object));
-    optional_object_ = owned_optional_object_.get();
+    Assign(std::move(object));
     return *this;
   }
 
   Optional<T>& operator=(T* ptr) {
-    owned_optional_object_ = nullptr;
+    Destroy();
     optional_object_ = ptr;
     return *this;
   }
 
   Optional<T>& operator=(std::unique_ptr<T>&& uptr) {
+    Destroy();
     owned_optional_object_ = std::move(uptr);
     optional_object_ = owned_optional_object_.get();
     return *this;
@@ -370,32 +387,27 @@ class Optional<T, std::enable_if_t<!std::is_pod<T>::value>> final {
 
   Optional<T>& operator=(const Optional<T>& rhs) {
     if (rhs.ExistsImpl()) {
-      owned_optional_object_ = std::make_unique<T>(rhs.ValueImpl());
+      operator=(rhs.ValueImpl());
     } else {
-      owned_optional_object_ = nullptr;
+      Destroy();
     }
-    optional_object_ = owned_optional_object_.get();
     return *this;
   }
 
-  Optional<T>& operator=(Optional<T>&& rhs) {
-    if (rhs.ExistsImpl()) {
-      owned_optional_object_ = std::move(rhs.owned_optional_object_);
-      rhs = nullptr;
-    } else {
-      owned_optional_object_ = nullptr;
+  Optional<T>& operator=(Optional<T>&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) {
+    if (&rhs != this) {
+      Destroy();
+      MoveFrom(rhs);
     }
-    optional_object_ = owned_optional_object_.get();
     return *this;
   }
 
   Optional<T>& operator=(const ImmutableOptional<T>& rhs) {
     if (rhs.ExistsImpl()) {
-      owned_optional_object_ = std::make_unique<T>(rhs.ValueImpl());
+      operator=(rhs.ValueImpl());
     } else {
-      owned_optional_object_ = nullptr;
+      Destroy();
     }
-    optional_object_ = owned_optional_object_.get();
     return *this;
   }
 
@@ -418,6 +430,68 @@ class Optional<T, std::enable_if_t<!std::is_pod<T>::value>> final {
   }
 
  private:
+  bool ObjectIsInline() const { return optional_object_ && this->IsInlineObject(optional_object_); }
+
+  // Requires the `Optional` to be empty.
+  template <typename... ARGS, bool INLINE = optional::StoredInline<T>::value>
+  std::enable_if_t<INLINE> Construct(ARGS&&... args) {
+    new (this->InlineObject()) T(std::forward<ARGS>(args)...);
+    optional_object_ = this->InlineObject();
+  }
+
+  template <typename... ARGS, bool INLINE = optional::StoredInline<T>::value>
+  std::enable_if_t<!INLINE> Construct(ARGS&&... args) {
+    owned_optional_object_ = std::make_unique<T>(std::forward<ARGS>(args)...);
+    optional_object_ = owned_optional_object_.get();
+  }
+
+  // The new object is constructed before the current one is destroyed, as the former may be a copy of the latter.
+  template <typename X>
+  void Assign(X&& object) {
+    if (ObjectIsInline()) {
+      *optional_object_ = std::forward<X>(object);
+    } else {
+      AssignNotInline(std::forward<X>(object));
+    }
+  }
+
+  template <typename X, bool INLINE = optional::StoredInline<T>::value>
+  std::enable_if_t<INLINE> AssignNotInline(X&& object) {
+    T copy(std::forward<X>(object));
+    Destroy();
+    Construct(std::move(copy));
+  }
+
+  template <typename X, bool INLINE = optional::StoredInline<T>::value>
+  std::enable_if_t<!INLINE> AssignNotInline(X&& object) {
+    std::unique_ptr<T> copy = std::make_unique<T>(std::forward<X>(object));
+    Destroy();
+    owned_optional_object_ = std::move(copy);
+    optional_object_ = owned_optional_object_.get();
+  }
+
+  void Destroy() {
+    if (ObjectIsInline()) {
+      optional_object_->~T();
+    }
+    owned_optional_object_ = nullptr;
+    optional_object_ = nullptr;
+  }
+
+  // Requires the `Optional` to be empty. Leaves `rhs` empty, unless it points to an object it does not own.
+  void MoveFrom(Optional<T>& rhs) {
+    if (rhs.ObjectIsInline()) {
+      Construct(std::move(*rhs.optional_object_));
+      rhs.Destroy();
+    } else if (rhs.owned_optional_object_) {
+      owned_optional_object_ = std::move(rhs.owned_optional_object_);
+      optional_object_ = owned_optional_object_.get();
+      rhs.optional_object_ = nullptr;
+    } else {
+      optional_object_ = rhs.optional_object_;
+    }
+  }
+
   std::unique_ptr<T> owned_optional_object_;
   T* optional_object_ = nullptr;
 };
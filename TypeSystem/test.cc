@@ -1300,6 +1300,95 @@ TEST(TypeSystemTest, TimestampSimple) {
   }
 }
 
+TEST(TypeSystemTest, VariantWithDerivedTypes) {
+  using namespace struct_definition_test;
+  using current::BypassVariantTypeCheck;
+
+  struct Visitor {
+    std::string s;
+    void operator()(const Foo& foo) { s += "Foo " + current::ToString(foo.i) + '\n'; }
+    void operator()(const DerivedFromFoo& derived) { s += "DerivedFromFoo " + current::ToString(derived.i) + '\n'; }
+  };
+
+  {
+    Variant<Foo, DerivedFromFoo> p(DerivedFromFoo(1u));
+    EXPECT_TRUE(Exists<DerivedFromFoo>(p));
+    EXPECT_TRUE(Exists<Foo>(p));
+    EXPECT_FALSE(Exists<DerivedFromDerivedFromFoo>(p));
+    EXPECT_EQ(1001u, Value<Foo>(p).i);
+    EXPECT_EQ(1001u, Value<DerivedFromFoo>(p).i);
+
+    Visitor v;
+    p.Call(v);
+    p = Foo(2u);
+    p.Call(v);
+    EXPECT_EQ("DerivedFromFoo 1001\nFoo 2\n", v.s);
+    EXPECT_TRUE(Exists<Foo>(p));
+    EXPECT_FALSE(Exists<DerivedFromFoo>(p));
+    EXPECT_THROW(Value<DerivedFromFoo>(p), NoValueOfTypeException<DerivedFromFoo>);
+  }
+
+  {
+    // The type not in the type list can only be brought in bypassing the type check. Retrieving it still works,
+    // while `Call()` refuses to handle it.
+    Variant<Foo> p(BypassVariantTypeCheck(), std::make_unique<DerivedFromDerivedFromFoo>(1u));
+    EXPECT_TRUE(Exists<DerivedFromDerivedFromFoo>(p));
+    EXPECT_TRUE(Exists<Foo>(p));
+    EXPECT_EQ(2002u, Value<Foo>(p).i);
+    Visitor v;
+    EXPECT_THROW(p.Call(v), current::metaprogramming::UnlistedTypeException);
+  }
+}
+
+TEST(TypeSystemTest, OptionalKeepsSmallObjectsInline) {
+  using namespace struct_definition_test;
+
+  {
+    Optional<Foo> p(Foo(3u));
+    Optional<Foo> q(std::move(p));
+    EXPECT_FALSE(Exists(p));
+    EXPECT_EQ(3u, Value(q).i);
+    p = q;
+    q = Foo(4u);
+    EXPECT_EQ(3u, Value(p).i);
+    EXPECT_EQ(4u, Value(q).i);
+    p = std::move(p);
+    EXPECT_EQ(3u, Value(p).i);
+  }
+
+  // The large values of `Optional` are kept on the heap, and are moved by taking them over.
+  static_assert(current::optional::StoredInline<Foo>::value, "");
+  static_assert(!current::optional::StoredInline<Baz>::value, "");
+  static_assert(sizeof(Optional<Baz>) == 2u * sizeof(void*), "");
+  {
+    Baz baz;
+    baz.v1.push_back(42u);
+    Optional<Baz> p(baz);
+    const Baz* large = &Value(p);
+    Optional<Baz> q(std::move(p));
+    EXPECT_FALSE(Exists(p));
+    EXPECT_EQ(large, &Value(q));
+    p = q;
+    EXPECT_NE(large, &Value(p));
+    EXPECT_EQ("42", current::strings::Join(Value(p).v1, ','));
+
+    // Assigning the large value, or the whole `Optional`, to itself is fine.
+    p = p;
+    EXPECT_EQ("42", current::strings::Join(Value(p).v1, ','));
+    p = Value(p);
+    EXPECT_EQ("42", current::strings::Join(Value(p).v1, ','));
+    q = std::move(Value(q));
+    EXPECT_EQ("42", current::strings::Join(Value(q).v1, ','));
+  }
+
+  {
+    // Same for the small value held on the heap, after adopting a `unique_ptr`.
+    Optional<Foo> p(std::make_unique<Foo>(5u));
+    p = Value(p);
+    EXPECT_EQ(5u, Value(p).i);
+  }
+}
+
 namespace struct_definition_test {
 CURRENT_STRUCT(WithTimestampVariant) {
   CURRENT_FIELD(magic, (Variant<WithTimestampUS, WithTimestampUInt64>));
@@ -35,6 +35,8 @@ SOFTWARE.
 #include "../port.h"  // `make_unique`.
 
 #include <memory>
+#include <type_traits>
+#include <typeinfo>
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
 // For runtime, not compile-time, extra checks.
@@ -113,6 +115,56 @@ struct RuntimeTypeListHelpers<TypeListImpl<TS...>> {
 };
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
 
+// The `Variant` keeps the index of the type of its object in its type list, so that `Call()` and `Value<>()`
+// dispatch on it through the tables built at compile time, with no RTTI involved.
+template <typename TYPE_LIST>
+struct TypeIndexDispatcher;
+
+template <typename... TS>
+struct TypeIndexDispatcher<TypeListImpl<TS...>> {
+  template <typename T, typename F>
+  static void CallAs(object_base_t& object, F& f) {
+    f(static_cast<T&>(object));
+  }
+
+  template <typename T, typename F>
+  static void CallAsConst(const object_base_t& object, F& f) {
+    f(static_cast<const T&>(object));
+  }
+
+  template <typename F>
+  static void Call(size_t index, object_base_t& object, F& f) {
+    static void (*const handlers[])(object_base_t&, F&) = {&CallAs<TS, F>...};
+    handlers[index](object, f);
+  }
+
+  template <typename F>
+  static void Call(size_t index, const object_base_t& object, F& f) {
+    static void (*const handlers[])(const object_base_t&, F&) = {&CallAsConst<TS, F>...};
+    handlers[index](object, f);
+  }
+
+  // Whether the object of the `index`-th type is an `X`, i.e., is of type `X` or of a type derived from it.
+  template <typename X>
+  static bool IsA(size_t index) {
+    static const bool is_a[] = {std::is_base_of<X, TS>::value...};
+    return is_a[index];
+  }
+
+  // The index of the type the object has been created as, for the objects coming in with their type erased.
+  // Returns `sizeof...(TS)` if the type is not in the type list, in which case the `Variant` falls back to RTTI.
+  static size_t IndexOf(const object_base_t& object) {
+    static const std::type_info* const types[] = {&typeid(TS)...};
+    const std::type_info& type = typeid(object);
+    for (size_t i = 0u; i < sizeof...(TS); ++i) {
+      if (*types[i] == type) {
+        return i;
+      }
+    }
+    return sizeof...(TS);
+  }
+};
+
 }  // namespace current::variant
 
 struct IHasUncheckedMoveFromUniquePtr : CurrentVariant {
@@ -142,8 +194,9 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 
   VariantImpl() {}
 
-  VariantImpl(BypassVariantTypeCheck, std::unique_ptr<current::variant::object_base_t>&& rhs)
-      : object_(std::move(rhs)) {}
+  VariantImpl(BypassVariantTypeCheck, std::unique_ptr<current::variant::object_base_t>&& rhs) {
+    SetTypeErasedObject(std::move(rhs));
+  }
 
   // Use deep copy helper for all Variant types, including our own.
   VariantImpl(const VariantImpl& rhs) { CopyFrom(rhs); }
@@ -173,12 +226,14 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
     using decayed_t = current::decay<X>;
     variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<decayed_t>();
     object_ = std::make_unique<decayed_t>(std::forward<X>(input));
+    type_index_ = TypeListIndex<typelist_t, decayed_t>::value;
   }
 #else
   template <typename X, class ENABLE = std::enable_if_t<TypeListContains<typelist_t, current::decay<X>>::value>>
   VariantImpl(X&& input) {
     using decayed_t = current::decay<X>;
     object_ = std::make_unique<decayed_t>(std::forward<X>(input));
+    type_index_ = TypeListIndex<typelist_t, decayed_t>::value;
   }
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
 
@@ -191,6 +246,7 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 
   VariantImpl& operator=(VariantImpl&& rhs) {
     object_ = std::move(rhs.object_);
+    type_index_ = rhs.type_index_;
     return *this;
   }
 
@@ -205,11 +261,12 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
     variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<decayed_t>();
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
     object_ = std::make_unique<decayed_t>(std::forward<X>(input));
+    type_index_ = TypeListIndex<typelist_t, decayed_t>::value;
     return *this;
   }
 
   void UncheckedMoveFromUniquePtr(std::unique_ptr<current::variant::object_base_t> input) override {
-    object_ = std::move(input);
+    SetTypeErasedObject(std::move(input));
   }
 
   operator bool() const { return object_ ? true : false; }
@@ -217,7 +274,11 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   template <typename F>
   void Call(F&& f) {
     if (object_) {
-      current::metaprogramming::RTTIDynamicCall<typelist_t>(*object_, std::forward<F>(f));
+      if (type_index_ < typelist_size) {
+        variant::TypeIndexDispatcher<typelist_t>::Call(type_index_, *object_, f);
+      } else {
+        current::metaprogramming::RTTIDynamicCall<typelist_t>(*object_, std::forward<F>(f));
+      }
     } else {
       CURRENT_THROW(UninitializedVariantOfTypeException<TYPES...>());
     }
@@ -226,14 +287,18 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   template <typename F>
   void Call(F&& f) const {
     if (object_) {
-      current::metaprogramming::RTTIDynamicCall<typelist_t>(*object_, std::forward<F>(f));
+      if (type_index_ < typelist_size) {
+        variant::TypeIndexDispatcher<typelist_t>::Call(type_index_, *object_, f);
+      } else {
+        current::metaprogramming::RTTIDynamicCall<typelist_t>(*object_, std::forward<F>(f));
+      }
     } else {
       CURRENT_THROW(UninitializedVariantOfTypeException<TYPES...>());
     }
   }
 
   // By design, `VariantExistsImpl<T>()` and `VariantValueImpl<T>()` do not check
-  // whether `X` is part of `typelist_t`. More specifically, they pass if `dynamic_cast<>` succeeds,
+  // whether `X` is part of `typelist_t`. More specifically, they pass if `dynamic_cast<>` would succeed,
   // and thus will successfully retrieve a derived type as a base one,
   // regardless of whether the base one is present in `typelist_t`.
   // Use `Call()` to run a strict check.
@@ -242,12 +307,12 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 
   template <typename X>
   std::enable_if_t<!std::is_same<X, current::variant::object_base_t>::value, bool> VariantExistsImpl() const {
-    return dynamic_cast<const X*>(object_.get()) != nullptr;
+    return PointerAs<const X>() != nullptr;
   }
 
   template <typename X>
   std::enable_if_t<!std::is_same<X, current::variant::object_base_t>::value, X&> VariantValueImpl() {
-    X* ptr = dynamic_cast<X*>(object_.get());
+    X* ptr = PointerAs<X>();
     if (ptr) {
       return *ptr;
     } else {
@@ -257,7 +322,7 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 
   template <typename X>
   const X& VariantValueImpl() const {
-    const X* ptr = dynamic_cast<const X*>(object_.get());
+    const X* ptr = PointerAs<const X>();
     if (ptr) {
       return *ptr;
     } else {
@@ -276,20 +341,22 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
 
  private:
   struct TypeAwareClone {
-    std::unique_ptr<current::variant::object_base_t>& into;
-    TypeAwareClone(std::unique_ptr<current::variant::object_base_t>& into) : into(into) {}
+    VariantImpl& into;
+    TypeAwareClone(VariantImpl& into) : into(into) {}
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
     template <typename U>
     void operator()(const U& instance) {
       using decayed_u = current::decay<U>;
       variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<decayed_u>();
-      into = std::make_unique<decayed_u>(instance);
+      into.object_ = std::make_unique<decayed_u>(instance);
+      into.type_index_ = TypeListIndex<typelist_t, decayed_u>::value;
     }
 #else
     template <typename U>
     std::enable_if_t<TypeListContains<typelist_t, current::decay<U>>::value> operator()(const U& instance) {
-      into = std::make_unique<current::decay<U>>(instance);
+      into.object_ = std::make_unique<current::decay<U>>(instance);
+      into.type_index_ = TypeListIndex<typelist_t, current::decay<U>>::value;
     }
 
     template <typename U>
@@ -302,9 +369,8 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   struct TypeAwareMove {
     // `from` should not be an rvalue reference, as the move operation in `operator()` may still throw.
     std::unique_ptr<current::variant::object_base_t>& from;
-    std::unique_ptr<current::variant::object_base_t>& into;
-    TypeAwareMove(std::unique_ptr<current::variant::object_base_t>& from,
-                  std::unique_ptr<current::variant::object_base_t>& into)
+    VariantImpl& into;
+    TypeAwareMove(std::unique_ptr<current::variant::object_base_t>& from, VariantImpl& into)
         : from(from), into(into) {}
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
@@ -312,12 +378,14 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
     void operator()(U&&) {
       using decayed_u = current::decay<U>;
       variant::RuntimeTypeListHelpers<typelist_t>::template AssertContains<decayed_u>();
-      into = std::move(from);
+      into.object_ = std::move(from);
+      into.type_index_ = TypeListIndex<typelist_t, decayed_u>::value;
     }
 #else
     template <typename U>
     std::enable_if_t<TypeListContains<typelist_t, current::decay<U>>::value> operator()(U&&) {
-      into = std::move(from);
+      into.object_ = std::move(from);
+      into.type_index_ = TypeListIndex<typelist_t, current::decay<U>>::value;
     }
 
     template <typename U>
@@ -330,7 +398,7 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   template <typename... RHS>
   void CopyFrom(const VariantImpl<RHS...>& rhs) {
     if (rhs.object_) {
-      TypeAwareClone cloner(object_);
+      TypeAwareClone cloner(*this);
       rhs.Call(cloner);
     } else {
       object_ = nullptr;
@@ -340,7 +408,7 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   template <typename... RHS>
   void MoveFrom(VariantImpl<RHS...>&& rhs) {
     if (rhs.object_) {
-      TypeAwareMove mover(rhs.object_, object_);
+      TypeAwareMove mover(rhs.object_, *this);
       rhs.Call(mover);
     } else {
       object_ = nullptr;
@@ -348,7 +416,32 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   }
 
  private:
+  void SetTypeErasedObject(std::unique_ptr<current::variant::object_base_t>&& object) {
+    object_ = std::move(object);
+    type_index_ = object_ ? variant::TypeIndexDispatcher<typelist_t>::IndexOf(*object_) : typelist_size;
+  }
+
+  // Returns the object as `X*`, or `nullptr` if it is not an `X`. Same as `dynamic_cast<>`, but for the types
+  // not in `typelist_t`, which only the `BypassVariantTypeCheck` and `UncheckedMoveFromUniquePtr()` paths can bring in.
+  template <typename X>
+  std::enable_if_t<std::is_base_of<current::variant::object_base_t, current::decay<X>>::value, X*> PointerAs() const {
+    if (object_ && type_index_ < typelist_size) {
+      return variant::TypeIndexDispatcher<typelist_t>::template IsA<current::decay<X>>(type_index_)
+                 ? static_cast<X*>(object_.get())
+                 : nullptr;
+    } else {
+      return dynamic_cast<X*>(object_.get());
+    }
+  }
+
+  template <typename X>
+  std::enable_if_t<!std::is_base_of<current::variant::object_base_t, current::decay<X>>::value, X*> PointerAs() const {
+    return dynamic_cast<X*>(object_.get());
+  }
+
   std::unique_ptr<current::variant::object_base_t> object_;
+  // The index of the type of `object_` in `typelist_t`, or `typelist_size` if it is not there.
+  size_t type_index_ = typelist_size;
 };
 
 // `Variant<...>` can accept either a list of types, or a `TypeList<...>`.
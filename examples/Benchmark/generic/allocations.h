@@ -0,0 +1,69 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Counts the heap allocations made by each thread, for the benchmark to report the allocations per query.
+// Replaces the global `operator new`, thus must only be included from the single translation unit, `run.cc`,
+// and not in `make check`, which links the header compiled twice.
+
+#ifndef BENCHMARK_ALLOCATIONS_H
+#define BENCHMARK_ALLOCATIONS_H
+
+#include "../../../port.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+inline uint64_t& ThreadLocalAllocationsCount() {
+  static thread_local uint64_t count = 0u;
+  return count;
+}
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+
+void* operator new(size_t size) {
+  ++ThreadLocalAllocationsCount();
+  if (void* result = std::malloc(size ? size : 1u)) {
+    return result;
+  }
+  throw std::bad_alloc();  // LCOV_EXCL_LINE
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  ++ThreadLocalAllocationsCount();
+  return std::malloc(size ? size : 1u);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& nothrow) noexcept { return operator new(size, nothrow); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+#endif  // CURRENT_MAKE_CHECK_MODE
+
+#endif  // BENCHMARK_ALLOCATIONS_H
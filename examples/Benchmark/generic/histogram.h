@@ -0,0 +1,134 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The HDR-style latency histogram: the values below 1024 microseconds are kept exactly, the larger ones with
+// the relative precision of 1/1024, in log-linear buckets. Recording a value is O(1), and the histograms
+// of the individual threads are merged into the final one.
+//
+// `RecordCorrected()` compensates for the coordinated omission of a closed-loop load generator, the way
+// HdrHistogram does: the query which has taken N expected intervals stands for N-1 more queries,
+// which would have been sent, and would have waited, had the load generator not been blocked on this one.
+
+#ifndef BENCHMARK_HISTOGRAM_H
+#define BENCHMARK_HISTOGRAM_H
+
+#include "../../../port.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class LatencyHistogram final {
+ public:
+  LatencyHistogram() : counts_(kBucketsCount, 0u) {}
+
+  void Record(uint64_t value) {
+    ++counts_[IndexOf(value)];
+    ++total_count_;
+    total_sum_ += static_cast<double>(value);
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+  }
+
+  void RecordCorrected(uint64_t value, uint64_t expected_interval) {
+    Record(value);
+    if (expected_interval) {
+      for (uint64_t missing = value; missing > expected_interval;) {
+        missing -= expected_interval;
+        Record(missing);
+      }
+    }
+  }
+
+  void Merge(const LatencyHistogram& rhs) {
+    for (size_t i = 0; i < kBucketsCount; ++i) {
+      counts_[i] += rhs.counts_[i];
+    }
+    total_count_ += rhs.total_count_;
+    total_sum_ += rhs.total_sum_;
+    min_ = std::min(min_, rhs.min_);
+    max_ = std::max(max_, rhs.max_);
+  }
+
+  uint64_t TotalCount() const { return total_count_; }
+  uint64_t Min() const { return total_count_ ? min_ : 0u; }
+  uint64_t Max() const { return max_; }
+  double Mean() const { return total_count_ ? total_sum_ / total_count_ : 0.0; }
+
+  // The value below or at which `percentile` percent of the recorded values are, up to the bucket precision.
+  uint64_t ValueAtPercentile(double percentile) const {
+    if (!total_count_) {
+      return 0u;
+    }
+    const double fraction = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+    const uint64_t rank = std::max(static_cast<uint64_t>(fraction * total_count_ + 0.5), uint64_t(1));
+    uint64_t seen = 0u;
+    for (size_t i = 0; i < kBucketsCount; ++i) {
+      seen += counts_[i];
+      if (seen >= rank) {
+        return std::min(HighestValueOf(i), max_);
+      }
+    }
+    return max_;  // LCOV_EXCL_LINE
+  }
+
+ private:
+  static constexpr uint64_t kSubBucketBits = 10u;
+  static constexpr uint64_t kSubBucketCount = uint64_t(1) << kSubBucketBits;
+  // Values up to 2^51 microseconds, which is over 70 years, are bucketed; larger ones land in the last bucket.
+  static constexpr uint64_t kMaxShift = 40u;
+  static constexpr size_t kBucketsCount = static_cast<size_t>(kSubBucketCount * (kMaxShift + 2));
+
+  static size_t IndexOf(uint64_t value) {
+    if (value < kSubBucketCount) {
+      return static_cast<size_t>(value);
+    }
+    uint64_t shift = 0u;
+    while ((value >> shift) >= 2 * kSubBucketCount) {
+      ++shift;
+    }
+    if (shift > kMaxShift) {
+      return kBucketsCount - 1u;
+    }
+    return static_cast<size_t>(kSubBucketCount * (shift + 1) + ((value >> shift) - kSubBucketCount));
+  }
+
+  static uint64_t HighestValueOf(size_t index) {
+    if (index < kSubBucketCount) {
+      return index;
+    }
+    const uint64_t shift = index / kSubBucketCount - 1u;
+    const uint64_t sub_bucket = kSubBucketCount + index % kSubBucketCount;
+    return ((sub_bucket + 1u) << shift) - 1u;
+  }
+
+  std::vector<uint64_t> counts_;
+  uint64_t total_count_ = 0u;
+  double total_sum_ = 0.0;
+  uint64_t min_ = std::numeric_limits<uint64_t>::max();
+  uint64_t max_ = 0u;
+};
+
+#endif  // BENCHMARK_HISTOGRAM_H
@@ -0,0 +1,77 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The machine-readable report of a benchmark run, printed as JSON with `--json_report`, to compare the runs.
+
+#ifndef BENCHMARK_REPORT_H
+#define BENCHMARK_REPORT_H
+
+#include "../../../port.h"
+
+#include "histogram.h"
+
+#include "../../../TypeSystem/struct.h"
+
+// All latencies are in microseconds.
+CURRENT_STRUCT(BenchmarkLatencyReport) {
+  CURRENT_FIELD(min, uint64_t, 0u);
+  CURRENT_FIELD(mean, double, 0.0);
+  CURRENT_FIELD(p50, uint64_t, 0u);
+  CURRENT_FIELD(p90, uint64_t, 0u);
+  CURRENT_FIELD(p99, uint64_t, 0u);
+  CURRENT_FIELD(p999, uint64_t, 0u);
+  CURRENT_FIELD(p9999, uint64_t, 0u);
+  CURRENT_FIELD(max, uint64_t, 0u);
+  // The number of values in the histogram, which exceeds the number of queries if corrected for coordinated omission.
+  CURRENT_FIELD(count, uint64_t, 0u);
+
+  CURRENT_DEFAULT_CONSTRUCTOR(BenchmarkLatencyReport) {}
+  CURRENT_CONSTRUCTOR(BenchmarkLatencyReport)(const LatencyHistogram& histogram)
+      : min(histogram.Min()),
+        mean(histogram.Mean()),
+        p50(histogram.ValueAtPercentile(50)),
+        p90(histogram.ValueAtPercentile(90)),
+        p99(histogram.ValueAtPercentile(99)),
+        p999(histogram.ValueAtPercentile(99.9)),
+        p9999(histogram.ValueAtPercentile(99.99)),
+        max(histogram.Max()),
+        count(histogram.TotalCount()) {}
+};
+
+CURRENT_STRUCT(BenchmarkReport) {
+  CURRENT_FIELD(scenario, std::string);
+  CURRENT_FIELD(mode, std::string);  // "closed" or "open".
+  CURRENT_FIELD(threads, uint32_t, 0u);
+  CURRENT_FIELD(seconds, double, 0.0);
+  CURRENT_FIELD(target_qps, double, 0.0);            // The rate of the open-loop mode, zero for the closed-loop one.
+  CURRENT_FIELD(expected_interval_us, uint64_t, 0u);  // The coordinated omission correction of the closed-loop mode.
+  CURRENT_FIELD(queries, uint64_t, 0u);
+  CURRENT_FIELD(errors, uint64_t, 0u);
+  CURRENT_FIELD(qps, double, 0.0);
+  CURRENT_FIELD(latency_us, BenchmarkLatencyReport);
+  // The allocations made by the other threads, e.g. by the server, are not counted.
+  CURRENT_FIELD(allocations_per_query, double, 0.0);
+};
+
+#endif  // BENCHMARK_REPORT_H
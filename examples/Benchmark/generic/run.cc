@@ -24,10 +24,20 @@ SOFTWARE.
 
 #include "../../../current.h"
 
+#include "allocations.h"
+#include "histogram.h"
+#include "report.h"
+
 #include "scenario_golden_1k_qps.h"
 #include "scenario_json.h"
+#include "scenario_binary.h"
+#include "scenario_numbers.h"
+#include "scenario_variant.h"
 #include "scenario_simple_http.h"
 #include "scenario_storage.h"
+#include "scenario_storage_rest.h"
+#include "scenario_sherlock_pubsub.h"
+#include "scenario_event_collector.h"
 #include "scenario_nginx_client.h"
 #include "scenario_replication.h"
 
@@ -43,60 +53,143 @@ DEFINE_int32(threads,
              "the measurement may be imprecise when run against a high-latency network,"
              "as more time would be spent waiting than running. Thus, this tool is only good for local tests.");
 
+DEFINE_string(mode,
+              "closed",
+              "'closed' to run the next query from each thread as soon as the previous one is done, "
+              "'open' to start the queries at the fixed rate of `--qps`, regardless of how long they take.");
+
+DEFINE_double(qps, 1000.0, "The total rate of queries of the open-loop mode, spread evenly across the threads.");
+
+DEFINE_uint64(expected_interval_us,
+              0u,
+              "If nonzero, correct the latencies of the closed-loop mode for coordinated omission, "
+              "assuming the queries were meant to be sent from each thread this many microseconds apart.");
+
+DEFINE_bool(json_report, false, "Print the JSON report instead of the human-readable summary.");
+
 static double NowInSeconds() {
   // Don't use `current::time::Now()`, as it's under a mutex, and guaranteed to increase by at least 1 per call.
   return 1e-6 *
-         std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch())
+         std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
              .count();
 }
 
 template <typename SCENARIO>
-void Run(const SCENARIO& scenario) {
+BenchmarkReport Run(const SCENARIO& scenario) {
+  const bool open_loop = (FLAGS_mode == "open");
+  if (!open_loop && FLAGS_mode != "closed") {
+    std::cerr << "The `--mode` flag must be 'closed' or 'open'." << std::endl;
+    std::exit(-1);
+  }
+  if (open_loop && !(FLAGS_qps > 0)) {
+    std::cerr << "The `--qps` flag must be positive in the open-loop mode." << std::endl;
+    std::exit(-1);
+  }
+
   struct Thread {
-    Thread(const SCENARIO& scenario, double total_seconds)
+    Thread(const SCENARIO& scenario, size_t index, double begin, double end, bool open_loop)
         : scenario_(scenario),
-          wall_time_second_end_(NowInSeconds() + total_seconds),
-          queries_completed_within_desired_timeframe_(0u),
+          index_(index),
+          wall_time_second_begin_(begin),
+          wall_time_second_end_(end),
+          open_loop_(open_loop),
           thread_(&Thread::ThreadFunction, this) {}
 
     void Join() { thread_.join(); }
 
     const SCENARIO& scenario_;
+    const size_t index_;
+    const double wall_time_second_begin_;
     const double wall_time_second_end_;
-    size_t queries_completed_within_desired_timeframe_;
+    const bool open_loop_;
+    size_t queries_completed_within_desired_timeframe_ = 0u;
+    size_t errors_ = 0u;
+    // The heap allocations made by the queries, including the ones not counted in the final number.
+    uint64_t allocations_ = 0u;
+    size_t queries_ = 0u;
+    LatencyHistogram latencies_us_;
     std::thread thread_;
 
-    // The thread function runs the queries continuously. It only counts the queries
-    // completed within the originally desired number of seconds in the final number.
-    void ThreadFunction() {
-      while (true) {
+    // Returns the time the query has completed at.
+    double RunOneQuery() {
+      const uint64_t allocations_before = ThreadLocalAllocationsCount();
+      try {
         scenario_->RunOneQuery();
+      } catch (const std::exception&) {
+        ++errors_;
+      }
+      allocations_ += ThreadLocalAllocationsCount() - allocations_before;
+      ++queries_;
+      return NowInSeconds();
+    }
 
-        if (NowInSeconds() >= wall_time_second_end_) {
-          break;
+    // The closed-loop mode runs the queries continuously. It only counts the queries
+    // completed within the originally desired number of seconds in the final number.
+    // The open-loop mode starts the queries on schedule, and measures their latencies from the scheduled time,
+    // so that the time a query has waited for the previous one to complete is accounted for.
+    void ThreadFunction() {
+      if (!open_loop_) {
+        while (true) {
+          const double begin = NowInSeconds();
+          const double end = RunOneQuery();
+          if (end >= wall_time_second_end_) {
+            break;
+          }
+          ++queries_completed_within_desired_timeframe_;
+          latencies_us_.RecordCorrected(static_cast<uint64_t>(1e6 * (end - begin)), FLAGS_expected_interval_us);
+        }
+      } else {
+        const double interval = FLAGS_threads / FLAGS_qps;
+        for (double scheduled = wall_time_second_begin_ + interval * index_ / FLAGS_threads;
+             scheduled < wall_time_second_end_;
+             scheduled += interval) {
+          const double now = NowInSeconds();
+          if (now < scheduled) {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(1e6 * (scheduled - now))));
+          }
+          const double end = RunOneQuery();
+          if (end >= wall_time_second_end_) {
+            break;
+          }
+          ++queries_completed_within_desired_timeframe_;
+          latencies_us_.Record(static_cast<uint64_t>(1e6 * (end - scheduled)));
         }
-
-        ++queries_completed_within_desired_timeframe_;
       }
     }
   };
 
+  const double begin = NowInSeconds();
+  const double end = begin + FLAGS_seconds;
   std::vector<std::unique_ptr<Thread>> threads(FLAGS_threads);
-  for (auto& t : threads) {
-    t = std::make_unique<Thread>(scenario, FLAGS_seconds);
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i] = std::make_unique<Thread>(scenario, i, begin, end, open_loop);
   }
 
   for (auto& t : threads) {
     t->Join();
   }
 
-  size_t total_queries = 0u;
+  BenchmarkReport report;
+  report.scenario = FLAGS_scenario;
+  report.mode = FLAGS_mode;
+  report.threads = static_cast<uint32_t>(FLAGS_threads);
+  report.seconds = FLAGS_seconds;
+  report.target_qps = open_loop ? FLAGS_qps : 0.0;
+  report.expected_interval_us = open_loop ? 0u : FLAGS_expected_interval_us;
+  LatencyHistogram latencies_us;
+  uint64_t allocations = 0u;
+  size_t queries = 0u;
   for (auto& t : threads) {
-    total_queries += t->queries_completed_within_desired_timeframe_;
+    report.queries += t->queries_completed_within_desired_timeframe_;
+    report.errors += t->errors_;
+    latencies_us.Merge(t->latencies_us_);
+    allocations += t->allocations_;
+    queries += t->queries_;
   }
-
-  const double qps = total_queries / FLAGS_seconds;
-  std::cout << std::setw(3) << qps << " QPS." << std::endl;
+  report.qps = report.queries / FLAGS_seconds;
+  report.allocations_per_query = queries ? static_cast<double>(allocations) / queries : 0.0;
+  report.latency_us = BenchmarkLatencyReport(latencies_us);
+  return report;
 }
 
 int main(int argc, char** argv) {
@@ -108,7 +201,19 @@ int main(int argc, char** argv) {
     return 1;
   } else {
     try {
-      Run(registerer.map.at(FLAGS_scenario).second());
+      const BenchmarkReport report = Run(registerer.map.at(FLAGS_scenario).second());
+      if (FLAGS_json_report) {
+        std::cout << JSON(report) << std::endl;
+      } else {
+        std::cout << std::setw(3) << report.qps << " QPS." << std::endl;
+        std::cout << "Latency, us: p50 " << report.latency_us.p50 << ", p90 " << report.latency_us.p90 << ", p99 "
+                  << report.latency_us.p99 << ", p99.9 " << report.latency_us.p999 << ", max "
+                  << report.latency_us.max << '.' << std::endl;
+        std::cout << "Heap allocations per query: " << report.allocations_per_query << '.' << std::endl;
+        if (report.errors) {
+          std::cout << report.errors << " queries failed." << std::endl;
+        }
+      }
       return 0;
     } catch (const std::out_of_range&) {
       std::cout << "Scenario `" << FLAGS_scenario << "` is not defined." << std::endl;
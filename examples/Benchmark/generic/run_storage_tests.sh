@@ -25,3 +25,13 @@ for STORAGE_TRANSACTION in empty size get put ; do
     done
   done
 done
+
+for THREADS in 1 4 16 ; do
+  echo -n "mixed,90% get,size=50000,threads=$THREADS : "
+  $CMD \
+    --storage_transaction=mixed \
+    --storage_read_percentage=90 \
+    --storage_initial_size=50000 \
+    --threads=$THREADS \
+    --seconds=2
+done
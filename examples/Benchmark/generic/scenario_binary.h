@@ -0,0 +1,69 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef BENCHMARK_SCENARIO_BINARY_H
+#define BENCHMARK_SCENARIO_BINARY_H
+
+#include "../../../port.h"
+
+#include "../../../TypeSystem/Serialization/binary.h"
+
+#include "benchmark.h"
+#include "scenario_json.h"  // The `TopLevel` object to serialize.
+
+#include "../../../Bricks/dflags/dflags.h"
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+DEFINE_string(binary, "gen", "Binary serialization action to take in the performance test, gen/parse/both.");
+#else
+DECLARE_string(binary);
+#endif
+
+// The same object as the `json` scenario uses, to compare the two formats.
+SCENARIO(binary, "Binary serialization performance test.") {
+  const TopLevel test_object;
+  const std::string test_object_binary;
+  std::function<void()> f;
+
+  binary() : test_object(), test_object_binary(Binary(test_object)) {
+    std::cerr << "Binary length: " << test_object_binary.length() << ", JSON length: " << JSON(test_object).length()
+              << std::endl;
+    if (FLAGS_binary == "gen") {
+      f = [this]() { Binary(test_object); };
+    } else if (FLAGS_binary == "parse") {
+      f = [this]() { ParseBinary<TopLevel>(test_object_binary); };
+    } else if (FLAGS_binary == "both") {
+      f = [this]() { ParseBinary<TopLevel>(Binary(test_object)); };
+    } else {
+      std::cerr << "The `--binary` flag must be 'gen', 'parse', or 'both'." << std::endl;
+      CURRENT_ASSERT(false);
+    }
+  }
+
+  void RunOneQuery() override { f(); }
+};
+
+REGISTER_SCENARIO(binary);
+
+#endif  // BENCHMARK_SCENARIO_BINARY_H
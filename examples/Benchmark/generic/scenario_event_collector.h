@@ -0,0 +1,70 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef BENCHMARK_SCENARIO_EVENT_COLLECTOR_H
+#define BENCHMARK_SCENARIO_EVENT_COLLECTOR_H
+
+#include "../../../port.h"
+
+#include "benchmark.h"
+
+#include "../../../EventCollector/event_collector.h"
+
+#include "../../../Bricks/dflags/dflags.h"
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+DEFINE_uint16(event_collector_local_port, 9801, "Local port for the `event_collector` scenario to listen on.");
+DEFINE_string(event_collector_route, "/log", "The route of the `event_collector` scenario.");
+DEFINE_bool(event_collector_post, false, "Set to `true` to POST the events, not GET them.");
+#else
+DECLARE_uint16(event_collector_local_port);
+DECLARE_string(event_collector_route);
+DECLARE_bool(event_collector_post);
+#endif
+
+SCENARIO(event_collector, "Log events into `EventCollectorHTTPServer`, which writes them into a null stream.") {
+  std::ostringstream null_stream;
+  std::unique_ptr<EventCollectorHTTPServer> server;
+  std::string url;
+
+  event_collector() {
+    null_stream.setstate(std::ios_base::badbit);
+    server = std::make_unique<EventCollectorHTTPServer>(
+        FLAGS_event_collector_local_port, null_stream, std::chrono::microseconds(0), FLAGS_event_collector_route);
+    url = "localhost:" + current::ToString(FLAGS_event_collector_local_port) + FLAGS_event_collector_route;
+  }
+
+  void RunOneQuery() override {
+    const auto response = !FLAGS_event_collector_post
+                              ? HTTP(GET(url + "?event=benchmark"))
+                              : HTTP(POST(url, "{\"event\":\"benchmark\"}", "application/json"));
+    if (response.body != "OK\n") {
+      CURRENT_THROW(current::Exception("Unexpected HTTP response body `" + response.body + "`."));
+    }
+  }
+};
+
+REGISTER_SCENARIO(event_collector);
+
+#endif  // BENCHMARK_SCENARIO_EVENT_COLLECTOR_H
@@ -36,7 +36,10 @@ SOFTWARE.
 #include "../../../Bricks/dflags/dflags.h"
 
 #ifndef CURRENT_MAKE_CHECK_MODE
-DEFINE_string(json, "gen", "JSON action to take in the performance test, gen/parse/both.");
+DEFINE_string(json,
+              "gen",
+              "JSON action to take in the performance test, gen/parse/both, or view/fields to parse the `name` only, "
+              "with `ParseJSON` or with `ParseJSONFields` respectively.");
 #else
 DECLARE_string(json);
 #endif
@@ -166,6 +169,9 @@ CURRENT_STRUCT(TopLevel) {
   }
 };
 
+// The field of `TopLevel` some readers are only interested in.
+CURRENT_STRUCT(TopLevelName) { CURRENT_FIELD(name, std::string); };
+
 SCENARIO(json, "JSON performance test.") {
   const TopLevel test_object;
   const std::string test_object_json;
@@ -182,10 +188,14 @@ SCENARIO(json, "JSON performance test.") {
       f = [this]() { JSON(test_object); };
     } else if (FLAGS_json == "parse") {
       f = [this]() { ParseJSON<TopLevel>(test_object_json); };
+    } else if (FLAGS_json == "view") {
+      f = [this]() { ParseJSON<TopLevelName>(test_object_json); };
+    } else if (FLAGS_json == "fields") {
+      f = [this]() { ParseJSONFields<TopLevelName>(test_object_json, JSONFieldsProjectionOf<TopLevelName>()); };
     } else if (FLAGS_json == "both") {
       f = [this]() { ParseJSON<TopLevel>(JSON(test_object)); };
     } else {
-      std::cerr << "The `--json` flag must be 'gen', 'parse', or 'both'." << std::endl;
+      std::cerr << "The `--json` flag must be 'gen', 'parse', 'both', 'view', or 'fields'." << std::endl;
       CURRENT_ASSERT(false);
     }
   }
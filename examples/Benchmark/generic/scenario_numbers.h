@@ -0,0 +1,163 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef BENCHMARK_SCENARIO_NUMBERS_H
+#define BENCHMARK_SCENARIO_NUMBERS_H
+
+#include "../../../port.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "../../../Bricks/strings/number.h"
+
+#include "benchmark.h"
+
+#include "../../../Bricks/dflags/dflags.h"
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+DEFINE_string(numbers, "format", "Numbers conversion to benchmark, format/parse.");
+DEFINE_string(numbers_type,
+              "double",
+              "The numbers to convert: `double` for any doubles, `decimal` for the doubles with at most 15 "
+              "significant digits, as most numbers in JSON are, or `int`.");
+DEFINE_string(numbers_impl, "current", "The implementation to use, `current` for Bricks, or `std` for the C library.");
+#else
+DECLARE_string(numbers);
+DECLARE_string(numbers_type);
+DECLARE_string(numbers_impl);
+#endif
+
+// Each query converts the same 1000 random numbers.
+SCENARIO(numbers, "Conversions between numbers and strings performance test.") {
+  std::vector<double> doubles;
+  std::vector<int64_t> ints;
+  std::vector<std::string> strings;
+  std::function<void()> f;
+
+  numbers() {
+    std::mt19937_64 random(42);
+    for (size_t i = 0u; i < 1000u; ++i) {
+      const uint64_t bits = random();
+      if (FLAGS_numbers_type == "decimal") {
+        const double significand = static_cast<double>(bits % 1000000000000000ull);
+        doubles.push_back(significand / std::pow(10.0, static_cast<double>(bits % 20u)));
+      } else {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        doubles.push_back(std::isfinite(value) ? value : static_cast<double>(bits));
+      }
+      ints.push_back(static_cast<int64_t>(bits) >> (bits % 64u));
+      char buffer[current::strings::kMaxFormattedNumberLength];
+      if (FLAGS_numbers_type != "int") {
+        strings.emplace_back(buffer, current::strings::FormatNumber(doubles.back(), buffer));
+      } else {
+        strings.emplace_back(buffer, current::strings::FormatNumber(ints.back(), buffer));
+      }
+    }
+    const bool is_current = (FLAGS_numbers_impl == "current");
+    if (!is_current && FLAGS_numbers_impl != "std") {
+      std::cerr << "The `--numbers_impl` flag must be 'current' or 'std'." << std::endl;
+      CURRENT_ASSERT(false);
+    }
+    if (FLAGS_numbers_type != "double" && FLAGS_numbers_type != "decimal" && FLAGS_numbers_type != "int") {
+      std::cerr << "The `--numbers_type` flag must be 'double', 'decimal', or 'int'." << std::endl;
+      CURRENT_ASSERT(false);
+    }
+    const bool is_double = (FLAGS_numbers_type != "int");
+    if (FLAGS_numbers == "format") {
+      if (is_double) {
+        f = is_current ? std::function<void()>([this]() { Format(doubles, FormatViaCurrent<double>); })
+                       : std::function<void()>([this]() { Format(doubles, FormatViaPrintf); });
+      } else {
+        f = is_current ? std::function<void()>([this]() { Format(ints, FormatViaCurrent<int64_t>); })
+                       : std::function<void()>([this]() { Format(ints, FormatViaToString); });
+      }
+    } else if (FLAGS_numbers == "parse") {
+      if (is_double) {
+        f = is_current ? std::function<void()>([this]() { Parse(ParseViaCurrent<double>); })
+                       : std::function<void()>([this]() { Parse(ParseViaStrtod); });
+      } else {
+        f = is_current ? std::function<void()>([this]() { Parse(ParseViaCurrent<int64_t>); })
+                       : std::function<void()>([this]() { Parse(ParseViaStrtoll); });
+      }
+    } else {
+      std::cerr << "The `--numbers` flag must be 'format' or 'parse'." << std::endl;
+      CURRENT_ASSERT(false);
+    }
+  }
+
+  template <typename T>
+  static size_t FormatViaCurrent(T value) {
+    char buffer[current::strings::kMaxFormattedNumberLength];
+    return static_cast<size_t>(current::strings::FormatNumber(value, buffer) - buffer);
+  }
+
+  // `%.17g` is what it takes for `printf()` to round-trip any double, although it is not the shortest form.
+  static size_t FormatViaPrintf(double value) {
+    char buffer[current::strings::kMaxFormattedNumberLength];
+    return static_cast<size_t>(std::snprintf(buffer, sizeof(buffer), "%.17g", value));
+  }
+
+  static size_t FormatViaToString(int64_t value) { return std::to_string(value).length(); }
+
+  template <typename T>
+  static double ParseViaCurrent(const std::string& s) {
+    T value = 0;
+    current::strings::ParseNumber(s.data(), s.data() + s.length(), value);
+    return static_cast<double>(value);
+  }
+
+  static double ParseViaStrtod(const std::string& s) { return std::strtod(s.c_str(), nullptr); }
+
+  static double ParseViaStrtoll(const std::string& s) {
+    return static_cast<double>(std::strtoll(s.c_str(), nullptr, 10));
+  }
+
+  template <typename T, typename F>
+  static void Format(const std::vector<T>& values, F&& format) {
+    size_t total_length = 0u;
+    for (T value : values) {
+      total_length += format(value);
+    }
+    CURRENT_ASSERT(total_length);
+  }
+
+  template <typename F>
+  void Parse(F&& parse) const {
+    double sum = 0.0;
+    for (const std::string& s : strings) {
+      sum += parse(s);
+    }
+    volatile double result = sum;  // Keep the parsing from being optimized away.
+    static_cast<void>(result);
+  }
+
+  void RunOneQuery() override { f(); }
+};
+
+REGISTER_SCENARIO(numbers);
+
+#endif  // BENCHMARK_SCENARIO_NUMBERS_H
@@ -0,0 +1,101 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef BENCHMARK_SCENARIO_SHERLOCK_PUBSUB_H
+#define BENCHMARK_SCENARIO_SHERLOCK_PUBSUB_H
+
+#include "../../../port.h"
+
+#include "benchmark.h"
+
+#include "../../../Sherlock/sherlock.h"
+
+#include "../../../Bricks/dflags/dflags.h"
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+DEFINE_uint32(sherlock_pubsub_entry_length, 100, "The length of the string payload of the published entries.");
+#else
+DECLARE_uint32(sherlock_pubsub_entry_length);
+#endif
+
+namespace benchmark {
+namespace sherlock_pubsub {
+
+CURRENT_STRUCT(Entry) {
+  CURRENT_FIELD(payload, std::string);
+  CURRENT_CONSTRUCTOR(Entry)(const std::string& payload = "") : payload(payload) {}
+};
+
+// Keeps track of how many entries have been delivered to the subscriber so far.
+class SubscriberImpl {
+ public:
+  explicit SubscriberImpl(std::atomic_uint64_t& delivered) : delivered_(delivered) {}
+
+  current::ss::EntryResponse operator()(const Entry&, idxts_t current, idxts_t) {
+    delivered_ = current.index + 1u;
+    return current::ss::EntryResponse::More;
+  }
+
+  current::ss::EntryResponse operator()(std::chrono::microseconds) { return current::ss::EntryResponse::More; }
+
+  static current::ss::EntryResponse EntryResponseIfNoMorePassTypeFilter() { return current::ss::EntryResponse::More; }
+
+  current::ss::TerminationResponse Terminate() const { return current::ss::TerminationResponse::Terminate; }
+
+ private:
+  std::atomic_uint64_t& delivered_;
+};
+
+using Subscriber = current::ss::StreamSubscriber<SubscriberImpl, Entry>;
+
+}  // namespace benchmark::sherlock_pubsub
+}  // namespace benchmark
+
+SCENARIO(sherlock_pubsub, "Publish into the in-memory stream, and wait for the subscriber to receive the entry.") {
+  using stream_t = current::sherlock::Stream<benchmark::sherlock_pubsub::Entry, current::persistence::Memory>;
+  std::atomic_uint64_t delivered;
+  stream_t stream;
+  benchmark::sherlock_pubsub::Subscriber subscriber;
+  current::sherlock::SubscriberScope scope;
+  const std::string payload;
+
+  sherlock_pubsub()
+      : delivered(0u),
+        subscriber(delivered),
+        scope(stream.Subscribe(subscriber)),
+        payload(FLAGS_sherlock_pubsub_entry_length, '.') {}
+
+  // The latency of a query is the time from publishing the entry to it having been seen by the subscriber.
+  // As the subscriber receives the entries in order, the entries published by other threads are waited for as well.
+  void RunOneQuery() override {
+    const uint64_t index = stream.Publish(benchmark::sherlock_pubsub::Entry(payload)).index;
+    while (delivered <= index) {
+      std::this_thread::yield();
+    }
+  }
+};
+
+REGISTER_SCENARIO(sherlock_pubsub);
+
+#endif  // BENCHMARK_SCENARIO_SHERLOCK_PUBSUB_H
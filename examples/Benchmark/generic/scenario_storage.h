@@ -39,10 +39,12 @@ SOFTWARE.
 DEFINE_uint32(storage_initial_size, 10000, "The number of records initially in the storage.");
 DEFINE_string(storage_transaction, "empty", "The transaction to run in the inner loop of the load test.");
 DEFINE_bool(storage_test_string, false, "Set to `true` to test 'get' and 'put' with string, not int, keys.");
+DEFINE_uint32(storage_read_percentage, 90, "The percentage of 'get'-s, the rest being 'put'-s, for the 'mixed' test.");
 #else
 DECLARE_uint32(storage_initial_size);
 DECLARE_string(storage_transaction);
 DECLARE_bool(storage_test_string);
+DECLARE_uint32(storage_read_percentage);
 #endif
 
 CURRENT_STRUCT(UInt32KeyValuePair) {
@@ -79,6 +81,8 @@ SCENARIO(storage, "Storage transactions test.") {
   size_t actual_size_uint32;
   size_t actual_size_string;
   std::function<void()> f;
+  std::function<void()> get;
+  std::function<void()> put;
 
   static uint32_t RandomUInt32() { return current::random::RandomIntegral<uint32_t>(1000000, 999999); }
   static std::string RandomString() { return current::ToString(RandomUInt32()); }
@@ -86,6 +90,25 @@ SCENARIO(storage, "Storage transactions test.") {
   storage() {
     const bool testing_string = FLAGS_storage_test_string;
 
+    get = [this, testing_string]() {
+      Value(db.ReadOnlyTransaction([this, testing_string](ImmutableFields<storage_t> fields) {
+        if (!testing_string) {
+          return Exists(fields.hashmap_uint32[RandomUInt32()]);
+        } else {
+          return Exists(fields.hashmap_string[RandomString()]);
+        }
+      }).Go());
+    };
+    put = [this, testing_string]() {
+      db.ReadWriteTransaction([this, testing_string](MutableFields<storage_t> fields) {
+        if (!testing_string) {
+          fields.hashmap_uint32.Add(UInt32KeyValuePair(RandomUInt32(), RandomUInt32()));
+        } else {
+          fields.hashmap_string.Add(StringKeyValuePair(RandomString(), RandomUInt32()));
+        }
+      }).Wait();
+    };
+
     std::map<std::string, std::function<void()>> tests = {
         {{"empty"}, [this]() { db.ReadOnlyTransaction([](ImmutableFields<storage_t>) {}).Wait(); }},
         {{"size"},
@@ -98,25 +121,16 @@ SCENARIO(storage, "Storage transactions test.") {
              }
            }).Wait();
          }},
-        {{"get"},
-         [this, testing_string]() {
-           Value(db.ReadOnlyTransaction([this, testing_string](ImmutableFields<storage_t> fields) {
-             if (!testing_string) {
-               return Exists(fields.hashmap_uint32[RandomUInt32()]);
-             } else {
-               return Exists(fields.hashmap_string[RandomString()]);
-             }
-           }).Go());
-         }},
-        {{"put"},
-         [this, testing_string]() {
-           db.ReadWriteTransaction([this, testing_string](MutableFields<storage_t> fields) {
-             if (!testing_string) {
-               fields.hashmap_uint32.Add(UInt32KeyValuePair(RandomUInt32(), RandomUInt32()));
-             } else {
-               fields.hashmap_string.Add(StringKeyValuePair(RandomString(), RandomUInt32()));
-             }
-           }).Wait();
+        {{"get"}, [this]() { get(); }},
+        {{"put"}, [this]() { put(); }},
+        // The read-heavy load, to run with `--threads=16` or so, as the read-only transactions run concurrently.
+        {{"mixed"},
+         [this]() {
+           if (current::random::RandomIntegral<uint32_t>(0u, 99u) < FLAGS_storage_read_percentage) {
+             get();
+           } else {
+             put();
+           }
          }}};
     const auto cit = tests.find(FLAGS_storage_transaction);
 
@@ -0,0 +1,78 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef BENCHMARK_SCENARIO_STORAGE_REST_H
+#define BENCHMARK_SCENARIO_STORAGE_REST_H
+
+#include "../../../port.h"
+
+#include "benchmark.h"
+#include "scenario_storage.h"
+
+#include "../../../Storage/api.h"
+
+#include "../../../Bricks/dflags/dflags.h"
+#include "../../../Bricks/util/random.h"
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+DEFINE_uint16(storage_rest_local_port, 9800, "Local port for the `storage_rest` scenario to serve the storage on.");
+DEFINE_uint32(storage_rest_initial_size, 10000, "The number of records initially in the storage served over REST.");
+#else
+DECLARE_uint16(storage_rest_local_port);
+DECLARE_uint32(storage_rest_initial_size);
+#endif
+
+SCENARIO(storage_rest, "Storage served via `RESTfulStorage`, queried for the existing keys over HTTP.") {
+  using storage_t = KeyValueDB<SherlockInMemoryStreamPersister>;
+  storage_t db;
+  std::unique_ptr<RESTfulStorage<storage_t>> rest;
+  std::vector<std::string> urls;
+
+  storage_rest() {
+    CURRENT_ASSERT(FLAGS_storage_rest_initial_size > 0u);
+    db.ReadWriteTransaction([](MutableFields<storage_t> fields) {
+      for (uint32_t i = 0; i < FLAGS_storage_rest_initial_size; ++i) {
+        fields.hashmap_uint32.Add(UInt32KeyValuePair(i, i * i));
+      }
+    }).Wait();
+    rest = std::make_unique<RESTfulStorage<storage_t>>(db, FLAGS_storage_rest_local_port, "/api", "");
+    const std::string prefix =
+        "localhost:" + current::ToString(FLAGS_storage_rest_local_port) + "/api/data/hashmap_uint32/";
+    for (uint32_t i = 0; i < FLAGS_storage_rest_initial_size; ++i) {
+      urls.push_back(prefix + current::ToString(i));
+    }
+  }
+
+  void RunOneQuery() override {
+    const auto response = HTTP(GET(urls[current::random::RandomIntegral<size_t>(0u, urls.size() - 1u)]));
+    if (static_cast<int>(response.code) != 200) {
+      CURRENT_THROW(current::Exception("Unexpected HTTP response code " +
+                                       current::ToString(static_cast<int>(response.code)) + "."));
+    }
+  }
+};
+
+REGISTER_SCENARIO(storage_rest);
+
+#endif  // BENCHMARK_SCENARIO_STORAGE_REST_H
@@ -0,0 +1,125 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2017 Dmitry "Dima" Korolev, <dmitry.korolev@gmail.com>.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+
+#ifndef BENCHMARK_SCENARIO_VARIANT_H
+#define BENCHMARK_SCENARIO_VARIANT_H
+
+#include "../../../port.h"
+
+#include "benchmark.h"
+
+#include "../../../TypeSystem/struct.h"
+#include "../../../TypeSystem/optional.h"
+#include "../../../TypeSystem/variant.h"
+
+#include "../../../Bricks/dflags/dflags.h"
+
+#ifndef CURRENT_MAKE_CHECK_MODE
+DEFINE_string(variant, "assign", "Variant operation to benchmark, assign/copy/move.");
+#else
+DECLARE_string(variant);
+#endif
+
+namespace benchmark {
+namespace variant {
+
+CURRENT_STRUCT(SmallA) { CURRENT_FIELD(x, int32_t, 0); };
+CURRENT_STRUCT(SmallB) {
+  CURRENT_FIELD(x, int64_t, 0);
+  CURRENT_FIELD(y, double, 0.0);
+};
+CURRENT_STRUCT(SmallC) { CURRENT_FIELD(s, std::string, "short"); };
+CURRENT_STRUCT(SmallOptional) { CURRENT_FIELD(o, Optional<SmallC>); };
+
+using small_variant_t = Variant<SmallA, SmallB, SmallC, SmallOptional>;
+
+}  // namespace benchmark::variant
+}  // namespace benchmark
+
+// Each query assigns, copies, or moves 1000 small `Variant`-s, some of which contain an `Optional<>`.
+SCENARIO(variant, "Variant and Optional performance test.") {
+  std::vector<benchmark::variant::small_variant_t> source;
+  std::vector<benchmark::variant::small_variant_t> destination;
+  std::function<void()> f;
+
+  variant() : source(1000u), destination(1000u) {
+    using namespace benchmark::variant;
+    for (size_t i = 0u; i < source.size(); ++i) {
+      source[i] = Value(i);
+    }
+    if (FLAGS_variant == "assign") {
+      f = [this]() {
+        for (size_t i = 0u; i < destination.size(); ++i) {
+          destination[i] = Value(i);
+        }
+      };
+    } else if (FLAGS_variant == "copy") {
+      f = [this]() {
+        for (size_t i = 0u; i < destination.size(); ++i) {
+          destination[i] = source[i];
+        }
+      };
+    } else if (FLAGS_variant == "move") {
+      f = [this]() {
+        for (size_t i = 0u; i < destination.size(); ++i) {
+          destination[i] = std::move(source[i]);
+          source[i] = std::move(destination[i]);
+        }
+      };
+    } else {
+      std::cerr << "The `--variant` flag must be 'assign', 'copy', or 'move'." << std::endl;
+      CURRENT_ASSERT(false);
+    }
+  }
+
+  static benchmark::variant::small_variant_t Value(size_t i) {
+    using namespace benchmark::variant;
+    switch (i % 4u) {
+      case 0u: {
+        SmallA a;
+        a.x = static_cast<int32_t>(i);
+        return a;
+      }
+      case 1u: {
+        SmallB b;
+        b.x = static_cast<int64_t>(i);
+        return b;
+      }
+      case 2u:
+        return SmallC();
+      default: {
+        SmallOptional o;
+        o.o = SmallC();
+        return o;
+      }
+    }
+  }
+
+  void RunOneQuery() override { f(); }
+};
+
+REGISTER_SCENARIO(variant);
+
+#endif  // BENCHMARK_SCENARIO_VARIANT_H